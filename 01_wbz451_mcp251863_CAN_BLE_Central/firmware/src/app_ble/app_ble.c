@@ -43,6 +43,10 @@
 #include "osal/osal_freertos_extend.h"
 #include "app_ble.h"
 #include "app_ble_handler.h"
+#include "app_ble_peer.h"
+#include "app_ble_evt_pool.h"
+#include "app_ble_gatt_cache.h"
+#include "system/console/sys_console.h"
 
 
 
@@ -64,6 +68,17 @@
 
 #define GAP_DEV_NAME_VALUE          "Microchip"
 
+#define APP_CONN_SCAN_INTERVAL      0x3C    // 37.5 ms
+#define APP_CONN_SCAN_WINDOW        0x1E    // 18.75 ms
+#define APP_RECONN_SCAN_INTERVAL    0x10    // 10 ms
+#define APP_RECONN_SCAN_WINDOW      0x10    // 10 ms, initiator listens continuously
+
+#define APP_CONN_STATE_IDLE         0
+#define APP_CONN_STATE_CONNECTING   1       // Create connection to a scanned address outstanding
+#define APP_CONN_STATE_RECONNECTING 2       // Create connection from the accept list outstanding
+
+#define APP_CONN_DEDUP_ENTRIES      8       // Advertisers remembered to suppress repeated attempts
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Global Variables
@@ -71,12 +86,25 @@
 // *****************************************************************************
 BLE_DD_Config_T         ddConfig;
 
+typedef struct APP_BleConnDedup_T
+{
+    BLE_GAP_Addr_T      addr;
+    TickType_t          lastAttempt;
+} APP_BleConnDedup_T;
+
+static uint8_t              s_connState;
+static uint16_t             s_connTimeoutMs;
+static TickType_t           s_connStart;
+static APP_BleConnDedup_T   s_connDedup[APP_CONN_DEDUP_ENTRIES];
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Function Prototypes
 // *****************************************************************************
 // *****************************************************************************
 
+static void APP_BleStackEvtRelease(STACK_Event_T *p_stackEvt);
+
 
 // *****************************************************************************
 // *****************************************************************************
@@ -91,13 +119,12 @@ void APP_BleStackCb(STACK_Event_T *p_stack)
     APP_Msg_T   *p_appMsg;
 
     memcpy((uint8_t *)&stackEvent, (uint8_t *)p_stack, sizeof(STACK_Event_T));
-    stackEvent.p_event=OSAL_Malloc(p_stack->evtLen);
+    stackEvent.p_event=APP_BleEvtPoolAlloc(p_stack->evtLen);
     if(stackEvent.p_event==NULL)
     {
         return;
     }
     memcpy(stackEvent.p_event, p_stack->p_event, p_stack->evtLen);
-    stackEvent.p_event=stackEvent.p_event;
 
     if (p_stack->groupId==STACK_GRP_GATT)
     {
@@ -107,12 +134,15 @@ void APP_BleStackCb(STACK_Event_T *p_stack)
         {
             uint8_t *p_payload;
 
-            p_payload = (uint8_t *)OSAL_Malloc((p_evtGatt->eventField.onClientCccdListChange.numOfCccd*4));
-            if (p_payload != NULL)
+            p_payload = (uint8_t *)APP_BleEvtPoolAlloc((p_evtGatt->eventField.onClientCccdListChange.numOfCccd*4));
+            if (p_payload == NULL)
             {
-                memcpy(p_payload, (uint8_t *)p_evtGatt->eventField.onClientCccdListChange.p_cccdList, (p_evtGatt->eventField.onClientCccdListChange.numOfCccd*4));
-                p_evtGatt->eventField.onClientCccdListChange.p_cccdList = (GATTS_CccdList_T *)p_payload;
+                /* The stack owned list is gone once this callback returns. */
+                APP_BleEvtPoolFree(stackEvent.p_event);
+                return;
             }
+            memcpy(p_payload, (uint8_t *)p_evtGatt->eventField.onClientCccdListChange.p_cccdList, (p_evtGatt->eventField.onClientCccdListChange.numOfCccd*4));
+            p_evtGatt->eventField.onClientCccdListChange.p_cccdList = (GATTS_CccdList_T *)p_payload;
         }
     }
 
@@ -123,11 +153,34 @@ void APP_BleStackCb(STACK_Event_T *p_stack)
     ((STACK_Event_T *)appMsg.msgData)->p_event=stackEvent.p_event;
 
     p_appMsg = &appMsg;
-    OSAL_QUEUE_Send(&appData.appQueue, p_appMsg, 0);
+    if (OSAL_QUEUE_Send(&appData.appQueue, p_appMsg, 0) != OSAL_RESULT_TRUE)
+    {
+        APP_BleStackEvtRelease(&stackEvent);
+        return;
+    }
+    APP_MsgNotify();
+}
+
+static void APP_BleStackEvtRelease(STACK_Event_T *p_stackEvt)
+{
+    if (p_stackEvt->groupId==STACK_GRP_GATT)
+    {
+        GATT_Event_T *p_evtGatt = (GATT_Event_T *)p_stackEvt->p_event;
+
+        if (p_evtGatt->eventId == GATTS_EVT_CLIENT_CCCDLIST_CHANGE)
+        {
+            APP_BleEvtPoolFree(p_evtGatt->eventField.onClientCccdListChange.p_cccdList);
+        }
+    }
+
+    APP_BleEvtPoolFree(p_stackEvt->p_event);
 }
 
 void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt)
 {
+    BLE_GAP_Event_T *p_gapEvt = (BLE_GAP_Event_T *)p_stackEvt->p_event;
+    bool gattCached = false;
+
     switch(p_stackEvt->groupId)
     {
         case STACK_GRP_BLE_GAP:
@@ -158,6 +211,15 @@ void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt)
 
     }
 
+    if ((p_stackEvt->groupId == STACK_GRP_BLE_GAP) && (p_gapEvt->eventId == BLE_GAP_EVT_CONNECTED)
+        && (p_gapEvt->eventField.evtConnect.status == GAP_STATUS_SUCCESS))
+    {
+        // Known peers skip BLE_DD, their TRS handles are restored below
+        gattCached = APP_BleGattCacheConnected(p_gapEvt->eventField.evtConnect.connHandle,
+            &p_gapEvt->eventField.evtConnect.remoteAddr);
+        ddConfig.disableConnectedDisc = gattCached;
+    }
+
     //Direct event to BLE middleware
     BLE_DM_BleEventHandler(p_stackEvt);
 
@@ -167,6 +229,11 @@ void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt)
 
     /* Transparent Profile */
     BLE_TRSPC_BleEventHandler(p_stackEvt);
+
+    if (gattCached)
+    {
+        APP_BleGattCacheRestore(p_gapEvt->eventField.evtConnect.connHandle);
+    }
     
 
 
@@ -177,7 +244,7 @@ void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt)
 
 
 
-    OSAL_Free(p_stackEvt->p_event);
+    APP_BleStackEvtRelease(p_stackEvt);
 }
 
 
@@ -197,6 +264,175 @@ void APP_DdEvtHandler(BLE_DD_Event_T *p_event)
 
 
 
+static uint16_t APP_BleCreateConnection(uint8_t filterPolicy, const BLE_GAP_Addr_T *p_addr, uint16_t scanInterval, uint16_t scanWindow)
+{
+    BLE_GAP_CreateConnParams_T createConnParam_t;
+
+    memset(&createConnParam_t, 0, sizeof(BLE_GAP_CreateConnParams_T));
+    createConnParam_t.scanInterval = scanInterval;
+    createConnParam_t.scanWindow = scanWindow;
+    createConnParam_t.filterPolicy = filterPolicy;
+    if (p_addr != NULL)
+    {
+        memcpy(&createConnParam_t.peerAddr, p_addr, sizeof(BLE_GAP_Addr_T));
+    }
+    createConnParam_t.connParams.intervalMin = 0x10; // 20ms
+    createConnParam_t.connParams.intervalMax = 0x10; // 20ms
+    createConnParam_t.connParams.latency = 0;
+    createConnParam_t.connParams.supervisionTimeout = 0x48; // 720ms
+    return BLE_GAP_CreateConnection(&createConnParam_t);
+}
+
+static bool APP_BleConnSeen(const BLE_GAP_Addr_T *p_addr)
+{
+    TickType_t now = xTaskGetTickCount();
+    uint8_t i;
+    uint8_t oldest = 0;
+
+    for (i = 0; i < APP_CONN_DEDUP_ENTRIES; i++)
+    {
+        if (memcmp(&s_connDedup[i].addr, p_addr, sizeof(BLE_GAP_Addr_T)) == 0)
+        {
+            if (((now - s_connDedup[i].lastAttempt) * portTICK_PERIOD_MS) < APP_CONN_DEDUP_TIME_MS)
+            {
+                return true;
+            }
+            oldest = i;
+            break;
+        }
+        if ((now - s_connDedup[i].lastAttempt) > (now - s_connDedup[oldest].lastAttempt))
+        {
+            oldest = i;
+        }
+    }
+
+    memcpy(&s_connDedup[oldest].addr, p_addr, sizeof(BLE_GAP_Addr_T));
+    s_connDedup[oldest].lastAttempt = now;
+    return false;
+}
+
+static void APP_BleConnPending(uint8_t state, uint16_t timeoutMs)
+{
+    s_connState = state;
+    s_connTimeoutMs = timeoutMs;
+    s_connStart = xTaskGetTickCount();
+}
+
+bool APP_BleConnRequest(const BLE_GAP_Addr_T *p_addr)
+{
+    if ((s_connState != APP_CONN_STATE_IDLE) || APP_BleConnSeen(p_addr))
+    {
+        return false;
+    }
+
+    // Further reports of this or other peripherals are of no use while connecting
+    APP_BleScanStop();
+    if (APP_BleCreateConnection(BLE_GAP_INIT_FP_FILTER_ACCEPT_LIST_NOT_USED, p_addr,
+        APP_CONN_SCAN_INTERVAL, APP_CONN_SCAN_WINDOW) != MBA_RES_SUCCESS)
+    {
+        APP_BleScanStart();
+        return false;
+    }
+
+    APP_BleConnPending(APP_CONN_STATE_CONNECTING, APP_CONN_TIMEOUT_MS);
+    SYS_CONSOLE_MESSAGE("Found BLE CAN Peripheral Device - ");
+    extern void PrintBtAddress(uint8_t *addr);
+    PrintBtAddress((uint8_t *)p_addr->addr);
+    return true;
+}
+
+bool APP_BleReconnStart(void)
+{
+#ifdef APP_CAN_BCAST_ENABLE
+    // Connections are not used while listening to the broadcast train
+    return false;
+#else
+    if (s_connState != APP_CONN_STATE_IDLE)
+    {
+        return false;
+    }
+
+    APP_BleScanStop();
+    if (!APP_BlePeerAcceptListLoad())
+    {
+        return false;
+    }
+
+    // Initiate straight from the accept list: the first advertising packet of
+    // the known peer (directed or not) creates the link, nothing is parsed.
+    if (APP_BleCreateConnection(BLE_GAP_INIT_FP_FILTER_ACCEPT_LIST_USED, NULL,
+        APP_RECONN_SCAN_INTERVAL, APP_RECONN_SCAN_WINDOW) != MBA_RES_SUCCESS)
+    {
+        return false;
+    }
+
+    APP_BleConnPending(APP_CONN_STATE_RECONNECTING, APP_RECONN_TIMEOUT_MS);
+    return true;
+#endif
+}
+
+void APP_BleConnDone(void)
+{
+    s_connState = APP_CONN_STATE_IDLE;
+}
+
+bool APP_BleConnPendingGet(void)
+{
+    return (s_connState != APP_CONN_STATE_IDLE);
+}
+
+uint16_t APP_BleConnTasks(void)
+{
+    uint32_t elapsed;
+
+    if (s_connState == APP_CONN_STATE_IDLE)
+    {
+        return OSAL_WAIT_FOREVER;
+    }
+
+    elapsed = (xTaskGetTickCount() - s_connStart) * portTICK_PERIOD_MS;
+    if (elapsed < s_connTimeoutMs)
+    {
+        return (uint16_t)(s_connTimeoutMs - elapsed);
+    }
+
+    // The peer did not answer, look for any BLE CAN Peripheral instead. The
+    // cancelled attempt is reported as a failed BLE_GAP_EVT_CONNECTED.
+    SYS_CONSOLE_PRINT("[BLE]%s timeout, scanning\r\n",
+        (s_connState == APP_CONN_STATE_RECONNECTING) ? "Reconnect" : "Connect");
+    s_connState = APP_CONN_STATE_IDLE;
+    BLE_GAP_CreateConnectionCancel();
+    APP_BleScanStart();
+    return OSAL_WAIT_FOREVER;
+}
+
+void APP_BleScanStart(void)
+{
+#ifdef APP_CAN_BCAST_ENABLE
+    BLE_GAP_ExtScanningEnable_T extScanEnable;
+
+    extScanEnable.enable = true;
+    extScanEnable.filterDuplicates = BLE_GAP_SCAN_FD_ENABLE;
+    extScanEnable.duration = 0;
+    extScanEnable.period = 0;
+    BLE_GAP_SetExtScanningEnable(BLE_GAP_SCAN_MODE_OBSERVER, &extScanEnable);
+#else
+    BLE_GAP_SetScanningEnable(true, BLE_GAP_SCAN_FD_ENABLE, BLE_GAP_SCAN_MODE_OBSERVER, 100);
+#endif
+}
+
+void APP_BleScanStop(void)
+{
+#ifdef APP_CAN_BCAST_ENABLE
+    BLE_GAP_ExtScanningEnable_T extScanEnable;
+
+    memset(&extScanEnable, 0, sizeof(BLE_GAP_ExtScanningEnable_T));
+    BLE_GAP_SetExtScanningEnable(BLE_GAP_SCAN_MODE_OBSERVER, &extScanEnable);
+#else
+    BLE_GAP_SetScanningEnable(false, BLE_GAP_SCAN_FD_DISABLE, BLE_GAP_SCAN_MODE_OBSERVER, 0);
+#endif
+}
+
 void APP_BleConfigBasic()
 {
 
@@ -223,7 +459,11 @@ void APP_BleConfigAdvance()
     BLE_SMP_Config_T                smpParam;
 
    
+#ifdef APP_CAN_BCAST_ENABLE
+    BLE_GAP_ExtScanningPhy_T        extScanPhy;
+#else
     BLE_GAP_ScanningParams_T        scanParam;
+#endif
     BLE_DM_Config_T                 dmConfig;
     BLE_GAP_ServiceOption_T         gapServiceOptions;
     
@@ -241,6 +481,16 @@ void APP_BleConfigAdvance()
     BLE_GAP_ConfigureBuildInService(&gapServiceOptions);
     
     
+#ifdef APP_CAN_BCAST_ENABLE
+    // Configure extended scan parameters, LE 1M primary channels only
+    memset(&extScanPhy, 0, sizeof(BLE_GAP_ExtScanningPhy_T));
+    extScanPhy.le1mPhy.enable = true;
+    extScanPhy.le1mPhy.type = BLE_GAP_SCAN_TYPE_PASSIVE_SCAN;
+    extScanPhy.le1mPhy.interval = 160;
+    extScanPhy.le1mPhy.window = 80;
+    extScanPhy.le1mPhy.disChannel = 0;
+    BLE_GAP_SetExtScanningParams(BLE_GAP_SCAN_FP_ACCEPT_ALL, &extScanPhy);
+#else
     // Configure scan parameters
     scanParam.type = BLE_GAP_SCAN_TYPE_PASSIVE_SCAN;      /* Scan Type */
     scanParam.interval = 160;      /* Scan Interval */
@@ -248,6 +498,7 @@ void APP_BleConfigAdvance()
     scanParam.filterPolicy = BLE_GAP_SCAN_FP_ACCEPT_ALL;       /* Scan Filter Policy */
     scanParam.disChannel = 0;      /* Disable specific channel during scanning */
     BLE_GAP_SetScanningParam(&scanParam);
+#endif
 
     BLE_GAP_SetConnTxPowerLevel(15, &connTxPower);      /* Connection TX Power */
 
@@ -292,6 +543,10 @@ void APP_BleStackInitAdvance()
 
 
     BLE_GAP_ScanInit();     /* Scan */
+#ifdef APP_CAN_BCAST_ENABLE
+    BLE_GAP_ExtScanInit(BLE_GAP_EXT_SCAN_DATA_LEN_MAX, 0);     /* Extended Scan */
+    BLE_GAP_SyncInit();     /* Periodic Advertising Sync */
+#endif
     
     BLE_GAP_ConnCentralInit();  /* Central */
 
@@ -335,7 +590,10 @@ void APP_BleStackInitAdvance()
 
 void APP_BleStackInit()
 {
+    APP_BleEvtPoolInit();
     APP_BleStackInitBasic();
     APP_BleConfigBasic();
     APP_BleStackInitAdvance();
+    APP_BlePeerInit();
+    APP_BleGattCacheInit();
 }
\ No newline at end of file
@@ -193,6 +193,163 @@ void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt);
 */
 void APP_BleStackLogHandler(BT_SYS_LogEvent_T *p_logEvt);
 
+/*******************************************************************************
+  Function:
+    void APP_BleScanStart(void)
+
+  Summary:
+     Starts scanning for BLE CAN Peripherals. Uses extended scanning when
+     APP_CAN_BCAST_ENABLE is defined.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_BleScanStart(void);
+
+/*******************************************************************************
+  Function:
+    void APP_BleScanStop(void)
+
+  Summary:
+     Stops scanning.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_BleScanStop(void);
+
+/*******************************************************************************
+  Function:
+    bool APP_BleConnRequest(const BLE_GAP_Addr_T *p_addr)
+
+  Summary:
+     Connects to a BLE CAN Peripheral found while scanning.
+
+  Description:
+    Only one connection attempt is outstanding at a time, and an advertiser
+    is not retried within APP_CONN_DEDUP_TIME_MS of the previous attempt, so
+    repeated advertising reports do not turn into repeated create connection
+    commands. Scanning is stopped as soon as the connection is initiated and
+    the attempt is cancelled after APP_CONN_TIMEOUT_MS.
+
+  Precondition:
+
+  Parameters:
+    p_addr - Address of the advertiser.
+
+  Returns:
+    true  - Connection initiated.
+    false - Attempt already outstanding, advertiser recently tried, or the
+            create connection failed.
+
+*/
+bool APP_BleConnRequest(const BLE_GAP_Addr_T *p_addr);
+
+/*******************************************************************************
+  Function:
+    bool APP_BleReconnStart(void)
+
+  Summary:
+     Starts a fast reconnection to the last connected peer.
+
+  Description:
+    Scanning is stopped, the persisted peer is loaded into the filter accept
+    list and a high duty cycle create connection using the accept list is
+    issued. If the peer does not connect within APP_RECONN_TIMEOUT_MS the
+    attempt is cancelled and open scanning is resumed by APP_BleConnTasks.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    true  - Reconnection started.
+    false - No peer known, another attempt is outstanding or the attempt
+            could not be started; the caller shall fall back to
+            APP_BleScanStart.
+
+*/
+bool APP_BleReconnStart(void);
+
+/*******************************************************************************
+  Function:
+    void APP_BleConnDone(void)
+
+  Summary:
+     Closes the outstanding connection attempt.
+
+  Description:
+    Called when BLE_GAP_EVT_CONNECTED reports the result of the attempt.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_BleConnDone(void);
+
+/*******************************************************************************
+  Function:
+    bool APP_BleConnPendingGet(void)
+
+  Summary:
+     Returns true while a connection attempt is outstanding.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    See summary.
+
+*/
+bool APP_BleConnPendingGet(void);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_BleConnTasks(void)
+
+  Summary:
+     Supervises the timeout of the outstanding connection attempt.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    Time in milliseconds until the function needs to be called again, or
+    OSAL_WAIT_FOREVER when no attempt is outstanding.
+
+*/
+uint16_t APP_BleConnTasks(void);
+
 #endif /* _APP_BLE_H */
 
 //DOM-IGNORE-BEGIN
@@ -0,0 +1,209 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application BLE Event Pool Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_ble_evt_pool.c
+
+  Summary:
+    Fixed block pool for BLE stack events and their payloads.
+
+  Description:
+    See app_ble_evt_pool.h.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "app_ble_evt_pool.h"
+#include "configuration.h"
+#include "osal/osal_freertos.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct APP_BleEvtPoolBlock_T
+{
+    struct APP_BleEvtPoolBlock_T    *p_next;
+} APP_BleEvtPoolBlock_T;
+
+typedef struct APP_BleEvtPoolClass_T
+{
+    uint8_t                 *p_storage;
+    APP_BleEvtPoolBlock_T   *p_free;
+    APP_BleEvtPoolStats_T   stats;
+} APP_BleEvtPoolClass_T;
+
+static uint32_t s_smallStorage[(APP_BLE_EVT_POOL_SMALL_SIZE * APP_BLE_EVT_POOL_SMALL_NUM) / 4] APP_STATIC_SECTION("pool");
+static uint32_t s_mediumStorage[(APP_BLE_EVT_POOL_MEDIUM_SIZE * APP_BLE_EVT_POOL_MEDIUM_NUM) / 4] APP_STATIC_SECTION("pool");
+static uint32_t s_largeStorage[(APP_BLE_EVT_POOL_LARGE_SIZE * APP_BLE_EVT_POOL_LARGE_NUM) / 4] APP_STATIC_SECTION("pool");
+
+/* Ordered by block size, APP_BleEvtPoolAlloc relies on it. */
+static APP_BleEvtPoolClass_T s_poolClass[APP_BLE_EVT_POOL_CLASS_NUM] =
+{
+    {(uint8_t *)s_smallStorage,  NULL, {APP_BLE_EVT_POOL_SMALL_SIZE,  APP_BLE_EVT_POOL_SMALL_NUM,  0, 0, 0, 0}},
+    {(uint8_t *)s_mediumStorage, NULL, {APP_BLE_EVT_POOL_MEDIUM_SIZE, APP_BLE_EVT_POOL_MEDIUM_NUM, 0, 0, 0, 0}},
+    {(uint8_t *)s_largeStorage,  NULL, {APP_BLE_EVT_POOL_LARGE_SIZE,  APP_BLE_EVT_POOL_LARGE_NUM,  0, 0, 0, 0}},
+};
+
+static uint32_t s_oversizeCnt;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void APP_BleEvtPoolInit(void)
+{
+    uint8_t i, j;
+    APP_BleEvtPoolClass_T *p_class;
+    APP_BleEvtPoolBlock_T *p_block;
+
+    for (i = 0; i < APP_BLE_EVT_POOL_CLASS_NUM; i++)
+    {
+        p_class = &s_poolClass[i];
+        p_class->p_free = NULL;
+
+        for (j = p_class->stats.blockNum; j > 0; j--)
+        {
+            p_block = (APP_BleEvtPoolBlock_T *)(p_class->p_storage + ((j - 1) * p_class->stats.blockSize));
+            p_block->p_next = p_class->p_free;
+            p_class->p_free = p_block;
+        }
+
+        p_class->stats.inUse = 0;
+        p_class->stats.highWater = 0;
+        p_class->stats.allocCnt = 0;
+        p_class->stats.exhaustCnt = 0;
+    }
+
+    s_oversizeCnt = 0;
+}
+
+void *APP_BleEvtPoolAlloc(size_t size)
+{
+    uint8_t i;
+    APP_BleEvtPoolClass_T *p_class;
+    APP_BleEvtPoolBlock_T *p_block = NULL;
+
+    if (size > APP_BLE_EVT_POOL_LARGE_SIZE)
+    {
+        s_oversizeCnt++;
+        return NULL;
+    }
+
+    OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
+
+    for (i = 0; i < APP_BLE_EVT_POOL_CLASS_NUM; i++)
+    {
+        p_class = &s_poolClass[i];
+
+        if (size > p_class->stats.blockSize)
+        {
+            continue;
+        }
+
+        if (p_class->p_free == NULL)
+        {
+            p_class->stats.exhaustCnt++;
+            continue;
+        }
+
+        p_block = p_class->p_free;
+        p_class->p_free = p_block->p_next;
+        p_class->stats.allocCnt++;
+        p_class->stats.inUse++;
+        if (p_class->stats.inUse > p_class->stats.highWater)
+        {
+            p_class->stats.highWater = p_class->stats.inUse;
+        }
+        break;
+    }
+
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, 0);
+
+    return p_block;
+}
+
+void APP_BleEvtPoolFree(void *p_block)
+{
+    uint8_t i;
+    uint8_t *p_addr = (uint8_t *)p_block;
+    APP_BleEvtPoolClass_T *p_class;
+
+    if (p_block == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < APP_BLE_EVT_POOL_CLASS_NUM; i++)
+    {
+        p_class = &s_poolClass[i];
+
+        if ((p_addr >= p_class->p_storage)
+            && (p_addr < (p_class->p_storage + (p_class->stats.blockSize * p_class->stats.blockNum))))
+        {
+            OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
+            ((APP_BleEvtPoolBlock_T *)p_block)->p_next = p_class->p_free;
+            p_class->p_free = (APP_BleEvtPoolBlock_T *)p_block;
+            p_class->stats.inUse--;
+            OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, 0);
+            return;
+        }
+    }
+}
+
+bool APP_BleEvtPoolStatsGet(uint8_t classIdx, APP_BleEvtPoolStats_T *p_stats)
+{
+    if (classIdx >= APP_BLE_EVT_POOL_CLASS_NUM)
+    {
+        return false;
+    }
+
+    OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
+    memcpy(p_stats, &s_poolClass[classIdx].stats, sizeof(APP_BleEvtPoolStats_T));
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, 0);
+
+    return true;
+}
+
+uint32_t APP_BleEvtPoolOversizeCntGet(void)
+{
+    return s_oversizeCnt;
+}
+
+/*******************************************************************************
+ End of File
+ */
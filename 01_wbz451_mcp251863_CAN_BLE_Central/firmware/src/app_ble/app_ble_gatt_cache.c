@@ -0,0 +1,237 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application BLE GATT Handle Cache Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_ble_gatt_cache.c
+
+  Summary:
+    Caches the Transparent service handles of known peers in persistent storage.
+
+  Description:
+    See app_ble_gatt_cache.h.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "app_ble_gatt_cache.h"
+#include "app_ble_peer.h"
+#include "ble_gcm/ble_dd.h"
+#include "ble_trspc/ble_trspc.h"
+#include "mba_error_defs.h"
+#include "pds.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_BLE_GATT_CACHE_MARK         0x5A
+#define APP_BLE_GATT_CACHE_NONE         0xFF
+#define APP_BLE_GATT_CACHE_NO_CONN      0xFFFF
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct APP_BleGattCacheEntry_T
+{
+    BLE_GAP_Addr_T          addr;
+    BLE_TRSPC_CharHandles_T handles;       /* tcpHandle 0: entry unused */
+} APP_BleGattCacheEntry_T;
+
+typedef struct APP_BleGattCacheRecord_T
+{
+    uint8_t                 mark;
+    uint8_t                 next;          /* Entry replaced when the cache is full */
+    APP_BleGattCacheEntry_T entry[APP_BLE_GATT_CACHE_ENTRIES];
+} APP_BleGattCacheRecord_T;
+
+typedef struct APP_BleGattCacheLink_T
+{
+    uint16_t                connHandle;
+    BLE_GAP_Addr_T          addr;
+    uint8_t                 entryIdx;
+} APP_BleGattCacheLink_T;
+
+static APP_BleGattCacheRecord_T s_cacheRecord;
+static APP_BleGattCacheLink_T   s_cacheLink[BLE_GAP_MAX_LINK_NBR];
+
+PDS_DECLARE_FILE(APP_BLE_GATT_CACHE_ITEM_ID, sizeof(APP_BleGattCacheRecord_T), &s_cacheRecord, FILE_INTEGRITY_CONTROL_MARK);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint8_t APP_BleGattCacheFind(const BLE_GAP_Addr_T *p_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < APP_BLE_GATT_CACHE_ENTRIES; i++)
+    {
+        if ((s_cacheRecord.entry[i].handles.tcpHandle != 0)
+            && (memcmp(&s_cacheRecord.entry[i].addr, p_addr, sizeof(BLE_GAP_Addr_T)) == 0))
+        {
+            return i;
+        }
+    }
+    return APP_BLE_GATT_CACHE_NONE;
+}
+
+static APP_BleGattCacheLink_T *APP_BleGattCacheLinkGet(uint16_t connHandle)
+{
+    uint8_t i;
+
+    for (i = 0; i < BLE_GAP_MAX_LINK_NBR; i++)
+    {
+        if (s_cacheLink[i].connHandle == connHandle)
+        {
+            return &s_cacheLink[i];
+        }
+    }
+    return NULL;
+}
+
+void APP_BleGattCacheInit(void)
+{
+    uint8_t i;
+
+    if (!PDS_IsAbleToRestore(APP_BLE_GATT_CACHE_ITEM_ID) || !PDS_Restore(APP_BLE_GATT_CACHE_ITEM_ID)
+        || (s_cacheRecord.mark != APP_BLE_GATT_CACHE_MARK) || (s_cacheRecord.next >= APP_BLE_GATT_CACHE_ENTRIES))
+    {
+        memset(&s_cacheRecord, 0, sizeof(APP_BleGattCacheRecord_T));
+        s_cacheRecord.mark = APP_BLE_GATT_CACHE_MARK;
+    }
+
+    for (i = 0; i < BLE_GAP_MAX_LINK_NBR; i++)
+    {
+        s_cacheLink[i].connHandle = APP_BLE_GATT_CACHE_NO_CONN;
+    }
+}
+
+bool APP_BleGattCacheConnected(uint16_t connHandle, const BLE_GAP_Addr_T *p_addr)
+{
+    APP_BleGattCacheLink_T *p_link = APP_BleGattCacheLinkGet(APP_BLE_GATT_CACHE_NO_CONN);
+
+    if (p_link == NULL)
+    {
+        return false;
+    }
+
+    p_link->connHandle = connHandle;
+    memcpy(&p_link->addr, p_addr, sizeof(BLE_GAP_Addr_T));
+    p_link->entryIdx = APP_BleGattCacheFind(p_addr);
+    return (p_link->entryIdx != APP_BLE_GATT_CACHE_NONE);
+}
+
+void APP_BleGattCacheRestore(uint16_t connHandle)
+{
+    APP_BleGattCacheLink_T *p_link = APP_BleGattCacheLinkGet(connHandle);
+
+    if ((p_link == NULL) || (p_link->entryIdx == APP_BLE_GATT_CACHE_NONE))
+    {
+        return;
+    }
+
+    if (BLE_TRSPC_RestoreCharHandles(connHandle, &s_cacheRecord.entry[p_link->entryIdx].handles) == MBA_RES_INVALID_PARA)
+    {
+        APP_BleGattCacheInvalidate(connHandle);
+        BLE_DD_RestartServicesDiscovery(connHandle);
+    }
+}
+
+void APP_BleGattCacheUpdate(uint16_t connHandle)
+{
+    APP_BleGattCacheLink_T *p_link = APP_BleGattCacheLinkGet(connHandle);
+    BLE_TRSPC_CharHandles_T handles;
+    uint8_t idx;
+
+    if ((p_link == NULL) || (BLE_TRSPC_GetCharHandles(connHandle, &handles) != MBA_RES_SUCCESS))
+    {
+        return;
+    }
+
+    idx = APP_BleGattCacheFind(&p_link->addr);
+    if (idx == APP_BLE_GATT_CACHE_NONE)
+    {
+        idx = s_cacheRecord.next;
+        s_cacheRecord.next = (s_cacheRecord.next + 1) % APP_BLE_GATT_CACHE_ENTRIES;
+    }
+    else if (memcmp(&s_cacheRecord.entry[idx].handles, &handles, sizeof(BLE_TRSPC_CharHandles_T)) == 0)
+    {
+        p_link->entryIdx = idx;
+        return;
+    }
+
+    memcpy(&s_cacheRecord.entry[idx].addr, &p_link->addr, sizeof(BLE_GAP_Addr_T));
+    memcpy(&s_cacheRecord.entry[idx].handles, &handles, sizeof(BLE_TRSPC_CharHandles_T));
+    p_link->entryIdx = idx;
+    PDS_Store(APP_BLE_GATT_CACHE_ITEM_ID);
+}
+
+void APP_BleGattCacheInvalidate(uint16_t connHandle)
+{
+    APP_BleGattCacheLink_T *p_link = APP_BleGattCacheLinkGet(connHandle);
+    uint8_t idx;
+
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    idx = APP_BleGattCacheFind(&p_link->addr);
+    p_link->entryIdx = APP_BLE_GATT_CACHE_NONE;
+    if (idx != APP_BLE_GATT_CACHE_NONE)
+    {
+        memset(&s_cacheRecord.entry[idx], 0, sizeof(APP_BleGattCacheEntry_T));
+        PDS_Store(APP_BLE_GATT_CACHE_ITEM_ID);
+    }
+}
+
+void APP_BleGattCacheDisconnected(uint16_t connHandle)
+{
+    APP_BleGattCacheLink_T *p_link = APP_BleGattCacheLinkGet(connHandle);
+
+    if (p_link != NULL)
+    {
+        p_link->connHandle = APP_BLE_GATT_CACHE_NO_CONN;
+    }
+}
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,163 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application BLE GATT Handle Cache Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_ble_gatt_cache.h
+
+  Summary:
+    Caches the Transparent service handles of known peers in persistent storage.
+
+  Description:
+    A BLE CAN Peripheral always exposes the same GATT database, so the handles
+    found by BLE_DD on the first connection are kept in one PDS item, keyed by
+    the peer identity address. On later connections to the same peer BLE_DD is
+    skipped and the TRSPC data session is enabled on the cached handles right
+    away. The profile revalidates them once the session is up and restarts
+    discovery if they turn out stale.
+*******************************************************************************/
+
+#ifndef _APP_BLE_GATT_CACHE_H
+#define _APP_BLE_GATT_CACHE_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_BLE_GATT_CACHE_ENTRIES      4       /* Peers remembered, oldest entry is replaced */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_BleGattCacheInit(void)
+
+  Summary:
+    Restores the handle cache from PDS.
+
+  Precondition:
+    PDS_Init() has been called.
+*/
+void APP_BleGattCacheInit(void);
+
+/*******************************************************************************
+  Function:
+    bool APP_BleGattCacheConnected(uint16_t connHandle, const BLE_GAP_Addr_T *p_addr)
+
+  Summary:
+    Binds a new connection to its peer address and looks the peer up.
+
+  Description:
+    Must be called before BLE_DD processes BLE_GAP_EVT_CONNECTED so that the
+    discovery can be disabled for this connection.
+
+  Returns:
+    true  - Handles are cached, call APP_BleGattCacheRestore once TRSPC has
+            processed BLE_GAP_EVT_CONNECTED.
+    false - Unknown peer, BLE_DD discovery is needed.
+*/
+bool APP_BleGattCacheConnected(uint16_t connHandle, const BLE_GAP_Addr_T *p_addr);
+
+/*******************************************************************************
+  Function:
+    void APP_BleGattCacheRestore(uint16_t connHandle)
+
+  Summary:
+    Hands the cached handles to TRSPC, or restarts discovery if it refuses them.
+*/
+void APP_BleGattCacheRestore(uint16_t connHandle);
+
+/*******************************************************************************
+  Function:
+    void APP_BleGattCacheUpdate(uint16_t connHandle)
+
+  Summary:
+    Stores the handles TRSPC found for this connection.
+
+  Description:
+    Called on BLE_TRSPC_EVT_DISC_COMPLETE. Flash is only written when the
+    handles changed.
+*/
+void APP_BleGattCacheUpdate(uint16_t connHandle);
+
+/*******************************************************************************
+  Function:
+    void APP_BleGattCacheInvalidate(uint16_t connHandle)
+
+  Summary:
+    Forgets the handles of the peer on this connection.
+
+  Description:
+    Called on BLE_TRSPC_EVT_CHAR_HANDLES_STALE.
+*/
+void APP_BleGattCacheInvalidate(uint16_t connHandle);
+
+/*******************************************************************************
+  Function:
+    void APP_BleGattCacheDisconnected(uint16_t connHandle)
+
+  Summary:
+    Releases the connection binding.
+*/
+void APP_BleGattCacheDisconnected(uint16_t connHandle);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_BLE_GATT_CACHE_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -50,6 +50,14 @@
 
 #include "system/console/sys_console.h"
 #include "app.h"
+#include "app_ble.h"
+#include "app_ble_peer.h"
+#include "app_ble_gatt_cache.h"
+#include "can_bridge/can_bcast.h"
+#include "can_bridge/can_isotp.h"
+#include "can_bridge/can_j1939.h"
+#include "can_bridge/can_cache.h"
+#include "can_bridge/can_cyclic.h"
 // *****************************************************************************
 // *****************************************************************************
 // Section: Global Variables
@@ -60,7 +68,15 @@
 #define AD_TYPE_SERVICE_UUID        0xFEDA        
 #define AD_TYPE_SERVICE_DATA        0xFFBC
 
-extern uint16_t conn_hdl;
+#ifdef APP_CAN_BCAST_ENABLE
+#define APP_BCAST_SYNC_IDLE         0
+#define APP_BCAST_SYNC_PENDING      1
+#define APP_BCAST_SYNC_ESTABLISHED  2
+
+static uint8_t              s_bcastSyncState;
+static uint16_t             s_bcastSyncHandle;
+static CAN_BCAST_Decoder_T  s_bcastDec;
+#endif
 
 bool lookForServiceItemInAdvertisingString(uint8_t *adv, uint8_t advLength)
 {
@@ -95,6 +111,25 @@ bool lookForServiceItemInAdvertisingString(uint8_t *adv, uint8_t advLength)
     }
     return false;
 }
+#ifdef APP_CAN_BCAST_ENABLE
+static void APP_BcastFrameRx(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+{
+    APP_Msg_T appMsg;
+    uint8_t dataLen = p_obj->bF.ctrl.RTR ? 0 : DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)p_obj->bF.ctrl.DLC);
+
+    // Same layout as a frame received through the Transparent profile
+    appMsg.msgId = APP_MSG_BLE_RX_CAN_TX_EVT;
+    appMsg.msgData[0] = sizeof(CAN_RX_MSGOBJ) + dataLen;
+    memcpy(&appMsg.msgData[1], p_obj, sizeof(CAN_RX_MSGOBJ));
+    memcpy(&appMsg.msgData[1 + sizeof(CAN_RX_MSGOBJ)], p_data, dataLen);
+#ifdef APP_DIR_SCHED_ENABLE
+    APP_DirPost(APP_DIR_BLE_TO_CAN, &appMsg.msgData[1], appMsg.msgData[0]);
+#else
+    OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
+#endif
+}
+#endif
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Functions
@@ -106,18 +141,67 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
     {
         case BLE_GAP_EVT_CONNECTED:
         {
-            conn_hdl = p_event->eventField.evtConnect.connHandle;
+            uint8_t link;
+
+            if (p_event->eventField.evtConnect.status != GAP_STATUS_SUCCESS)
+            {
+                // Cancelled attempts are already closed by APP_BleConnTasks
+                if (APP_BleConnPendingGet())
+                {
+                    APP_BleConnDone();
+                    APP_BleScanStart();
+                }
+                break;
+            }
+            APP_BleConnDone();
+            link = APP_LinkAdd(p_event->eventField.evtConnect.connHandle);
+            if (link == APP_MAX_LINKS)
+            {
+                BLE_GAP_Disconnect(p_event->eventField.evtConnect.connHandle, GAP_DISC_REASON_REMOTE_TERMINATE);
+                break;
+            }
+            APP_BlePeerSave(&p_event->eventField.evtConnect.remoteAddr);
             USER_LED_Clear();
-            SYS_CONSOLE_PRINT("[BLE]Connected\r\n");
-            BLE_GAP_SetScanningEnable(false, BLE_GAP_SCAN_FD_DISABLE, BLE_GAP_SCAN_MODE_OBSERVER, 0);
+#ifdef CAN_CACHE_ENABLE
+            // The new peer has none of the cached values
+            CAN_CACHE_Reset();
+#endif
+            SYS_CONSOLE_PRINT("[BLE]Connected: link %d\r\n", link);
+            if (APP_LinkFreeCount() == 0)
+            {
+                // Keep scanning only while further BLE CAN Peripherals can be linked
+                APP_BleScanStop();
+            }
+            else
+            {
+                // Fast reconnection stops scanning, resume it for the free links
+                APP_BleScanStart();
+            }
         }
         break;
 
         case BLE_GAP_EVT_DISCONNECTED:
         {
-            conn_hdl = 0xFFFF;
-            BLE_GAP_SetScanningEnable(true, BLE_GAP_SCAN_FD_ENABLE, BLE_GAP_SCAN_MODE_OBSERVER, 100);
-            USER_LED_Set();
+            APP_LinkRemove(p_event->eventField.evtDisconnect.connHandle);
+            APP_BleGattCacheDisconnected(p_event->eventField.evtDisconnect.connHandle);
+#ifdef CAN_ISOTP_ENABLE
+            CAN_ISOTP_MtuSet(BLE_ATT_DEFAULT_MTU_LEN);
+#endif
+#ifdef CAN_J1939_ENABLE
+            CAN_J1939_MtuSet(BLE_ATT_DEFAULT_MTU_LEN);
+#endif
+            if (!APP_BleReconnStart())
+            {
+                APP_BleScanStart();
+            }
+            if (APP_LinkFreeCount() == APP_MAX_LINKS)
+            {
+                USER_LED_Set();
+#ifdef CAN_CYCLIC_ENABLE
+                // No peer is left to refresh the schedule
+                CAN_CYCLIC_Reset();
+#endif
+            }
             SYS_CONSOLE_PRINT("[BLE]Disconnected: 0x%x\r\n",p_event->eventField.evtDisconnect.reason);
         }
         break;
@@ -136,13 +220,12 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_ADV_REPORT:
         {
-            if(lookForServiceItemInAdvertisingString(p_event->eventField.evtAdvReport.advData,
+            // Parse only while no connection attempt is outstanding
+            if (!APP_BleConnPendingGet() &&
+                lookForServiceItemInAdvertisingString(p_event->eventField.evtAdvReport.advData,
                 p_event->eventField.evtAdvReport.length) )
             {
-                APP_Msg_T appMsg;
-                appMsg.msgId = APP_MSG_BLE_CONN_EVT;
-                memcpy(appMsg.msgData, &p_event->eventField.evtAdvReport.addr, sizeof(BLE_GAP_Addr_T));
-                OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
+                APP_BleConnRequest(&p_event->eventField.evtAdvReport.addr);
             }
         }
         break;
@@ -161,7 +244,26 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_EXT_ADV_REPORT:
         {
-            /* TODO: implement your application code.*/
+#ifdef APP_CAN_BCAST_ENABLE
+            BLE_GAP_EvtExtAdvReport_T *p_report = &p_event->eventField.evtExtAdvReport;
+
+            // Only the non-connectable set carrying the periodic train is of interest
+            if ((s_bcastSyncState == APP_BCAST_SYNC_IDLE) && (p_report->periodAdvInterval != 0)
+                && lookForServiceItemInAdvertisingString(p_report->advData, p_report->length))
+            {
+                BLE_GAP_CreateSync_T createSync;
+
+                createSync.options = 0;
+                createSync.advSid = p_report->sid;
+                createSync.advAddr = p_report->addr;
+                createSync.skip = 0;
+                createSync.syncTimeout = APP_BCAST_SYNC_TIMEOUT;
+                if (BLE_GAP_CreateSync(&createSync) == MBA_RES_SUCCESS)
+                {
+                    s_bcastSyncState = APP_BCAST_SYNC_PENDING;
+                }
+            }
+#endif
         }
         break;
 
@@ -209,19 +311,48 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_PERI_ADV_SYNC_EST:
         {
-            /* TODO: implement your application code.*/
+#ifdef APP_CAN_BCAST_ENABLE
+            if (p_event->eventField.evtPeriAdvSyncEst.status == 0)
+            {
+                s_bcastSyncHandle = p_event->eventField.evtPeriAdvSyncEst.syncHandle;
+                s_bcastSyncState = APP_BCAST_SYNC_ESTABLISHED;
+                CAN_BCAST_DecoderReset(&s_bcastDec);
+                APP_BleScanStop();
+                USER_LED_Clear();
+                SYS_CONSOLE_PRINT("[BLE]Broadcast synced - ");
+                extern void PrintBtAddress(uint8_t *addr);
+                PrintBtAddress(p_event->eventField.evtPeriAdvSyncEst.advAddr.addr);
+            }
+            else
+            {
+                s_bcastSyncState = APP_BCAST_SYNC_IDLE;
+            }
+#endif
         }
         break;
 
         case BLE_GAP_EVT_PERI_ADV_REPORT:
         {
-            /* TODO: implement your application code.*/
+#ifdef APP_CAN_BCAST_ENABLE
+            BLE_GAP_EvtPeriAdvReport_T *p_report = &p_event->eventField.evtPeriAdvReport;
+
+            if ((s_bcastSyncState == APP_BCAST_SYNC_ESTABLISHED) && (p_report->syncHandle == s_bcastSyncHandle)
+                && (p_report->dataStatus == BLE_GAP_EXT_ADV_REPORT_DATA_STATUS_COMPLETE))
+            {
+                CAN_BCAST_Decode(&s_bcastDec, p_report->advData, p_report->dataLength, APP_BcastFrameRx);
+            }
+#endif
         }
         break;
 
         case BLE_GAP_EVT_PERI_ADV_SYNC_LOST:
         {
-            /* TODO: implement your application code.*/
+#ifdef APP_CAN_BCAST_ENABLE
+            s_bcastSyncState = APP_BCAST_SYNC_IDLE;
+            USER_LED_Set();
+            SYS_CONSOLE_PRINT("[BLE]Broadcast sync lost, missed trains: %d\r\n", s_bcastDec.trainMissCnt);
+            APP_BleScanStart();
+#endif
         }
         break;
 
@@ -233,7 +364,11 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_SCAN_TIMEOUT:
         {
-            /* TODO: implement your application code.*/
+            // Keep looking while links are free and nothing is being connected
+            if (!APP_BleConnPendingGet() && (APP_LinkFreeCount() > 0))
+            {
+                APP_BleScanStart();
+            }
         }
         break;
 
@@ -396,7 +531,17 @@ void APP_GattEvtHandler(GATT_Event_T *p_event)
 
         case ATT_EVT_UPDATE_MTU:
         {
-            /* TODO: implement your application code.*/
+            /* ISO-TP and J1939 segments go to the first connected link, size
+               them only while it is the only one */
+            if (APP_LinkFreeCount() == (APP_MAX_LINKS - 1))
+            {
+#ifdef CAN_ISOTP_ENABLE
+                CAN_ISOTP_MtuSet(p_event->eventField.onUpdateMTU.exchangedMTU);
+#endif
+#ifdef CAN_J1939_ENABLE
+                CAN_J1939_MtuSet(p_event->eventField.onUpdateMTU.exchangedMTU);
+#endif
+            }
         }
         break;
 
@@ -421,7 +566,6 @@ void APP_GattEvtHandler(GATT_Event_T *p_event)
         case GATTS_EVT_CLIENT_CCCDLIST_CHANGE:
         {
             /* TODO: implement your application code.*/
-            OSAL_Free(p_event->eventField.onClientCccdListChange.p_cccdList);
         }
         break;
 
@@ -0,0 +1,172 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application BLE Peer Persistence Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_ble_peer.h
+
+  Summary:
+    Keeps the address of the last connected BLE peer in persistent storage.
+
+  Description:
+    The address is written to one PDS item so that the link can be re-created
+    straight after reset or disconnection without scanning and parsing
+    advertising data first. The flash write itself is carried out by the idle
+    task (PDS_StoreItemTaskHandler), so saving from the application task is
+    cheap.
+*******************************************************************************/
+
+#ifndef _APP_BLE_PEER_H
+#define _APP_BLE_PEER_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+#include "pds.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_BLE_PEER_DEV_ID_NONE        0xFF
+
+/* PDS item IDs owned by the application. Enumerated rather than #defined
+   because PDS_DECLARE_FILE token-pastes the ID into the file descriptor name.
+   PDS_APP_MAX_ITEMS_AMOUNT in pds_config.h must cover every item up to
+   APP_BLE_PDS_ITEM_END. */
+typedef enum APP_BlePdsItem_T
+{
+    APP_BLE_PEER_ITEM_ID = (PDS_MODULE_APP_OFFSET),
+    APP_BLE_GATT_CACHE_ITEM_ID,
+    APP_BLE_PDS_ITEM_END
+} APP_BlePdsItem_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_BlePeerInit(void)
+
+  Summary:
+    Restores the last peer address from PDS.
+
+  Precondition:
+    PDS_Init() has been called.
+*/
+void APP_BlePeerInit(void);
+
+/*******************************************************************************
+  Function:
+    bool APP_BlePeerGet(BLE_GAP_Addr_T *p_addr)
+
+  Summary:
+    Returns the last connected peer.
+
+  Returns:
+    true  - A peer is known, p_addr is filled.
+    false - No peer was stored yet.
+*/
+bool APP_BlePeerGet(BLE_GAP_Addr_T *p_addr);
+
+/*******************************************************************************
+  Function:
+    void APP_BlePeerSave(const BLE_GAP_Addr_T *p_addr)
+
+  Summary:
+    Remembers p_addr as the last connected peer.
+
+  Description:
+    Flash is only written when the address differs from the stored one.
+*/
+void APP_BlePeerSave(const BLE_GAP_Addr_T *p_addr);
+
+/*******************************************************************************
+  Function:
+    uint8_t APP_BlePeerPairedDevId(const BLE_GAP_Addr_T *p_addr)
+
+  Summary:
+    Looks p_addr up in the BLE_DM paired device list.
+
+  Returns:
+    Paired device ID or APP_BLE_PEER_DEV_ID_NONE if the peer is not bonded.
+*/
+uint8_t APP_BlePeerPairedDevId(const BLE_GAP_Addr_T *p_addr);
+
+/*******************************************************************************
+  Function:
+    bool APP_BlePeerAcceptListLoad(void)
+
+  Summary:
+    Loads the last peer into the controller filter accept list.
+
+  Description:
+    Bonded peers are added through BLE_DM_SetFilterAcceptList so that the
+    identity address from the bonding record is used. Peers that never bonded
+    are added with their connection address through BLE_GAP_SetFilterAcceptList.
+
+  Precondition:
+    The accept list is not in use by scanning, advertising or an outstanding
+    create connection.
+
+  Returns:
+    true  - The accept list holds the last peer.
+    false - No peer known or the list could not be written.
+*/
+bool APP_BlePeerAcceptListLoad(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_BLE_PEER_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,296 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Telemetry Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_telemetry.c
+
+  Summary:
+    Periodic CPU, stack, heap and queue usage snapshots pushed over BLE.
+
+  Description:
+    See app_telemetry.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "app.h"
+#include "app_ble_evt_pool.h"
+#include "app_telemetry.h"
+
+#ifdef APP_TELEMETRY_ENABLE
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_TELEMETRY_CYCLES_PER_TICK   (configCPU_CLOCK_HZ / configTICK_RATE_HZ)
+
+typedef struct APP_TelemetryPrev_T
+{
+    UBaseType_t     taskNumber;
+    uint32_t        runTime;
+} APP_TelemetryPrev_T;
+
+static TaskStatus_t         s_telemStatus[APP_TELEMETRY_MAX_TASKS];
+static APP_TelemetryPrev_T  s_telemPrev[APP_TELEMETRY_MAX_TASKS];
+static uint8_t              s_telemPrevNum;
+static TickType_t           s_telemPrevTick;
+
+static uint16_t             s_telemQueuePeak;
+static uint16_t             s_telemRingPeak;
+static uint32_t             s_telemRingDrops;
+#ifdef APP_RX_ADAPT_ENABLE
+static APP_RxStats_T        s_telemRxPrev;
+#endif
+
+static uint8_t              s_telemRecord[APP_TELEMETRY_RECORD_MAX_LEN];
+static uint8_t              s_telemRecordLen;
+static uint8_t              s_telemSeq;
+static uint8_t              s_telemFragIdx;
+static uint8_t              s_telemFragNum;     /* 0: nothing to send */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void APP_TelemetryPut16(uint8_t *p_buf, uint32_t value)
+{
+    if (value > 0xFFFFU)
+    {
+        value = 0xFFFFU;
+    }
+    p_buf[0] = (uint8_t)value;
+    p_buf[1] = (uint8_t)(value >> 8);
+}
+
+static uint8_t APP_TelemetrySat8(uint32_t value)
+{
+    return (value > 0xFFU) ? 0xFFU : (uint8_t)value;
+}
+
+static uint32_t APP_TelemetryPrevRunTime(UBaseType_t taskNumber)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_telemPrevNum; i++)
+    {
+        if (s_telemPrev[i].taskNumber == taskNumber)
+        {
+            return s_telemPrev[i].runTime;
+        }
+    }
+    return 0;
+}
+
+static void APP_TelemetryRxPut(uint8_t *p_buf)
+{
+#ifdef APP_RX_ADAPT_ENABLE
+    const APP_RxStats_T *p_rx = APP_RxStatsGet();
+    uint32_t total = 0;
+    uint8_t mask = 0;
+    uint8_t ch;
+
+    for (ch = 0; ch < APP_RX_OVF_CH_NUM; ch++)
+    {
+        total += p_rx->overflow[ch];
+        if (p_rx->overflow[ch] != s_telemRxPrev.overflow[ch])
+        {
+            mask |= (uint8_t)(1U << ch);
+        }
+    }
+    APP_TelemetryPut16(&p_buf[0], total);
+    p_buf[2] = APP_TelemetrySat8(p_rx->boosts - s_telemRxPrev.boosts);
+    p_buf[3] = mask;
+    s_telemRxPrev = *p_rx;
+#else
+    memset(p_buf, 0, 4);
+#endif
+}
+
+static void APP_TelemetrySnapshot(TickType_t now)
+{
+    APP_BleEvtPoolStats_T poolStats;
+    uint32_t wallCycles = (now - s_telemPrevTick) * APP_TELEMETRY_CYCLES_PER_TICK;
+    uint32_t exhaustCnt = 0;
+    uint8_t *p_buf = s_telemRecord;
+    UBaseType_t taskNum;
+    uint8_t i;
+
+    taskNum = uxTaskGetSystemState(s_telemStatus, APP_TELEMETRY_MAX_TASKS, NULL);
+
+    p_buf[0] = APP_TELEMETRY_VERSION;
+    p_buf[1] = s_telemSeq;
+    p_buf[2] = (uint8_t)taskNum;
+    p_buf[3] = APP_TelemetrySat8(s_telemQueuePeak);
+    APP_TelemetryPut16(&p_buf[4], (now - s_telemPrevTick) * portTICK_PERIOD_MS);
+    APP_TelemetryPut16(&p_buf[6], xPortGetFreeHeapSize());
+    APP_TelemetryPut16(&p_buf[8], xPortGetMinimumEverFreeHeapSize());
+    p_buf[10] = APP_TelemetrySat8(s_telemRingPeak);
+    p_buf[11] = APP_TelemetrySat8(s_telemRingDrops);
+    for (i = 0; i < APP_BLE_EVT_POOL_CLASS_NUM; i++)
+    {
+        APP_BleEvtPoolStatsGet(i, &poolStats);
+        p_buf[12 + i] = poolStats.highWater;
+        exhaustCnt += poolStats.exhaustCnt;
+    }
+    p_buf[15] = APP_TelemetrySat8(exhaustCnt);
+    APP_TelemetryRxPut(&p_buf[16]);
+    p_buf += APP_TELEMETRY_HDR_LEN;
+
+    for (i = 0; i < taskNum; i++)
+    {
+        TaskStatus_t *p_status = &s_telemStatus[i];
+        uint32_t cycles = p_status->ulRunTimeCounter - APP_TelemetryPrevRunTime(p_status->xTaskNumber);
+        uint32_t load = 0;
+
+        if (wallCycles != 0)
+        {
+            load = (uint32_t)(((uint64_t)cycles * 1000U) / wallCycles);
+        }
+        memset(p_buf, 0, 4);
+        strncpy((char *)p_buf, p_status->pcTaskName, 4);
+        APP_TelemetryPut16(&p_buf[4], load);
+        APP_TelemetryPut16(&p_buf[6], p_status->usStackHighWaterMark);
+        p_buf += APP_TELEMETRY_TASK_LEN;
+
+        s_telemPrev[i].taskNumber = p_status->xTaskNumber;
+        s_telemPrev[i].runTime = p_status->ulRunTimeCounter;
+    }
+    s_telemPrevNum = (uint8_t)taskNum;
+    s_telemPrevTick = now;
+
+    s_telemRecordLen = (uint8_t)(p_buf - s_telemRecord);
+    s_telemFragNum = (s_telemRecordLen + APP_TELEMETRY_FRAG_DATA_LEN - 1) / APP_TELEMETRY_FRAG_DATA_LEN;
+    s_telemFragIdx = 0;
+    s_telemSeq++;
+
+    s_telemQueuePeak = 0;
+    s_telemRingPeak = 0;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void APP_TelemetryInit(void)
+{
+    s_telemPrevNum = 0;
+    s_telemPrevTick = xTaskGetTickCount();
+    s_telemQueuePeak = 0;
+    s_telemRingPeak = 0;
+    s_telemFragNum = 0;
+}
+
+void APP_TelemetryDepthSample(const SPSC_RING_T *p_evtRing)
+{
+    uint16_t depth;
+
+    depth = (uint16_t)uxQueueMessagesWaiting(appData.appQueue);
+    if (depth > s_telemQueuePeak)
+    {
+        s_telemQueuePeak = depth;
+    }
+    depth = SPSC_RING_Count(p_evtRing);
+    if (depth > s_telemRingPeak)
+    {
+        s_telemRingPeak = depth;
+    }
+    s_telemRingDrops = p_evtRing->dropCnt;
+}
+
+uint16_t APP_TelemetryTasks(void)
+{
+    TickType_t now = xTaskGetTickCount();
+    TickType_t elapsed = now - s_telemPrevTick;
+
+    if (elapsed >= pdMS_TO_TICKS(APP_TELEMETRY_PERIOD_MS))
+    {
+        APP_TelemetrySnapshot(now);
+        return APP_TELEMETRY_PERIOD_MS;
+    }
+    return (uint16_t)((pdMS_TO_TICKS(APP_TELEMETRY_PERIOD_MS) - elapsed) * portTICK_PERIOD_MS);
+}
+
+uint8_t APP_TelemetryFragmentGet(uint8_t *p_frag)
+{
+    uint16_t offset;
+    uint8_t len;
+
+    if (s_telemFragIdx >= s_telemFragNum)
+    {
+        return 0;
+    }
+
+    offset = (uint16_t)s_telemFragIdx * APP_TELEMETRY_FRAG_DATA_LEN;
+    len = s_telemRecordLen - offset;
+    if (len > APP_TELEMETRY_FRAG_DATA_LEN)
+    {
+        len = APP_TELEMETRY_FRAG_DATA_LEN;
+    }
+    p_frag[0] = (uint8_t)(s_telemSeq - 1);
+    p_frag[1] = s_telemFragIdx;
+    if ((s_telemFragIdx + 1) == s_telemFragNum)
+    {
+        p_frag[1] |= APP_TELEMETRY_FRAG_LAST;
+    }
+    memcpy(&p_frag[2], &s_telemRecord[offset], len);
+    return 2 + len;
+}
+
+void APP_TelemetryFragmentSent(void)
+{
+    if (s_telemFragIdx < s_telemFragNum)
+    {
+        s_telemFragIdx++;
+    }
+}
+
+void APP_TelemetryRecordDrop(void)
+{
+    s_telemFragIdx = s_telemFragNum;
+}
+
+#endif /* APP_TELEMETRY_ENABLE */
+
+/*******************************************************************************
+ End of File
+ */
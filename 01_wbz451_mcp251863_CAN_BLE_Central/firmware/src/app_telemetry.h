@@ -0,0 +1,205 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Telemetry Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_telemetry.h
+
+  Summary:
+    Periodic CPU, stack, heap and queue usage snapshots pushed over BLE.
+
+  Description:
+    With APP_TELEMETRY_ENABLE the FreeRTOS run time statistics count every
+    task's CPU cycles with the DWT cycle counter. Every APP_TELEMETRY_PERIOD_MS
+    APP_Tasks takes a snapshot of the per task CPU load and stack high-water
+    mark, the heap minimum-ever-free size, the peak depths of appQueue and of
+    the interrupt event ring and the BLE event pool high-water marks. With
+    APP_RX_ADAPT_ENABLE the record also carries the RX FIFO overflows of the
+    CAN controller, a total of 0 shows that no frame was lost in hardware at
+    the bus load of the run.
+
+    The snapshot is serialized into a compact little endian record and sent
+    in fragments as TRS vendor command APP_TELEMETRY_VENDOR_OPCODE. A fragment
+    is only sent when appQueue is empty, so telemetry never delays CAN
+    traffic. A snapshot that is not sent completely before the next one is
+    dropped.
+
+    Record layout:
+      0      version (APP_TELEMETRY_VERSION)
+      1      sequence number
+      2      number of task entries
+      3      appQueue peak depth during the period
+      4..5   period in ms
+      6..7   heap free bytes, saturated to 0xFFFF
+      8..9   heap minimum-ever-free bytes, saturated to 0xFFFF
+      10     event ring peak depth during the period
+      11     event ring drops, saturated to 0xFF
+      12..14 BLE event pool high-water mark per size class
+      15     BLE event pool exhausted requests, saturated to 0xFF
+      16..17 RX FIFO overflow events since start, all FIFOs, saturated
+      18     RX FIFO found above half full during the period, saturated
+      19     FIFOs that overflowed during the period, bit n for channel n
+      20..   task entries, APP_TELEMETRY_TASK_LEN bytes each:
+               0..3 task name, first 4 characters, zero padded
+               4..5 CPU load during the period in 1/1000
+               6..7 stack high-water mark in words
+    The time the core slept is 1000 minus the sum of the task loads.
+
+    Fragment (vendor command payload after the opcode):
+      0      sequence number of the record
+      1      fragment index, bit 7 set on the last fragment
+      2..    up to APP_TELEMETRY_FRAG_DATA_LEN record bytes
+*******************************************************************************/
+
+#ifndef _APP_TELEMETRY_H
+#define _APP_TELEMETRY_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "can_bridge/spsc_ring.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_TELEMETRY_VERSION           2
+#define APP_TELEMETRY_PERIOD_MS         5000    /* < 67 s, the cycle counter wrap time */
+#define APP_TELEMETRY_MAX_TASKS         4
+#define APP_TELEMETRY_HDR_LEN           20
+#define APP_TELEMETRY_TASK_LEN          8
+#define APP_TELEMETRY_RECORD_MAX_LEN    (APP_TELEMETRY_HDR_LEN + (APP_TELEMETRY_MAX_TASKS * APP_TELEMETRY_TASK_LEN))
+
+/* Vendor command carrying the record. Fragments fit into a 23 byte ATT MTU. */
+#define APP_TELEMETRY_VENDOR_OPCODE     0x31
+#define APP_TELEMETRY_FRAG_DATA_LEN     17
+#define APP_TELEMETRY_FRAG_LEN          (2 + APP_TELEMETRY_FRAG_DATA_LEN)
+#define APP_TELEMETRY_FRAG_LAST         0x80
+#define APP_TELEMETRY_RETRY_MS          20      /* Retry after the BLE stack was out of buffers */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_TelemetryInit(void)
+
+  Summary:
+    Starts the first measurement period.
+*/
+void APP_TelemetryInit(void);
+
+/*******************************************************************************
+  Function:
+    void APP_TelemetryDepthSample(const SPSC_RING_T *p_evtRing)
+
+  Summary:
+    Updates the peak depths of appQueue and of the interrupt event ring.
+
+  Description:
+    Called by APP_Tasks when it wakes up, before it drains the ring and the
+    queue. Both only grow until APP_Tasks drains them, so this sees their
+    peak depth.
+*/
+void APP_TelemetryDepthSample(const SPSC_RING_T *p_evtRing);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_TelemetryTasks(void)
+
+  Summary:
+    Takes a snapshot when the period has elapsed.
+
+  Returns:
+    Time in ms until the next snapshot is due.
+*/
+uint16_t APP_TelemetryTasks(void);
+
+/*******************************************************************************
+  Function:
+    uint8_t APP_TelemetryFragmentGet(uint8_t *p_frag)
+
+  Summary:
+    Copies the next unsent fragment of the last snapshot.
+
+  Parameters:
+    p_frag - Buffer of APP_TELEMETRY_FRAG_LEN bytes.
+
+  Returns:
+    Fragment length, 0 if everything is sent.
+*/
+uint8_t APP_TelemetryFragmentGet(uint8_t *p_frag);
+
+/*******************************************************************************
+  Function:
+    void APP_TelemetryFragmentSent(void)
+
+  Summary:
+    Moves on to the next fragment after the current one was sent.
+*/
+void APP_TelemetryFragmentSent(void);
+
+/*******************************************************************************
+  Function:
+    void APP_TelemetryRecordDrop(void)
+
+  Summary:
+    Discards the unsent fragments of the last snapshot, e.g. when the peer
+    did not enable vendor command notifications.
+*/
+void APP_TelemetryRecordDrop(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_TELEMETRY_H */
+
+/*******************************************************************************
+ End of File
+ */
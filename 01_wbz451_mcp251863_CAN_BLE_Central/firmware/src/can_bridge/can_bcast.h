@@ -0,0 +1,184 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Broadcast Codec Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_bcast.h
+
+  Summary:
+    Packs CAN frames into periodic advertising data and unpacks them again.
+
+  Description:
+    The broadcast PDU is a single Manufacturer Specific Data AD structure so
+    that generic scanners can still parse the periodic advertising train:
+
+      [len][0xFF][company ID, 2 bytes][format][seq][record]...[record]
+
+    Each record is a header byte (bit 7 IDE, bit 6 RTR, bits 3:0 DLC) followed
+    by the identifier (2 bytes for standard, 4 bytes for extended, little
+    endian) and the data bytes. The sequence number changes whenever new data
+    is published, which lets a listener ignore the repetitions of the same
+    train and count the trains it missed.
+*******************************************************************************/
+
+#ifndef _CAN_BCAST_H
+#define _CAN_BCAST_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "canfdspi/drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define CAN_BCAST_PDU_MAX               247     /* Fits one periodic advertising report fragment */
+#define CAN_BCAST_COMPANY_ID            0x00CD  /* Microchip Technology Inc. */
+#define CAN_BCAST_FORMAT                0x01
+#define CAN_BCAST_HDR_LEN               6
+#define CAN_BCAST_MAX_DATA_BYTES        8
+
+#define CAN_BCAST_REC_IDE               0x80
+#define CAN_BCAST_REC_RTR               0x40
+#define CAN_BCAST_REC_DLC_MASK          0x0F
+
+typedef struct
+{
+    uint8_t     buf[CAN_BCAST_PDU_MAX];
+    uint8_t     len;
+    uint8_t     seq;
+    uint8_t     frameNum;
+} CAN_BCAST_Encoder_T;
+
+typedef struct
+{
+    uint8_t     lastSeq;
+    bool        synced;
+    uint32_t    trainCnt;
+    uint32_t    trainMissCnt;
+    uint32_t    frameCnt;
+} CAN_BCAST_Decoder_T;
+
+/* Called once per decoded frame. p_obj uses the controller RX object layout so
+   it can be handed to the same path as frames received over a connection. */
+typedef void (*CAN_BCAST_FrameCb_T)(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_BCAST_EncoderReset(CAN_BCAST_Encoder_T *p_enc)
+
+  Summary:
+    Starts a new, empty broadcast PDU. The sequence number is kept.
+*/
+void CAN_BCAST_EncoderReset(CAN_BCAST_Encoder_T *p_enc);
+
+/*******************************************************************************
+  Function:
+    bool CAN_BCAST_EncoderAdd(CAN_BCAST_Encoder_T *p_enc,
+                              const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+
+  Summary:
+    Appends one frame to the PDU.
+
+  Returns:
+    true  - Frame added.
+    false - Not enough room left in the PDU.
+*/
+bool CAN_BCAST_EncoderAdd(CAN_BCAST_Encoder_T *p_enc, const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    uint8_t CAN_BCAST_EncoderFinish(CAN_BCAST_Encoder_T *p_enc)
+
+  Summary:
+    Completes the PDU header and advances the sequence number.
+
+  Returns:
+    Number of valid bytes in p_enc->buf.
+*/
+uint8_t CAN_BCAST_EncoderFinish(CAN_BCAST_Encoder_T *p_enc);
+
+/*******************************************************************************
+  Function:
+    void CAN_BCAST_DecoderReset(CAN_BCAST_Decoder_T *p_dec)
+
+  Summary:
+    Resets the decoder state after a new periodic sync is established.
+*/
+void CAN_BCAST_DecoderReset(CAN_BCAST_Decoder_T *p_dec);
+
+/*******************************************************************************
+  Function:
+    uint8_t CAN_BCAST_Decode(CAN_BCAST_Decoder_T *p_dec, const uint8_t *p_adv,
+                             uint8_t len, CAN_BCAST_FrameCb_T frameCb)
+
+  Summary:
+    Looks for a broadcast PDU in advertising data and reports its frames.
+
+  Description:
+    Repetitions of an already decoded train are ignored. Records with more
+    than CAN_BCAST_MAX_DATA_BYTES data bytes are skipped.
+
+  Returns:
+    Number of frames passed to frameCb.
+*/
+uint8_t CAN_BCAST_Decode(CAN_BCAST_Decoder_T *p_dec, const uint8_t *p_adv, uint8_t len, CAN_BCAST_FrameCb_T frameCb);
+
+#endif /* _CAN_BCAST_H */
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,339 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Loopback Benchmark Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_bench.c
+
+  Summary:
+    Throughput and latency benchmark through the complete bridge path.
+
+  Description:
+    See can_bench.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "can_bench.h"
+
+#ifdef CAN_BENCH_ENABLE
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+typedef char can_bench_slot_num_check[((CAN_BENCH_SLOT_NUM & (CAN_BENCH_SLOT_NUM - 1)) == 0) ? 1 : -1];
+
+#define CAN_BENCH_CYCLES_PER_US     (configCPU_CLOCK_HZ / 1000000UL)
+
+typedef struct CAN_BENCH_Counters_T
+{
+    uint32_t    gen;                    /* Frames loaded into the TX FIFO */
+    uint32_t    done;                   /* Frames that completed their path */
+    uint32_t    lost;                   /* Frames not back before their slot was reused */
+    uint32_t    busy;                   /* Frames refused by a full TX FIFO */
+    uint32_t    maxUs;
+} CAN_BENCH_Counters_T;
+
+static CAN_BENCH_TxFunc_T   s_benchTx;
+static CAN_BENCH_Config_T   s_benchCfg;
+static bool                 s_benchRunning;
+static bool                 s_benchGenerator;   /* Set once a run with rate > 0 started */
+static TickType_t           s_benchStartTick;
+static TickType_t           s_benchLastTick;
+static TickType_t           s_benchReportTick;
+static uint32_t             s_benchCredit;      /* Due frames * 1000 */
+static uint16_t             s_benchSeq;
+static uint32_t             s_benchSlot[CAN_BENCH_SLOT_NUM];     /* Cycle count at generation, 0: free */
+static uint16_t             s_benchSlotSeq[CAN_BENCH_SLOT_NUM];
+static uint32_t             s_benchSample[CAN_BENCH_SAMPLE_NUM]; /* Latencies in us */
+static uint16_t             s_benchSampleNum;
+static CAN_BENCH_Counters_T s_benchPeriod;
+static CAN_BENCH_Counters_T s_benchTotal;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool CAN_BENCH_IsBenchFrame(const CAN_MSGOBJ_ID *p_id, uint32_t ide, uint32_t dlc, const uint8_t *p_data)
+{
+    return (ide == 0)
+        && (p_id->SID >= s_benchCfg.idFirst)
+        && (p_id->SID < (uint32_t)s_benchCfg.idFirst + s_benchCfg.idNum)
+        && (DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)dlc) >= CAN_BENCH_HDR_LEN)
+        && (p_data[0] == CAN_BENCH_MAGIC);
+}
+
+static void CAN_BENCH_Generate(void)
+{
+    uint8_t data[8];
+    uint16_t slot = s_benchSeq & (CAN_BENCH_SLOT_NUM - 1);
+    uint8_t i;
+
+    data[0] = CAN_BENCH_MAGIC;
+    data[1] = (uint8_t)s_benchSeq;
+    data[2] = (uint8_t)(s_benchSeq >> 8);
+    data[3] = 0;
+    for (i = CAN_BENCH_HDR_LEN; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(s_benchSeq + i);
+    }
+
+    if (!s_benchTx(s_benchCfg.idFirst + (s_benchSeq % s_benchCfg.idNum), s_benchCfg.dlc, data))
+    {
+        s_benchPeriod.busy++;
+        return;
+    }
+
+    if (s_benchSlot[slot] != 0U)
+    {
+        s_benchPeriod.lost++;
+    }
+    s_benchSlot[slot] = DWT->CYCCNT | 1U;
+    s_benchSlotSeq[slot] = s_benchSeq;
+    s_benchPeriod.gen++;
+    s_benchSeq++;
+}
+
+static void CAN_BENCH_SamplesSort(uint16_t num)
+{
+    uint16_t i;
+    uint16_t j;
+    uint32_t v;
+
+    for (i = 1; i < num; i++)
+    {
+        v = s_benchSample[i];
+        for (j = i; (j > 0) && (s_benchSample[j - 1] > v); j--)
+        {
+            s_benchSample[j] = s_benchSample[j - 1];
+        }
+        s_benchSample[j] = v;
+    }
+}
+
+static void CAN_BENCH_Report(uint32_t periodMs)
+{
+    uint16_t num = (s_benchSampleNum < CAN_BENCH_SAMPLE_NUM) ? s_benchSampleNum : CAN_BENCH_SAMPLE_NUM;
+    uint32_t p50 = 0;
+    uint32_t p90 = 0;
+    uint32_t p99 = 0;
+
+    if (periodMs == 0)
+    {
+        periodMs = 1;
+    }
+    if (num > 0)
+    {
+        CAN_BENCH_SamplesSort(num);
+        p50 = s_benchSample[(num * 50U) / 100U];
+        p90 = s_benchSample[(num * 90U) / 100U];
+        p99 = s_benchSample[(num * 99U) / 100U];
+    }
+
+    SYS_CONSOLE_PRINT("[BENCH] gen %lu/s done %lu/s lost %lu busy %lu | us p50 %lu p90 %lu p99 %lu max %lu\r\n",
+        (unsigned long)((s_benchPeriod.gen * 1000U) / periodMs),
+        (unsigned long)((s_benchPeriod.done * 1000U) / periodMs),
+        (unsigned long)s_benchPeriod.lost, (unsigned long)s_benchPeriod.busy,
+        (unsigned long)p50, (unsigned long)p90, (unsigned long)p99, (unsigned long)s_benchPeriod.maxUs);
+
+    s_benchTotal.gen += s_benchPeriod.gen;
+    s_benchTotal.done += s_benchPeriod.done;
+    s_benchTotal.lost += s_benchPeriod.lost;
+    s_benchTotal.busy += s_benchPeriod.busy;
+    if (s_benchPeriod.maxUs > s_benchTotal.maxUs)
+    {
+        s_benchTotal.maxUs = s_benchPeriod.maxUs;
+    }
+    memset(&s_benchPeriod, 0, sizeof(s_benchPeriod));
+    s_benchSampleNum = 0;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_BENCH_Init(CAN_BENCH_TxFunc_T txFunc)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    s_benchTx = txFunc;
+    s_benchRunning = false;
+    s_benchGenerator = false;
+    s_benchCfg.idFirst = CAN_BENCH_ID_FIRST;
+    s_benchCfg.idNum = CAN_BENCH_ID_NUM;
+}
+
+bool CAN_BENCH_Start(const CAN_BENCH_Config_T *p_config)
+{
+    static const CAN_BENCH_Config_T defaults =
+    {
+        CAN_BENCH_RATE, CAN_BENCH_ID_FIRST, CAN_BENCH_ID_NUM, CAN_BENCH_DLC, CAN_BENCH_HOPS, CAN_BENCH_DURATION_MS
+    };
+
+    if (p_config == NULL)
+    {
+        p_config = &defaults;
+    }
+    if ((s_benchTx == NULL) || (p_config->idNum == 0) || (p_config->hops == 0)
+        || (p_config->dlc < CAN_BENCH_HDR_LEN) || (p_config->dlc > CAN_DLC_8)
+        || (((uint32_t)p_config->idFirst + p_config->idNum) > 0x800U))
+    {
+        return false;
+    }
+
+    s_benchCfg = *p_config;
+    s_benchStartTick = xTaskGetTickCount();
+    s_benchLastTick = s_benchStartTick;
+    s_benchReportTick = s_benchStartTick;
+    s_benchCredit = 0;
+    s_benchSampleNum = 0;
+    memset(s_benchSlot, 0, sizeof(s_benchSlot));
+    memset(&s_benchPeriod, 0, sizeof(s_benchPeriod));
+    memset(&s_benchTotal, 0, sizeof(s_benchTotal));
+    s_benchGenerator = (s_benchCfg.rate != 0);
+    s_benchRunning = s_benchGenerator;
+
+    SYS_CONSOLE_PRINT("[BENCH] %s, %u frames/s, ID 0x%X..0x%X, DLC %u, %u hop(s)\r\n",
+        s_benchGenerator ? "start" : "echo", s_benchCfg.rate, s_benchCfg.idFirst,
+        s_benchCfg.idFirst + s_benchCfg.idNum - 1, s_benchCfg.dlc, s_benchCfg.hops);
+    return true;
+}
+
+void CAN_BENCH_Stop(void)
+{
+    uint32_t inFlight = 0;
+    uint16_t i;
+
+    if (!s_benchRunning)
+    {
+        return;
+    }
+    s_benchRunning = false;
+    CAN_BENCH_Report(xTaskGetTickCount() - s_benchReportTick);
+
+    for (i = 0; i < CAN_BENCH_SLOT_NUM; i++)
+    {
+        if (s_benchSlot[i] != 0U)
+        {
+            inFlight++;
+        }
+    }
+    SYS_CONSOLE_PRINT("[BENCH] total gen %lu done %lu lost %lu busy %lu in flight %lu max %lu us\r\n",
+        (unsigned long)s_benchTotal.gen, (unsigned long)s_benchTotal.done, (unsigned long)s_benchTotal.lost,
+        (unsigned long)s_benchTotal.busy, (unsigned long)inFlight, (unsigned long)s_benchTotal.maxUs);
+}
+
+uint16_t CAN_BENCH_Tasks(uint16_t waitMs)
+{
+    TickType_t now;
+
+    if (!s_benchRunning)
+    {
+        return waitMs;
+    }
+
+    now = xTaskGetTickCount();
+    s_benchCredit += (uint32_t)s_benchCfg.rate * ((now - s_benchLastTick) * portTICK_PERIOD_MS);
+    s_benchLastTick = now;
+    while (s_benchCredit >= 1000U)
+    {
+        s_benchCredit -= 1000U;
+        CAN_BENCH_Generate();
+    }
+
+    if (((now - s_benchReportTick) * portTICK_PERIOD_MS) >= CAN_BENCH_REPORT_MS)
+    {
+        CAN_BENCH_Report((now - s_benchReportTick) * portTICK_PERIOD_MS);
+        s_benchReportTick = now;
+    }
+    if ((s_benchCfg.durationMs != 0) && (((now - s_benchStartTick) * portTICK_PERIOD_MS) >= s_benchCfg.durationMs))
+    {
+        CAN_BENCH_Stop();
+        return waitMs;
+    }
+    return 1;
+}
+
+bool CAN_BENCH_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+{
+    uint16_t seq;
+    uint16_t slot;
+    uint32_t us;
+
+    if (!s_benchGenerator || !CAN_BENCH_IsBenchFrame(&p_obj->bF.id, p_obj->bF.ctrl.IDE, p_obj->bF.ctrl.DLC, p_data)
+        || (p_data[3] < s_benchCfg.hops))
+    {
+        return false;
+    }
+
+    seq = (uint16_t)p_data[1] | ((uint16_t)p_data[2] << 8);
+    slot = seq & (CAN_BENCH_SLOT_NUM - 1);
+    /* A late frame whose slot was reused is already counted as lost. */
+    if ((s_benchSlot[slot] != 0U) && (s_benchSlotSeq[slot] == seq))
+    {
+        us = (DWT->CYCCNT - s_benchSlot[slot]) / CAN_BENCH_CYCLES_PER_US;
+        s_benchSlot[slot] = 0;
+        s_benchPeriod.done++;
+        if (us > s_benchPeriod.maxUs)
+        {
+            s_benchPeriod.maxUs = us;
+        }
+        s_benchSample[s_benchSampleNum % CAN_BENCH_SAMPLE_NUM] = us;
+        s_benchSampleNum++;
+    }
+    return true;
+}
+
+void CAN_BENCH_Decoded(const CAN_TX_MSGOBJ *p_obj, uint8_t *p_data)
+{
+    if (CAN_BENCH_IsBenchFrame(&p_obj->bF.id, p_obj->bF.ctrl.IDE, p_obj->bF.ctrl.DLC, p_data))
+    {
+        p_data[3]++;
+    }
+}
+
+#endif /* CAN_BENCH_ENABLE */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,220 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Loopback Benchmark Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_bench.h
+
+  Summary:
+    Throughput and latency benchmark through the complete bridge path.
+
+  Description:
+    With CAN_BENCH_ENABLE the MCP251863 runs in internal loopback mode and
+    the generator loads frames into the TX FIFO at a fixed rate. The frames
+    come back through the RX interrupt and take the normal path: RX FIFO
+    read, encoding, BLE hop, decoding and TX FIFO load. The decoded frame
+    loops back once more. The generator consumes it there and measures the
+    latency from its generation.
+
+    The first data bytes of a benchmark frame carry CAN_BENCH_MAGIC, a
+    sequence number and a hop counter that every decoding increments:
+      0    CAN_BENCH_MAGIC
+      1..2 sequence number, little endian
+      3    hop counter
+    A frame is complete when its hop counter reaches the configured number
+    of hops:
+      - 1 with CAN_BENCH_LOCAL_LOOP: the BLE hop is replaced by a local
+        hand-off from the encoder to the decoder on the same board.
+      - 2 across a real link: the peer also runs with CAN_BENCH_ENABLE and
+        a rate of 0. It only echoes the frames back over BLE.
+
+    Every CAN_BENCH_REPORT_MS the generator prints the generated and
+    completed frames per second, lost frames, frames refused by a full TX
+    FIFO and the latency percentiles of the period.
+
+    Latencies are measured with the DWT cycle counter. While the generator
+    runs, APP_Tasks wakes every millisecond, so the core does not enter
+    tickless sleep, which would stop the counter.
+*******************************************************************************/
+
+#ifndef _CAN_BENCH_H
+#define _CAN_BENCH_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "canfdspi/drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* Uncomment to build the benchmark mode. The CAN bus is not used then. */
+//#define CAN_BENCH_ENABLE
+
+/* Uncomment to loop the BLE hop locally instead of sending over BLE. */
+//#define CAN_BENCH_LOCAL_LOOP
+
+/* Default configuration started by APP_Tasks. */
+#define CAN_BENCH_RATE              500     /* Frames/s, 0: echo frames of a peer only */
+#define CAN_BENCH_ID_FIRST          0x100   /* Standard IDs used in turn */
+#define CAN_BENCH_ID_NUM            8
+#define CAN_BENCH_DLC               8       /* 4..8 */
+#define CAN_BENCH_DURATION_MS       10000   /* 0: run until CAN_BENCH_Stop() */
+
+#ifdef CAN_BENCH_LOCAL_LOOP
+#define CAN_BENCH_HOPS              1
+#else
+#define CAN_BENCH_HOPS              2
+#endif
+
+#define CAN_BENCH_REPORT_MS         1000
+#define CAN_BENCH_SLOT_NUM          256     /* Frames in flight, power of two */
+#define CAN_BENCH_SAMPLE_NUM        256     /* Latency samples per report */
+#define CAN_BENCH_MAGIC             0xB5
+#define CAN_BENCH_HDR_LEN           4
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct CAN_BENCH_Config_T
+{
+    uint16_t    rate;                   /* Frames/s */
+    uint16_t    idFirst;
+    uint8_t     idNum;
+    uint8_t     dlc;
+    uint8_t     hops;
+    uint32_t    durationMs;
+} CAN_BENCH_Config_T;
+
+/* Loads one standard frame into the TX FIFO without waiting. Returns false
+   when the FIFO is full. */
+typedef bool (*CAN_BENCH_TxFunc_T)(uint16_t sid, uint8_t dlc, const uint8_t *p_data);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_BENCH_Init(CAN_BENCH_TxFunc_T txFunc)
+
+  Summary:
+    Starts the DWT cycle counter and registers the TX FIFO load function.
+*/
+void CAN_BENCH_Init(CAN_BENCH_TxFunc_T txFunc);
+
+/*******************************************************************************
+  Function:
+    bool CAN_BENCH_Start(const CAN_BENCH_Config_T *p_config)
+
+  Summary:
+    Starts a run. p_config NULL selects the CAN_BENCH_xxx defaults.
+
+  Returns:
+    true  - Run started.
+    false - Invalid configuration.
+*/
+bool CAN_BENCH_Start(const CAN_BENCH_Config_T *p_config);
+
+/*******************************************************************************
+  Function:
+    void CAN_BENCH_Stop(void)
+
+  Summary:
+    Stops the generator and prints the totals of the run.
+*/
+void CAN_BENCH_Stop(void);
+
+/*******************************************************************************
+  Function:
+    uint16_t CAN_BENCH_Tasks(uint16_t waitMs)
+
+  Summary:
+    Generates the frames that are due and prints the periodic report.
+
+  Returns:
+    waitMs, shortened to 1 ms while the generator runs.
+*/
+uint16_t CAN_BENCH_Tasks(uint16_t waitMs);
+
+/*******************************************************************************
+  Function:
+    bool CAN_BENCH_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+
+  Summary:
+    Checks a received frame for a completed benchmark frame.
+
+  Returns:
+    true  - The frame completed its path. It is counted and must not be
+            forwarded.
+    false - Forward the frame as usual.
+*/
+bool CAN_BENCH_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    void CAN_BENCH_Decoded(const CAN_TX_MSGOBJ *p_obj, uint8_t *p_data)
+
+  Summary:
+    Increments the hop counter of a benchmark frame received over BLE,
+    before it is loaded into the TX FIFO.
+*/
+void CAN_BENCH_Decoded(const CAN_TX_MSGOBJ *p_obj, uint8_t *p_data);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _CAN_BENCH_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,276 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Change-Only Forwarding Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_cache.c
+
+  Summary:
+    Last value cache per CAN identifier.
+
+  Description:
+    See can_cache.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "can_cache.h"
+
+#ifdef CAN_CACHE_ENABLE
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+#define CAN_CACHE_EXT_FLAG          0x80000000UL
+#define CAN_CACHE_NO_DATA           0xFF    /* DLC of a slot without a payload yet */
+#define CAN_CACHE_PROBE_MAX         16      /* Bounds the lookup once the table fills up */
+#define CAN_CACHE_USED_WORDS        ((CAN_CACHE_SLOT_NUM + 31U) / 32U)
+#define CAN_CACHE_DATA_MAX          8
+#define CAN_CACHE_PERIOD_MISS       3       /* Intervals off the locked period before it unlocks */
+
+#define CAN_CACHE_MS_TO_TICKS(ms)   ((TickType_t)(((ms) + portTICK_PERIOD_MS - 1U) / portTICK_PERIOD_MS))
+
+typedef struct CAN_CACHE_Slot_T
+{
+    uint32_t    key;                    /* Identifier, CAN_CACHE_EXT_FLAG for extended */
+    TickType_t  sentTick;
+    TickType_t  rxTick;
+    uint16_t    keepAliveMs;
+    uint16_t    periodMs;               /* Measured period, 0 while unknown */
+    uint8_t     hits;                   /* Intervals matching periodMs, locked at CAN_CACHE_PERIOD_LOCK */
+    uint8_t     misses;
+    uint8_t     dlc;
+    uint8_t     data[CAN_CACHE_DATA_MAX];
+} CAN_CACHE_Slot_T;
+
+static CAN_CACHE_Slot_T     s_cacheSlot[CAN_CACHE_SLOT_NUM];
+static uint32_t             s_cacheUsed[CAN_CACHE_USED_WORDS];
+static CAN_CACHE_Stats_T    s_cacheStats;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Returns the slot of key, a new one if it is not in the table yet, or NULL
+   when no free slot is within CAN_CACHE_PROBE_MAX. */
+static CAN_CACHE_Slot_T *CAN_CACHE_SlotGet(uint32_t key)
+{
+    uint32_t idx = (uint32_t)(key * 2654435761U) >> (32U - CAN_CACHE_SLOT_BITS);
+    CAN_CACHE_Slot_T *p_slot;
+    uint8_t probe;
+
+    for (probe = 0; probe < CAN_CACHE_PROBE_MAX; probe++)
+    {
+        p_slot = &s_cacheSlot[idx];
+        if (!(s_cacheUsed[idx >> 5] & (1UL << (idx & 31U))))
+        {
+            s_cacheUsed[idx >> 5] |= 1UL << (idx & 31U);
+            p_slot->key = key;
+            p_slot->keepAliveMs = CAN_CACHE_KEEPALIVE_MS;
+            p_slot->dlc = CAN_CACHE_NO_DATA;
+            p_slot->rxTick = 0;
+            p_slot->periodMs = 0;
+            p_slot->hits = 0;
+            p_slot->misses = 0;
+            return p_slot;
+        }
+        if (p_slot->key == key)
+        {
+            return p_slot;
+        }
+        idx = (idx + 1U) & (CAN_CACHE_SLOT_NUM - 1U);
+    }
+    return NULL;
+}
+
+/* Measures the interval since the previous frame of the slot. Returns true
+   when the period locked or unlocked with this frame. */
+static bool CAN_CACHE_PeriodTrack(CAN_CACHE_Slot_T *p_slot, TickType_t now)
+{
+    uint32_t intervalMs = (uint32_t)(TickType_t)(now - p_slot->rxTick) * portTICK_PERIOD_MS;
+    uint32_t tolMs = ((uint32_t)p_slot->periodMs >> 3) + 2U;
+    bool locked = (p_slot->hits >= CAN_CACHE_PERIOD_LOCK);
+
+    p_slot->rxTick = now;
+    if ((p_slot->periodMs != 0U) && ((intervalMs + tolMs) >= p_slot->periodMs)
+        && (intervalMs <= (p_slot->periodMs + tolMs)))
+    {
+        // Follow a slow drift of the source clock
+        p_slot->periodMs = (uint16_t)((3U * p_slot->periodMs + intervalMs + 2U) / 4U);
+        p_slot->misses = 0;
+        if (!locked)
+        {
+            p_slot->hits++;
+            return (p_slot->hits == CAN_CACHE_PERIOD_LOCK);
+        }
+        return false;
+    }
+
+    // A late frame and the early one after it do not unlock the period
+    if (locked && (++p_slot->misses < CAN_CACHE_PERIOD_MISS))
+    {
+        return false;
+    }
+    p_slot->hits = 0;
+    p_slot->misses = 0;
+    p_slot->periodMs = (intervalMs <= CAN_CACHE_PERIOD_MAX_MS) ? (uint16_t)intervalMs : 0U;
+    return locked;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_CACHE_Init(void)
+{
+    memset(s_cacheUsed, 0, sizeof(s_cacheUsed));
+    memset(&s_cacheStats, 0, sizeof(s_cacheStats));
+}
+
+void CAN_CACHE_Reset(void)
+{
+    uint32_t idx;
+
+    for (idx = 0; idx < CAN_CACHE_SLOT_NUM; idx++)
+    {
+        s_cacheSlot[idx].dlc = CAN_CACHE_NO_DATA;
+    }
+}
+
+bool CAN_CACHE_KeepAliveSet(uint32_t id, bool extended, uint16_t periodMs)
+{
+    CAN_CACHE_Slot_T *p_slot = CAN_CACHE_SlotGet(extended ? (id | CAN_CACHE_EXT_FLAG) : id);
+
+    if (p_slot == NULL)
+    {
+        return false;
+    }
+    p_slot->keepAliveMs = periodMs;
+    return true;
+}
+
+bool CAN_CACHE_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data,
+                       uint16_t *p_periodMs)
+{
+    CAN_CACHE_Slot_T *p_slot;
+    TickType_t now;
+    uint32_t key;
+    uint16_t keepAliveMs;
+    bool lockChanged = false;
+    uint8_t dlc = p_obj->bF.ctrl.DLC;
+    uint8_t n = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)dlc);
+
+    if (p_periodMs != NULL)
+    {
+        *p_periodMs = 0;
+    }
+    if (p_obj->bF.ctrl.RTR || (n > CAN_CACHE_DATA_MAX))
+    {
+        return false;
+    }
+
+    if (p_obj->bF.ctrl.IDE)
+    {
+        key = (((uint32_t)p_obj->bF.id.SID << 18) | p_obj->bF.id.EID) | CAN_CACHE_EXT_FLAG;
+    }
+    else
+    {
+        key = p_obj->bF.id.SID;
+    }
+    p_slot = CAN_CACHE_SlotGet(key);
+    if (p_slot == NULL)
+    {
+        s_cacheStats.uncached++;
+        return false;
+    }
+
+    now = xTaskGetTickCount();
+    keepAliveMs = p_slot->keepAliveMs;
+    if (p_periodMs != NULL)
+    {
+        lockChanged = CAN_CACHE_PeriodTrack(p_slot, now);
+        if (p_slot->hits >= CAN_CACHE_PERIOD_LOCK)
+        {
+            *p_periodMs = p_slot->periodMs;
+            if (keepAliveMs > CAN_CACHE_CYCLIC_REFRESH_MS)
+            {
+                keepAliveMs = CAN_CACHE_CYCLIC_REFRESH_MS;
+            }
+        }
+    }
+
+    if ((p_slot->dlc == dlc) && (memcmp(p_slot->data, p_data, n) == 0))
+    {
+        if (lockChanged)
+        {
+            s_cacheStats.periodLock++;
+        }
+        else if ((keepAliveMs != 0U) && ((TickType_t)(now - p_slot->sentTick) < CAN_CACHE_MS_TO_TICKS(keepAliveMs)))
+        {
+            s_cacheStats.suppressed++;
+            return true;
+        }
+        else
+        {
+            s_cacheStats.keepAlive++;
+        }
+    }
+    else
+    {
+        s_cacheStats.changed++;
+        p_slot->dlc = dlc;
+        memcpy(p_slot->data, p_data, n);
+    }
+    p_slot->sentTick = now;
+    return false;
+}
+
+const CAN_CACHE_Stats_T *CAN_CACHE_StatsGet(void)
+{
+    return &s_cacheStats;
+}
+
+#endif /* CAN_CACHE_ENABLE */
+
+/*******************************************************************************
+ End of File
+ */
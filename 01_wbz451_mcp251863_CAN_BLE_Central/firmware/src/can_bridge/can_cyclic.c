@@ -0,0 +1,283 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Cyclic Transmit Offload Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_cyclic.c
+
+  Summary:
+    Local schedule of the cyclic frames received over BLE.
+
+  Description:
+    See can_cyclic.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "can_cyclic.h"
+#include "can_log.h"
+
+#ifdef CAN_CYCLIC_ENABLE
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+#define CAN_CYCLIC_EXT_FLAG         0x80000000UL
+#define CAN_CYCLIC_DATA_MAX         8
+
+#define CAN_CYCLIC_MS_TO_TICKS(ms)  ((TickType_t)(((ms) + portTICK_PERIOD_MS - 1U) / portTICK_PERIOD_MS))
+
+typedef struct CAN_CYCLIC_Entry_T
+{
+    CAN_TX_MSGOBJ       obj;
+    uint8_t             data[CAN_CYCLIC_DATA_MAX];
+    uint32_t            key;            /* Identifier, CAN_CYCLIC_EXT_FLAG for extended */
+    TickType_t          due;
+    TickType_t          leaseEnd;
+    TickType_t          period;         /* Ticks */
+    CAN_CYCLIC_Class_T  cls;
+    bool                used;
+} CAN_CYCLIC_Entry_T;
+
+static CAN_CYCLIC_Entry_T   s_cyclicEntry[CAN_CYCLIC_ENTRY_NUM];
+static CAN_CYCLIC_TxFunc_T  s_cyclicTx;
+static CAN_CYCLIC_Stats_T   s_cyclicStats;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Returns the entry of key, NULL if it is not scheduled. */
+static CAN_CYCLIC_Entry_T *CAN_CYCLIC_Find(uint32_t key)
+{
+    uint8_t i;
+
+    for (i = 0; i < CAN_CYCLIC_ENTRY_NUM; i++)
+    {
+        if (s_cyclicEntry[i].used && (s_cyclicEntry[i].key == key))
+        {
+            return &s_cyclicEntry[i];
+        }
+    }
+    return NULL;
+}
+
+static CAN_CYCLIC_Entry_T *CAN_CYCLIC_Alloc(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < CAN_CYCLIC_ENTRY_NUM; i++)
+    {
+        if (!s_cyclicEntry[i].used)
+        {
+            return &s_cyclicEntry[i];
+        }
+    }
+    return NULL;
+}
+
+/* Sends the entry when it is due. Returns false while the TX FIFO is full. */
+static bool CAN_CYCLIC_Send(CAN_CYCLIC_Entry_T *p_entry, TickType_t now)
+{
+    TickType_t behind = now - p_entry->due;
+    uint16_t behindMs;
+
+    if (!s_cyclicTx(p_entry->cls, &p_entry->obj, p_entry->data))
+    {
+        return false;
+    }
+    s_cyclicStats.sent++;
+
+    behindMs = (uint16_t)(behind * portTICK_PERIOD_MS);
+    if (behindMs > s_cyclicStats.lateMaxMs)
+    {
+        s_cyclicStats.lateMaxMs = behindMs;
+    }
+    if (behind >= p_entry->period)
+    {
+        // A whole period was missed, restart the phase from this transmission
+        s_cyclicStats.late++;
+        CAN_LOG2(CAN_LOG_CYCLIC_LATE, p_entry->key & ~CAN_CYCLIC_EXT_FLAG, behindMs);
+        p_entry->due = now + p_entry->period;
+    }
+    else
+    {
+        p_entry->due += p_entry->period;
+    }
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_CYCLIC_Init(CAN_CYCLIC_TxFunc_T txFunc)
+{
+    s_cyclicTx = txFunc;
+    memset(s_cyclicEntry, 0, sizeof(s_cyclicEntry));
+    memset(&s_cyclicStats, 0, sizeof(s_cyclicStats));
+}
+
+void CAN_CYCLIC_Reset(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < CAN_CYCLIC_ENTRY_NUM; i++)
+    {
+        s_cyclicEntry[i].used = false;
+    }
+}
+
+uint32_t CAN_CYCLIC_Stamp(uint16_t periodMs)
+{
+    if ((periodMs == 0U) || (periodMs > CAN_CYCLIC_PERIOD_MAX_MS))
+    {
+        return 0;
+    }
+    return CAN_CYCLIC_STAMP_TAG | periodMs;
+}
+
+bool CAN_CYCLIC_Update(const CAN_TX_MSGOBJ *p_obj, const uint8_t *p_data)
+{
+    CAN_CYCLIC_Entry_T *p_entry;
+    uint32_t stamp = p_obj->bF.timeStamp;
+    uint16_t periodMs = CAN_CYCLIC_STAMP_PERIOD(stamp);
+    uint8_t n = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)p_obj->bF.ctrl.DLC);
+    TickType_t now;
+    uint32_t key;
+
+    if (p_obj->bF.ctrl.IDE)
+    {
+        key = (((uint32_t)p_obj->bF.id.SID << 18) | p_obj->bF.id.EID) | CAN_CYCLIC_EXT_FLAG;
+    }
+    else
+    {
+        key = p_obj->bF.id.SID;
+    }
+    p_entry = CAN_CYCLIC_Find(key);
+
+    if (((stamp & CAN_CYCLIC_STAMP_TAG_MASK) != CAN_CYCLIC_STAMP_TAG) || (periodMs == 0U)
+        || (periodMs > CAN_CYCLIC_PERIOD_MAX_MS) || p_obj->bF.ctrl.RTR || (n > CAN_CYCLIC_DATA_MAX))
+    {
+        if (p_entry != NULL)
+        {
+            p_entry->used = false;
+            s_cyclicStats.stopped++;
+            CAN_LOG1(CAN_LOG_CYCLIC_STOP, key & ~CAN_CYCLIC_EXT_FLAG);
+        }
+        return false;
+    }
+
+    s_cyclicStats.updates++;
+    now = xTaskGetTickCount();
+    if (p_entry == NULL)
+    {
+        p_entry = CAN_CYCLIC_Alloc();
+        if (p_entry == NULL)
+        {
+            s_cyclicStats.full++;
+            return false;
+        }
+        s_cyclicStats.started++;
+        CAN_LOG2(CAN_LOG_CYCLIC_START, key & ~CAN_CYCLIC_EXT_FLAG, periodMs);
+        p_entry->key = key;
+        p_entry->due = now;
+        p_entry->used = true;
+    }
+
+    p_entry->obj.word[0] = p_obj->word[0];
+    p_entry->obj.word[1] = p_obj->word[1];
+    p_entry->obj.word[2] = 0;
+    memcpy(p_entry->data, p_data, n);
+    p_entry->period = CAN_CYCLIC_MS_TO_TICKS(periodMs);
+    p_entry->cls = (periodMs <= CAN_CYCLIC_FAST_MS) ? CAN_CYCLIC_CLASS_FAST : CAN_CYCLIC_CLASS_SLOW;
+    p_entry->leaseEnd = now + CAN_CYCLIC_MS_TO_TICKS(CAN_CYCLIC_LEASE_MS);
+    return true;
+}
+
+uint16_t CAN_CYCLIC_Tasks(uint16_t waitMs)
+{
+    CAN_CYCLIC_Entry_T *p_entry;
+    TickType_t now = xTaskGetTickCount();
+    uint16_t ms;
+    uint8_t i;
+
+    for (i = 0; i < CAN_CYCLIC_ENTRY_NUM; i++)
+    {
+        p_entry = &s_cyclicEntry[i];
+        if (!p_entry->used)
+        {
+            continue;
+        }
+        if ((int32_t)(now - p_entry->leaseEnd) >= 0)
+        {
+            // The peer stopped refreshing, the source is gone or no longer cyclic
+            p_entry->used = false;
+            s_cyclicStats.expired++;
+            CAN_LOG1(CAN_LOG_CYCLIC_STOP, p_entry->key & ~CAN_CYCLIC_EXT_FLAG);
+            continue;
+        }
+        if ((int32_t)(now - p_entry->due) >= 0)
+        {
+            if (!CAN_CYCLIC_Send(p_entry, now))
+            {
+                // TX FIFO full, retry on the next tick
+                waitMs = (portTICK_PERIOD_MS < waitMs) ? portTICK_PERIOD_MS : waitMs;
+                continue;
+            }
+        }
+        ms = (uint16_t)((p_entry->due - now) * portTICK_PERIOD_MS);
+        waitMs = (ms < waitMs) ? ms : waitMs;
+    }
+    return waitMs;
+}
+
+const CAN_CYCLIC_Stats_T *CAN_CYCLIC_StatsGet(void)
+{
+    return &s_cyclicStats;
+}
+
+#endif /* CAN_CYCLIC_ENABLE */
+
+/*******************************************************************************
+ End of File
+ */
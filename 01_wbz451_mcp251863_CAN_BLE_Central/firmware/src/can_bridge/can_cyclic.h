@@ -0,0 +1,223 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Cyclic Transmit Offload Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_cyclic.h
+
+  Summary:
+    Transmits the cyclic frames of the far CAN segment locally, at the
+    period of their source, from the last payload received over BLE.
+
+  Description:
+    With change-only forwarding (can_cache.h) an unchanged cyclic frame
+    crosses BLE once per keep-alive period, and a frame that does cross it
+    is delayed by the connection event timing. The receiving node therefore
+    owns the transmission of these frames.
+
+    The sending node measures the period of every cached identifier. Once
+    it is stable, the forwarded frames carry it in the time stamp word of
+    the message object, which is otherwise unused over BLE (RX time stamps
+    are disabled and the TX object has none). A tagged frame is a "payload
+    changed" message for the scheduler of the receiving node: the first one
+    installs the identifier, later ones replace the payload, which goes out
+    at the next due time so the phase of the schedule is kept. A frame
+    without the tag stops the schedule of its identifier and is sent as
+    before, so a peer without this module sees unchanged behavior.
+
+    The schedule of an identifier ends CAN_CYCLIC_LEASE_MS after the last
+    tagged frame; the sender repeats locked frames at least every
+    CAN_CACHE_CYCLIC_REFRESH_MS to renew it. The due times advance by whole
+    periods from the first transmission, a transmission later than one
+    period is counted and resynchronizes the schedule.
+
+    Each identifier falls into a period class. With CAN_CYCLIC_CLASS_FIFO
+    every class has its own TX FIFO in the controller, at a higher
+    priority than the bridge TX FIFO, so a periodic frame never waits
+    behind a burst of bridged frames.
+*******************************************************************************/
+
+#ifndef _CAN_CYCLIC_H
+#define _CAN_CYCLIC_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "canfdspi/drv_canfdspi_api.h"
+#include "can_cache.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* Uncomment to transmit the cyclic frames of the peer locally, needs CAN_CACHE_ENABLE. */
+//#define CAN_CYCLIC_ENABLE
+
+/* Comment out to send the cyclic frames through the bridge TX FIFO. */
+#define CAN_CYCLIC_CLASS_FIFO
+
+#if defined(CAN_CYCLIC_ENABLE) && !defined(CAN_CACHE_ENABLE)
+#error "CAN_CYCLIC_ENABLE needs the periods measured by CAN_CACHE_ENABLE"
+#endif
+
+#define CAN_CYCLIC_ENTRY_NUM        32
+#define CAN_CYCLIC_LEASE_MS         3000    /* Above CAN_CACHE_CYCLIC_REFRESH_MS of the peer */
+#define CAN_CYCLIC_PERIOD_MAX_MS    1000    /* Slower identifiers are forwarded as before */
+#define CAN_CYCLIC_FAST_MS          20      /* Upper period of CAN_CYCLIC_CLASS_FAST */
+
+/* Time stamp word of a forwarded frame: tag and period in ms. */
+#define CAN_CYCLIC_STAMP_TAG        0xC5C50000UL
+#define CAN_CYCLIC_STAMP_TAG_MASK   0xFFFF0000UL
+#define CAN_CYCLIC_STAMP_PERIOD(stamp)  ((uint16_t)((stamp) & 0xFFFFU))
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef enum CAN_CYCLIC_Class_T
+{
+    CAN_CYCLIC_CLASS_FAST = 0,          /* Period up to CAN_CYCLIC_FAST_MS */
+    CAN_CYCLIC_CLASS_SLOW,
+    CAN_CYCLIC_CLASS_NUM
+} CAN_CYCLIC_Class_T;
+
+/* Loads a frame into the TX FIFO of the class, false when it is full. */
+typedef bool (*CAN_CYCLIC_TxFunc_T)(CAN_CYCLIC_Class_T cls, CAN_TX_MSGOBJ *p_obj, uint8_t *p_data);
+
+typedef struct CAN_CYCLIC_Stats_T
+{
+    uint32_t    sent;
+    uint32_t    updates;                /* Tagged frames received */
+    uint32_t    started;
+    uint32_t    stopped;                /* Untagged frame of a scheduled identifier */
+    uint32_t    expired;                /* No tagged frame within CAN_CYCLIC_LEASE_MS */
+    uint32_t    late;                   /* Sent more than one period after the due time */
+    uint32_t    full;                   /* No free entry, sent as a bridged frame */
+    uint16_t    lateMaxMs;              /* Largest delay behind the due time */
+} CAN_CYCLIC_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_CYCLIC_Init(CAN_CYCLIC_TxFunc_T txFunc)
+
+  Summary:
+    Empties the schedule and sets the CAN transmit function.
+*/
+void CAN_CYCLIC_Init(CAN_CYCLIC_TxFunc_T txFunc);
+
+/*******************************************************************************
+  Function:
+    void CAN_CYCLIC_Reset(void)
+
+  Summary:
+    Stops every schedule, called when the last BLE link disconnects.
+*/
+void CAN_CYCLIC_Reset(void);
+
+/*******************************************************************************
+  Function:
+    uint32_t CAN_CYCLIC_Stamp(uint16_t periodMs)
+
+  Summary:
+    Returns the time stamp word of a forwarded frame with the measured
+    period of its identifier, 0 for a frame that is not cyclic.
+*/
+uint32_t CAN_CYCLIC_Stamp(uint16_t periodMs);
+
+/*******************************************************************************
+  Function:
+    bool CAN_CYCLIC_Update(const CAN_TX_MSGOBJ *p_obj, const uint8_t *p_data)
+
+  Summary:
+    Passes a frame received over BLE to the scheduler.
+
+  Description:
+    A tagged frame installs or updates the schedule of its identifier, an
+    untagged one stops it.
+
+  Returns:
+    true  - The scheduler transmits the frame.
+    false - Transmit it as a bridged frame.
+*/
+bool CAN_CYCLIC_Update(const CAN_TX_MSGOBJ *p_obj, const uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    uint16_t CAN_CYCLIC_Tasks(uint16_t waitMs)
+
+  Summary:
+    Transmits the due frames and ends the expired schedules.
+
+  Returns:
+    waitMs, or less when the next frame is due earlier.
+*/
+uint16_t CAN_CYCLIC_Tasks(uint16_t waitMs);
+
+/*******************************************************************************
+  Function:
+    const CAN_CYCLIC_Stats_T *CAN_CYCLIC_StatsGet(void)
+
+  Summary:
+    Returns the counters since CAN_CYCLIC_Init.
+*/
+const CAN_CYCLIC_Stats_T *CAN_CYCLIC_StatsGet(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _CAN_CYCLIC_H */
+
+/*******************************************************************************
+ End of File
+ */
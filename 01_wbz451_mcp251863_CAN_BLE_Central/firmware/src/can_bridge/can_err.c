@@ -0,0 +1,307 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Error Management Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_err.c
+
+  Summary:
+    Error state poll, bus off recovery and the hold ring for the bus.
+
+  Description:
+    See can_err.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "can_err.h"
+#include "can_log.h"
+
+#ifdef CAN_ERR_ENABLE
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+#define CAN_ERR_DATA_MAX            8       /* Payload size of the bridge TX FIFO */
+
+#define CAN_ERR_MS_TO_TICKS(ms)     ((TickType_t)(((ms) + portTICK_PERIOD_MS - 1U) / portTICK_PERIOD_MS))
+
+#define CAN_ERR_FLAGS_BUS_OFF       (CAN_TX_BUS_OFF_STATE)
+#define CAN_ERR_FLAGS_PASSIVE       (CAN_TX_BUS_PASSIVE_STATE | CAN_RX_BUS_PASSIVE_STATE)
+#define CAN_ERR_FLAGS_WARNING       (CAN_TX_RX_WARNING_STATE | CAN_TX_WARNING_STATE | CAN_RX_WARNING_STATE)
+
+typedef struct CAN_ERR_Entry_T
+{
+    CAN_TX_MSGOBJ   obj;
+    uint8_t         data[CAN_ERR_DATA_MAX];
+} CAN_ERR_Entry_T;
+
+static CAN_ERR_ReadFunc_T       s_errRead;
+static CAN_ERR_RestartFunc_T    s_errRestart;
+static CAN_ERR_TxFunc_T         s_errTx;
+static CAN_ERR_Policy_T         s_errPolicy;
+static CAN_ERR_State_T          s_errState;
+static CAN_ERR_Stats_T          s_errStats;
+static bool                     s_errPollNow;
+static TickType_t               s_errPollTick;
+static TickType_t               s_errBusOffTick;
+static bool                     s_errRestartPending;
+static bool                     s_errRestarted;         /* s_errRestartTick is valid */
+static TickType_t               s_errRestartTick;
+static uint16_t                 s_errRestartMs;
+static CAN_ERR_Entry_T          s_errHold[CAN_ERR_HOLD_LEN];
+static uint8_t                  s_errHoldHead;
+static uint8_t                  s_errHoldCount;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static CAN_ERR_State_T CAN_ERR_StateOf(CAN_ERROR_STATE flags)
+{
+    if (flags & CAN_ERR_FLAGS_BUS_OFF)
+    {
+        return CAN_ERR_STATE_BUS_OFF;
+    }
+    if (flags & CAN_ERR_FLAGS_PASSIVE)
+    {
+        return CAN_ERR_STATE_PASSIVE;
+    }
+    if (flags & CAN_ERR_FLAGS_WARNING)
+    {
+        return CAN_ERR_STATE_WARNING;
+    }
+    return CAN_ERR_STATE_ACTIVE;
+}
+
+static void CAN_ERR_BusOff(TickType_t now)
+{
+    s_errStats.busOff++;
+    s_errBusOffTick = now;
+    s_errRestartPending = (s_errPolicy == CAN_ERR_POLICY_RESTART);
+
+    // Back off while the bus keeps failing soon after a restart
+    if (s_errRestarted && ((TickType_t)(now - s_errRestartTick) < CAN_ERR_MS_TO_TICKS(CAN_ERR_STABLE_MS)))
+    {
+        s_errRestartMs = ((2U * s_errRestartMs) < CAN_ERR_RESTART_MAX_MS) ? (2U * s_errRestartMs) : CAN_ERR_RESTART_MAX_MS;
+    }
+    else
+    {
+        s_errRestartMs = CAN_ERR_RESTART_MS;
+    }
+}
+
+static void CAN_ERR_Poll(TickType_t now)
+{
+    CAN_ERR_Status_T status;
+    CAN_ERR_State_T state;
+    uint16_t recoverMs;
+
+    s_errPollNow = false;
+    s_errPollTick = now;
+    if (!s_errRead(&status))
+    {
+        return;
+    }
+    s_errStats.polls++;
+    s_errStats.diagFlags |= (uint16_t)(status.diag.word[1] >> 16);
+    s_errStats.tecMax = (status.tec > s_errStats.tecMax) ? status.tec : s_errStats.tecMax;
+    s_errStats.recMax = (status.rec > s_errStats.recMax) ? status.rec : s_errStats.recMax;
+
+    state = CAN_ERR_StateOf(status.flags);
+    if (state == s_errState)
+    {
+        return;
+    }
+    CAN_LOG3(CAN_LOG_ERR_STATE, state, status.tec, status.rec);
+
+    if (state == CAN_ERR_STATE_BUS_OFF)
+    {
+        CAN_ERR_BusOff(now);
+    }
+    else if (s_errState == CAN_ERR_STATE_BUS_OFF)
+    {
+        s_errRestartPending = false;
+        recoverMs = (uint16_t)((now - s_errBusOffTick) * portTICK_PERIOD_MS);
+        s_errStats.recoverMaxMs = (recoverMs > s_errStats.recoverMaxMs) ? recoverMs : s_errStats.recoverMaxMs;
+        CAN_LOG2(CAN_LOG_ERR_RECOVERED, recoverMs, s_errHoldCount);
+    }
+
+    if ((state == CAN_ERR_STATE_PASSIVE) && (s_errState < CAN_ERR_STATE_PASSIVE))
+    {
+        s_errStats.passive++;
+    }
+    else if ((state == CAN_ERR_STATE_WARNING) && (s_errState < CAN_ERR_STATE_WARNING))
+    {
+        s_errStats.warning++;
+    }
+    s_errState = state;
+}
+
+/* Loads the held frames in order until the TX FIFO is full. */
+static void CAN_ERR_Flush(void)
+{
+    CAN_ERR_Entry_T *p_entry;
+
+    while ((s_errHoldCount != 0U) && (s_errState != CAN_ERR_STATE_BUS_OFF))
+    {
+        p_entry = &s_errHold[s_errHoldHead];
+        if (!s_errTx(&p_entry->obj, p_entry->data))
+        {
+            break;
+        }
+        s_errHoldHead = (s_errHoldHead + 1U) & (CAN_ERR_HOLD_LEN - 1U);
+        s_errHoldCount--;
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_ERR_Init(CAN_ERR_ReadFunc_T readFunc, CAN_ERR_RestartFunc_T restartFunc, CAN_ERR_TxFunc_T txFunc)
+{
+    s_errRead = readFunc;
+    s_errRestart = restartFunc;
+    s_errTx = txFunc;
+    s_errPolicy = CAN_ERR_POLICY_DEFAULT;
+    s_errState = CAN_ERR_STATE_ACTIVE;
+    memset(&s_errStats, 0, sizeof(s_errStats));
+    s_errPollNow = true;
+    s_errRestartPending = false;
+    s_errRestarted = false;
+    s_errRestartMs = CAN_ERR_RESTART_MS;
+    s_errHoldHead = 0;
+    s_errHoldCount = 0;
+}
+
+void CAN_ERR_PolicySet(CAN_ERR_Policy_T policy)
+{
+    s_errPolicy = policy;
+    s_errRestartPending = (policy == CAN_ERR_POLICY_RESTART) && (s_errState == CAN_ERR_STATE_BUS_OFF);
+}
+
+void CAN_ERR_Event(void)
+{
+    s_errPollNow = true;
+}
+
+bool CAN_ERR_TxReady(void)
+{
+    return (s_errState != CAN_ERR_STATE_BUS_OFF) && (s_errHoldCount == 0U);
+}
+
+bool CAN_ERR_Hold(const CAN_TX_MSGOBJ *p_obj, const uint8_t *p_data)
+{
+    CAN_ERR_Entry_T *p_entry;
+    uint8_t n = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)p_obj->bF.ctrl.DLC);
+
+    if (s_errHoldCount >= CAN_ERR_HOLD_LEN)
+    {
+        s_errStats.dropped++;
+        return false;
+    }
+    p_entry = &s_errHold[(s_errHoldHead + s_errHoldCount) & (CAN_ERR_HOLD_LEN - 1U)];
+    p_entry->obj = *p_obj;
+    memcpy(p_entry->data, p_data, (n < CAN_ERR_DATA_MAX) ? n : CAN_ERR_DATA_MAX);
+    s_errHoldCount++;
+    s_errStats.held++;
+    return true;
+}
+
+uint16_t CAN_ERR_Tasks(uint16_t waitMs)
+{
+    TickType_t now = xTaskGetTickCount();
+    TickType_t elapsed;
+    uint16_t pollMs;
+    uint16_t ms;
+
+    pollMs = ((s_errState >= CAN_ERR_STATE_PASSIVE) || (s_errHoldCount != 0U)) ? CAN_ERR_POLL_FAST_MS : CAN_ERR_POLL_MS;
+    if (s_errPollNow || ((TickType_t)(now - s_errPollTick) >= CAN_ERR_MS_TO_TICKS(pollMs)))
+    {
+        CAN_ERR_Poll(now);
+    }
+
+    if (s_errRestartPending)
+    {
+        elapsed = now - s_errBusOffTick;
+        if (elapsed >= CAN_ERR_MS_TO_TICKS(s_errRestartMs))
+        {
+            if (s_errRestart())
+            {
+                s_errStats.restarts++;
+                s_errRestartPending = false;
+                s_errRestarted = true;
+                s_errRestartTick = now;
+                CAN_ERR_Poll(now);
+            }
+        }
+        else
+        {
+            ms = (uint16_t)((CAN_ERR_MS_TO_TICKS(s_errRestartMs) - elapsed) * portTICK_PERIOD_MS);
+            waitMs = (ms < waitMs) ? ms : waitMs;
+        }
+    }
+
+    CAN_ERR_Flush();
+
+    pollMs = ((s_errState >= CAN_ERR_STATE_PASSIVE) || (s_errHoldCount != 0U)) ? CAN_ERR_POLL_FAST_MS : CAN_ERR_POLL_MS;
+    elapsed = now - s_errPollTick;
+    ms = (elapsed < CAN_ERR_MS_TO_TICKS(pollMs)) ? (uint16_t)((CAN_ERR_MS_TO_TICKS(pollMs) - elapsed) * portTICK_PERIOD_MS) : 0U;
+    return (ms < waitMs) ? ms : waitMs;
+}
+
+CAN_ERR_State_T CAN_ERR_StateGet(void)
+{
+    return s_errState;
+}
+
+const CAN_ERR_Stats_T *CAN_ERR_StatsGet(void)
+{
+    return &s_errStats;
+}
+
+#endif /* CAN_ERR_ENABLE */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,239 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge ISO-TP Offload Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_isotp.h
+
+  Summary:
+    ISO 15765-2 transport layer on both ends of the bridge, so diagnostic
+    PDUs cross BLE once instead of frame by frame.
+
+  Description:
+    Frames carrying the identifiers of a configured address pair (e.g. the
+    UDS request and response identifiers 0x7E0/0x7E8) are not forwarded.
+    The node that receives them on its CAN segment takes the role of the
+    far end of the ISO-TP connection: it answers the First Frame with a
+    Flow Control frame itself, collects the Consecutive Frames and sends the
+    complete PDU over BLE. The other node transmits the PDU on its segment
+    with the same identifier, as Single Frame or as First Frame and
+    Consecutive Frames paced by the Flow Control frames of the receiver.
+    Flow Control frames never cross BLE, so the timing of each segment only
+    depends on its own bus.
+
+    Both nodes must be configured with the same address pairs. Normal
+    addressing with 8 byte frames padded with CAN_ISOTP_PAD is used, PDUs
+    of up to CAN_ISOTP_PDU_MAX bytes. Each pair has one buffer: a new PDU
+    in either direction aborts an unfinished one, which matches the
+    half-duplex request/response pattern of diagnostics.
+
+    BLE transport: TRS vendor command CAN_ISOTP_VENDOR_OPCODE, one PDU at a
+    time in segments sized to the ATT MTU. Segment (after the opcode):
+      0      bit 7 first segment, bit 6 last segment, bits 5..0 counter
+      first segment only:
+      1..4   CAN identifier, little endian, bit 31 set for extended
+      5..6   PDU length, little endian
+      then   PDU bytes
+*******************************************************************************/
+
+#ifndef _CAN_ISOTP_H
+#define _CAN_ISOTP_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "canfdspi/drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* Uncomment to terminate ISO-TP locally on both nodes. */
+//#define CAN_ISOTP_ENABLE
+
+#define CAN_ISOTP_PAIR_NUM          2
+#define CAN_ISOTP_PDU_MAX           4095    /* Largest PDU without the 32 bit First Frame length */
+#define CAN_ISOTP_DEFAULT_ID_A      0x7E0   /* Pair added by the application: UDS engine ECU */
+#define CAN_ISOTP_DEFAULT_ID_B      0x7E8
+
+/* Flow Control sent to the local sender. BS 0: no further Flow Control. */
+#define CAN_ISOTP_BS                0
+#define CAN_ISOTP_STMIN             0       /* ms */
+#define CAN_ISOTP_PAD               0xCC
+
+#define CAN_ISOTP_N_CR_MS           1000    /* Consecutive Frame timeout */
+#define CAN_ISOTP_N_BS_MS           1000    /* Flow Control timeout */
+#define CAN_ISOTP_BLE_RX_MS         2000    /* Timeout between BLE segments */
+#define CAN_ISOTP_WFT_MAX           8       /* Flow Control WAIT frames accepted in a row */
+#define CAN_ISOTP_BLE_RETRY_MS      20      /* Retry after the BLE stack was out of buffers */
+
+#define CAN_ISOTP_VENDOR_OPCODE     0x32
+#define CAN_ISOTP_SEG_FIRST         0x80
+#define CAN_ISOTP_SEG_LAST          0x40
+#define CAN_ISOTP_SEG_CNT_MASK      0x3F
+#define CAN_ISOTP_SEG_HDR_LEN       7       /* Header of the first segment */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Loads one 8 byte frame into the TX FIFO without waiting. Returns false
+   when the FIFO is full. */
+typedef bool (*CAN_ISOTP_TxFunc_T)(uint32_t id, bool extended, const uint8_t *p_data);
+
+typedef enum CAN_ISOTP_BleResult_T
+{
+    CAN_ISOTP_BLE_SENT,
+    CAN_ISOTP_BLE_BUSY,                 /* Out of buffers, try again later */
+    CAN_ISOTP_BLE_FAILED                /* Not connected */
+} CAN_ISOTP_BleResult_T;
+
+/* Sends one segment as vendor command CAN_ISOTP_VENDOR_OPCODE. */
+typedef CAN_ISOTP_BleResult_T (*CAN_ISOTP_BleFunc_T)(const uint8_t *p_seg, uint8_t len);
+
+typedef struct CAN_ISOTP_Stats_T
+{
+    uint32_t    toBle;                  /* PDUs reassembled and sent over BLE */
+    uint32_t    toCan;                  /* PDUs transmitted on the CAN segment */
+    uint32_t    aborted;                /* Replaced by a new PDU or refused by the receiver */
+    uint32_t    timeouts;
+    uint32_t    errors;                 /* Sequence errors, unknown identifiers, oversized PDUs */
+} CAN_ISOTP_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_ISOTP_Init(CAN_ISOTP_TxFunc_T txFunc, CAN_ISOTP_BleFunc_T bleFunc)
+
+  Summary:
+    Removes all address pairs and registers the CAN and BLE send functions.
+*/
+void CAN_ISOTP_Init(CAN_ISOTP_TxFunc_T txFunc, CAN_ISOTP_BleFunc_T bleFunc);
+
+/*******************************************************************************
+  Function:
+    bool CAN_ISOTP_PairAdd(uint32_t idA, uint32_t idB, bool extended)
+
+  Summary:
+    Terminates ISO-TP for the two identifiers of a physical address pair.
+
+  Description:
+    Each identifier is the Flow Control identifier of the other one. The
+    frames of both are no longer forwarded.
+
+  Returns:
+    true  - Pair added.
+    false - Table full, invalid or already used identifiers.
+*/
+bool CAN_ISOTP_PairAdd(uint32_t idA, uint32_t idB, bool extended);
+
+/*******************************************************************************
+  Function:
+    void CAN_ISOTP_MtuSet(uint16_t attMtu)
+
+  Summary:
+    Sets the ATT MTU the BLE segments are sized to.
+*/
+void CAN_ISOTP_MtuSet(uint16_t attMtu);
+
+/*******************************************************************************
+  Function:
+    bool CAN_ISOTP_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+
+  Summary:
+    Handles a frame received on the CAN segment.
+
+  Returns:
+    true  - The frame belongs to an address pair and was consumed.
+    false - Not an ISO-TP frame, forward it.
+*/
+bool CAN_ISOTP_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    void CAN_ISOTP_BleRx(const uint8_t *p_seg, uint16_t len)
+
+  Summary:
+    Handles a CAN_ISOTP_VENDOR_OPCODE segment, without the opcode.
+*/
+void CAN_ISOTP_BleRx(const uint8_t *p_seg, uint16_t len);
+
+/*******************************************************************************
+  Function:
+    uint16_t CAN_ISOTP_Tasks(uint16_t waitMs)
+
+  Summary:
+    Sends pending frames and segments and checks the timeouts.
+
+  Returns:
+    waitMs, shortened to the time until the next ISO-TP work.
+*/
+uint16_t CAN_ISOTP_Tasks(uint16_t waitMs);
+
+/*******************************************************************************
+  Function:
+    const CAN_ISOTP_Stats_T *CAN_ISOTP_StatsGet(void)
+
+  Summary:
+    Returns the counters since CAN_ISOTP_Init.
+*/
+const CAN_ISOTP_Stats_T *CAN_ISOTP_StatsGet(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _CAN_ISOTP_H */
+
+/*******************************************************************************
+ End of File
+ */
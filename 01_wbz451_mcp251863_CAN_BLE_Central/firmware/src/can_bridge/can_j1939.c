@@ -0,0 +1,777 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge J1939 Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_j1939.c
+
+  Summary:
+    SAE J1939 PGN filtering and transport protocol reassembly.
+
+  Description:
+    See can_j1939.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "gatt.h"
+#include "can_j1939.h"
+#include "can_log.h"
+
+#ifdef CAN_J1939_ENABLE
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+#define CAN_J1939_PGN_TP_CM         0xEC00UL
+#define CAN_J1939_PGN_TP_DT         0xEB00UL
+#define CAN_J1939_PGN_MAX           0x3FFFFUL
+#define CAN_J1939_PF_PDU2           240     /* PDU format from which PS is a group extension */
+
+#define CAN_J1939_CM_RTS            16
+#define CAN_J1939_CM_CTS            17
+#define CAN_J1939_CM_BAM            32
+#define CAN_J1939_CM_ABORT          255
+
+#define CAN_J1939_TP_PRIO           7
+#define CAN_J1939_DT_DATA_LEN       7
+#define CAN_J1939_TP_LEN_MIN        9
+#define CAN_J1939_PAD               0xFF
+#define CAN_J1939_ATT_HDR_LEN       4       /* ATT write header and vendor opcode */
+
+#define CAN_J1939_ID_MASK_PF        0x03FF0000UL    /* EDP, DP and PF */
+#define CAN_J1939_ID_MASK_PS        0x0000FF00UL
+#define CAN_J1939_ID_MASK_SA        0x000000FFUL
+
+#define CAN_J1939_MS_TO_TICKS(ms)   ((TickType_t)(((ms) + portTICK_PERIOD_MS - 1U) / portTICK_PERIOD_MS))
+
+typedef struct CAN_J1939_Filter_T
+{
+    uint32_t    pgn;
+    uint8_t     sa;
+} CAN_J1939_Filter_T;
+
+typedef enum CAN_J1939_State_T
+{
+    CAN_J1939_IDLE,
+    CAN_J1939_CAN_RX,               /* Collecting TP.DT packets */
+    CAN_J1939_BLE_TX                /* Sending the PGN over BLE */
+} CAN_J1939_State_T;
+
+/* A PGN reassembled from the bus, or received over BLE or sent as BAM. */
+typedef struct CAN_J1939_Pdu_T
+{
+    CAN_J1939_State_T   state;
+    uint32_t            pgn;
+    uint8_t             sa;
+    uint8_t             da;
+    uint8_t             prio;
+    uint8_t             packets;
+    uint8_t             seq;            /* Next TP.DT sequence number, 0: TP.CM */
+    uint16_t            len;
+    uint16_t            pos;
+    TickType_t          deadline;
+    uint8_t             buf[CAN_J1939_PDU_MAX];
+} CAN_J1939_Pdu_T;
+
+static CAN_J1939_TxFunc_T   s_j1939Tx;
+static CAN_J1939_BleFunc_T  s_j1939Ble;
+static CAN_J1939_Filter_T   s_j1939Filter[CAN_J1939_FILTER_NUM];
+static uint8_t              s_j1939FilterNum;
+static CAN_J1939_Pdu_T      s_j1939Session[CAN_J1939_SESSION_NUM];
+static CAN_J1939_Pdu_T     *s_j1939BleTxPdu;    /* One PGN at a time over BLE */
+static uint8_t              s_j1939BleTxCnt;
+static uint8_t              s_j1939SegMax;
+static CAN_J1939_Pdu_T      s_j1939BleRx;       /* pos != 0 while segments are expected */
+static uint8_t              s_j1939BleRxCnt;
+static CAN_J1939_Pdu_T      s_j1939Bam;         /* state BLE_TX while being sent on the bus */
+static CAN_J1939_Stats_T    s_j1939Stats;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool CAN_J1939_IsPdu1(uint32_t pgn)
+{
+    return (((pgn >> 8) & 0xFFU) < CAN_J1939_PF_PDU2);
+}
+
+static uint32_t CAN_J1939_Id(uint8_t prio, uint32_t pgn, uint8_t da, uint8_t sa)
+{
+    if (CAN_J1939_IsPdu1(pgn))
+    {
+        pgn |= da;
+    }
+    return ((uint32_t)prio << 26) | (pgn << 8) | sa;
+}
+
+/* Splits an identifier into PGN and destination address. */
+static uint32_t CAN_J1939_Pgn(uint32_t id, uint8_t *p_da)
+{
+    uint32_t pgn = (id >> 8) & CAN_J1939_PGN_MAX;
+
+    if (CAN_J1939_IsPdu1(pgn))
+    {
+        *p_da = (uint8_t)pgn;
+        return pgn & ~0xFFUL;
+    }
+    *p_da = CAN_J1939_ADDR_GLOBAL;
+    return pgn;
+}
+
+static bool CAN_J1939_Selected(uint32_t pgn, uint8_t sa)
+{
+    uint8_t i;
+
+    if (s_j1939FilterNum == 0U)
+    {
+        return true;
+    }
+    for (i = 0; i < s_j1939FilterNum; i++)
+    {
+        if ((s_j1939Filter[i].pgn == pgn) && ((s_j1939Filter[i].sa == CAN_J1939_ADDR_ANY) || (s_j1939Filter[i].sa == sa)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static CAN_J1939_Pdu_T *CAN_J1939_SessionFind(uint8_t sa, uint8_t da)
+{
+    uint8_t i;
+
+    for (i = 0; i < CAN_J1939_SESSION_NUM; i++)
+    {
+        if ((s_j1939Session[i].state == CAN_J1939_CAN_RX) && (s_j1939Session[i].sa == sa) && (s_j1939Session[i].da == da))
+        {
+            return &s_j1939Session[i];
+        }
+    }
+    return NULL;
+}
+
+static void CAN_J1939_Abort(CAN_J1939_Pdu_T *p_pdu, uint32_t *p_counter)
+{
+    if (p_pdu->state != CAN_J1939_IDLE)
+    {
+        (*p_counter)++;
+        CAN_LOG2(CAN_LOG_J1939_ABORT, p_pdu->pgn, p_pdu->sa);
+    }
+    if (s_j1939BleTxPdu == p_pdu)
+    {
+        s_j1939BleTxPdu = NULL;
+    }
+    p_pdu->state = CAN_J1939_IDLE;
+}
+
+static void CAN_J1939_RxCm(uint8_t sa, uint8_t da, uint8_t prio, const uint8_t *p_data)
+{
+    CAN_J1939_Pdu_T *p_pdu;
+    uint32_t pgn = (uint32_t)p_data[5] | ((uint32_t)p_data[6] << 8) | ((uint32_t)p_data[7] << 16);
+    uint16_t len = (uint16_t)p_data[1] | ((uint16_t)p_data[2] << 8);
+    uint8_t i;
+
+    switch (p_data[0])
+    {
+        case CAN_J1939_CM_RTS:
+        case CAN_J1939_CM_BAM:
+            if (((p_data[0] == CAN_J1939_CM_BAM) != (da == CAN_J1939_ADDR_GLOBAL))
+                || (len < CAN_J1939_TP_LEN_MIN) || (len > CAN_J1939_PDU_MAX)
+                || (p_data[3] != ((len + CAN_J1939_DT_DATA_LEN - 1U) / CAN_J1939_DT_DATA_LEN)))
+            {
+                s_j1939Stats.errors++;
+                break;
+            }
+            /* A new session between the same nodes replaces the current one. */
+            p_pdu = CAN_J1939_SessionFind(sa, da);
+            if (p_pdu != NULL)
+            {
+                CAN_J1939_Abort(p_pdu, &s_j1939Stats.aborted);
+            }
+            if (!CAN_J1939_Selected(pgn, sa))
+            {
+                s_j1939Stats.filtered++;
+                break;
+            }
+            for (i = 0; i < CAN_J1939_SESSION_NUM; i++)
+            {
+                if (s_j1939Session[i].state == CAN_J1939_IDLE)
+                {
+                    break;
+                }
+            }
+            if (i == CAN_J1939_SESSION_NUM)
+            {
+                s_j1939Stats.dropped++;
+                break;
+            }
+            p_pdu = &s_j1939Session[i];
+            p_pdu->pgn = pgn;
+            p_pdu->sa = sa;
+            p_pdu->da = da;
+            p_pdu->prio = prio;
+            p_pdu->len = len;
+            p_pdu->packets = p_data[3];
+            p_pdu->seq = 1;
+            p_pdu->deadline = xTaskGetTickCount() + CAN_J1939_MS_TO_TICKS(CAN_J1939_T_SESSION_MS);
+            p_pdu->state = CAN_J1939_CAN_RX;
+            break;
+
+        case CAN_J1939_CM_CTS:
+            /* Sent by the receiver: the session runs from da to sa. A
+               retransmission restarts at the requested packet, which must
+               lie within the PGN together with the packets it clears. */
+            p_pdu = CAN_J1939_SessionFind(da, sa);
+            if (p_pdu != NULL)
+            {
+                if (p_data[1] != 0U)
+                {
+                    if ((p_data[2] == 0U) || (((uint16_t)p_data[2] + p_data[1] - 1U) > p_pdu->packets))
+                    {
+                        s_j1939Stats.errors++;
+                        CAN_J1939_Abort(p_pdu, &s_j1939Stats.aborted);
+                        break;
+                    }
+                    p_pdu->seq = p_data[2];
+                }
+                p_pdu->deadline = xTaskGetTickCount() + CAN_J1939_MS_TO_TICKS(CAN_J1939_T_SESSION_MS);
+            }
+            break;
+
+        case CAN_J1939_CM_ABORT:
+            p_pdu = CAN_J1939_SessionFind(sa, da);
+            if (p_pdu == NULL)
+            {
+                p_pdu = CAN_J1939_SessionFind(da, sa);
+            }
+            if (p_pdu != NULL)
+            {
+                CAN_J1939_Abort(p_pdu, &s_j1939Stats.aborted);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void CAN_J1939_RxDt(uint8_t sa, uint8_t da, const uint8_t *p_data)
+{
+    CAN_J1939_Pdu_T *p_pdu = CAN_J1939_SessionFind(sa, da);
+    uint16_t offset;
+    uint16_t n;
+
+    if (p_pdu == NULL)
+    {
+        return;
+    }
+    if ((p_data[0] != p_pdu->seq) || (p_pdu->seq == 0U) || (p_pdu->seq > p_pdu->packets))
+    {
+        s_j1939Stats.errors++;
+        CAN_J1939_Abort(p_pdu, &s_j1939Stats.aborted);
+        return;
+    }
+
+    offset = (uint16_t)(p_pdu->seq - 1U) * CAN_J1939_DT_DATA_LEN;
+    if ((offset >= p_pdu->len) || (p_pdu->len > sizeof(p_pdu->buf)))
+    {
+        s_j1939Stats.errors++;
+        CAN_J1939_Abort(p_pdu, &s_j1939Stats.aborted);
+        return;
+    }
+    n = p_pdu->len - offset;
+    if (n > CAN_J1939_DT_DATA_LEN)
+    {
+        n = CAN_J1939_DT_DATA_LEN;
+    }
+    memcpy(&p_pdu->buf[offset], &p_data[1], n);
+
+    if (p_pdu->seq == p_pdu->packets)
+    {
+        p_pdu->pos = 0;
+        p_pdu->state = CAN_J1939_BLE_TX;
+        return;
+    }
+    p_pdu->seq++;
+    p_pdu->deadline = xTaskGetTickCount() + CAN_J1939_MS_TO_TICKS(CAN_J1939_T_SESSION_MS);
+}
+
+static void CAN_J1939_BleTxNext(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < CAN_J1939_SESSION_NUM; i++)
+    {
+        if (s_j1939Session[i].state == CAN_J1939_BLE_TX)
+        {
+            s_j1939BleTxPdu = &s_j1939Session[i];
+            return;
+        }
+    }
+}
+
+/* Sends the segments of s_j1939BleTxPdu. Returns the ms until the next
+   attempt, 0 when the PGN is done. */
+static uint16_t CAN_J1939_BleTx(void)
+{
+    CAN_J1939_Pdu_T *p_pdu = s_j1939BleTxPdu;
+    uint8_t seg[UINT8_MAX];
+    uint16_t hdr;
+    uint16_t n;
+
+    while (p_pdu->pos < p_pdu->len)
+    {
+        hdr = 1;
+        seg[0] = s_j1939BleTxCnt & CAN_J1939_SEG_CNT_MASK;
+        if (p_pdu->pos == 0U)
+        {
+            seg[0] |= CAN_J1939_SEG_FIRST;
+            seg[1] = (uint8_t)p_pdu->pgn;
+            seg[2] = (uint8_t)(p_pdu->pgn >> 8);
+            seg[3] = (uint8_t)(p_pdu->pgn >> 16);
+            seg[4] = p_pdu->sa;
+            seg[5] = p_pdu->da;
+            seg[6] = p_pdu->prio;
+            seg[7] = (uint8_t)p_pdu->len;
+            seg[8] = (uint8_t)(p_pdu->len >> 8);
+            hdr = CAN_J1939_SEG_HDR_LEN;
+        }
+        n = p_pdu->len - p_pdu->pos;
+        if (n > (uint16_t)(s_j1939SegMax - hdr))
+        {
+            n = s_j1939SegMax - hdr;
+        }
+        else
+        {
+            seg[0] |= CAN_J1939_SEG_LAST;
+        }
+        memcpy(&seg[hdr], &p_pdu->buf[p_pdu->pos], n);
+
+        switch (s_j1939Ble(seg, (uint8_t)(hdr + n)))
+        {
+            case CAN_J1939_BLE_SENT:
+                p_pdu->pos += n;
+                s_j1939BleTxCnt++;
+                break;
+
+            case CAN_J1939_BLE_BUSY:
+                return CAN_J1939_BLE_RETRY_MS;
+
+            default:
+                CAN_J1939_Abort(p_pdu, &s_j1939Stats.aborted);
+                return 0;
+        }
+    }
+
+    s_j1939Stats.toBle++;
+    CAN_LOG3(CAN_LOG_J1939_TO_BLE, p_pdu->pgn, p_pdu->sa, p_pdu->len);
+    p_pdu->state = CAN_J1939_IDLE;
+    s_j1939BleTxPdu = NULL;
+    return 0;
+}
+
+/* Sends TP.CM_BAM and the TP.DT packets of s_j1939Bam, CAN_J1939_BAM_GAP_MS
+   apart. Returns the ms until the next packet is due. */
+static uint16_t CAN_J1939_BamTx(TickType_t now)
+{
+    CAN_J1939_Pdu_T *p_pdu = &s_j1939Bam;
+    uint8_t frame[8];
+    uint16_t offset;
+    uint16_t n;
+    uint32_t id;
+
+    while ((p_pdu->state == CAN_J1939_BLE_TX) && ((int32_t)(now - p_pdu->deadline) >= 0))
+    {
+        if (p_pdu->seq == 0U)
+        {
+            frame[0] = CAN_J1939_CM_BAM;
+            frame[1] = (uint8_t)p_pdu->len;
+            frame[2] = (uint8_t)(p_pdu->len >> 8);
+            frame[3] = p_pdu->packets;
+            frame[4] = CAN_J1939_PAD;
+            frame[5] = (uint8_t)p_pdu->pgn;
+            frame[6] = (uint8_t)(p_pdu->pgn >> 8);
+            frame[7] = (uint8_t)(p_pdu->pgn >> 16);
+            id = CAN_J1939_Id(CAN_J1939_TP_PRIO, CAN_J1939_PGN_TP_CM, CAN_J1939_ADDR_GLOBAL, p_pdu->sa);
+        }
+        else
+        {
+            offset = (uint16_t)(p_pdu->seq - 1U) * CAN_J1939_DT_DATA_LEN;
+            n = p_pdu->len - offset;
+            if (n > CAN_J1939_DT_DATA_LEN)
+            {
+                n = CAN_J1939_DT_DATA_LEN;
+            }
+            frame[0] = p_pdu->seq;
+            memcpy(&frame[1], &p_pdu->buf[offset], n);
+            memset(&frame[1 + n], CAN_J1939_PAD, CAN_J1939_DT_DATA_LEN - n);
+            id = CAN_J1939_Id(CAN_J1939_TP_PRIO, CAN_J1939_PGN_TP_DT, CAN_J1939_ADDR_GLOBAL, p_pdu->sa);
+        }
+        if (!s_j1939Tx(id, true, frame))
+        {
+            return 1;
+        }
+
+        if (p_pdu->seq == p_pdu->packets)
+        {
+            p_pdu->state = CAN_J1939_IDLE;
+            s_j1939Stats.bamSent++;
+            CAN_LOG3(CAN_LOG_J1939_BAM, p_pdu->pgn, p_pdu->sa, p_pdu->len);
+            return OSAL_WAIT_FOREVER;
+        }
+        p_pdu->seq++;
+        p_pdu->deadline = now + CAN_J1939_MS_TO_TICKS(CAN_J1939_BAM_GAP_MS);
+    }
+
+    if (p_pdu->state == CAN_J1939_BLE_TX)
+    {
+        return (uint16_t)((p_pdu->deadline - now) * portTICK_PERIOD_MS);
+    }
+    return OSAL_WAIT_FOREVER;
+}
+
+/* A PGN received completely over BLE. */
+static void CAN_J1939_BleReceived(CAN_J1939_Pdu_T *p_pdu)
+{
+    if (p_pdu->da != CAN_J1939_ADDR_GLOBAL)
+    {
+        s_j1939Stats.directed++;
+        return;
+    }
+    if (s_j1939Bam.state != CAN_J1939_IDLE)
+    {
+        s_j1939Stats.dropped++;
+        return;
+    }
+
+    s_j1939Bam.pgn = p_pdu->pgn;
+    s_j1939Bam.sa = p_pdu->sa;
+    s_j1939Bam.da = p_pdu->da;
+    s_j1939Bam.len = p_pdu->len;
+    s_j1939Bam.packets = (uint8_t)((p_pdu->len + CAN_J1939_DT_DATA_LEN - 1U) / CAN_J1939_DT_DATA_LEN);
+    s_j1939Bam.seq = 0;
+    memcpy(s_j1939Bam.buf, p_pdu->buf, p_pdu->len);
+    s_j1939Bam.deadline = xTaskGetTickCount();
+    s_j1939Bam.state = CAN_J1939_BLE_TX;
+    (void)CAN_J1939_BamTx(s_j1939Bam.deadline);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_J1939_Init(CAN_J1939_TxFunc_T txFunc, CAN_J1939_BleFunc_T bleFunc)
+{
+    uint8_t i;
+
+    s_j1939Tx = txFunc;
+    s_j1939Ble = bleFunc;
+    s_j1939FilterNum = 0;
+    for (i = 0; i < CAN_J1939_SESSION_NUM; i++)
+    {
+        s_j1939Session[i].state = CAN_J1939_IDLE;
+    }
+    s_j1939BleTxPdu = NULL;
+    s_j1939BleRx.pos = 0;
+    s_j1939Bam.state = CAN_J1939_IDLE;
+    memset(&s_j1939Stats, 0, sizeof(s_j1939Stats));
+    CAN_J1939_MtuSet(BLE_ATT_DEFAULT_MTU_LEN);
+}
+
+bool CAN_J1939_FilterAdd(uint32_t pgn, uint8_t sa)
+{
+    /* The PS field of a PDU1 PGN is the destination address. */
+    if ((s_j1939FilterNum == CAN_J1939_FILTER_NUM) || (pgn > CAN_J1939_PGN_MAX)
+        || (CAN_J1939_IsPdu1(pgn) && ((pgn & 0xFFU) != 0U)))
+    {
+        return false;
+    }
+    s_j1939Filter[s_j1939FilterNum].pgn = pgn;
+    s_j1939Filter[s_j1939FilterNum].sa = sa;
+    s_j1939FilterNum++;
+    return true;
+}
+
+uint8_t CAN_J1939_HwFilterNum(void)
+{
+    if ((s_j1939FilterNum == 0U) || ((s_j1939FilterNum + 2U) > CAN_J1939_HW_FILTER_NUM))
+    {
+        return 1;
+    }
+    return s_j1939FilterNum + 2U;
+}
+
+bool CAN_J1939_HwFilterGet(uint8_t idx, CAN_FILTEROBJ_ID *p_obj, CAN_MASKOBJ_ID *p_mask)
+{
+    uint32_t id = 0;
+    uint32_t mask = 0;
+
+    if (idx >= CAN_J1939_HwFilterNum())
+    {
+        return false;
+    }
+
+    if (CAN_J1939_HwFilterNum() == 1U)
+    {
+        /* Every extended frame */
+    }
+    else if (idx < s_j1939FilterNum)
+    {
+        id = CAN_J1939_Id(0, s_j1939Filter[idx].pgn, 0, s_j1939Filter[idx].sa);
+        mask = CAN_J1939_ID_MASK_PF;
+        if (!CAN_J1939_IsPdu1(s_j1939Filter[idx].pgn))
+        {
+            mask |= CAN_J1939_ID_MASK_PS;
+        }
+        if (s_j1939Filter[idx].sa != CAN_J1939_ADDR_ANY)
+        {
+            mask |= CAN_J1939_ID_MASK_SA;
+        }
+    }
+    else
+    {
+        /* The PGN of a session is only known from its TP.CM frame. */
+        id = CAN_J1939_Id(0, (idx == s_j1939FilterNum) ? CAN_J1939_PGN_TP_CM : CAN_J1939_PGN_TP_DT, 0, 0);
+        mask = CAN_J1939_ID_MASK_PF;
+    }
+
+    memset(p_obj, 0, sizeof(*p_obj));
+    memset(p_mask, 0, sizeof(*p_mask));
+    p_obj->SID = id >> 18;
+    p_obj->EID = id & 0x3FFFFU;
+    p_obj->EXIDE = 1;
+    p_mask->MSID = mask >> 18;
+    p_mask->MEID = mask & 0x3FFFFU;
+    p_mask->MIDE = 1;
+    return true;
+}
+
+void CAN_J1939_MtuSet(uint16_t attMtu)
+{
+    uint16_t segMax = attMtu - CAN_J1939_ATT_HDR_LEN;
+
+    s_j1939SegMax = (segMax > UINT8_MAX) ? UINT8_MAX : (uint8_t)segMax;
+}
+
+bool CAN_J1939_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+{
+    uint32_t id = ((uint32_t)p_obj->bF.id.SID << 18) | p_obj->bF.id.EID;
+    uint8_t n = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)p_obj->bF.ctrl.DLC);
+    uint8_t sa = (uint8_t)id;
+    uint8_t da;
+    uint32_t pgn;
+
+    if (!p_obj->bF.ctrl.IDE)
+    {
+        return false;
+    }
+
+    pgn = CAN_J1939_Pgn(id, &da);
+    if ((pgn == CAN_J1939_PGN_TP_CM) || (pgn == CAN_J1939_PGN_TP_DT))
+    {
+        if (p_obj->bF.ctrl.RTR || (n < 8U))
+        {
+            s_j1939Stats.errors++;
+        }
+        else if (pgn == CAN_J1939_PGN_TP_CM)
+        {
+            CAN_J1939_RxCm(sa, da, (uint8_t)(id >> 26), p_data);
+        }
+        else
+        {
+            CAN_J1939_RxDt(sa, da, p_data);
+        }
+        return true;
+    }
+
+    if (!CAN_J1939_Selected(pgn, sa))
+    {
+        s_j1939Stats.filtered++;
+        return true;
+    }
+    return false;
+}
+
+void CAN_J1939_BleRx(const uint8_t *p_seg, uint16_t len)
+{
+    CAN_J1939_Pdu_T *p_pdu = &s_j1939BleRx;
+    uint16_t hdr = 1;
+
+    if (len < 1U)
+    {
+        return;
+    }
+
+    if (p_seg[0] & CAN_J1939_SEG_FIRST)
+    {
+        if (p_pdu->pos != 0U)
+        {
+            s_j1939Stats.aborted++;
+        }
+        p_pdu->pos = 0;
+        if (len < CAN_J1939_SEG_HDR_LEN)
+        {
+            s_j1939Stats.errors++;
+            return;
+        }
+        p_pdu->pgn = (uint32_t)p_seg[1] | ((uint32_t)p_seg[2] << 8) | ((uint32_t)p_seg[3] << 16);
+        p_pdu->sa = p_seg[4];
+        p_pdu->da = p_seg[5];
+        p_pdu->prio = p_seg[6];
+        p_pdu->len = (uint16_t)p_seg[7] | ((uint16_t)p_seg[8] << 8);
+        if ((p_pdu->len < CAN_J1939_TP_LEN_MIN) || (p_pdu->len > CAN_J1939_PDU_MAX))
+        {
+            s_j1939Stats.errors++;
+            return;
+        }
+        s_j1939BleRxCnt = p_seg[0];
+        hdr = CAN_J1939_SEG_HDR_LEN;
+    }
+    else
+    {
+        if (p_pdu->pos == 0U)
+        {
+            return;
+        }
+        s_j1939BleRxCnt++;
+        if ((p_seg[0] & CAN_J1939_SEG_CNT_MASK) != (s_j1939BleRxCnt & CAN_J1939_SEG_CNT_MASK))
+        {
+            s_j1939Stats.errors++;
+            p_pdu->pos = 0;
+            return;
+        }
+    }
+
+    if ((len - hdr) > (p_pdu->len - p_pdu->pos))
+    {
+        s_j1939Stats.errors++;
+        p_pdu->pos = 0;
+        return;
+    }
+    memcpy(&p_pdu->buf[p_pdu->pos], &p_seg[hdr], len - hdr);
+    p_pdu->pos += len - hdr;
+    p_pdu->deadline = xTaskGetTickCount() + CAN_J1939_MS_TO_TICKS(CAN_J1939_BLE_RX_MS);
+
+    if (p_seg[0] & CAN_J1939_SEG_LAST)
+    {
+        if (p_pdu->pos != p_pdu->len)
+        {
+            s_j1939Stats.errors++;
+        }
+        else
+        {
+            CAN_J1939_BleReceived(p_pdu);
+        }
+        p_pdu->pos = 0;
+    }
+}
+
+uint16_t CAN_J1939_Tasks(uint16_t waitMs)
+{
+    CAN_J1939_Pdu_T *p_pdu;
+    TickType_t now = xTaskGetTickCount();
+    uint16_t ms;
+    uint8_t i;
+
+    for (i = 0; i < CAN_J1939_SESSION_NUM; i++)
+    {
+        p_pdu = &s_j1939Session[i];
+        if (p_pdu->state == CAN_J1939_CAN_RX)
+        {
+            if ((int32_t)(now - p_pdu->deadline) >= 0)
+            {
+                CAN_J1939_Abort(p_pdu, &s_j1939Stats.timeouts);
+            }
+            else
+            {
+                ms = (uint16_t)((p_pdu->deadline - now) * portTICK_PERIOD_MS);
+                waitMs = (ms < waitMs) ? ms : waitMs;
+            }
+        }
+    }
+
+    if (s_j1939BleRx.pos != 0U)
+    {
+        if ((int32_t)(now - s_j1939BleRx.deadline) >= 0)
+        {
+            s_j1939BleRx.pos = 0;
+            s_j1939Stats.timeouts++;
+        }
+        else
+        {
+            ms = (uint16_t)((s_j1939BleRx.deadline - now) * portTICK_PERIOD_MS);
+            waitMs = (ms < waitMs) ? ms : waitMs;
+        }
+    }
+
+    ms = CAN_J1939_BamTx(now);
+    waitMs = (ms < waitMs) ? ms : waitMs;
+
+    /* Reassembled PGNs in session order, one at a time. */
+    if (s_j1939BleTxPdu == NULL)
+    {
+        CAN_J1939_BleTxNext();
+    }
+    while (s_j1939BleTxPdu != NULL)
+    {
+        ms = CAN_J1939_BleTx();
+        if (ms != 0U)
+        {
+            waitMs = (ms < waitMs) ? ms : waitMs;
+            break;
+        }
+        CAN_J1939_BleTxNext();
+    }
+    return waitMs;
+}
+
+const CAN_J1939_Stats_T *CAN_J1939_StatsGet(void)
+{
+    return &s_j1939Stats;
+}
+
+#endif /* CAN_J1939_ENABLE */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,224 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Deferred Log Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_log.c
+
+  Summary:
+    Binary log records expanded to text outside of the data path.
+
+  Description:
+    See can_log.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "can_log.h"
+
+#ifdef CAN_LOG_ENABLE
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+typedef char can_log_ring_size_check[((CAN_LOG_RING_SIZE & (CAN_LOG_RING_SIZE - 1)) == 0) ? 1 : -1];
+
+typedef struct CAN_LOG_Record_T
+{
+    volatile uint32_t   seq;            /* Write index + 1 once the record is complete */
+    uint32_t            timestamp;      /* ms */
+    uint16_t            fmtId;
+    uint8_t             argNum;
+    uint32_t            arg[CAN_LOG_MAX_ARGS];
+} CAN_LOG_Record_T;
+
+#define CAN_LOG_FMT_STRING(id, fmt) fmt,
+
+static const char * const s_canLogFmt[CAN_LOG_FMT_NUM] =
+{
+    CAN_LOG_FORMATS(CAN_LOG_FMT_STRING)
+};
+
+static CAN_LOG_Record_T s_canLogRing[CAN_LOG_RING_SIZE] APP_STATIC_SECTION("log");
+static volatile uint32_t s_canLogWrIdx;         /* Reserved by writers */
+static volatile uint32_t s_canLogRdIdx;         /* Written by CAN_LOG_Tasks only */
+static volatile uint32_t s_canLogDropCnt;
+static uint32_t s_canLogDropReported;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void CAN_LOG_Output(uint32_t timestamp, uint16_t fmtId, uint8_t argNum, const uint32_t *p_arg)
+{
+    char line[CAN_LOG_LINE_MAX];
+    int len;
+#ifdef CAN_LOG_OUTPUT_BINARY
+    uint8_t i;
+
+    len = 0;
+    line[len++] = (char)CAN_LOG_FRAME_SYNC;
+    line[len++] = (char)(6 + argNum * 4);
+    line[len++] = (char)fmtId;
+    line[len++] = (char)(fmtId >> 8);
+    memcpy(&line[len], &timestamp, 4);
+    len += 4;
+    for (i = 0; i < argNum; i++)
+    {
+        memcpy(&line[len], &p_arg[i], 4);
+        len += 4;
+    }
+#else
+    int n;
+
+    len = snprintf(line, sizeof(line), "[%lu] ", (unsigned long)timestamp);
+    n = snprintf(&line[len], sizeof(line) - len, s_canLogFmt[fmtId], p_arg[0], p_arg[1], p_arg[2], p_arg[3]);
+    if (n < 0)
+    {
+        return;
+    }
+    len += n;
+    if (len >= (int)sizeof(line))
+    {
+        len = sizeof(line) - 1;
+    }
+#endif
+    SYS_CONSOLE_Write(SYS_CONSOLE_DEFAULT_INSTANCE, line, len);
+}
+
+static bool CAN_LOG_ConsoleReady(void)
+{
+    return (SYS_CONSOLE_WriteFreeBufferCountGet(SYS_CONSOLE_DEFAULT_INSTANCE) >= CAN_LOG_LINE_MAX);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_LOG_Write(CAN_LOG_Fmt_T fmt, uint8_t argNum, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    CAN_LOG_Record_T *p_rec;
+    uint32_t idx;
+    uint32_t cnt;
+
+    do
+    {
+        idx = __LDREXW(&s_canLogWrIdx);
+        if ((idx - s_canLogRdIdx) >= CAN_LOG_RING_SIZE)
+        {
+            __CLREX();
+            do
+            {
+                cnt = __LDREXW(&s_canLogDropCnt);
+            } while (__STREXW(cnt + 1, &s_canLogDropCnt) != 0);
+            return;
+        }
+    } while (__STREXW(idx + 1, &s_canLogWrIdx) != 0);
+
+    p_rec = &s_canLogRing[idx & (CAN_LOG_RING_SIZE - 1)];
+    p_rec->timestamp = (__get_IPSR() != 0) ? xTaskGetTickCountFromISR() : xTaskGetTickCount();
+    p_rec->fmtId = (uint16_t)fmt;
+    p_rec->argNum = argNum;
+    p_rec->arg[0] = a0;
+    p_rec->arg[1] = a1;
+    p_rec->arg[2] = a2;
+    p_rec->arg[3] = a3;
+
+    /* Publish the record only after its content is written. */
+    __DMB();
+    p_rec->seq = idx + 1;
+}
+
+uint16_t CAN_LOG_Tasks(uint16_t waitMs)
+{
+    CAN_LOG_Record_T *p_rec;
+    uint32_t rdIdx = s_canLogRdIdx;
+    uint32_t dropCnt = s_canLogDropCnt;
+    uint8_t n;
+
+    if ((dropCnt != s_canLogDropReported) && CAN_LOG_ConsoleReady())
+    {
+        uint32_t arg[CAN_LOG_MAX_ARGS] = { dropCnt - s_canLogDropReported, 0, 0, 0 };
+
+        CAN_LOG_Output(xTaskGetTickCount(), CAN_LOG_DROPPED, 1, arg);
+        s_canLogDropReported = dropCnt;
+    }
+
+    for (n = 0; n < CAN_LOG_EXPAND_MAX; n++)
+    {
+        p_rec = &s_canLogRing[rdIdx & (CAN_LOG_RING_SIZE - 1)];
+
+        /* Stop at a slot that is reserved but not yet complete. */
+        if ((rdIdx == s_canLogWrIdx) || (p_rec->seq != (rdIdx + 1)) || !CAN_LOG_ConsoleReady())
+        {
+            break;
+        }
+        __DMB();
+        if (p_rec->fmtId < CAN_LOG_FMT_NUM)
+        {
+            CAN_LOG_Output(p_rec->timestamp, p_rec->fmtId, p_rec->argNum, p_rec->arg);
+        }
+
+        /* The record must be read before a writer may reuse the slot. */
+        __DMB();
+        rdIdx++;
+        s_canLogRdIdx = rdIdx;
+    }
+
+    if ((rdIdx != s_canLogWrIdx) && (waitMs > CAN_LOG_RETRY_MS))
+    {
+        return CAN_LOG_RETRY_MS;
+    }
+    return waitMs;
+}
+
+uint32_t CAN_LOG_DropCntGet(void)
+{
+    return s_canLogDropCnt;
+}
+
+#endif /* CAN_LOG_ENABLE */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,202 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Deferred Log Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_log.h
+
+  Summary:
+    Binary log records expanded to text outside of the data path.
+
+  Description:
+    A log call stores only a format ID, a time stamp and up to
+    CAN_LOG_MAX_ARGS 32-bit arguments into a lock-free ring. No formatting
+    and no console access happens at the call site, so logging can stay
+    enabled on every frame.
+
+    Any task or interrupt may log. Writers reserve a slot with an
+    LDREX/STREX loop on the write index and publish it with a sequence word,
+    so the ring needs no critical section. APP_Tasks expands the records
+    with CAN_LOG_Tasks() once appQueue is drained. Records are only expanded
+    while the console write buffer has room. When the ring is full, new
+    records are dropped and counted.
+
+    With CAN_LOG_OUTPUT_BINARY the records are written to the console as
+    binary frames. tools/can_log_decode.py expands them on the host using
+    the format strings below. Frame: 0xA5, payload length, format ID
+    (uint16_t), time stamp in ms (uint32_t), arguments (uint32_t each), all
+    little endian.
+*******************************************************************************/
+
+#ifndef _CAN_LOG_H
+#define _CAN_LOG_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* Comment out to compile out all log calls. */
+#define CAN_LOG_ENABLE
+
+/* Uncomment to write binary frames instead of text. */
+//#define CAN_LOG_OUTPUT_BINARY
+
+#define CAN_LOG_RING_SIZE           32      /* Power of two */
+#define CAN_LOG_MAX_ARGS            4
+#define CAN_LOG_LINE_MAX            96      /* Longest expanded line */
+#define CAN_LOG_EXPAND_MAX          8       /* Records expanded per CAN_LOG_Tasks() call */
+#define CAN_LOG_RETRY_MS            10      /* Wait for console room */
+#define CAN_LOG_FRAME_SYNC          0xA5
+
+/* Format strings. Arguments are uint32_t, use the l length modifier. The
+   format ID is the position in this list, append new entries at the end
+   to keep decoding old captures. */
+#define CAN_LOG_FORMATS(X)                                                                          \
+    X(CAN_LOG_CAN_RX,           "CAN RX id 0x%lX dlc %lu data %08lX %08lX\r\n")                   \
+    X(CAN_LOG_CAN_TX,           "CAN TX id 0x%lX dlc %lu data %08lX %08lX\r\n")                   \
+    X(CAN_LOG_CAN_TX_FAIL,      "CAN TX failed, error flags 0x%lX\r\n")                           \
+    X(CAN_LOG_CAN_RX_DROP,      "CAN RX id 0x%lX dropped, appQueue full\r\n")                     \
+    X(CAN_LOG_DROPPED,          "%lu log records dropped\r\n")                                    \
+    X(CAN_LOG_ISOTP_TO_BLE,     "ISO-TP id 0x%lX %lu bytes to BLE\r\n")                           \
+    X(CAN_LOG_ISOTP_TO_CAN,     "ISO-TP id 0x%lX %lu bytes to CAN\r\n")                           \
+    X(CAN_LOG_ISOTP_ABORT,      "ISO-TP id 0x%lX aborted in state %lu\r\n")                       \
+    X(CAN_LOG_J1939_TO_BLE,     "J1939 PGN 0x%lX SA 0x%lX %lu bytes to BLE\r\n")                  \
+    X(CAN_LOG_J1939_BAM,        "J1939 PGN 0x%lX SA 0x%lX %lu bytes sent as BAM\r\n")             \
+    X(CAN_LOG_J1939_ABORT,      "J1939 PGN 0x%lX SA 0x%lX aborted\r\n")                           \
+    X(CAN_LOG_CYCLIC_START,     "Cyclic id 0x%lX scheduled every %lu ms\r\n")                     \
+    X(CAN_LOG_CYCLIC_STOP,      "Cyclic id 0x%lX stopped\r\n")                                    \
+    X(CAN_LOG_CYCLIC_LATE,      "Cyclic id 0x%lX sent %lu ms late\r\n")                           \
+    X(CAN_LOG_QOS_DROP,         "QoS id 0x%lX dropped, class %lu queue full\r\n")                 \
+    X(CAN_LOG_ERR_STATE,        "CAN error state %lu, TEC %lu REC %lu\r\n")                       \
+    X(CAN_LOG_ERR_RECOVERED,    "CAN bus off recovered after %lu ms, %lu frames held\r\n")        \
+    X(CAN_LOG_RX_OVERFLOW,      "CAN RX FIFO %lu overflow, %lu events\r\n")
+
+#define CAN_LOG_FMT_ENUM(id, fmt)   id,
+
+/* Packs 4 data bytes into one argument, printed in bus order by %08lX. */
+#define CAN_LOG_BE32(p)     (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+
+#ifdef CAN_LOG_ENABLE
+#define CAN_LOG0(fmt)                   CAN_LOG_Write((fmt), 0, 0, 0, 0, 0)
+#define CAN_LOG1(fmt, a0)               CAN_LOG_Write((fmt), 1, (uint32_t)(a0), 0, 0, 0)
+#define CAN_LOG2(fmt, a0, a1)           CAN_LOG_Write((fmt), 2, (uint32_t)(a0), (uint32_t)(a1), 0, 0)
+#define CAN_LOG3(fmt, a0, a1, a2)       CAN_LOG_Write((fmt), 3, (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2), 0)
+#define CAN_LOG4(fmt, a0, a1, a2, a3)   CAN_LOG_Write((fmt), 4, (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2), (uint32_t)(a3))
+#else
+#define CAN_LOG0(fmt)
+#define CAN_LOG1(fmt, a0)
+#define CAN_LOG2(fmt, a0, a1)
+#define CAN_LOG3(fmt, a0, a1, a2)
+#define CAN_LOG4(fmt, a0, a1, a2, a3)
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef enum CAN_LOG_Fmt_T
+{
+    CAN_LOG_FORMATS(CAN_LOG_FMT_ENUM)
+    CAN_LOG_FMT_NUM
+} CAN_LOG_Fmt_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_LOG_Write(CAN_LOG_Fmt_T fmt, uint8_t argNum, uint32_t a0,
+                       uint32_t a1, uint32_t a2, uint32_t a3)
+
+  Summary:
+    Stores one log record. Use the CAN_LOGn macros instead.
+
+  Remarks:
+    Task and interrupt safe, does not block.
+*/
+void CAN_LOG_Write(CAN_LOG_Fmt_T fmt, uint8_t argNum, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+
+/*******************************************************************************
+  Function:
+    uint16_t CAN_LOG_Tasks(uint16_t waitMs)
+
+  Summary:
+    Expands up to CAN_LOG_EXPAND_MAX records to the console.
+
+  Parameters:
+    waitMs - Time in ms the caller is going to wait.
+
+  Returns:
+    waitMs, shortened to CAN_LOG_RETRY_MS if records are left in the ring.
+*/
+uint16_t CAN_LOG_Tasks(uint16_t waitMs);
+
+/*******************************************************************************
+  Function:
+    uint32_t CAN_LOG_DropCntGet(void)
+
+  Summary:
+    Returns the number of records dropped because the ring was full.
+*/
+uint32_t CAN_LOG_DropCntGet(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _CAN_LOG_H */
+
+/*******************************************************************************
+ End of File
+ */
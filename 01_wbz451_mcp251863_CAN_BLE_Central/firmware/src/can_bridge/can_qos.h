@@ -0,0 +1,252 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Quality of Service Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_qos.h
+
+  Summary:
+    Priority classes, rate limits and a weighted scheduler between CAN RX
+    and the BLE sender, so a chatty ECU cannot starve the other identifiers.
+
+  Description:
+    Every received frame is put into the queue of its class, taken from the
+    ranges added with CAN_QOS_RangeAdd or CAN_QOS_CLASS_DEFAULT. The classes
+    below CAN_QOS_STRICT_NUM are served by strict priority, class 0 first.
+    The other classes share the remaining BLE capacity by deficit round
+    robin: per visit a class may send CAN_QOS_QUANTUM_BYTES times its
+    weight in data PDU bytes (message object and data). The default weights
+    halve from class to class.
+
+    Two kinds of token bucket limit the rates:
+      - a class bucket shapes: the head frame of the class waits for a
+        token, counted once as shaped,
+      - an identifier bucket polices: a frame arriving without a token is
+        dropped, counted as policed, so a babbling identifier cannot fill
+        the queue of its class.
+    A frame arriving at a full class queue is dropped as well.
+
+    The scheduler hands out one frame at a time with CAN_QOS_Peek and
+    releases it with CAN_QOS_Pop once the BLE stack accepted it, so a busy
+    stack delays the frames instead of losing them. The sender keeps going
+    until the stack is out of buffers, which fills the connection event
+    with the frames of the highest priority at that moment.
+*******************************************************************************/
+
+#ifndef _CAN_QOS_H
+#define _CAN_QOS_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "canfdspi/drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* Uncomment to schedule the CAN to BLE frames by class instead of in arrival order. */
+//#define CAN_QOS_ENABLE
+
+#define CAN_QOS_CLASS_NUM           4
+#define CAN_QOS_STRICT_NUM          1       /* Classes served by strict priority */
+#define CAN_QOS_CLASS_DEFAULT       2       /* Class of the identifiers outside every range */
+#define CAN_QOS_QUEUE_LEN           16      /* Frames per class, power of 2 */
+#define CAN_QOS_RANGE_NUM           8
+#define CAN_QOS_ID_LIMIT_NUM        8       /* Identifiers with their own rate limit */
+#define CAN_QOS_QUANTUM_BYTES       20      /* Per weight unit, the largest data PDU */
+#define CAN_QOS_RETRY_MS            10      /* BLE send retry while the stack is out of buffers */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct CAN_QOS_Stats_T
+{
+    uint32_t    queued;
+    uint32_t    sent;
+    uint32_t    dropped;                /* Class queue full, or flushed without a link */
+    uint32_t    policed;                /* Over the rate limit of the identifier */
+    uint32_t    shaped;                 /* Held back by the rate limit of the class */
+    uint16_t    latencyMaxMs;           /* Longest time a frame spent in the queue */
+    uint8_t     depthMax;
+} CAN_QOS_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_QOS_Init(void)
+
+  Summary:
+    Empties the queues and the tables and sets the default weights, without
+    rate limits.
+*/
+void CAN_QOS_Init(void);
+
+/*******************************************************************************
+  Function:
+    bool CAN_QOS_RangeAdd(uint32_t first, uint32_t last, bool extended, uint8_t cls)
+
+  Summary:
+    Assigns the identifiers first to last of one format to a class. The
+    first matching range wins.
+
+  Returns:
+    true  - Range added.
+    false - Range table full or invalid arguments.
+*/
+bool CAN_QOS_RangeAdd(uint32_t first, uint32_t last, bool extended, uint8_t cls);
+
+/*******************************************************************************
+  Function:
+    bool CAN_QOS_WeightSet(uint8_t cls, uint8_t weight)
+
+  Summary:
+    Sets the round robin weight of a class at or above CAN_QOS_STRICT_NUM.
+
+  Returns:
+    true  - Weight set.
+    false - Strict priority class, or a weight of 0.
+*/
+bool CAN_QOS_WeightSet(uint8_t cls, uint8_t weight);
+
+/*******************************************************************************
+  Function:
+    bool CAN_QOS_ClassRateSet(uint8_t cls, uint16_t framesPerSec, uint16_t burst)
+
+  Summary:
+    Shapes a class to framesPerSec with bursts of up to burst frames, a rate
+    of 0 removes the limit.
+
+  Returns:
+    true  - Limit set.
+    false - Invalid class.
+*/
+bool CAN_QOS_ClassRateSet(uint8_t cls, uint16_t framesPerSec, uint16_t burst);
+
+/*******************************************************************************
+  Function:
+    bool CAN_QOS_IdRateSet(uint32_t id, bool extended, uint16_t framesPerSec,
+                           uint16_t burst)
+
+  Summary:
+    Polices one identifier to framesPerSec with bursts of up to burst
+    frames, a rate of 0 removes the limit.
+
+  Returns:
+    true  - Limit set.
+    false - Table full.
+*/
+bool CAN_QOS_IdRateSet(uint32_t id, bool extended, uint16_t framesPerSec, uint16_t burst);
+
+/*******************************************************************************
+  Function:
+    void CAN_QOS_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+
+  Summary:
+    Queues a received frame in its class, or counts it as policed or
+    dropped.
+*/
+void CAN_QOS_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    bool CAN_QOS_Peek(CAN_RX_MSGOBJ *p_obj, uint8_t *p_data, uint16_t *p_waitMs)
+
+  Summary:
+    Selects the next frame to send and copies it, 8 bytes of data at most.
+
+  Returns:
+    true  - Frame copied, CAN_QOS_Pop() releases it once sent.
+    false - No frame may be sent now. *p_waitMs is the time until a rate
+            limit lets the next one go, OSAL_WAIT_FOREVER when the queues
+            are empty.
+*/
+bool CAN_QOS_Peek(CAN_RX_MSGOBJ *p_obj, uint8_t *p_data, uint16_t *p_waitMs);
+
+/*******************************************************************************
+  Function:
+    void CAN_QOS_Pop(void)
+
+  Summary:
+    Releases the frame returned by the last CAN_QOS_Peek().
+*/
+void CAN_QOS_Pop(void);
+
+/*******************************************************************************
+  Function:
+    void CAN_QOS_Flush(void)
+
+  Summary:
+    Drops the queued frames, called while no BLE link is connected.
+*/
+void CAN_QOS_Flush(void);
+
+/*******************************************************************************
+  Function:
+    const CAN_QOS_Stats_T *CAN_QOS_StatsGet(uint8_t cls)
+
+  Summary:
+    Returns the counters of a class since CAN_QOS_Init, NULL for an invalid
+    class.
+*/
+const CAN_QOS_Stats_T *CAN_QOS_StatsGet(uint8_t cls);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _CAN_QOS_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,191 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Trace Replay Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_replay.c
+
+  Summary:
+    Replays a recorded CAN trace through the bridge on the device.
+
+  Description:
+    See can_replay.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include "definitions.h"
+#include "can_replay.h"
+
+#ifdef CAN_REPLAY_ENABLE
+
+#include "can_replay_trace.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+static CAN_REPLAY_TxFunc_T  s_replayTx;
+static bool                 s_replayRunning;
+static uint16_t             s_replaySpeedup;
+static TickType_t           s_replayStartTick;  /* Tick of trace time 0 */
+static uint32_t             s_replayIndex;
+static uint32_t             s_replayLoop;
+static uint32_t             s_replaySent;
+static uint32_t             s_replayRetries;    /* Calls that found the TX FIFO full */
+static uint32_t             s_replayMaxLagMs;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Trace time reached at tick now, in us. */
+static uint64_t CAN_REPLAY_TraceNowUs(TickType_t now)
+{
+    return (uint64_t)((now - s_replayStartTick) * portTICK_PERIOD_MS) * 1000U * s_replaySpeedup;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_REPLAY_Init(CAN_REPLAY_TxFunc_T txFunc)
+{
+    s_replayTx = txFunc;
+    s_replayRunning = false;
+}
+
+bool CAN_REPLAY_Start(uint16_t speedup, uint32_t delayMs)
+{
+    if ((s_replayTx == NULL) || (CAN_REPLAY_TRACE_NUM == 0) || (speedup == 0))
+    {
+        return false;
+    }
+
+    s_replaySpeedup = speedup;
+    s_replayStartTick = xTaskGetTickCount() + (TickType_t)(delayMs / portTICK_PERIOD_MS);
+    s_replayIndex = 0;
+    s_replayLoop = 0;
+    s_replaySent = 0;
+    s_replayRetries = 0;
+    s_replayMaxLagMs = 0;
+    s_replayRunning = true;
+
+    SYS_CONSOLE_PRINT("[REPLAY] %lu frames, %lu ms, x%u, start in %lu ms\r\n",
+        (unsigned long)CAN_REPLAY_TRACE_NUM, (unsigned long)(s_replayTrace[CAN_REPLAY_TRACE_NUM - 1].timeUs / 1000U),
+        speedup, (unsigned long)delayMs);
+    return true;
+}
+
+void CAN_REPLAY_Stop(void)
+{
+    if (!s_replayRunning)
+    {
+        return;
+    }
+    s_replayRunning = false;
+
+    SYS_CONSOLE_PRINT("[REPLAY] done, %lu frames in %lu loop(s), %lu TX FIFO retries, max lag %lu ms\r\n",
+        (unsigned long)s_replaySent, (unsigned long)s_replayLoop, (unsigned long)s_replayRetries,
+        (unsigned long)s_replayMaxLagMs);
+}
+
+uint16_t CAN_REPLAY_Tasks(uint16_t waitMs)
+{
+    const CAN_REPLAY_Frame_T *p_frame;
+    TickType_t now;
+    uint64_t traceUs;
+    uint32_t ms;
+
+    if (!s_replayRunning)
+    {
+        return waitMs;
+    }
+
+    now = xTaskGetTickCount();
+    if ((int32_t)(now - s_replayStartTick) < 0)
+    {
+        ms = (uint32_t)(s_replayStartTick - now) * portTICK_PERIOD_MS;
+        return (ms < waitMs) ? (uint16_t)ms : waitMs;
+    }
+
+    traceUs = CAN_REPLAY_TraceNowUs(now);
+    while (s_replayIndex < CAN_REPLAY_TRACE_NUM)
+    {
+        p_frame = &s_replayTrace[s_replayIndex];
+        if (p_frame->timeUs > traceUs)
+        {
+            ms = (uint32_t)((p_frame->timeUs - traceUs) / (1000U * s_replaySpeedup));
+            if (ms == 0)
+            {
+                ms = 1;
+            }
+            return (ms < waitMs) ? (uint16_t)ms : waitMs;
+        }
+        if (!s_replayTx(p_frame))
+        {
+            s_replayRetries++;
+            return 1;
+        }
+
+        ms = (uint32_t)((traceUs - p_frame->timeUs) / (1000U * s_replaySpeedup));
+        if (ms > s_replayMaxLagMs)
+        {
+            s_replayMaxLagMs = ms;
+        }
+        s_replaySent++;
+        s_replayIndex++;
+    }
+
+    s_replayLoop++;
+    if ((CAN_REPLAY_LOOPS != 0) && (s_replayLoop >= CAN_REPLAY_LOOPS))
+    {
+        CAN_REPLAY_Stop();
+        return waitMs;
+    }
+    s_replayIndex = 0;
+    s_replayStartTick = now + 1;
+    return 1;
+}
+
+#endif /* CAN_REPLAY_ENABLE */
+
+/*******************************************************************************
+ End of File
+ */
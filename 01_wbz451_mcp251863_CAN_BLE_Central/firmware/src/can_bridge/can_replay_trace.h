@@ -0,0 +1,226 @@
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+/*******************************************************************************
+  CAN Bridge Replay Trace
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_replay_trace.h
+
+  Summary:
+    Trace played by can_replay.c.
+
+  Description:
+    Generated by "tools/can_replay.py header" from example.log,
+    170 frames over 0.990 s. Included by can_replay.c only.
+*******************************************************************************/
+
+#ifndef _CAN_REPLAY_TRACE_H
+#define _CAN_REPLAY_TRACE_H
+
+#define CAN_REPLAY_TRACE_NUM        170U
+
+static const CAN_REPLAY_Frame_T s_replayTrace[CAN_REPLAY_TRACE_NUM] =
+{
+    {          0, 0x000000DA, 0x07, { 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0xA5 } },
+    {        900, 0x00000123, 0x03, { 0x03, 0xE8, 0x00 } },
+    {       5100, 0x000007E8, 0x04, { 0x03, 0x41, 0x0C, 0x00 } },
+    {       6900, 0x18FEF100, 0x18, { 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF } },
+    {      10000, 0x000000DA, 0x07, { 0x01, 0x03, 0x00, 0x00, 0x41, 0x00, 0xA5 } },
+    {      20000, 0x000000DA, 0x07, { 0x02, 0x06, 0x00, 0x00, 0x42, 0x00, 0xA5 } },
+    {      20900, 0x00000123, 0x03, { 0x03, 0xEF, 0x01 } },
+    {      30000, 0x000000DA, 0x07, { 0x03, 0x09, 0x00, 0x00, 0x43, 0x00, 0xA5 } },
+    {      40000, 0x000000DA, 0x07, { 0x04, 0x0C, 0x00, 0x00, 0x44, 0x00, 0xA5 } },
+    {      40900, 0x00000123, 0x03, { 0x03, 0xF6, 0x02 } },
+    {      50000, 0x000000DA, 0x07, { 0x05, 0x0F, 0x00, 0x00, 0x45, 0x00, 0xA5 } },
+    {      60000, 0x000000DA, 0x07, { 0x06, 0x12, 0x00, 0x00, 0x46, 0x00, 0xA5 } },
+    {      60900, 0x00000123, 0x03, { 0x03, 0xFD, 0x03 } },
+    {      70000, 0x000000DA, 0x07, { 0x07, 0x15, 0x00, 0x00, 0x47, 0x00, 0xA5 } },
+    {      80000, 0x000000DA, 0x07, { 0x08, 0x18, 0x00, 0x00, 0x48, 0x00, 0xA5 } },
+    {      80900, 0x00000123, 0x03, { 0x04, 0x04, 0x04 } },
+    {      90000, 0x000000DA, 0x07, { 0x09, 0x1B, 0x00, 0x00, 0x49, 0x00, 0xA5 } },
+    {     100000, 0x000000DA, 0x07, { 0x0A, 0x1E, 0x00, 0x00, 0x4A, 0x00, 0xA5 } },
+    {     100900, 0x00000123, 0x03, { 0x04, 0x0B, 0x05 } },
+    {     105100, 0x000007E8, 0x04, { 0x03, 0x41, 0x0C, 0x09 } },
+    {     106900, 0x18FEF100, 0x18, { 0xFF, 0x01, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF } },
+    {     110000, 0x000000DA, 0x07, { 0x0B, 0x21, 0x00, 0x00, 0x4B, 0x00, 0xA5 } },
+    {     120000, 0x000000DA, 0x07, { 0x0C, 0x24, 0x00, 0x00, 0x4C, 0x00, 0xA5 } },
+    {     120900, 0x00000123, 0x03, { 0x04, 0x12, 0x06 } },
+    {     130000, 0x000000DA, 0x07, { 0x0D, 0x27, 0x00, 0x00, 0x4D, 0x00, 0xA5 } },
+    {     140000, 0x000000DA, 0x07, { 0x0E, 0x2A, 0x00, 0x00, 0x4E, 0x00, 0xA5 } },
+    {     140900, 0x00000123, 0x03, { 0x04, 0x19, 0x07 } },
+    {     150000, 0x000000DA, 0x07, { 0x0F, 0x2D, 0x00, 0x00, 0x4F, 0x00, 0xA5 } },
+    {     160000, 0x000000DA, 0x07, { 0x10, 0x30, 0x00, 0x00, 0x50, 0x00, 0xA5 } },
+    {     160900, 0x00000123, 0x03, { 0x04, 0x20, 0x08 } },
+    {     170000, 0x000000DA, 0x07, { 0x11, 0x33, 0x00, 0x00, 0x51, 0x00, 0xA5 } },
+    {     180000, 0x000000DA, 0x07, { 0x12, 0x36, 0x00, 0x00, 0x52, 0x00, 0xA5 } },
+    {     180900, 0x00000123, 0x03, { 0x04, 0x27, 0x09 } },
+    {     190000, 0x000000DA, 0x07, { 0x13, 0x39, 0x00, 0x00, 0x53, 0x00, 0xA5 } },
+    {     200000, 0x000000DA, 0x07, { 0x14, 0x3C, 0x00, 0x00, 0x54, 0x00, 0xA5 } },
+    {     200900, 0x00000123, 0x03, { 0x04, 0x2E, 0x0A } },
+    {     205100, 0x000007E8, 0x04, { 0x03, 0x41, 0x0C, 0x12 } },
+    {     206900, 0x18FEF100, 0x18, { 0xFF, 0x02, 0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF } },
+    {     210000, 0x000000DA, 0x07, { 0x15, 0x3F, 0x00, 0x00, 0x55, 0x00, 0xA5 } },
+    {     220000, 0x000000DA, 0x07, { 0x16, 0x42, 0x00, 0x00, 0x56, 0x00, 0xA5 } },
+    {     220900, 0x00000123, 0x03, { 0x04, 0x35, 0x0B } },
+    {     230000, 0x000000DA, 0x07, { 0x17, 0x45, 0x00, 0x00, 0x57, 0x00, 0xA5 } },
+    {     240000, 0x000000DA, 0x07, { 0x18, 0x48, 0x00, 0x00, 0x58, 0x00, 0xA5 } },
+    {     240900, 0x00000123, 0x03, { 0x04, 0x3C, 0x0C } },
+    {     250000, 0x000000DA, 0x07, { 0x19, 0x4B, 0x00, 0x00, 0x59, 0x00, 0xA5 } },
+    {     260000, 0x000000DA, 0x07, { 0x1A, 0x4E, 0x00, 0x00, 0x5A, 0x00, 0xA5 } },
+    {     260900, 0x00000123, 0x03, { 0x04, 0x43, 0x0D } },
+    {     270000, 0x000000DA, 0x07, { 0x1B, 0x51, 0x00, 0x00, 0x5B, 0x00, 0xA5 } },
+    {     280000, 0x000000DA, 0x07, { 0x1C, 0x54, 0x00, 0x00, 0x5C, 0x00, 0xA5 } },
+    {     280900, 0x00000123, 0x03, { 0x04, 0x4A, 0x0E } },
+    {     290000, 0x000000DA, 0x07, { 0x1D, 0x57, 0x00, 0x00, 0x5D, 0x00, 0xA5 } },
+    {     300000, 0x000000DA, 0x07, { 0x1E, 0x5A, 0x00, 0x00, 0x5E, 0x00, 0xA5 } },
+    {     300900, 0x00000123, 0x03, { 0x04, 0x51, 0x0F } },
+    {     305100, 0x000007E8, 0x04, { 0x03, 0x41, 0x0C, 0x1B } },
+    {     306900, 0x18FEF100, 0x18, { 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF } },
+    {     310000, 0x000000DA, 0x07, { 0x1F, 0x5D, 0x00, 0x00, 0x5F, 0x00, 0xA5 } },
+    {     320000, 0x000000DA, 0x07, { 0x20, 0x60, 0x00, 0x00, 0x60, 0x00, 0xA5 } },
+    {     320900, 0x00000123, 0x03, { 0x04, 0x58, 0x00 } },
+    {     330000, 0x000000DA, 0x07, { 0x21, 0x63, 0x00, 0x00, 0x61, 0x00, 0xA5 } },
+    {     340000, 0x000000DA, 0x07, { 0x22, 0x66, 0x00, 0x00, 0x62, 0x00, 0xA5 } },
+    {     340900, 0x00000123, 0x03, { 0x04, 0x5F, 0x01 } },
+    {     350000, 0x000000DA, 0x07, { 0x23, 0x69, 0x00, 0x00, 0x63, 0x00, 0xA5 } },
+    {     360000, 0x000000DA, 0x07, { 0x24, 0x6C, 0x00, 0x00, 0x64, 0x00, 0xA5 } },
+    {     360900, 0x00000123, 0x03, { 0x04, 0x66, 0x02 } },
+    {     370000, 0x000000DA, 0x07, { 0x25, 0x6F, 0x00, 0x00, 0x65, 0x00, 0xA5 } },
+    {     380000, 0x000000DA, 0x07, { 0x26, 0x72, 0x00, 0x00, 0x66, 0x00, 0xA5 } },
+    {     380900, 0x00000123, 0x03, { 0x04, 0x6D, 0x03 } },
+    {     390000, 0x000000DA, 0x07, { 0x27, 0x75, 0x00, 0x00, 0x67, 0x00, 0xA5 } },
+    {     400000, 0x000000DA, 0x07, { 0x28, 0x78, 0x00, 0x00, 0x68, 0x00, 0xA5 } },
+    {     400900, 0x00000123, 0x03, { 0x04, 0x74, 0x04 } },
+    {     405100, 0x000007E8, 0x04, { 0x03, 0x41, 0x0C, 0x24 } },
+    {     406900, 0x18FEF100, 0x18, { 0xFF, 0x04, 0x04, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF } },
+    {     410000, 0x000000DA, 0x07, { 0x29, 0x7B, 0x00, 0x00, 0x69, 0x00, 0xA5 } },
+    {     420000, 0x000000DA, 0x07, { 0x2A, 0x7E, 0x00, 0x00, 0x6A, 0x00, 0xA5 } },
+    {     420900, 0x00000123, 0x03, { 0x04, 0x7B, 0x05 } },
+    {     430000, 0x000000DA, 0x07, { 0x2B, 0x81, 0x00, 0x00, 0x6B, 0x00, 0xA5 } },
+    {     440000, 0x000000DA, 0x07, { 0x2C, 0x84, 0x00, 0x00, 0x6C, 0x00, 0xA5 } },
+    {     440900, 0x00000123, 0x03, { 0x04, 0x82, 0x06 } },
+    {     450000, 0x000000DA, 0x07, { 0x2D, 0x87, 0x00, 0x00, 0x6D, 0x00, 0xA5 } },
+    {     460000, 0x000000DA, 0x07, { 0x2E, 0x8A, 0x00, 0x00, 0x6E, 0x00, 0xA5 } },
+    {     460900, 0x00000123, 0x03, { 0x04, 0x89, 0x07 } },
+    {     470000, 0x000000DA, 0x07, { 0x2F, 0x8D, 0x00, 0x00, 0x6F, 0x00, 0xA5 } },
+    {     480000, 0x000000DA, 0x07, { 0x30, 0x90, 0x00, 0x00, 0x70, 0x00, 0xA5 } },
+    {     480900, 0x00000123, 0x03, { 0x04, 0x90, 0x08 } },
+    {     490000, 0x000000DA, 0x07, { 0x31, 0x93, 0x00, 0x00, 0x71, 0x00, 0xA5 } },
+    {     500000, 0x000000DA, 0x07, { 0x32, 0x96, 0x00, 0x00, 0x72, 0x00, 0xA5 } },
+    {     500900, 0x00000123, 0x03, { 0x04, 0x97, 0x09 } },
+    {     505100, 0x000007E8, 0x04, { 0x03, 0x41, 0x0C, 0x2D } },
+    {     506900, 0x18FEF100, 0x18, { 0xFF, 0x05, 0x05, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF } },
+    {     510000, 0x000000DA, 0x07, { 0x33, 0x99, 0x00, 0x00, 0x73, 0x00, 0xA5 } },
+    {     520000, 0x000000DA, 0x07, { 0x34, 0x9C, 0x00, 0x00, 0x74, 0x00, 0xA5 } },
+    {     520900, 0x00000123, 0x03, { 0x04, 0x9E, 0x0A } },
+    {     530000, 0x000000DA, 0x07, { 0x35, 0x9F, 0x00, 0x00, 0x75, 0x00, 0xA5 } },
+    {     540000, 0x000000DA, 0x07, { 0x36, 0xA2, 0x00, 0x00, 0x76, 0x00, 0xA5 } },
+    {     540900, 0x00000123, 0x03, { 0x04, 0xA5, 0x0B } },
+    {     550000, 0x000000DA, 0x07, { 0x37, 0xA5, 0x00, 0x00, 0x77, 0x00, 0xA5 } },
+    {     560000, 0x000000DA, 0x07, { 0x38, 0xA8, 0x00, 0x00, 0x78, 0x00, 0xA5 } },
+    {     560900, 0x00000123, 0x03, { 0x04, 0xAC, 0x0C } },
+    {     570000, 0x000000DA, 0x07, { 0x39, 0xAB, 0x00, 0x00, 0x79, 0x00, 0xA5 } },
+    {     580000, 0x000000DA, 0x07, { 0x3A, 0xAE, 0x00, 0x00, 0x7A, 0x00, 0xA5 } },
+    {     580900, 0x00000123, 0x03, { 0x04, 0xB3, 0x0D } },
+    {     590000, 0x000000DA, 0x07, { 0x3B, 0xB1, 0x00, 0x00, 0x7B, 0x00, 0xA5 } },
+    {     600000, 0x000000DA, 0x07, { 0x3C, 0xB4, 0x00, 0x00, 0x7C, 0x00, 0xA5 } },
+    {     600900, 0x00000123, 0x03, { 0x04, 0xBA, 0x0E } },
+    {     605100, 0x000007E8, 0x04, { 0x03, 0x41, 0x0C, 0x36 } },
+    {     606900, 0x18FEF100, 0x18, { 0xFF, 0x06, 0x06, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF } },
+    {     610000, 0x000000DA, 0x07, { 0x3D, 0xB7, 0x00, 0x00, 0x7D, 0x00, 0xA5 } },
+    {     620000, 0x000000DA, 0x07, { 0x3E, 0xBA, 0x00, 0x00, 0x7E, 0x00, 0xA5 } },
+    {     620900, 0x00000123, 0x03, { 0x04, 0xC1, 0x0F } },
+    {     630000, 0x000000DA, 0x07, { 0x3F, 0xBD, 0x00, 0x00, 0x7F, 0x00, 0xA5 } },
+    {     640000, 0x000000DA, 0x07, { 0x40, 0xC0, 0x00, 0x00, 0x80, 0x00, 0xA5 } },
+    {     640900, 0x00000123, 0x03, { 0x04, 0xC8, 0x00 } },
+    {     650000, 0x000000DA, 0x07, { 0x41, 0xC3, 0x00, 0x00, 0x81, 0x00, 0xA5 } },
+    {     660000, 0x000000DA, 0x07, { 0x42, 0xC6, 0x00, 0x00, 0x82, 0x00, 0xA5 } },
+    {     660900, 0x00000123, 0x03, { 0x04, 0xCF, 0x01 } },
+    {     670000, 0x000000DA, 0x07, { 0x43, 0xC9, 0x00, 0x00, 0x83, 0x00, 0xA5 } },
+    {     680000, 0x000000DA, 0x07, { 0x44, 0xCC, 0x00, 0x00, 0x84, 0x00, 0xA5 } },
+    {     680900, 0x00000123, 0x03, { 0x04, 0xD6, 0x02 } },
+    {     690000, 0x000000DA, 0x07, { 0x45, 0xCF, 0x00, 0x00, 0x85, 0x00, 0xA5 } },
+    {     700000, 0x000000DA, 0x07, { 0x46, 0xD2, 0x00, 0x00, 0x86, 0x00, 0xA5 } },
+    {     700900, 0x00000123, 0x03, { 0x04, 0xDD, 0x03 } },
+    {     705100, 0x000007E8, 0x04, { 0x03, 0x41, 0x0C, 0x3F } },
+    {     706900, 0x18FEF100, 0x18, { 0xFF, 0x07, 0x07, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF } },
+    {     710000, 0x000000DA, 0x07, { 0x47, 0xD5, 0x00, 0x00, 0x87, 0x00, 0xA5 } },
+    {     720000, 0x000000DA, 0x07, { 0x48, 0xD8, 0x00, 0x00, 0x88, 0x00, 0xA5 } },
+    {     720900, 0x00000123, 0x03, { 0x04, 0xE4, 0x04 } },
+    {     730000, 0x000000DA, 0x07, { 0x49, 0xDB, 0x00, 0x00, 0x89, 0x00, 0xA5 } },
+    {     740000, 0x000000DA, 0x07, { 0x4A, 0xDE, 0x00, 0x00, 0x8A, 0x00, 0xA5 } },
+    {     740900, 0x00000123, 0x03, { 0x04, 0xEB, 0x05 } },
+    {     750000, 0x000000DA, 0x07, { 0x4B, 0xE1, 0x00, 0x00, 0x8B, 0x00, 0xA5 } },
+    {     760000, 0x000000DA, 0x07, { 0x4C, 0xE4, 0x00, 0x00, 0x8C, 0x00, 0xA5 } },
+    {     760900, 0x00000123, 0x03, { 0x04, 0xF2, 0x06 } },
+    {     770000, 0x000000DA, 0x07, { 0x4D, 0xE7, 0x00, 0x00, 0x8D, 0x00, 0xA5 } },
+    {     780000, 0x000000DA, 0x07, { 0x4E, 0xEA, 0x00, 0x00, 0x8E, 0x00, 0xA5 } },
+    {     780900, 0x00000123, 0x03, { 0x04, 0xF9, 0x07 } },
+    {     790000, 0x000000DA, 0x07, { 0x4F, 0xED, 0x00, 0x00, 0x8F, 0x00, 0xA5 } },
+    {     800000, 0x000000DA, 0x07, { 0x50, 0xF0, 0x00, 0x00, 0x90, 0x00, 0xA5 } },
+    {     800900, 0x00000123, 0x03, { 0x05, 0x00, 0x08 } },
+    {     805100, 0x000007E8, 0x04, { 0x03, 0x41, 0x0C, 0x48 } },
+    {     806900, 0x18FEF100, 0x18, { 0xFF, 0x08, 0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF } },
+    {     810000, 0x000000DA, 0x07, { 0x51, 0xF3, 0x00, 0x00, 0x91, 0x00, 0xA5 } },
+    {     820000, 0x000000DA, 0x07, { 0x52, 0xF6, 0x00, 0x00, 0x92, 0x00, 0xA5 } },
+    {     820900, 0x00000123, 0x03, { 0x05, 0x07, 0x09 } },
+    {     830000, 0x000000DA, 0x07, { 0x53, 0xF9, 0x00, 0x00, 0x93, 0x00, 0xA5 } },
+    {     840000, 0x000000DA, 0x07, { 0x54, 0xFC, 0x00, 0x00, 0x94, 0x00, 0xA5 } },
+    {     840900, 0x00000123, 0x03, { 0x05, 0x0E, 0x0A } },
+    {     850000, 0x000000DA, 0x07, { 0x55, 0xFF, 0x00, 0x00, 0x95, 0x00, 0xA5 } },
+    {     860000, 0x000000DA, 0x07, { 0x56, 0x02, 0x00, 0x00, 0x96, 0x00, 0xA5 } },
+    {     860900, 0x00000123, 0x03, { 0x05, 0x15, 0x0B } },
+    {     870000, 0x000000DA, 0x07, { 0x57, 0x05, 0x00, 0x00, 0x97, 0x00, 0xA5 } },
+    {     880000, 0x000000DA, 0x07, { 0x58, 0x08, 0x00, 0x00, 0x98, 0x00, 0xA5 } },
+    {     880900, 0x00000123, 0x03, { 0x05, 0x1C, 0x0C } },
+    {     890000, 0x000000DA, 0x07, { 0x59, 0x0B, 0x00, 0x00, 0x99, 0x00, 0xA5 } },
+    {     900000, 0x000000DA, 0x07, { 0x5A, 0x0E, 0x00, 0x00, 0x9A, 0x00, 0xA5 } },
+    {     900900, 0x00000123, 0x03, { 0x05, 0x23, 0x0D } },
+    {     905100, 0x000007E8, 0x04, { 0x03, 0x41, 0x0C, 0x51 } },
+    {     906900, 0x18FEF100, 0x18, { 0xFF, 0x09, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF } },
+    {     910000, 0x000000DA, 0x07, { 0x5B, 0x11, 0x00, 0x00, 0x9B, 0x00, 0xA5 } },
+    {     920000, 0x000000DA, 0x07, { 0x5C, 0x14, 0x00, 0x00, 0x9C, 0x00, 0xA5 } },
+    {     920900, 0x00000123, 0x03, { 0x05, 0x2A, 0x0E } },
+    {     930000, 0x000000DA, 0x07, { 0x5D, 0x17, 0x00, 0x00, 0x9D, 0x00, 0xA5 } },
+    {     940000, 0x000000DA, 0x07, { 0x5E, 0x1A, 0x00, 0x00, 0x9E, 0x00, 0xA5 } },
+    {     940900, 0x00000123, 0x03, { 0x05, 0x31, 0x0F } },
+    {     950000, 0x000000DA, 0x07, { 0x5F, 0x1D, 0x00, 0x00, 0x9F, 0x00, 0xA5 } },
+    {     960000, 0x000000DA, 0x07, { 0x60, 0x20, 0x00, 0x00, 0xA0, 0x00, 0xA5 } },
+    {     960900, 0x00000123, 0x03, { 0x05, 0x38, 0x00 } },
+    {     970000, 0x000000DA, 0x07, { 0x61, 0x23, 0x00, 0x00, 0xA1, 0x00, 0xA5 } },
+    {     980000, 0x000000DA, 0x07, { 0x62, 0x26, 0x00, 0x00, 0xA2, 0x00, 0xA5 } },
+    {     980900, 0x00000123, 0x03, { 0x05, 0x3F, 0x01 } },
+    {     990000, 0x000000DA, 0x07, { 0x63, 0x29, 0x00, 0x00, 0xA3, 0x00, 0xA5 } },
+};
+
+#endif /* _CAN_REPLAY_TRACE_H */
+
+/*******************************************************************************
+ End of File
+ */
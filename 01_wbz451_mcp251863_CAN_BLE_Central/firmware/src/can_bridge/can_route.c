@@ -0,0 +1,300 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Routing Table Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_route.c
+
+  Summary:
+    CAN identifier to BLE link routing table.
+
+  Description:
+    See can_route.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "can_route.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+
+#define CAN_ROUTE_STD_MAP_WORDS     (CAN_ROUTE_STD_ID_NUM / 32)
+
+typedef struct
+{
+    uint32_t                stdMap[CAN_ROUTE_MAX_LINKS][CAN_ROUTE_STD_MAP_WORDS];
+    CAN_ROUTE_ExtEntry_T    extTable[CAN_ROUTE_EXT_MAX_ENTRIES];
+    uint8_t                 extNum;
+    CAN_ROUTE_LinkSet_T     extDefault;
+} CAN_ROUTE_Table_T;
+
+static CAN_ROUTE_Table_T s_route;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Returns the index of the first entry whose idLow is greater than id. */
+static uint8_t can_route_ExtUpperBound(uint32_t id)
+{
+    uint8_t low = 0;
+    uint8_t high = s_route.extNum;
+
+    while (low < high)
+    {
+        uint8_t mid = (uint8_t)((low + high) >> 1);
+
+        if (s_route.extTable[mid].idLow <= id)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_ROUTE_Init(CAN_ROUTE_LinkSet_T defaultLinks)
+{
+    uint8_t link;
+
+    memset(&s_route, 0, sizeof(s_route));
+    for (link = 0; link < CAN_ROUTE_MAX_LINKS; link++)
+    {
+        if (defaultLinks & CAN_ROUTE_LINK(link))
+        {
+            memset(s_route.stdMap[link], 0xFF, sizeof(s_route.stdMap[link]));
+        }
+    }
+    s_route.extDefault = defaultLinks;
+}
+
+bool CAN_ROUTE_StdRouteSet(uint16_t idLow, uint16_t idHigh, uint16_t mask, uint16_t match, CAN_ROUTE_LinkSet_T links)
+{
+    uint16_t id;
+    uint8_t link;
+
+    if ((idLow > idHigh) || (idHigh > CAN_ROUTE_STD_ID_MAX))
+    {
+        return false;
+    }
+
+    for (id = idLow; id <= idHigh; id++)
+    {
+        if ((id & mask) != (match & mask))
+        {
+            continue;
+        }
+
+        for (link = 0; link < CAN_ROUTE_MAX_LINKS; link++)
+        {
+            if (links & CAN_ROUTE_LINK(link))
+            {
+                s_route.stdMap[link][id >> 5] |= (1UL << (id & 0x1F));
+            }
+            else
+            {
+                s_route.stdMap[link][id >> 5] &= ~(1UL << (id & 0x1F));
+            }
+        }
+    }
+    return true;
+}
+
+bool CAN_ROUTE_ExtRouteAdd(const CAN_ROUTE_ExtEntry_T *p_entry)
+{
+    uint8_t pos;
+
+    if ((p_entry->idLow > p_entry->idHigh) || (p_entry->idHigh > CAN_ROUTE_EXT_ID_MAX)
+        || (s_route.extNum >= CAN_ROUTE_EXT_MAX_ENTRIES))
+    {
+        return false;
+    }
+
+    pos = can_route_ExtUpperBound(p_entry->idLow);
+
+    // Reject overlap with the preceding or following range
+    if ((pos > 0) && (s_route.extTable[pos - 1].idHigh >= p_entry->idLow))
+    {
+        return false;
+    }
+    if ((pos < s_route.extNum) && (s_route.extTable[pos].idLow <= p_entry->idHigh))
+    {
+        return false;
+    }
+
+    memmove(&s_route.extTable[pos + 1], &s_route.extTable[pos], (s_route.extNum - pos) * sizeof(CAN_ROUTE_ExtEntry_T));
+    s_route.extTable[pos] = *p_entry;
+    s_route.extNum++;
+    return true;
+}
+
+bool CAN_ROUTE_ExtRouteRemove(uint32_t idLow)
+{
+    uint8_t pos = can_route_ExtUpperBound(idLow);
+
+    if ((pos == 0) || (s_route.extTable[pos - 1].idLow != idLow))
+    {
+        return false;
+    }
+    pos--;
+    memmove(&s_route.extTable[pos], &s_route.extTable[pos + 1], (s_route.extNum - pos - 1) * sizeof(CAN_ROUTE_ExtEntry_T));
+    s_route.extNum--;
+    return true;
+}
+
+CAN_ROUTE_LinkSet_T CAN_ROUTE_Lookup(uint32_t id, bool extended)
+{
+    CAN_ROUTE_LinkSet_T links = CAN_ROUTE_LINK_NONE;
+
+    if (!extended)
+    {
+        uint32_t word = id >> 5;
+        uint32_t bit = 1UL << (id & 0x1F);
+        uint8_t link;
+
+        if (id > CAN_ROUTE_STD_ID_MAX)
+        {
+            return CAN_ROUTE_LINK_NONE;
+        }
+
+        for (link = 0; link < CAN_ROUTE_MAX_LINKS; link++)
+        {
+            if (s_route.stdMap[link][word] & bit)
+            {
+                links |= CAN_ROUTE_LINK(link);
+            }
+        }
+        return links;
+    }
+    else
+    {
+        uint8_t pos = can_route_ExtUpperBound(id);
+        const CAN_ROUTE_ExtEntry_T *p_entry;
+
+        if (pos == 0)
+        {
+            return s_route.extDefault;
+        }
+
+        p_entry = &s_route.extTable[pos - 1];
+        if ((id > p_entry->idHigh) || ((id & p_entry->mask) != (p_entry->match & p_entry->mask)))
+        {
+            return s_route.extDefault;
+        }
+        return p_entry->links;
+    }
+}
+
+CAN_ROUTE_LinkSet_T CAN_ROUTE_LookupRxObj(const CAN_RX_MSGOBJ *p_rxObj)
+{
+    if (p_rxObj->bF.ctrl.IDE)
+    {
+        return CAN_ROUTE_Lookup(CAN_ROUTE_ExtId(&p_rxObj->bF.id), true);
+    }
+    return CAN_ROUTE_Lookup(p_rxObj->bF.id.SID, false);
+}
+
+#ifdef CAN_ROUTE_ENABLE_BENCHMARK
+#define CAN_ROUTE_BENCH_LOOKUPS     1024
+
+static uint32_t can_route_BenchRun(bool extended, uint32_t idSpan)
+{
+    volatile CAN_ROUTE_LinkSet_T sink;
+    uint32_t start;
+    uint32_t i;
+
+    start = DWT->CYCCNT;
+    for (i = 0; i < CAN_ROUTE_BENCH_LOOKUPS; i++)
+    {
+        sink = CAN_ROUTE_Lookup((i * 7919U) % idSpan, extended);
+    }
+    (void)sink;
+    return (DWT->CYCCNT - start) / CAN_ROUTE_BENCH_LOOKUPS;
+}
+
+void CAN_ROUTE_Benchmark(void)
+{
+    static const uint8_t tableSizes[] = {1, 4, 8, 16, CAN_ROUTE_EXT_MAX_ENTRIES};
+    CAN_ROUTE_ExtEntry_T entry;
+    uint8_t i;
+    uint8_t n;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    SYS_CONSOLE_PRINT("[ROUTE] entries  std cyc/lookup  ext cyc/lookup\r\n");
+    for (i = 0; i < sizeof(tableSizes); i++)
+    {
+        uint32_t extSpan = (uint32_t)tableSizes[i] * 0x1000U;
+        uint32_t stdCycles;
+        uint32_t extCycles;
+
+        CAN_ROUTE_Init(CAN_ROUTE_LINK_NONE);
+        for (n = 0; n < tableSizes[i]; n++)
+        {
+            CAN_ROUTE_StdRouteSet(n * 64U, n * 64U + 31U, 0, 0, CAN_ROUTE_LINK(n % CAN_ROUTE_MAX_LINKS));
+
+            entry.idLow = (uint32_t)n * 0x1000U;
+            entry.idHigh = entry.idLow + 0x7FFU;
+            entry.mask = 0;
+            entry.match = 0;
+            entry.links = CAN_ROUTE_LINK(n % CAN_ROUTE_MAX_LINKS);
+            CAN_ROUTE_ExtRouteAdd(&entry);
+        }
+
+        stdCycles = can_route_BenchRun(false, CAN_ROUTE_STD_ID_NUM);
+        extCycles = can_route_BenchRun(true, extSpan);
+        SYS_CONSOLE_PRINT("[ROUTE] %7u  %14lu  %14lu\r\n", (unsigned)tableSizes[i], (unsigned long)stdCycles,
+                          (unsigned long)extCycles);
+    }
+
+    CAN_ROUTE_Init(CAN_ROUTE_LINK_ALL);
+}
+#endif
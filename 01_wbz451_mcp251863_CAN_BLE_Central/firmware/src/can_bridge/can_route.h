@@ -0,0 +1,224 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Routing Table Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_route.h
+
+  Summary:
+    CAN identifier to BLE link routing table.
+
+  Description:
+    Maps received CAN identifiers to the set of BLE links the frame is
+    forwarded to. Standard identifiers are resolved through one 2048-bit
+    bitmap per link, so the lookup cost does not depend on how many ranges
+    have been configured. Extended identifiers are resolved through a small
+    sorted table of non-overlapping ranges using binary search.
+*******************************************************************************/
+
+#ifndef _CAN_ROUTE_H
+#define _CAN_ROUTE_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "canfdspi/drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define CAN_ROUTE_MAX_LINKS             4       /* Number of BLE links a frame can be routed to */
+#define CAN_ROUTE_STD_ID_NUM            2048    /* 11-bit identifier space */
+#define CAN_ROUTE_STD_ID_MAX            0x7FF
+#define CAN_ROUTE_EXT_ID_MAX            0x1FFFFFFF
+#define CAN_ROUTE_EXT_MAX_ENTRIES       32      /* Extended identifier range table size */
+
+#define CAN_ROUTE_LINK_NONE             0x00
+#define CAN_ROUTE_LINK_ALL              ((CAN_ROUTE_LinkSet_T)((1U << CAN_ROUTE_MAX_LINKS) - 1U))
+#define CAN_ROUTE_LINK(idx)             ((CAN_ROUTE_LinkSet_T)(1U << (idx)))
+
+/* Uncomment to build CAN_ROUTE_Benchmark() */
+//#define CAN_ROUTE_ENABLE_BENCHMARK
+
+/* Set of BLE links, bit n set means the frame is forwarded on link n. */
+typedef uint8_t CAN_ROUTE_LinkSet_T;
+
+/* Extended identifier routing entry. A frame matches when its identifier lies
+   within [idLow, idHigh] and (id & mask) == (match & mask). */
+typedef struct
+{
+    uint32_t            idLow;
+    uint32_t            idHigh;
+    uint32_t            mask;
+    uint32_t            match;
+    CAN_ROUTE_LinkSet_T links;
+} CAN_ROUTE_ExtEntry_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_ROUTE_Init(CAN_ROUTE_LinkSet_T defaultLinks)
+
+  Summary:
+    Clears the routing table and sets the route used for unmatched extended
+    identifiers.
+
+  Description:
+    All standard identifiers are routed to defaultLinks after initialization.
+    Extended identifiers not covered by an entry are routed to defaultLinks.
+
+  Parameters:
+    defaultLinks - Link set used when no explicit route exists.
+
+  Returns:
+    None.
+*/
+void CAN_ROUTE_Init(CAN_ROUTE_LinkSet_T defaultLinks);
+
+/*******************************************************************************
+  Function:
+    bool CAN_ROUTE_StdRouteSet(uint16_t idLow, uint16_t idHigh, uint16_t mask,
+                               uint16_t match, CAN_ROUTE_LinkSet_T links)
+
+  Summary:
+    Routes a range of standard identifiers to a link set.
+
+  Description:
+    Every identifier in [idLow, idHigh] for which (id & mask) == (match & mask)
+    is routed to links, replacing its previous route. Use a mask of 0 to select
+    the whole range.
+
+  Returns:
+    true  - Route applied.
+    false - Invalid range.
+*/
+bool CAN_ROUTE_StdRouteSet(uint16_t idLow, uint16_t idHigh, uint16_t mask, uint16_t match, CAN_ROUTE_LinkSet_T links);
+
+/*******************************************************************************
+  Function:
+    bool CAN_ROUTE_ExtRouteAdd(const CAN_ROUTE_ExtEntry_T *p_entry)
+
+  Summary:
+    Inserts an extended identifier range into the sorted range table.
+
+  Returns:
+    true  - Entry added.
+    false - Invalid range, overlap with an existing entry or table full.
+*/
+bool CAN_ROUTE_ExtRouteAdd(const CAN_ROUTE_ExtEntry_T *p_entry);
+
+/*******************************************************************************
+  Function:
+    bool CAN_ROUTE_ExtRouteRemove(uint32_t idLow)
+
+  Summary:
+    Removes the extended identifier range starting at idLow.
+*/
+bool CAN_ROUTE_ExtRouteRemove(uint32_t idLow);
+
+/*******************************************************************************
+  Function:
+    CAN_ROUTE_LinkSet_T CAN_ROUTE_Lookup(uint32_t id, bool extended)
+
+  Summary:
+    Returns the link set a CAN identifier is forwarded to.
+
+  Parameters:
+    id       - 11-bit standard or 29-bit extended identifier.
+    extended - true when id is an extended identifier.
+*/
+CAN_ROUTE_LinkSet_T CAN_ROUTE_Lookup(uint32_t id, bool extended);
+
+/*******************************************************************************
+  Function:
+    CAN_ROUTE_LinkSet_T CAN_ROUTE_LookupRxObj(const CAN_RX_MSGOBJ *p_rxObj)
+
+  Summary:
+    Returns the link set for a message object read from the controller.
+*/
+CAN_ROUTE_LinkSet_T CAN_ROUTE_LookupRxObj(const CAN_RX_MSGOBJ *p_rxObj);
+
+/*******************************************************************************
+  Function:
+    uint32_t CAN_ROUTE_ExtId(const CAN_MSGOBJ_ID *p_id)
+
+  Summary:
+    Assembles the 29-bit identifier from the controller SID/EID fields.
+*/
+static inline uint32_t CAN_ROUTE_ExtId(const CAN_MSGOBJ_ID *p_id)
+{
+    return ((uint32_t)p_id->SID << 18) | (uint32_t)p_id->EID;
+}
+
+#ifdef CAN_ROUTE_ENABLE_BENCHMARK
+/*******************************************************************************
+  Function:
+    void CAN_ROUTE_Benchmark(void)
+
+  Summary:
+    Measures the lookup cost for growing table sizes using the DWT cycle
+    counter and prints the results on the console.
+
+  Remarks:
+    Destroys the current routing configuration.
+*/
+void CAN_ROUTE_Benchmark(void);
+#endif
+
+#endif /* _CAN_ROUTE_H */
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,525 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Bus Statistics Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_stats.c
+
+  Summary:
+    Bus load, per identifier rates and inter-arrival times, DLC histogram.
+
+  Description:
+    See can_stats.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "can_stats.h"
+
+#ifdef CAN_STATS_ENABLE
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+#define CAN_STATS_MS_TO_TICKS(ms)   ((TickType_t)(((ms) + portTICK_PERIOD_MS - 1U) / portTICK_PERIOD_MS))
+
+#define CAN_STATS_DLC_NUM           16
+#define CAN_STATS_HDR_BITS_STD      34      /* Stuffed part of the header and the CRC */
+#define CAN_STATS_HDR_BITS_EXT      54
+#define CAN_STATS_TRAILER_BITS      13      /* CRC delimiter, ACK, EOF, interframe space */
+#define CAN_STATS_KEY_STD           0x80000000UL    /* Sketch key of a standard ID, apart from the extended IDs */
+
+typedef struct CAN_STATS_Entry_T
+{
+    uint32_t    firstUs;
+    uint32_t    lastUs;
+    uint32_t    frames;
+    uint16_t    gapMax;                 /* In CAN_STATS_GAP_UNIT_US, saturated */
+} CAN_STATS_Entry_T;
+
+typedef struct CAN_STATS_ExtEntry_T
+{
+    uint32_t            id;
+    CAN_STATS_Entry_T   entry;
+} CAN_STATS_ExtEntry_T;
+
+/* Odd multipliers of the sketch row hashes */
+static const uint32_t s_statsHashMul[4] = { 0x9E3779B1UL, 0x85EBCA77UL, 0xC2B2AE3DUL, 0x27D4EB2FUL };
+
+static uint16_t             s_statsKbps;
+static TickType_t           s_statsWindowTick;
+static uint32_t             s_statsFirstUs;         /* First frame of the window */
+static uint32_t             s_statsFrames;
+static uint32_t             s_statsExtFrames;
+static uint64_t             s_statsBits;
+static TickType_t           s_statsPeriodTick;
+static uint32_t             s_statsPeriodBits;
+static uint16_t             s_statsLoadPeak;
+static uint16_t             s_statsStdIds;
+static uint32_t             s_statsDlc[CAN_STATS_DLC_NUM];
+static CAN_STATS_Entry_T    s_statsStd[CAN_STATS_STD_ID_NUM];
+static uint16_t             s_statsCms[CAN_STATS_CMS_DEPTH][CAN_STATS_CMS_WIDTH];
+static CAN_STATS_ExtEntry_T s_statsTop[CAN_STATS_EXT_TOP];
+static uint8_t              s_statsTopNum;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void CAN_STATS_Put32(uint8_t *p_buf, uint32_t value)
+{
+    p_buf[0] = (uint8_t)value;
+    p_buf[1] = (uint8_t)(value >> 8);
+    p_buf[2] = (uint8_t)(value >> 16);
+    p_buf[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t CAN_STATS_Get32(const uint8_t *p_buf)
+{
+    return (uint32_t)p_buf[0] | ((uint32_t)p_buf[1] << 8) | ((uint32_t)p_buf[2] << 16) | ((uint32_t)p_buf[3] << 24);
+}
+
+/* Bus load in 1/1000 of bits sent in ms. */
+static uint16_t CAN_STATS_Load(uint64_t bits, uint32_t ms)
+{
+    uint64_t load;
+
+    if ((ms == 0U) || (s_statsKbps == 0U))
+    {
+        return 0;
+    }
+    load = (bits * 1000U) / ((uint64_t)s_statsKbps * ms);
+    return (load > 1000U) ? 1000U : (uint16_t)load;
+}
+
+static uint32_t CAN_STATS_FrameBits(bool ext, uint8_t dataBytes)
+{
+    uint32_t stuffed = (ext ? CAN_STATS_HDR_BITS_EXT : CAN_STATS_HDR_BITS_STD) + (8U * dataBytes);
+
+    return stuffed + CAN_STATS_TRAILER_BITS + ((stuffed - 1U) / 4U);
+}
+
+static void CAN_STATS_EntryUpdate(CAN_STATS_Entry_T *p_entry, uint32_t nowUs)
+{
+    uint32_t gap;
+
+    if (p_entry->frames != 0U)
+    {
+        gap = (nowUs - p_entry->lastUs) / CAN_STATS_GAP_UNIT_US;
+        if (gap > p_entry->gapMax)
+        {
+            p_entry->gapMax = (gap > 0xFFFFU) ? 0xFFFFU : (uint16_t)gap;
+        }
+    }
+    else
+    {
+        p_entry->firstUs = nowUs;
+    }
+    p_entry->frames++;
+    p_entry->lastUs = nowUs;
+}
+
+static uint16_t CAN_STATS_CmsIndex(uint8_t row, uint32_t id)
+{
+    return (uint16_t)(((id + 1U) * s_statsHashMul[row]) >> (32U - CAN_STATS_CMS_WIDTH_BITS));
+}
+
+/* Conservative update: only the counters at the minimum are raised, the
+   others already count more than this ID. Returns the new estimate. */
+static uint16_t CAN_STATS_CmsAdd(uint32_t id)
+{
+    uint16_t est = 0xFFFFU;
+    uint16_t idx[CAN_STATS_CMS_DEPTH];
+    uint8_t row;
+
+    for (row = 0; row < CAN_STATS_CMS_DEPTH; row++)
+    {
+        idx[row] = CAN_STATS_CmsIndex(row, id);
+        if (s_statsCms[row][idx[row]] < est)
+        {
+            est = s_statsCms[row][idx[row]];
+        }
+    }
+    if (est != 0xFFFFU)
+    {
+        est++;
+    }
+    for (row = 0; row < CAN_STATS_CMS_DEPTH; row++)
+    {
+        if (s_statsCms[row][idx[row]] < est)
+        {
+            s_statsCms[row][idx[row]] = est;
+        }
+    }
+    return est;
+}
+
+static uint16_t CAN_STATS_CmsGet(uint32_t id)
+{
+    uint16_t est = 0xFFFFU;
+    uint16_t cnt;
+    uint8_t row;
+
+    for (row = 0; row < CAN_STATS_CMS_DEPTH; row++)
+    {
+        cnt = s_statsCms[row][CAN_STATS_CmsIndex(row, id)];
+        if (cnt < est)
+        {
+            est = cnt;
+        }
+    }
+    return est;
+}
+
+static CAN_STATS_ExtEntry_T *CAN_STATS_TopFind(uint32_t id)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_statsTopNum; i++)
+    {
+        if (s_statsTop[i].id == id)
+        {
+            return &s_statsTop[i];
+        }
+    }
+    return NULL;
+}
+
+/* Counts an identifier without a direct entry. It takes the entry of the
+   lowest estimate once its own estimate is higher. */
+static void CAN_STATS_SketchFrame(uint32_t id, uint32_t nowUs)
+{
+    CAN_STATS_ExtEntry_T *p_top = CAN_STATS_TopFind(id);
+    uint16_t est = CAN_STATS_CmsAdd(id);
+    uint8_t min;
+    uint8_t i;
+
+    if (p_top != NULL)
+    {
+        CAN_STATS_EntryUpdate(&p_top->entry, nowUs);
+        return;
+    }
+    if (s_statsTopNum < CAN_STATS_EXT_TOP)
+    {
+        p_top = &s_statsTop[s_statsTopNum++];
+    }
+    else
+    {
+        min = 0;
+        for (i = 1; i < CAN_STATS_EXT_TOP; i++)
+        {
+            if (s_statsTop[i].entry.frames < s_statsTop[min].entry.frames)
+            {
+                min = i;
+            }
+        }
+        if (est <= s_statsTop[min].entry.frames)
+        {
+            return;
+        }
+        p_top = &s_statsTop[min];
+    }
+    // Earlier frames of the ID were only counted in the sketch, their time
+    // span is taken from the start of the window
+    p_top->id = id;
+    p_top->entry.frames = est;
+    p_top->entry.gapMax = 0;
+    p_top->entry.firstUs = (est == 1U) ? nowUs : s_statsFirstUs;
+    p_top->entry.lastUs = nowUs;
+}
+
+static void CAN_STATS_EntryGet(const CAN_STATS_Entry_T *p_entry, CAN_STATS_Id_T *p_id)
+{
+    p_id->frames = p_entry->frames;
+    p_id->meanGapUs = (p_entry->frames > 1U) ? ((p_entry->lastUs - p_entry->firstUs) / (p_entry->frames - 1U)) : 0U;
+    p_id->maxGapUs = (uint32_t)p_entry->gapMax * CAN_STATS_GAP_UNIT_US;
+}
+
+/* Response of the ID and NEXT queries. */
+static uint8_t CAN_STATS_IdRsp(uint8_t *p_rsp, uint32_t id, const CAN_STATS_Id_T *p_id)
+{
+    p_rsp[1] = p_id->flags;
+    CAN_STATS_Put32(&p_rsp[2], id);
+    CAN_STATS_Put32(&p_rsp[6], p_id->frames);
+    CAN_STATS_Put32(&p_rsp[10], p_id->meanGapUs);
+    CAN_STATS_Put32(&p_rsp[14], p_id->maxGapUs);
+    return 18;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_STATS_Init(uint16_t bitRateKbps)
+{
+    s_statsKbps = bitRateKbps;
+    CAN_STATS_Reset();
+}
+
+void CAN_STATS_Reset(void)
+{
+    s_statsWindowTick = xTaskGetTickCount();
+    s_statsPeriodTick = s_statsWindowTick;
+    s_statsFirstUs = 0;
+    s_statsFrames = 0;
+    s_statsExtFrames = 0;
+    s_statsBits = 0;
+    s_statsPeriodBits = 0;
+    s_statsLoadPeak = 0;
+    s_statsStdIds = 0;
+    s_statsTopNum = 0;
+    memset(s_statsDlc, 0, sizeof(s_statsDlc));
+    memset(s_statsStd, 0, sizeof(s_statsStd));
+    memset(s_statsCms, 0, sizeof(s_statsCms));
+}
+
+void CAN_STATS_RxFrame(const CAN_RX_MSGOBJ *p_obj)
+{
+    TickType_t now = xTaskGetTickCount();
+    TickType_t elapsed = now - s_statsPeriodTick;
+    uint32_t nowUs = p_obj->bF.timeStamp;
+    bool ext = (p_obj->bF.ctrl.IDE != 0U);
+    uint8_t dataBytes = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)p_obj->bF.ctrl.DLC);
+    uint32_t bits = CAN_STATS_FrameBits(ext, dataBytes);
+    uint16_t load;
+    uint32_t sid = p_obj->bF.id.SID;
+
+    // Close the load period, a quiet bus closes it late over a longer time
+    if (elapsed >= CAN_STATS_MS_TO_TICKS(CAN_STATS_LOAD_PERIOD_MS))
+    {
+        load = CAN_STATS_Load(s_statsPeriodBits, elapsed * portTICK_PERIOD_MS);
+        if (load > s_statsLoadPeak)
+        {
+            s_statsLoadPeak = load;
+        }
+        s_statsPeriodTick = now;
+        s_statsPeriodBits = 0;
+    }
+
+    if (s_statsFrames == 0U)
+    {
+        s_statsFirstUs = nowUs;
+    }
+    s_statsFrames++;
+    s_statsBits += bits;
+    s_statsPeriodBits += bits;
+    s_statsDlc[p_obj->bF.ctrl.DLC]++;
+
+    if (ext)
+    {
+        s_statsExtFrames++;
+        CAN_STATS_SketchFrame((sid << 18) | p_obj->bF.id.EID, nowUs);
+    }
+    else if (sid < CAN_STATS_STD_ID_NUM)
+    {
+        if (s_statsStd[sid].frames == 0U)
+        {
+            s_statsStdIds++;
+        }
+        CAN_STATS_EntryUpdate(&s_statsStd[sid], nowUs);
+    }
+    else
+    {
+        CAN_STATS_SketchFrame(sid | CAN_STATS_KEY_STD, nowUs);
+    }
+}
+
+void CAN_STATS_SummaryGet(CAN_STATS_Summary_T *p_summary)
+{
+    uint32_t windowMs = (xTaskGetTickCount() - s_statsWindowTick) * portTICK_PERIOD_MS;
+
+    p_summary->windowMs = windowMs;
+    p_summary->frames = s_statsFrames;
+    p_summary->extFrames = s_statsExtFrames;
+    p_summary->load = CAN_STATS_Load(s_statsBits, windowMs);
+    p_summary->loadPeak = s_statsLoadPeak;
+    p_summary->stdIds = s_statsStdIds;
+}
+
+bool CAN_STATS_IdGet(uint32_t id, bool ext, CAN_STATS_Id_T *p_id)
+{
+    CAN_STATS_ExtEntry_T *p_top;
+    uint32_t key = ext ? id : (id | CAN_STATS_KEY_STD);
+
+    memset(p_id, 0, sizeof(*p_id));
+    p_id->flags = ext ? CAN_STATS_FLAG_EXT : 0U;
+    if (!ext && (id < CAN_STATS_STD_ID_NUM))
+    {
+        CAN_STATS_EntryGet(&s_statsStd[id], p_id);
+        return (p_id->frames != 0U);
+    }
+
+    p_top = CAN_STATS_TopFind(key);
+    if (p_top != NULL)
+    {
+        CAN_STATS_EntryGet(&p_top->entry, p_id);
+    }
+    else
+    {
+        p_id->frames = CAN_STATS_CmsGet(key);
+        p_id->flags |= CAN_STATS_FLAG_ESTIMATE;
+    }
+    return (p_id->frames != 0U);
+}
+
+uint32_t CAN_STATS_DlcGet(uint8_t dlc)
+{
+    return (dlc < CAN_STATS_DLC_NUM) ? s_statsDlc[dlc] : 0U;
+}
+
+uint8_t CAN_STATS_VendorCmd(const uint8_t *p_cmd, uint16_t cmdLen, uint8_t *p_rsp)
+{
+    CAN_STATS_Summary_T summary;
+    CAN_STATS_Id_T idStats;
+    uint32_t id;
+    uint8_t n;
+    uint8_t i;
+
+    if (cmdLen < 2)
+    {
+        return 0;
+    }
+    p_rsp[0] = p_cmd[1];
+
+    switch (p_cmd[1])
+    {
+        case CAN_STATS_VENDOR_SUMMARY:
+        {
+            CAN_STATS_SummaryGet(&summary);
+            CAN_STATS_Put32(&p_rsp[1], summary.windowMs);
+            CAN_STATS_Put32(&p_rsp[5], summary.frames);
+            CAN_STATS_Put32(&p_rsp[9], summary.extFrames);
+            p_rsp[13] = (uint8_t)summary.load;
+            p_rsp[14] = (uint8_t)(summary.load >> 8);
+            p_rsp[15] = (uint8_t)summary.loadPeak;
+            p_rsp[16] = (uint8_t)(summary.loadPeak >> 8);
+            p_rsp[17] = (uint8_t)summary.stdIds;
+            p_rsp[18] = (uint8_t)(summary.stdIds >> 8);
+            return 19;
+        }
+
+        case CAN_STATS_VENDOR_DLC:
+        {
+            if ((cmdLen < 3) || (p_cmd[2] >= CAN_STATS_DLC_NUM))
+            {
+                return 0;
+            }
+            n = CAN_STATS_DLC_NUM - p_cmd[2];
+            if (n > CAN_STATS_VENDOR_DLC_NUM)
+            {
+                n = CAN_STATS_VENDOR_DLC_NUM;
+            }
+            p_rsp[1] = p_cmd[2];
+            p_rsp[2] = n;
+            for (i = 0; i < n; i++)
+            {
+                CAN_STATS_Put32(&p_rsp[3 + i * 4], s_statsDlc[p_cmd[2] + i]);
+            }
+            return 3 + n * 4;
+        }
+
+        case CAN_STATS_VENDOR_ID:
+        {
+            if (cmdLen < 7)
+            {
+                return 0;
+            }
+            id = CAN_STATS_Get32(&p_cmd[3]);
+            (void)CAN_STATS_IdGet(id, (p_cmd[2] & CAN_STATS_FLAG_EXT) != 0U, &idStats);
+            return CAN_STATS_IdRsp(p_rsp, id, &idStats);
+        }
+
+        case CAN_STATS_VENDOR_NEXT:
+        {
+            if (cmdLen < 7)
+            {
+                return 0;
+            }
+            id = CAN_STATS_Get32(&p_cmd[3]);
+            memset(&idStats, 0, sizeof(idStats));
+            if (p_cmd[2] & CAN_STATS_FLAG_EXT)
+            {
+                idStats.flags = CAN_STATS_FLAG_EXT;
+                if (id < s_statsTopNum)
+                {
+                    CAN_STATS_EntryGet(&s_statsTop[id].entry, &idStats);
+                    id = s_statsTop[id].id;
+                    if (id & CAN_STATS_KEY_STD)
+                    {
+                        id &= ~CAN_STATS_KEY_STD;
+                        idStats.flags = 0;
+                    }
+                    return CAN_STATS_IdRsp(p_rsp, id, &idStats);
+                }
+            }
+            else
+            {
+                for (; id < CAN_STATS_STD_ID_NUM; id++)
+                {
+                    if (s_statsStd[id].frames != 0U)
+                    {
+                        CAN_STATS_EntryGet(&s_statsStd[id], &idStats);
+                        return CAN_STATS_IdRsp(p_rsp, id, &idStats);
+                    }
+                }
+            }
+            idStats.flags |= CAN_STATS_FLAG_END;
+            return CAN_STATS_IdRsp(p_rsp, id, &idStats);
+        }
+
+        case CAN_STATS_VENDOR_RESET:
+        {
+            CAN_STATS_Reset();
+        }
+        break;
+
+        default:
+        break;
+    }
+    return 0;
+}
+
+#endif /* CAN_STATS_ENABLE */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,261 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+/*******************************************************************************
+  CAN Bridge Bus Statistics Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_stats.h
+
+  Summary:
+    Bus load, per identifier frame rate and inter-arrival times and a DLC
+    histogram of the traffic on the bus.
+
+  Description:
+    The bridge filter only passes the bridged identifiers, so the bridge
+    alone cannot tell which other identifiers are on the bus. With
+    CAN_STATS_ENABLE the application adds a catch-all filter behind the
+    bridge filters into a statistics RX FIFO. Both RX FIFOs store the
+    time stamp of the controller, every received frame is passed to
+    CAN_STATS_RxFrame. With CAN_STATS_LISTEN_ONLY the controller only
+    listens, it neither acknowledges nor sends frames.
+
+    Per frame the module counts:
+      - the bits of the frame on the bus, with worst case bit stuffing
+        (34 or 54 bits of stuffed header, 8 bits per data byte, 13 bits of
+        trailer and interframe space). The bus load is these bits over the
+        bit rate and the time, so it is an upper bound. CAN FD frames are
+        counted at the nominal bit rate. Frames the bridge sends itself and
+        error frames are not counted,
+      - the DLC histogram,
+      - per standard identifier below CAN_STATS_STD_ID_NUM a direct entry
+        of 16 bytes: frames, time stamps of the first and the last frame and
+        longest inter-arrival time,
+      - per extended identifier (and standard identifier above the direct
+        entries) a count-min sketch of CAN_STATS_CMS_DEPTH rows of
+        CAN_STATS_CMS_WIDTH 16 bit counters with conservative update. The
+        sketch never underestimates a count. The CAN_STATS_EXT_TOP
+        identifiers with the highest estimates also get an entry like the
+        standard identifiers.
+
+    The mean inter-arrival time of an identifier is the time from its first
+    to its last frame over its frames minus one. An extended identifier that
+    takes over an entry from the sketch counts its time from the first frame
+    of the window instead. Time stamps are in us and wrap after 71 minutes,
+    a longer window gives wrong inter-arrival times.
+
+    The statistics use a fixed amount of RAM, about 19 KB with the default
+    sizes, 16 KB of it for the direct entries. Set CAN_STATS_STD_ID_NUM to
+    2048 to give every standard identifier its own entry, for about 35 KB.
+    They are updated and read from the application task only.
+*******************************************************************************/
+
+#ifndef _CAN_STATS_H
+#define _CAN_STATS_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "canfdspi/drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* Uncomment to collect the bus statistics. */
+//#define CAN_STATS_ENABLE
+/* Uncomment to select listen-only mode, nothing is sent on the bus. */
+//#define CAN_STATS_LISTEN_ONLY
+
+#define CAN_STATS_STD_ID_NUM        1024    /* Standard IDs with a direct entry, 16 bytes each, <= 2048 */
+#define CAN_STATS_CMS_DEPTH         4       /* Sketch rows, <= 4 */
+#define CAN_STATS_CMS_WIDTH_BITS    8
+#define CAN_STATS_CMS_WIDTH         (1U << CAN_STATS_CMS_WIDTH_BITS)
+#define CAN_STATS_EXT_TOP           8       /* Extended IDs with an entry */
+#define CAN_STATS_GAP_UNIT_US       100     /* Longest inter-arrival up to 6.5 s */
+#define CAN_STATS_LOAD_PERIOD_MS    1000    /* Period of the peak bus load */
+
+/* TRS vendor command reading the statistics. Request: opcode, query,
+   arguments. Response: opcode, query, data, all little endian. Responses
+   fit into a 23 byte ATT MTU.
+     SUMMARY: no arguments. Window in ms, frames, extended frames (uint32_t
+              each), bus load and peak bus load in 1/1000 (uint16_t each),
+              standard IDs seen (uint16_t).
+     DLC:     first DLC. First DLC, DLC count, frames per DLC (uint32_t).
+     ID:      flags, ID (uint32_t). Flags, ID, frames, mean and longest
+              inter-arrival time in us (uint32_t each).
+     NEXT:    flags, start (uint32_t). As ID for the first standard ID from
+              start on that was seen, or with CAN_STATS_FLAG_EXT for the
+              extended ID entry number start. CAN_STATS_FLAG_END when there
+              is none.
+     RESET:   no arguments and no response, starts a new window. */
+#define CAN_STATS_VENDOR_OPCODE     0x34
+#define CAN_STATS_VENDOR_SUMMARY    0x00
+#define CAN_STATS_VENDOR_DLC        0x01
+#define CAN_STATS_VENDOR_ID         0x02
+#define CAN_STATS_VENDOR_NEXT       0x03
+#define CAN_STATS_VENDOR_RESET      0xFF
+#define CAN_STATS_VENDOR_DLC_NUM    4
+#define CAN_STATS_VENDOR_RSP_LEN    19
+
+#define CAN_STATS_FLAG_EXT          0x01    /* Extended ID */
+#define CAN_STATS_FLAG_ESTIMATE     0x02    /* Frames from the sketch, no inter-arrival times */
+#define CAN_STATS_FLAG_END          0x04    /* NEXT found no further ID */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct CAN_STATS_Summary_T
+{
+    uint32_t    windowMs;
+    uint32_t    frames;
+    uint32_t    extFrames;
+    uint16_t    load;                   /* Bus load over the window in 1/1000 */
+    uint16_t    loadPeak;               /* Highest of the CAN_STATS_LOAD_PERIOD_MS periods */
+    uint16_t    stdIds;                 /* Standard IDs with a direct entry seen */
+} CAN_STATS_Summary_T;
+
+typedef struct CAN_STATS_Id_T
+{
+    uint32_t    frames;                 /* Saturated to 0xFFFF for a sketch estimate */
+    uint32_t    meanGapUs;
+    uint32_t    maxGapUs;
+    uint8_t     flags;                  /* CAN_STATS_FLAG_... */
+} CAN_STATS_Id_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_STATS_Init(uint16_t bitRateKbps)
+
+  Summary:
+    Sets the nominal bit rate of the bus and starts the first window.
+*/
+void CAN_STATS_Init(uint16_t bitRateKbps);
+
+/*******************************************************************************
+  Function:
+    void CAN_STATS_Reset(void)
+
+  Summary:
+    Clears the statistics and starts a new window.
+*/
+void CAN_STATS_Reset(void);
+
+/*******************************************************************************
+  Function:
+    void CAN_STATS_RxFrame(const CAN_RX_MSGOBJ *p_obj)
+
+  Summary:
+    Counts a received frame.
+
+  Description:
+    p_obj->bF.timeStamp is the receive time stamp of the controller in us.
+*/
+void CAN_STATS_RxFrame(const CAN_RX_MSGOBJ *p_obj);
+
+/*******************************************************************************
+  Function:
+    void CAN_STATS_SummaryGet(CAN_STATS_Summary_T *p_summary)
+
+  Summary:
+    Returns the frame counts and the bus load of the window.
+*/
+void CAN_STATS_SummaryGet(CAN_STATS_Summary_T *p_summary);
+
+/*******************************************************************************
+  Function:
+    bool CAN_STATS_IdGet(uint32_t id, bool ext, CAN_STATS_Id_T *p_id)
+
+  Summary:
+    Returns the frames and inter-arrival times of an identifier.
+
+  Returns:
+    true  - The identifier was seen in the window.
+    false - It was not, p_id holds 0 frames.
+*/
+bool CAN_STATS_IdGet(uint32_t id, bool ext, CAN_STATS_Id_T *p_id);
+
+/*******************************************************************************
+  Function:
+    uint32_t CAN_STATS_DlcGet(uint8_t dlc)
+
+  Summary:
+    Returns the frames of the window with the DLC.
+*/
+uint32_t CAN_STATS_DlcGet(uint8_t dlc);
+
+/*******************************************************************************
+  Function:
+    uint8_t CAN_STATS_VendorCmd(const uint8_t *p_cmd, uint16_t cmdLen, uint8_t *p_rsp)
+
+  Summary:
+    Handles a CAN_STATS_VENDOR_OPCODE vendor command.
+
+  Parameters:
+    p_cmd  - Received payload, starting with the opcode.
+    cmdLen - Length of p_cmd.
+    p_rsp  - Response payload without the opcode, CAN_STATS_VENDOR_RSP_LEN
+             bytes.
+
+  Returns:
+    Length of the response to send back, 0 for none.
+*/
+uint8_t CAN_STATS_VendorCmd(const uint8_t *p_cmd, uint16_t cmdLen, uint8_t *p_rsp);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _CAN_STATS_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,158 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge SPSC Ring Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    spsc_ring.h
+
+  Summary:
+    Lock-free single producer / single consumer ring of fixed size records.
+
+  Description:
+    The producer only writes the write index and the consumer only writes the
+    read index. Both are 32-bit words, which the Cortex-M4 stores atomically,
+    so one side may run in an interrupt and the other in a task without a
+    critical section. Data memory barriers order the record copy against the
+    index update. The ring only carries data; the producer wakes the consumer
+    separately, e.g. with xTaskNotifyFromISR().
+
+    Each ring must have exactly one producer and one consumer context.
+*******************************************************************************/
+
+#ifndef _SPSC_RING_H
+#define _SPSC_RING_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct
+{
+    uint8_t             *p_storage;     /* elemNum records of elemSize bytes */
+    uint16_t            elemSize;
+    uint16_t            mask;           /* elemNum - 1, elemNum is a power of two */
+    volatile uint32_t   wrIdx;          /* Free running, written by the producer only */
+    volatile uint32_t   rdIdx;          /* Free running, written by the consumer only */
+    volatile uint32_t   dropCnt;        /* Records rejected because the ring was full */
+} SPSC_RING_T;
+
+/* Defines a statically allocated ring named name holding elemNum records of
+   elemType. elemNum must be a power of two. */
+#define SPSC_RING_DEFINE(name, elemType, elemNum)                                   \
+    typedef char name##_size_check[(((elemNum) & ((elemNum) - 1)) == 0) ? 1 : -1];  \
+    static elemType name##_storage[elemNum];                                        \
+    static SPSC_RING_T name = { (uint8_t *)name##_storage, sizeof(elemType), (elemNum) - 1, 0, 0, 0 }
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    bool SPSC_RING_Init(SPSC_RING_T *p_ring, void *p_storage, uint16_t elemSize,
+                        uint16_t elemNum)
+
+  Summary:
+    Initializes a ring on caller provided storage.
+
+  Description:
+    Not needed for rings created with SPSC_RING_DEFINE.
+
+  Returns:
+    true  - Ring ready.
+    false - elemNum is not a power of two.
+*/
+bool SPSC_RING_Init(SPSC_RING_T *p_ring, void *p_storage, uint16_t elemSize, uint16_t elemNum);
+
+/*******************************************************************************
+  Function:
+    bool SPSC_RING_Push(SPSC_RING_T *p_ring, const void *p_elem)
+
+  Summary:
+    Copies one record into the ring. Producer side, ISR safe.
+
+  Returns:
+    true  - Record queued.
+    false - Ring full, dropCnt incremented.
+*/
+bool SPSC_RING_Push(SPSC_RING_T *p_ring, const void *p_elem);
+
+/*******************************************************************************
+  Function:
+    bool SPSC_RING_Pop(SPSC_RING_T *p_ring, void *p_elem)
+
+  Summary:
+    Copies the oldest record out of the ring. Consumer side, ISR safe.
+
+  Returns:
+    true  - p_elem is filled.
+    false - Ring empty.
+*/
+bool SPSC_RING_Pop(SPSC_RING_T *p_ring, void *p_elem);
+
+/*******************************************************************************
+  Function:
+    uint16_t SPSC_RING_Count(const SPSC_RING_T *p_ring)
+
+  Summary:
+    Returns the number of queued records. May be called from either side.
+*/
+uint16_t SPSC_RING_Count(const SPSC_RING_T *p_ring);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _SPSC_RING_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -29,6 +29,8 @@
 #ifndef FREERTOS_CONFIG_H
 #define FREERTOS_CONFIG_H
 
+#include "user.h"
+
 /*-----------------------------------------------------------
  * Application specific definitions.
  *
@@ -49,7 +51,11 @@
 #define configMAX_PRIORITIES                    ( 5UL )
 #define configMINIMAL_STACK_SIZE                ( 256 )
 #define configSUPPORT_DYNAMIC_ALLOCATION        1
+#ifdef APP_STATIC_ALLOCATION
+#define configSUPPORT_STATIC_ALLOCATION         1
+#else
 #define configSUPPORT_STATIC_ALLOCATION         0
+#endif
 #define configTOTAL_HEAP_SIZE                   ( ( size_t ) 40960 )
 #define configMAX_TASK_NAME_LEN                 ( 16 )
 #define configUSE_16_BIT_TICKS                  0
@@ -72,8 +78,21 @@
 #define configUSE_MALLOC_FAILED_HOOK            1
 
 /* Run time and task stats gathering related definitions. */
+#ifdef APP_TELEMETRY_ENABLE
+/* The run time counter is the DWT cycle counter. It stops while the core
+   sleeps in tickless idle, so sleep time is not charged to any task. */
+#define configGENERATE_RUN_TIME_STATS           1
+#define configUSE_TRACE_FACILITY                1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()                                        \
+    do {                                                                                \
+        *(volatile uint32_t *)0xE000EDFCUL |= (1UL << 24);  /* DEMCR.TRCENA */          \
+        *(volatile uint32_t *)0xE0001000UL |= 1UL;          /* DWT_CTRL.CYCCNTENA */    \
+    } while (0)
+#define portGET_RUN_TIME_COUNTER_VALUE()        (*(volatile uint32_t *)0xE0001004UL)   /* DWT_CYCCNT */
+#else
 #define configGENERATE_RUN_TIME_STATS           0
 #define configUSE_TRACE_FACILITY                0
+#endif
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
 /* Co-routine related definitions. */
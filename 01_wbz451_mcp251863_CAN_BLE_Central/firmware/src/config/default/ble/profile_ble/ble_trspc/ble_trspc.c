@@ -95,6 +95,16 @@
 #define BLE_TRSPC_MAX_BUF_IN                    (BLE_TRSPC_INIT_CREDIT*BLE_TRSPC_MAX_CONN_NBR)     /**< Maximum incoming queue number */
 /** @} */
 
+/**@defgroup BLE_TRSPC_RX_BUF BLE_TRSPC_RX_BUF
+ * @brief The definition of the per connection receive buffer. Received packets are stored back to back,
+ *        so the buffer holds INIT_CREDIT packets of the average length or fewer longer ones.
+ * @{ */
+#ifndef BLE_TRSPC_RX_PACKET_AVG_LEN
+#define BLE_TRSPC_RX_PACKET_AVG_LEN             64      /**< Expected average length of a received packet. */
+#endif
+#define BLE_TRSPC_RX_BUF_SIZE                   (BLE_TRSPC_INIT_CREDIT*BLE_TRSPC_RX_PACKET_AVG_LEN)     /**< Receive buffer size of one connection. */
+/** @} */
+
 /**@defgroup BLE_TRSPC_MAX_RETURN_CREDIT BLE_TRSPC_MAX_RETURN_CREDIT
  * @brief The definition of maximum return credit number.
  * @{ */
@@ -112,6 +122,16 @@
 #define CBFC_PROC_DISABLE_TUD_CCCD              0x05    /**< CBFC procdure: Disable TUD CCCD. */
 /** @} */
 
+/**@defgroup BLE_TRSPC_HANDLE_CACHE BLE_TRSPC_HANDLE_CACHE
+ * @brief The definition of cached handle usage and revalidation state.
+ * @{ */
+#define HANDLE_CACHE_IDLE                       0x00    /**< Handles come from discovery or were confirmed. */
+#define HANDLE_CACHE_RESTORED                   0x01    /**< Cached handles in use, data session being enabled. */
+#define HANDLE_CACHE_CHECK                      0x02    /**< Revalidation request waiting for the GATT client. */
+#define HANDLE_CACHE_CHECKING                   0x03    /**< Revalidation request outstanding. */
+#define HANDLE_CACHE_CONFIRMED                  0x04    /**< Cached TCP handle found again, waiting for the end of the procedure. */
+/** @} */
+
 /**@defgroup BLE_TRSPC_VENCOM_PROC BLE_TRSPC_VENCOM_PROC
  * @brief The definition of vendor command response procedure.
  * @{ */
@@ -164,7 +184,7 @@ typedef enum BLE_TRSPC_CharIndex_T
 typedef struct BLE_TRSPC_PacketList_T
 {
     uint16_t                   length;                  /**< Data length. */
-    uint8_t                    *p_packet;               /**< Pointer to the TX/RX data buffer */
+    uint16_t                   offset;                  /**< Offset of the data in the receive buffer. */
 } BLE_TRSPC_PacketList_T;
 
 /**@brief The structure contains information about packet input queue format of BLE transparent profile. */
@@ -173,7 +193,9 @@ typedef struct BLE_TRSPC_QueueIn_T
     uint8_t                    usedNum;                    /**< The number of data list of packetIn buffer. */
     uint8_t                    writeIndex;                 /**< The Index of data, written in packet buffer. */
     uint8_t                    readIndex;                  /**< The Index of data, read in packet buffer. */
+    uint16_t                   writeOffset;                /**< Offset of the first free byte behind the newest packet. */
     BLE_TRSPC_PacketList_T     packetList[BLE_TRSPC_INIT_CREDIT];  /**< Written in packet buffer. @ref BLE_TRSPC_PacketList_T.*/  
+    uint8_t                    buffer[BLE_TRSPC_RX_BUF_SIZE];      /**< Receive buffer holding the packet data. */
 } BLE_TRSPC_QueueIn_T;
 
 /**@brief The structure contains information about BLE transparent profile connection parameters for recording connection information. */
@@ -191,6 +213,7 @@ typedef struct BLE_TRSPC_ConnList_T
     BLE_TRSPC_QueueIn_T         inputQueue;             /**< Input queue to store Rx packets. */
     uint8_t                     cbfcRetryProcedure;     /**< Record credit based flow control configuration procedure for retry used. */
     uint8_t                     sessionReqAuth;         /**< Data Session need authenticated. */
+    uint8_t                     handleCache;            /**< Cached handle usage. @ref BLE_TRSPC_HANDLE_CACHE.*/
 } BLE_TRSPC_ConnList_T;
 
 // *****************************************************************************
@@ -227,7 +250,11 @@ static BLE_DD_DiscChar_T        *trsDiscCharList[] =
 
 static BLE_DD_CharList_T        s_trsCharList[BLE_TRSPC_MAX_CONN_NBR];
 
+/* Every GATTC_Write() copies the parameters before it returns, so one block serves all writes. */
+static GATTC_WriteParams_T      s_trspcWriteParams;
+
 MW_ASSERT((BLE_TRSPC_MAX_CONN_NBR*BLE_TRSPC_INIT_CREDIT)==BLE_TRSPC_MAX_BUF_IN);
+MW_ASSERT(BLE_TRSPC_RX_BUF_SIZE>=(BLE_ATT_MAX_MTU_LEN-ATT_WRITE_HEADER_SIZE));
 
 // *****************************************************************************
 // *****************************************************************************
@@ -294,31 +321,23 @@ static uint16_t ble_trspc_EnableControlPointCccd(BLE_TRSPC_ConnList_T *p_conn)
     GATTC_WriteParams_T *p_writeParams;
     uint16_t result;
 
-    p_writeParams = OSAL_Malloc(sizeof(GATTC_WriteParams_T));
-    if (p_writeParams != NULL)
-    {
-        p_writeParams->charHandle = s_trsCharInfoList[p_conn->connIndex][TRSPC_INDEX_CHARTCPCCCD].charHandle;
-        p_writeParams->charLength = 0x02;
-        U16_TO_BUF_LE(p_writeParams->charValue, BLE_TRSPC_CCCD_NOTIFY);
-        p_writeParams->writeType = ATT_WRITE_REQ;
-        p_writeParams->valueOffset = 0x0000;
-        p_writeParams->flags = 0;
+    p_writeParams = &s_trspcWriteParams;
+    p_writeParams->charHandle = s_trsCharInfoList[p_conn->connIndex][TRSPC_INDEX_CHARTCPCCCD].charHandle;
+    p_writeParams->charLength = 0x02;
+    U16_TO_BUF_LE(p_writeParams->charValue, BLE_TRSPC_CCCD_NOTIFY);
+    p_writeParams->writeType = ATT_WRITE_REQ;
+    p_writeParams->valueOffset = 0x0000;
+    p_writeParams->flags = 0;
 
-        result = GATTC_Write(p_conn->connHandle, p_writeParams);
-        if (result == MBA_RES_SUCCESS)
-        {
-            p_conn->cbfcProcedure = CBFC_PROC_ENABLE_TCP_CCCD;
-            p_conn->cbfcRetryProcedure = CBFC_PROC_IDLE;
-        }
-        else
-        {
-            p_conn->cbfcRetryProcedure = CBFC_PROC_ENABLE_SESSION;
-        }
-        OSAL_Free(p_writeParams);
+    result = GATTC_Write(p_conn->connHandle, p_writeParams);
+    if (result == MBA_RES_SUCCESS)
+    {
+        p_conn->cbfcProcedure = CBFC_PROC_ENABLE_TCP_CCCD;
+        p_conn->cbfcRetryProcedure = CBFC_PROC_IDLE;
     }
     else
     {
-        result = MBA_RES_OOM;
+        p_conn->cbfcRetryProcedure = CBFC_PROC_ENABLE_SESSION;
     }
 
     return result;
@@ -329,27 +348,23 @@ static void ble_trspc_EnableDownlinkCreditBaseFlowControl(BLE_TRSPC_ConnList_T *
     GATTC_WriteParams_T *p_writeParams;
     uint16_t result;
 
-    p_writeParams = OSAL_Malloc(sizeof(GATTC_WriteParams_T));
-    if (p_writeParams != NULL)
-    {
-        p_writeParams->charHandle = s_trsCharInfoList[p_conn->connIndex][TRSPC_INDEX_CHARTCP].charHandle;
-        p_writeParams->charLength = 0x01;
-        p_writeParams->charValue[0] = BLE_TRSPC_CBFC_OPCODE_DL_ENABLED;
-        p_writeParams->writeType = ATT_WRITE_REQ;
-        p_writeParams->valueOffset = 0x0000;
-        p_writeParams->flags = 0;
+    p_writeParams = &s_trspcWriteParams;
+    p_writeParams->charHandle = s_trsCharInfoList[p_conn->connIndex][TRSPC_INDEX_CHARTCP].charHandle;
+    p_writeParams->charLength = 0x01;
+    p_writeParams->charValue[0] = BLE_TRSPC_CBFC_OPCODE_DL_ENABLED;
+    p_writeParams->writeType = ATT_WRITE_REQ;
+    p_writeParams->valueOffset = 0x0000;
+    p_writeParams->flags = 0;
 
-        result = GATTC_Write(p_conn->connHandle, p_writeParams);
-        if (result == MBA_RES_SUCCESS)
-        {
-            p_conn->cbfcProcedure = CBFC_PROC_ENABLE_TDD_CBFC;
-            p_conn->cbfcRetryProcedure = CBFC_PROC_IDLE;
-        }
-        else
-        {
-            p_conn->cbfcRetryProcedure = CBFC_PROC_ENABLE_TCP_CCCD;
-        }
-        OSAL_Free(p_writeParams);
+    result = GATTC_Write(p_conn->connHandle, p_writeParams);
+    if (result == MBA_RES_SUCCESS)
+    {
+        p_conn->cbfcProcedure = CBFC_PROC_ENABLE_TDD_CBFC;
+        p_conn->cbfcRetryProcedure = CBFC_PROC_IDLE;
+    }
+    else
+    {
+        p_conn->cbfcRetryProcedure = CBFC_PROC_ENABLE_TCP_CCCD;
     }
 }
 
@@ -358,23 +373,19 @@ static void ble_trspc_ClientReturnCredit(BLE_TRSPC_ConnList_T *p_conn)
     GATTC_WriteParams_T *p_writeParams;
     uint16_t result;
 
-    p_writeParams = OSAL_Malloc(sizeof(GATTC_WriteParams_T));
-    if (p_writeParams != NULL)
-    {
-        p_writeParams->charHandle = s_trsCharInfoList[p_conn->connIndex][TRSPC_INDEX_CHARTCP].charHandle;
-        p_writeParams->charLength = 0x02;
-        p_writeParams->charValue[0] = BLE_TRSPC_CBFC_OPCODE_UL_ENABLED;
-        p_writeParams->charValue[1] = p_conn->peerCredit;
-        p_writeParams->writeType = ATT_WRITE_REQ;
-        p_writeParams->valueOffset = 0x0000;
-        p_writeParams->flags = 0;
+    p_writeParams = &s_trspcWriteParams;
+    p_writeParams->charHandle = s_trsCharInfoList[p_conn->connIndex][TRSPC_INDEX_CHARTCP].charHandle;
+    p_writeParams->charLength = 0x02;
+    p_writeParams->charValue[0] = BLE_TRSPC_CBFC_OPCODE_UL_ENABLED;
+    p_writeParams->charValue[1] = p_conn->peerCredit;
+    p_writeParams->writeType = ATT_WRITE_REQ;
+    p_writeParams->valueOffset = 0x0000;
+    p_writeParams->flags = 0;
 
-        result = GATTC_Write(p_conn->connHandle, p_writeParams);
-        if (result == MBA_RES_SUCCESS)
-        {
-            p_conn->peerCredit = 0;
-        }
-        OSAL_Free(p_writeParams);
+    result = GATTC_Write(p_conn->connHandle, p_writeParams);
+    if (result == MBA_RES_SUCCESS)
+    {
+        p_conn->peerCredit = 0;
     }
 }
 
@@ -383,38 +394,30 @@ static uint16_t ble_trspc_ConfigureUplinkDataCccd(BLE_TRSPC_ConnList_T *p_conn,
     GATTC_WriteParams_T *p_writeParams;
     uint16_t result;
 
-    p_writeParams = OSAL_Malloc(sizeof(GATTC_WriteParams_T));
-    if (p_writeParams != NULL)
-    {
-        p_writeParams->charHandle = s_trsCharInfoList[p_conn->connIndex][TRSPC_INDEX_CHARTUDCCCD].charHandle;
-        p_writeParams->charLength = sizeof(cccdValue);
-        U16_TO_BUF_LE(p_writeParams->charValue, cccdValue);
-        p_writeParams->writeType = ATT_WRITE_REQ;
-        p_writeParams->valueOffset = 0x0000;
-        p_writeParams->flags = 0;
+    p_writeParams = &s_trspcWriteParams;
+    p_writeParams->charHandle = s_trsCharInfoList[p_conn->connIndex][TRSPC_INDEX_CHARTUDCCCD].charHandle;
+    p_writeParams->charLength = sizeof(cccdValue);
+    U16_TO_BUF_LE(p_writeParams->charValue, cccdValue);
+    p_writeParams->writeType = ATT_WRITE_REQ;
+    p_writeParams->valueOffset = 0x0000;
+    p_writeParams->flags = 0;
 
-        result = GATTC_Write(p_conn->connHandle, p_writeParams);
-        if (result == MBA_RES_SUCCESS)
+    result = GATTC_Write(p_conn->connHandle, p_writeParams);
+    if (result == MBA_RES_SUCCESS)
+    {
+        if (cccdValue == BLE_TRSPC_CCCD_NOTIFY)
         {
-            if (cccdValue == BLE_TRSPC_CCCD_NOTIFY)
-            {
-                p_conn->cbfcProcedure = CBFC_PROC_ENABLE_TUD_CCCD;
-            }
-            else
-            {
-                p_conn->cbfcProcedure = CBFC_PROC_DISABLE_TUD_CCCD;
-            }
-            p_conn->cbfcRetryProcedure = CBFC_PROC_IDLE;
+            p_conn->cbfcProcedure = CBFC_PROC_ENABLE_TUD_CCCD;
         }
         else
         {
-            p_conn->cbfcRetryProcedure = CBFC_PROC_ENABLE_TDD_CBFC;
+            p_conn->cbfcProcedure = CBFC_PROC_DISABLE_TUD_CCCD;
         }
-        OSAL_Free(p_writeParams);
+        p_conn->cbfcRetryProcedure = CBFC_PROC_IDLE;
     }
     else
     {
-        result = MBA_RES_OOM;
+        p_conn->cbfcRetryProcedure = CBFC_PROC_ENABLE_TDD_CBFC;
     }
 
     return result;
@@ -456,6 +459,134 @@ uint16_t ble_trspc_EnableDataSession(uint16_t connHandle, uint8_t cbfcConfig)
     return result;
 }
 
+static void ble_trspc_CharHandlesStale(BLE_TRSPC_ConnList_T *p_conn)
+{
+    BLE_TRSPC_Event_T evtPara;
+
+    /* Drop the session built on the stale handles, it is enabled again once discovery completes. */
+    p_conn->handleCache = HANDLE_CACHE_IDLE;
+    p_conn->trsState = 0;
+    p_conn->cbfcConfig = BLE_TRSPC_CBFC_DISABLED;
+    p_conn->cbfcProcedure = CBFC_PROC_IDLE;
+    p_conn->cbfcRetryProcedure = CBFC_PROC_IDLE;
+    p_conn->localCredit = 0;
+    p_conn->peerCredit = 0;
+
+    if (bleTrspcProcess)
+    {
+        evtPara.eventId = BLE_TRSPC_EVT_CHAR_HANDLES_STALE;
+        evtPara.eventField.onCharHandlesStale.connHandle = p_conn->connHandle;
+        bleTrspcProcess(&evtPara);
+    }
+
+    BLE_DD_RestartServicesDiscovery(p_conn->connHandle);
+}
+
+static void ble_trspc_CheckCharHandles(BLE_TRSPC_ConnList_T *p_conn)
+{
+    GATTC_DiscoverCharacteristicByUuidParams_T discParams;
+    BLE_DD_CharInfo_T *p_charInfo = s_trsCharInfoList[p_conn->connIndex];
+
+    /* Look for the TCP declaration from the TUD declaration up to the last cached handle. */
+    discParams.startHandle = p_charInfo[TRSPC_INDEX_CHARTUD].charHandle - 1;
+    discParams.endHandle = p_charInfo[TRSPC_INDEX_CHARTCPCCCD].charHandle;
+    discParams.uuidLength = discCharTcp.uuidLength;
+    memcpy(discParams.uuid, discCharTcp.uuid, discCharTcp.uuidLength);
+
+    /* Retried on GATTC_EVT_PROTOCOL_AVAILABLE if the client is busy. */
+    if (GATTC_DiscoverCharacteristicsByUUID(p_conn->connHandle, &discParams) == MBA_RES_SUCCESS)
+    {
+        p_conn->handleCache = HANDLE_CACHE_CHECKING;
+    }
+}
+
+static void ble_trspc_ProcCharHandlesCheckResp(BLE_TRSPC_ConnList_T *p_conn, GATT_EvtDiscCharResp_T *p_event)
+{
+    uint16_t procIdx = 0;
+    uint16_t valueHandle;
+
+    /* Each entry: <declaration handle> <property> <value handle> <UUID> */
+    while ((p_event->attrPairLength != 0) && (procIdx < p_event->attrDataLength))
+    {
+        BUF_LE_TO_U16(&valueHandle, &p_event->attrData[procIdx+3]);
+        if (valueHandle == s_trsCharInfoList[p_conn->connIndex][TRSPC_INDEX_CHARTCP].charHandle)
+        {
+            p_conn->handleCache = HANDLE_CACHE_CONFIRMED;
+        }
+        procIdx += p_event->attrPairLength;
+    }
+}
+
+static void ble_trspc_CheckCharHandlesDone(BLE_TRSPC_ConnList_T *p_conn)
+{
+    if (p_conn->handleCache == HANDLE_CACHE_CONFIRMED)
+    {
+        p_conn->handleCache = HANDLE_CACHE_IDLE;
+    }
+    else
+    {
+        ble_trspc_CharHandlesStale(p_conn);
+    }
+}
+
+static uint8_t *ble_trspc_QueueInAlloc(BLE_TRSPC_QueueIn_T *p_queue, uint16_t length)
+{
+    uint16_t offset;
+    uint16_t readOffset;
+
+    if (length > BLE_TRSPC_RX_BUF_SIZE)
+    {
+        return NULL;
+    }
+
+    if (p_queue->usedNum == 0)
+    {
+        offset = 0;
+    }
+    else
+    {
+        readOffset = p_queue->packetList[p_queue->readIndex].offset;
+        offset = p_queue->writeOffset;
+
+        if (offset > readOffset)
+        {
+            // Packets are kept contiguous: wrap to the start if the tail is too short.
+            if ((BLE_TRSPC_RX_BUF_SIZE - offset) < length)
+            {
+                if (readOffset < length)
+                {
+                    return NULL;
+                }
+                offset = 0;
+            }
+        }
+        else if ((readOffset - offset) < length)
+        {
+            return NULL;
+        }
+    }
+
+    p_queue->packetList[p_queue->writeIndex].length = length;
+    p_queue->packetList[p_queue->writeIndex].offset = offset;
+    p_queue->writeOffset = offset + length;
+    p_queue->writeIndex++;
+    if (p_queue->writeIndex >= BLE_TRSPC_INIT_CREDIT)
+        p_queue->writeIndex = 0;
+
+    p_queue->usedNum++;
+
+    return &p_queue->buffer[offset];
+}
+
+static void ble_trspc_QueueInRelease(BLE_TRSPC_QueueIn_T *p_queue)
+{
+    p_queue->readIndex++;
+    if (p_queue->readIndex >= BLE_TRSPC_INIT_CREDIT)
+        p_queue->readIndex = 0;
+
+    p_queue->usedNum--;
+}
+
 static void ble_trspc_RcvData(BLE_TRSPC_ConnList_T *p_conn, uint16_t receivedLen, uint8_t *p_receivedValue)
 {
     if (p_conn->inputQueue.usedNum < BLE_TRSPC_INIT_CREDIT)
@@ -464,7 +595,7 @@ static void ble_trspc_RcvData(BLE_TRSPC_ConnList_T *p_conn, uint16_t receivedLen
         uint8_t *p_buffer = NULL;
 
         memset((uint8_t *) &evtPara, 0, sizeof(evtPara));
-        p_buffer = OSAL_Malloc(receivedLen);
+        p_buffer = ble_trspc_QueueInAlloc(&p_conn->inputQueue, receivedLen);
 
         if (p_buffer == NULL)
         {
@@ -477,13 +608,6 @@ static void ble_trspc_RcvData(BLE_TRSPC_ConnList_T *p_conn, uint16_t receivedLen
         }
 
         memcpy(p_buffer, p_receivedValue, receivedLen);
-        p_conn->inputQueue.packetList[p_conn->inputQueue.writeIndex].length = receivedLen;
-        p_conn->inputQueue.packetList[p_conn->inputQueue.writeIndex].p_packet = p_buffer;
-        p_conn->inputQueue.writeIndex++;
-        if (p_conn->inputQueue.writeIndex >= BLE_TRSPC_INIT_CREDIT)
-            p_conn->inputQueue.writeIndex = 0;
-
-        p_conn->inputQueue.usedNum++;
 
         evtPara.eventId = BLE_TRSPC_EVT_RECEIVE_DATA;
         evtPara.eventField.onReceiveData.connHandle = p_conn->connHandle;
@@ -540,6 +664,13 @@ static void ble_trspc_ProcGattWriteResp(BLE_TRSPC_ConnList_T *p_conn)
                 evtPara.eventField.onUplinkStatus.status = BLE_TRSPC_UL_STATUS_CBFCENABLED;
                 bleTrspcProcess(&evtPara);
             }
+
+            if (p_conn->handleCache == HANDLE_CACHE_RESTORED)
+            {
+                /* Data flows on the cached handles, confirm them in the background. */
+                p_conn->handleCache = HANDLE_CACHE_CHECK;
+                ble_trspc_CheckCharHandles(p_conn);
+            }
         }
         break;
 
@@ -656,6 +787,28 @@ void ble_trspc_GattEventProcess(GATT_Event_T *p_event)
                 {
                     p_conn->sessionReqAuth = 1;
                 }
+                else if ((p_conn->handleCache == HANDLE_CACHE_RESTORED) && (p_event->eventField.onError.reqOpcode == ATT_WRITE_REQ))
+                {
+                    ble_trspc_CharHandlesStale(p_conn);
+                }
+                else if (((p_conn->handleCache == HANDLE_CACHE_CHECKING) || (p_conn->handleCache == HANDLE_CACHE_CONFIRMED))
+                    && (p_event->eventField.onError.reqOpcode == ATT_READ_BY_TYPE_REQ))
+                {
+                    /* Attribute Not Found ends the revalidation procedure. */
+                    ble_trspc_CheckCharHandlesDone(p_conn);
+                }
+            }
+            break;
+
+        case GATTC_EVT_DISC_CHAR_BY_UUID_RESP:
+            p_conn = ble_trspc_GetConnListByHandle(p_event->eventField.onDiscCharByUuid.connHandle);
+            if ((p_conn != NULL) && ((p_conn->handleCache == HANDLE_CACHE_CHECKING) || (p_conn->handleCache == HANDLE_CACHE_CONFIRMED)))
+            {
+                ble_trspc_ProcCharHandlesCheckResp(p_conn, &p_event->eventField.onDiscCharByUuid);
+                if (p_event->eventField.onDiscCharByUuid.procedureStatus == GATT_PROCEDURE_STATUS_FINISH)
+                {
+                    ble_trspc_CheckCharHandlesDone(p_conn);
+                }
             }
             break;
 
@@ -701,6 +854,10 @@ void ble_trspc_GattEventProcess(GATT_Event_T *p_event)
             else if (p_conn != NULL)
             {
                 ble_trspc_ProcessQueuedTask();
+                if (p_conn->handleCache == HANDLE_CACHE_CHECK)
+                {
+                    ble_trspc_CheckCharHandles(p_conn);
+                }
             }
         break;
 
@@ -762,21 +919,7 @@ void ble_trspc_GapEventProcess(BLE_GAP_Event_T *p_event)
             p_conn = ble_trspc_GetConnListByHandle(p_event->eventField.evtDisconnect.connHandle);
             if (p_conn != NULL)
             {
-                // Flush all queued data.
-                while (p_conn->inputQueue.usedNum > 0)
-                {
-                    if (p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet)
-                    {
-                        OSAL_Free(p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet);
-                        p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet = NULL;
-                    }
-
-                    p_conn->inputQueue.readIndex++;
-                    if (p_conn->inputQueue.readIndex >= BLE_TRSPC_INIT_CREDIT)
-                        p_conn->inputQueue.readIndex = 0;
-
-                    p_conn->inputQueue.usedNum--;
-                }
+                // Queued data is dropped together with the connection context.
                 ble_trspc_InitConnList(p_conn);
             }
         }
@@ -878,26 +1021,18 @@ uint16_t BLE_TRSPC_SendVendorCommand(uint16_t connHandle, uint8_t commandID, uin
         return MBA_RES_INVALID_PARA;
     }
 
-    p_writeParams = OSAL_Malloc(sizeof(GATTC_WriteParams_T));
-    if (p_writeParams != NULL)
-    {
-        p_writeParams->charHandle = s_trsCharInfoList[p_conn->connIndex][TRSPC_INDEX_CHARTCP].charHandle;
-        p_writeParams->charLength = (commandLength+1);
-        p_writeParams->charValue[0] = commandID;
-        memcpy(&p_writeParams->charValue[1], p_commandPayload, commandLength);
-        p_writeParams->writeType = ATT_WRITE_REQ;
-        p_writeParams->valueOffset = 0x0000;
-        p_writeParams->flags = 0;
-        result = GATTC_Write(p_conn->connHandle, p_writeParams);
-        if (result == MBA_RES_SUCCESS)
-            p_conn->vendorCmdProc = VENCOM_PROC_ENABLE;
-        OSAL_Free(p_writeParams);
-        return result;
-    }
-    else
-    {
-        return MBA_RES_OOM;
-    }
+    p_writeParams = &s_trspcWriteParams;
+    p_writeParams->charHandle = s_trsCharInfoList[p_conn->connIndex][TRSPC_INDEX_CHARTCP].charHandle;
+    p_writeParams->charLength = (commandLength+1);
+    p_writeParams->charValue[0] = commandID;
+    memcpy(&p_writeParams->charValue[1], p_commandPayload, commandLength);
+    p_writeParams->writeType = ATT_WRITE_REQ;
+    p_writeParams->valueOffset = 0x0000;
+    p_writeParams->flags = 0;
+    result = GATTC_Write(p_conn->connHandle, p_writeParams);
+    if (result == MBA_RES_SUCCESS)
+        p_conn->vendorCmdProc = VENCOM_PROC_ENABLE;
+    return result;
 }
 
 uint16_t BLE_TRSPC_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data)
@@ -927,12 +1062,7 @@ uint16_t BLE_TRSPC_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data)
         return MBA_RES_FAIL;
     }
 
-    p_writeParams = OSAL_Malloc(sizeof(GATTC_WriteParams_T));
-
-    if (p_writeParams == NULL)
-    {
-        return MBA_RES_OOM;
-    }
+    p_writeParams = &s_trspcWriteParams;
 
     if (p_conn->trsState & BLE_TRSPC_DL_STATUS_CBFCENABLED)
     {
@@ -944,7 +1074,6 @@ uint16_t BLE_TRSPC_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data)
     }
     else
     {
-        OSAL_Free(p_writeParams);
         return MBA_RES_BAD_STATE;
     }
 
@@ -954,7 +1083,6 @@ uint16_t BLE_TRSPC_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data)
     p_writeParams->valueOffset = 0;
     p_writeParams->flags = 0;
     result = GATTC_Write(connHandle, p_writeParams);
-    OSAL_Free(p_writeParams);
 
     if (result == MBA_RES_SUCCESS)
     {
@@ -983,43 +1111,112 @@ void BLE_TRSPC_GetDataLength(uint16_t connHandle, uint16_t *p_dataLength)
         *p_dataLength = 0;
 }
 
-uint16_t BLE_TRSPC_GetData(uint16_t connHandle, uint8_t *p_data)
+uint16_t BLE_TRSPC_PeekData(uint16_t connHandle, uint8_t **pp_data, uint16_t *p_dataLength)
 {
     BLE_TRSPC_ConnList_T *p_conn = NULL;
+    BLE_TRSPC_PacketList_T *p_packet;
 
     p_conn = ble_trspc_GetConnListByHandle(connHandle);
-    if (p_conn)
+    if ((p_conn == NULL) || (p_conn->inputQueue.usedNum == 0))
     {
-        if ((p_conn->inputQueue.usedNum) > 0)
-        {
-            if (p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet)
-            {
-                memcpy(p_data, p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet, 
-                    p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].length);
-                OSAL_Free(p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet);
-                p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet = NULL;
-            }
+        return MBA_RES_FAIL;
+    }
 
-            p_conn->inputQueue.readIndex++;
-            if (p_conn->inputQueue.readIndex >= BLE_TRSPC_INIT_CREDIT)
-                p_conn->inputQueue.readIndex = 0;
+    p_packet = &p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex];
+    *pp_data = &p_conn->inputQueue.buffer[p_packet->offset];
+    *p_dataLength = p_packet->length;
 
-            p_conn->inputQueue.usedNum --;
+    return MBA_RES_SUCCESS;
+}
 
-            if (p_conn->trsState & BLE_TRSPC_UL_STATUS_CBFCENABLED)
-            {
-                p_conn->peerCredit++;
-                if (p_conn->peerCredit >= BLE_TRSPC_MAX_RETURN_CREDIT)
-                    ble_trspc_ClientReturnCredit(p_conn);
-            }
+uint16_t BLE_TRSPC_ReleaseData(uint16_t connHandle)
+{
+    BLE_TRSPC_ConnList_T *p_conn = NULL;
 
-            return MBA_RES_SUCCESS;
-        }
-        else
-            return MBA_RES_FAIL;
+    p_conn = ble_trspc_GetConnListByHandle(connHandle);
+    if ((p_conn == NULL) || (p_conn->inputQueue.usedNum == 0))
+    {
+        return MBA_RES_FAIL;
     }
-    else
+
+    ble_trspc_QueueInRelease(&p_conn->inputQueue);
+
+    if (p_conn->trsState & BLE_TRSPC_UL_STATUS_CBFCENABLED)
+    {
+        p_conn->peerCredit++;
+        if (p_conn->peerCredit >= BLE_TRSPC_MAX_RETURN_CREDIT)
+            ble_trspc_ClientReturnCredit(p_conn);
+    }
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_TRSPC_GetData(uint16_t connHandle, uint8_t *p_data)
+{
+    uint8_t *p_packet;
+    uint16_t length;
+
+    if (BLE_TRSPC_PeekData(connHandle, &p_packet, &length) != MBA_RES_SUCCESS)
+    {
         return MBA_RES_FAIL;
+    }
+
+    memcpy(p_data, p_packet, length);
+
+    return BLE_TRSPC_ReleaseData(connHandle);
+}
+
+uint16_t BLE_TRSPC_GetCharHandles(uint16_t connHandle, BLE_TRSPC_CharHandles_T *p_handles)
+{
+    BLE_TRSPC_ConnList_T *p_conn;
+    BLE_DD_CharInfo_T *p_charInfo;
+
+    p_conn = ble_trspc_GetConnListByHandle(connHandle);
+    if (p_conn == NULL)
+    {
+        return MBA_RES_FAIL;
+    }
+
+    p_charInfo = s_trsCharInfoList[p_conn->connIndex];
+    if (p_charInfo[TRSPC_INDEX_CHARTCP].charHandle == 0)
+    {
+        return MBA_RES_FAIL;
+    }
+
+    p_handles->tudHandle = p_charInfo[TRSPC_INDEX_CHARTUD].charHandle;
+    p_handles->tudCccdHandle = p_charInfo[TRSPC_INDEX_CHARTUDCCCD].charHandle;
+    p_handles->tddHandle = p_charInfo[TRSPC_INDEX_CHARTDD].charHandle;
+    p_handles->tcpHandle = p_charInfo[TRSPC_INDEX_CHARTCP].charHandle;
+    p_handles->tcpCccdHandle = p_charInfo[TRSPC_INDEX_CHARTCPCCCD].charHandle;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_TRSPC_RestoreCharHandles(uint16_t connHandle, const BLE_TRSPC_CharHandles_T *p_handles)
+{
+    BLE_TRSPC_ConnList_T *p_conn;
+    BLE_DD_CharInfo_T *p_charInfo;
+
+    p_conn = ble_trspc_GetConnListByHandle(connHandle);
+    if (p_conn == NULL)
+    {
+        return MBA_RES_FAIL;
+    }
+
+    if ((p_handles->tudHandle < 2) || (p_handles->tudCccdHandle == 0) || (p_handles->tddHandle == 0)
+        || (p_handles->tcpHandle == 0) || (p_handles->tcpCccdHandle <= p_handles->tudHandle))
+    {
+        return MBA_RES_INVALID_PARA;
+    }
+
+    p_charInfo = s_trsCharInfoList[p_conn->connIndex];
+    p_charInfo[TRSPC_INDEX_CHARTUD].charHandle = p_handles->tudHandle;
+    p_charInfo[TRSPC_INDEX_CHARTUDCCCD].charHandle = p_handles->tudCccdHandle;
+    p_charInfo[TRSPC_INDEX_CHARTDD].charHandle = p_handles->tddHandle;
+    p_charInfo[TRSPC_INDEX_CHARTCP].charHandle = p_handles->tcpHandle;
+    p_charInfo[TRSPC_INDEX_CHARTCPCCCD].charHandle = p_handles->tcpCccdHandle;
+
+    p_conn->handleCache = HANDLE_CACHE_RESTORED;
+    return ble_trspc_EnableDataSession(connHandle, (BLE_TRSPC_CBFC_DL_ENABLED|BLE_TRSPC_CBFC_UL_ENABLED));
 }
 
 void BLE_TRSPC_BleEventHandler(STACK_Event_T *p_stackEvent)
@@ -103,7 +103,8 @@ typedef enum BLE_TRSPC_EventId_T
     BLE_TRSPC_EVT_VENDOR_CMD,                           /**< Transparent Profile vendor command received notification event. See @ref BLE_TRSPC_EvtVendorCmd_T for event details. */
     BLE_TRSPC_EVT_VENDOR_CMD_RSP,                       /**< Transparent Profile Vendor command response received notification event. See @ref BLE_TRSPC_EvtVendorCmdRsp_T for event details. */
     BLE_TRSPC_EVT_DISC_COMPLETE,                        /**< Transparent Profile discovery complete event. See @ref BLE_TRSPC_EvtDiscComplete_T for event details. */
-    BLE_TRSPC_EVT_ERR_NO_MEM,                           /**< Profile internal error occurs due to insufficient heap memory. */
+    BLE_TRSPC_EVT_ERR_NO_MEM,                           /**< Profile internal error occurs because the receive buffer has no room for the packet. */
+    BLE_TRSPC_EVT_CHAR_HANDLES_STALE,                   /**< Handles given by @ref BLE_TRSPC_RestoreCharHandles do not match the peer database, discovery is restarted. See @ref BLE_TRSPC_EvtCharHandlesStale_T for event details. */
     BLE_TRSPC_EVT_END
 }BLE_TRSPC_EventId_T;
 
@@ -159,6 +160,12 @@ typedef struct BLE_TRSPC_EvtDiscComplete_T
     uint16_t        connHandle;                         /**< Connection handle associated with this connection. */
 }   BLE_TRSPC_EvtDiscComplete_T;
 
+/**@brief Data structure for @ref BLE_TRSPC_EVT_CHAR_HANDLES_STALE event. */
+typedef struct BLE_TRSPC_EvtCharHandlesStale_T
+{
+    uint16_t        connHandle;                         /**< Connection handle associated with this connection. */
+}   BLE_TRSPC_EvtCharHandlesStale_T;
+
 /**@brief The union of BLE Transparent profile client event types. */
 typedef union
 {
@@ -168,6 +175,7 @@ typedef union
     BLE_TRSPC_EvtVendorCmd_T        onVendorCmd;        /**< Handle @ref BLE_TRSPC_EVT_VENDOR_CMD. */
     BLE_TRSPC_EvtVendorCmdRsp_T     onVendorCmdRsp;     /**< Handle @ref BLE_TRSPC_EVT_VENDOR_CMD_RSP. */
     BLE_TRSPC_EvtDiscComplete_T     onDiscComplete;     /**< Handle @ref BLE_TRSPC_EVT_DISC_COMPLETE. */
+    BLE_TRSPC_EvtCharHandlesStale_T onCharHandlesStale; /**< Handle @ref BLE_TRSPC_EVT_CHAR_HANDLES_STALE. */
 } BLE_TRSPC_EventField_T;
 
 
@@ -178,6 +186,16 @@ typedef struct  BLE_TRSPC_Event_T
     BLE_TRSPC_EventField_T      eventField;             /**< Event field. */
 } BLE_TRSPC_Event_T;
 
+/**@brief Handles of the TRS characteristics and descriptors found on a peer. */
+typedef struct BLE_TRSPC_CharHandles_T
+{
+    uint16_t        tudHandle;                          /**< Transparent Uplink Data characteristic value handle. */
+    uint16_t        tudCccdHandle;                      /**< Transparent Uplink Data characteristic CCCD handle. */
+    uint16_t        tddHandle;                          /**< Transparent Downlink Data characteristic value handle. */
+    uint16_t        tcpHandle;                          /**< Transparent Control Point characteristic value handle. */
+    uint16_t        tcpCccdHandle;                      /**< Transparent Control Point characteristic CCCD handle. */
+}   BLE_TRSPC_CharHandles_T;
+
 /**@brief BLE Transparent profile cliet callback type. This callback function sends BLE Transparent profile client events to the application. */
 typedef void(*BLE_TRSPC_EventCb_T)(BLE_TRSPC_Event_T *p_event);
 
@@ -254,6 +272,56 @@ void BLE_TRSPC_GetDataLength(uint16_t connHandle, uint16_t *p_dataLength);
  */
 uint16_t BLE_TRSPC_GetData(uint16_t connHandle, uint8_t *p_data);
 
+/**@brief Get a borrowed pointer to the oldest queued packet without copying it.
+ *        The data stays valid until @ref BLE_TRSPC_ReleaseData or @ref BLE_TRSPC_GetData consumes the packet.
+ *
+ * @param[in]  connHandle                   Connection handle associated with the queued data
+ * @param[out] pp_data                      Pointer to the packet data in the profile receive buffer.
+ * @param[out] p_dataLength                 Data length.
+ *
+ * @retval MBA_RES_SUCCESS                  Successfully get the packet.
+ * @retval MBA_RES_FAIL                     No data in the input queue or can not find the link.
+ *
+ */
+uint16_t BLE_TRSPC_PeekData(uint16_t connHandle, uint8_t **pp_data, uint16_t *p_dataLength);
+
+/**@brief Consume the oldest queued packet after it was read with @ref BLE_TRSPC_PeekData.
+ *
+ * @param[in]  connHandle                   Connection handle associated with the queued data
+ *
+ * @retval MBA_RES_SUCCESS                  Successfully release the packet.
+ * @retval MBA_RES_FAIL                     No data in the input queue or can not find the link.
+ *
+ */
+uint16_t BLE_TRSPC_ReleaseData(uint16_t connHandle);
+
+/**@brief Get the TRS handles of a connection, e.g. to cache them after @ref BLE_TRSPC_EVT_DISC_COMPLETE.
+ *
+ * @param[in]  connHandle                   Connection handle associated with this connection.
+ * @param[out] p_handles                    Pointer to the handles buffer.
+ *
+ * @retval MBA_RES_SUCCESS                  Successfully get the handles.
+ * @retval MBA_RES_FAIL                     Invalid connection or the TRS was not discovered.
+ *
+ */
+uint16_t BLE_TRSPC_GetCharHandles(uint16_t connHandle, BLE_TRSPC_CharHandles_T *p_handles);
+
+/**@brief Use previously discovered TRS handles instead of discovering the peer database.
+ *        The data session is enabled immediately. Once it is up the cached handles are revalidated
+ *        with a single Read By Type request; if they turn out stale, or a request on them fails,
+ *        @ref BLE_TRSPC_EVT_CHAR_HANDLES_STALE is sent and BLE_DD discovery is restarted.
+ * @note  BLE_DD discovery for this connection shall be skipped with disableConnectedDisc in @ref BLE_DD_Config_T.
+ *
+ * @param[in] connHandle                    Connection handle associated with this connection.
+ * @param[in] p_handles                     Pointer to the cached handles.
+ *
+ * @retval MBA_RES_SUCCESS                  Successfully start the data session.
+ * @retval MBA_RES_FAIL                     Invalid connection.
+ * @retval MBA_RES_INVALID_PARA             Handles are invalid.
+ *
+ */
+uint16_t BLE_TRSPC_RestoreCharHandles(uint16_t connHandle, const BLE_TRSPC_CharHandles_T *p_handles);
+
 /**@brief Handle BLE_Stack events.
  *        This API should be called in the application while caching BLE_Stack events
  *
@@ -60,6 +60,19 @@
 /* This is the driver instance object array. */
 static DRV_SPI_OBJ gDrvSPIObj[DRV_SPI_INSTANCES_NUMBER];
 
+#ifdef APP_STATIC_ALLOCATION
+/* Storage of the driver mutexes and semaphores in the static allocation profile */
+typedef struct
+{
+    StaticSemaphore_t   transferMutex;
+    StaticSemaphore_t   clientMutex;
+    StaticSemaphore_t   transferDone;
+    StaticSemaphore_t   mutexExclusiveUse;
+} DRV_SPI_OSAL_OBJ;
+
+static DRV_SPI_OSAL_OBJ gDrvSPIOsalObj[DRV_SPI_INSTANCES_NUMBER] APP_STATIC_SECTION("rtos");
+#endif
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: File scope functions
@@ -252,6 +265,12 @@ SYS_MODULE_OBJ DRV_SPI_Initialize( const SYS_MODULE_INDEX drvIndex, const SYS_MO
 
 
 
+#ifdef APP_STATIC_ALLOCATION
+    dObj->transferMutex = xSemaphoreCreateMutexStatic(&gDrvSPIOsalObj[drvIndex].transferMutex);
+    dObj->clientMutex = xSemaphoreCreateMutexStatic(&gDrvSPIOsalObj[drvIndex].clientMutex);
+    dObj->transferDone = xSemaphoreCreateBinaryStatic(&gDrvSPIOsalObj[drvIndex].transferDone);
+    dObj->mutexExclusiveUse = xSemaphoreCreateMutexStatic(&gDrvSPIOsalObj[drvIndex].mutexExclusiveUse);
+#else
     if (OSAL_MUTEX_Create(&dObj->transferMutex) == OSAL_RESULT_FALSE)
     {
         /*  If the mutex was not created because the memory required to
@@ -277,6 +296,7 @@ SYS_MODULE_OBJ DRV_SPI_Initialize( const SYS_MODULE_INDEX drvIndex, const SYS_MO
     {
         return SYS_MODULE_OBJ_INVALID;
     }
+#endif
 
     /* Register a callback with PLIB.
      * dObj as a context parameter will be used to distinguish the events
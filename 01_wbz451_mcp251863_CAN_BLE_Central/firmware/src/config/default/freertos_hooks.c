@@ -144,6 +144,22 @@ void vApplicationTickHook( void )
 
 /*-----------------------------------------------------------*/
 
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+static StaticTask_t s_idleTaskTcb APP_STATIC_SECTION("rtos");
+static StackType_t  s_idleTaskStack[configMINIMAL_STACK_SIZE] APP_STATIC_SECTION("rtos");
+
+void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize )
+{
+    /* Required once configSUPPORT_STATIC_ALLOCATION is set, the idle task
+    then no longer takes its stack from the heap. */
+    *ppxIdleTaskTCBBuffer = &s_idleTaskTcb;
+    *ppxIdleTaskStackBuffer = s_idleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+#endif
+
+/*-----------------------------------------------------------*/
+
 /* Error Handler */
 void vAssertCalled( const char * pcFile, unsigned long ulLine )
 {
@@ -33,6 +33,31 @@ extern "C" {
 // *****************************************************************************
 // *****************************************************************************
 
+/* Static allocation build profile. When defined, the application and BLE
+   stack tasks, appQueue and the SPI driver mutexes/semaphores use statically
+   allocated memory instead of the FreeRTOS heap, so their size is fixed at
+   link time and the whole configTOTAL_HEAP_SIZE is left to the BLE stack. */
+//#define APP_STATIC_ALLOCATION
+
+/* Places a zero-initialized object in a named .bss.app_static.<group> input
+   section. The linker still collects it into .bss, the map file then lists
+   it under its group for the memory budget report (tools/mem_budget.py). */
+#define APP_STATIC_SECTION(group)   __attribute__((section(".bss.app_static." group)))
+
+/* Run time statistics and periodic telemetry records (app_telemetry.h).
+   Every context switch reads the DWT cycle counter. */
+//#define APP_TELEMETRY_ENABLE
+
+/* Separate CAN to BLE and BLE to CAN queues, served by deficit round robin
+   in APP_Tasks, so a flood in one direction cannot hold up the other one.
+   Queue depth and the budgets of the directions are set in app.h. */
+//#define APP_DIR_SCHED_ENABLE
+
+/* Counts the RX FIFO overflows of the CAN controller and drains the RX FIFO
+   in bursts, with APP_Tasks raised above the BLE stack, while it is above
+   half full. The burst length and the raised priority are set in app.h. */
+//#define APP_RX_ADAPT_ENABLE
+
 
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus
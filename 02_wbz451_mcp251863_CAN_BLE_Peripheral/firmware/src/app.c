@@ -53,11 +53,27 @@
 // *****************************************************************************
 #include <string.h>
 #include "app.h"
+#include "can_bridge/spsc_ring.h"
+#include "can_bridge/can_trace.h"
+#include "can_bridge/can_log.h"
+#include "can_bridge/can_bench.h"
+#include "can_bridge/can_replay.h"
+#include "can_bridge/can_isotp.h"
+#include "can_bridge/can_j1939.h"
+#include "can_bridge/can_cache.h"
+#include "can_bridge/can_cyclic.h"
+#include "can_bridge/can_mbox.h"
+#include "can_bridge/can_qos.h"
+#include "can_bridge/can_err.h"
+#include "can_bridge/can_stats.h"
+#include "app_telemetry.h"
+#include "mba_error_defs.h"
 #include "definitions.h"
 #include "app_ble.h"
 #include "ble_trsps/ble_trsps.h"
 
-//#define ENABLE_CONSOLE_PRINT
+/* CAN identifier as logged: 11 bit SID or 29 bit SID:EID. */
+#define APP_LOG_CAN_ID(obj)     ((obj).bF.ctrl.IDE ? (((uint32_t)(obj).bF.id.SID << 18) | (obj).bF.id.EID) : (uint32_t)(obj).bF.id.SID)
 
 // *****************************************************************************
 // *****************************************************************************
@@ -74,10 +90,46 @@ typedef struct CAN_MSG_t {
         CAN_RX_MSGOBJ rxObj;
     }msgObj;
     uint8_t can_data[MAX_DATA_BYTES];
+#ifdef CAN_TRACE_ENABLE
+    uint32_t traceEdge;     /* EIC edge time stamp, not sent over BLE */
+#endif
 }CAN_MSG_t;
 
 bool ramInitialized = false;
 
+SPSC_RING_DEFINE(s_appEvtRing, APP_Evt_T, APP_EVT_RING_SIZE);
+static bool s_appCanIntPending;            /* INT sources left set by APP_EvtTasks */
+
+#ifdef APP_STATIC_ALLOCATION
+static uint8_t       s_appQueueStorage[APP_QUEUE_LEN * sizeof(APP_Msg_T)] APP_STATIC_SECTION("rtos");
+static StaticQueue_t s_appQueueObj APP_STATIC_SECTION("rtos");
+#endif
+
+#ifdef APP_DIR_SCHED_ENABLE
+typedef struct APP_DirMsg_T
+{
+    TickType_t  tick;                   /* Queued at */
+    CAN_MSG_t   canMsg;
+} APP_DirMsg_T;
+
+static OSAL_QUEUE_HANDLE_TYPE   s_appDirQueue[APP_DIR_NUM];
+static int16_t                  s_appDirDeficit[APP_DIR_NUM];
+static APP_DirStats_T           s_appDirStats[APP_DIR_NUM];
+#ifdef APP_STATIC_ALLOCATION
+static uint8_t       s_appDirQueueStorage[APP_DIR_NUM][APP_DIR_QUEUE_LEN * sizeof(APP_DirMsg_T)] APP_STATIC_SECTION("rtos");
+static StaticQueue_t s_appDirQueueObj[APP_DIR_NUM] APP_STATIC_SECTION("rtos");
+#endif
+#endif
+
+#ifdef APP_RX_ADAPT_ENABLE
+static APP_RxStats_T    s_appRxStats;
+static uint8_t          s_appRxBurst;       /* Frames left that need no status read */
+static UBaseType_t      s_appRxBasePriority;
+static bool             s_appRxBoosted;
+#endif
+
+extern TaskHandle_t xAPP_Tasks;
+
 // *****************************************************************************
 /* Application Data
 
@@ -113,33 +165,599 @@ APP_DATA appData;
 
 void CAN_Receive_Callback(void)
 {
-    APP_Msg_T appCANMsg;
-    appCANMsg.msgId = APP_MSG_CAN_RECV_CB;
-    OSAL_QUEUE_SendISR(&appData.appQueue, &appCANMsg);
+    APP_Evt_T evt = { APP_EVT_CAN_RX, 0, 0 };
+    BaseType_t taskWoken = pdFALSE;
+
+    CAN_TRACE_EDGE();
+    /* A full ring still wakes the task, the RX FIFO is drained completely. */
+    SPSC_RING_Push(&s_appEvtRing, &evt);
+    xTaskNotifyFromISR(xAPP_Tasks, APP_NOTIFY_EVT, eSetBits, &taskWoken);
+    portYIELD_FROM_ISR(taskWoken);
+}
+
+void APP_MsgNotify(void)
+{
+    xTaskNotify(xAPP_Tasks, APP_NOTIFY_MSG, eSetBits);
+}
+
+static void APP_WaitNotify(uint16_t waitMs)
+{
+    TickType_t timeout;
+
+    if (waitMs == OSAL_WAIT_FOREVER)
+    {
+        timeout = portMAX_DELAY;
+    }
+    else
+    {
+        timeout = (TickType_t)(waitMs / portTICK_PERIOD_MS);
+    }
+    xTaskNotifyWait(0, APP_NOTIFY_EVT | APP_NOTIFY_MSG, NULL, timeout);
+}
+
+#ifdef APP_RX_ADAPT_ENABLE
+/* Counts and clears the overflow flags of all RX FIFOs. A flag stays set
+   from the first frame the full FIFO lost until it is cleared, so every
+   event lost one frame or more. */
+static void APP_RxOverflowCount(void)
+{
+    uint32_t rxovif = 0;
+    uint8_t ch;
+
+    DRV_CANFDSPI_ReceiveEventOverflowGet(DRV_CANFDSPI_INDEX_0, &rxovif);
+    for (ch = 0; ch < APP_RX_OVF_CH_NUM; ch++)
+    {
+        if (rxovif & (1UL << ch))
+        {
+            DRV_CANFDSPI_ReceiveChannelEventOverflowClear(DRV_CANFDSPI_INDEX_0, (CAN_FIFO_CHANNEL)ch);
+            s_appRxStats.overflow[ch]++;
+            CAN_LOG2(CAN_LOG_RX_OVERFLOW, ch, s_appRxStats.overflow[ch]);
+        }
+    }
+}
+
+/* Raises APP_Tasks above the BLE stack until the RX FIFO is drained, the
+   FIFO fills up while the task is preempted. */
+static void APP_RxBoost(void)
+{
+    s_appRxStats.boosts++;
+    if (!s_appRxBoosted)
+    {
+        s_appRxBasePriority = uxTaskPriorityGet(NULL);
+        vTaskPrioritySet(NULL, APP_RX_BOOST_PRIORITY);
+        s_appRxBoosted = true;
+    }
 }
 
-void APP_ReceiveMessage_Tasks()
+static void APP_RxBoostEnd(void)
+{
+    s_appRxBurst = 0;
+    if (s_appRxBoosted)
+    {
+        vTaskPrioritySet(NULL, s_appRxBasePriority);
+        s_appRxBoosted = false;
+    }
+}
+
+const APP_RxStats_T *APP_RxStatsGet(void)
+{
+    return &s_appRxStats;
+}
+#endif
+
+bool APP_ReceiveMessage_Tasks()
 {
     APP_Msg_T appCANMsgQueue;
     CAN_MSG_t *canMsg = (CAN_MSG_t *)&appCANMsgQueue.msgData;
     CAN_RX_FIFO_EVENT rxFlags;
+#ifdef CAN_CYCLIC_ENABLE
+    uint16_t periodMs;
+#endif
 
+#ifdef APP_RX_ADAPT_ENABLE
+    if (s_appRxBurst != 0U)
+    {
+        // The FIFO was half full, these frames are known to be there
+        s_appRxBurst--;
+        s_appRxStats.burstFrames++;
+        rxFlags = CAN_RX_FIFO_NOT_EMPTY_EVENT;
+    }
+    else
+    {
+        DRV_CANFDSPI_ReceiveChannelEventGet(DRV_CANFDSPI_INDEX_0, APP_RX_FIFO, &rxFlags);
+        if (rxFlags & CAN_RX_FIFO_OVERFLOW_EVENT)
+        {
+            APP_RxOverflowCount();
+        }
+        if (rxFlags & CAN_RX_FIFO_HALF_FULL_EVENT)
+        {
+            // Above the high-water mark, drain a burst at raised priority
+            APP_RxBoost();
+            s_appRxBurst = APP_RX_BURST_LEN - 1U;
+        }
+    }
+#else
     DRV_CANFDSPI_ReceiveChannelEventGet(DRV_CANFDSPI_INDEX_0, APP_RX_FIFO, &rxFlags);
+#endif
     if (rxFlags & CAN_RX_FIFO_NOT_EMPTY_EVENT)
     {
+#ifdef CAN_TRACE_ENABLE
+        canMsg->traceEdge = CAN_TRACE_EdgeTake();
+        CAN_TRACE_SINCE(CAN_TRACE_P_ISR_WAKE, canMsg->traceEdge);
+#endif
+        CAN_TRACE_BEGIN(readStamp);
         DRV_CANFDSPI_ReceiveMessageGet(DRV_CANFDSPI_INDEX_0, APP_RX_FIFO, &canMsg->msgObj.rxObj, canMsg->can_data, MAX_DATA_BYTES);
-#ifdef ENABLE_CONSOLE_PRINT
-        SYS_CONSOLE_PRINT("New Message Received from CAN BUS\r\nMessage ID: 0x%X, DLC: 0x%X\r\nMessage: ", canMsg->msgObj.rxObj.bF.id.SID, canMsg->msgObj.rxObj.bF.ctrl.DLC);
-        for(uint8_t i = 0; i<canMsg->msgObj.rxObj.bF.ctrl.DLC; i++)
+        CAN_TRACE_END(CAN_TRACE_P_FIFO_READ, readStamp);
+        CAN_LOG4(CAN_LOG_CAN_RX, APP_LOG_CAN_ID(canMsg->msgObj.rxObj), canMsg->msgObj.rxObj.bF.ctrl.DLC,
+                 CAN_LOG_BE32(&canMsg->can_data[0]), CAN_LOG_BE32(&canMsg->can_data[4]));
+#ifdef CAN_STATS_ENABLE
+        CAN_STATS_RxFrame(&canMsg->msgObj.rxObj);
+        // The data PDU carries no time stamp, as without the statistics
+        canMsg->msgObj.rxObj.bF.timeStamp = 0;
+#endif
+#ifdef CAN_BENCH_ENABLE
+        if (CAN_BENCH_RxFrame(&canMsg->msgObj.rxObj, canMsg->can_data))
         {
-            SYS_CONSOLE_PRINT(" 0x%X",canMsg->can_data[i]);
+            return true;
         }
-        SYS_CONSOLE_PRINT("\r\n\n");
-#endif        
+#endif
+#ifdef CAN_ISOTP_ENABLE
+        if (CAN_ISOTP_RxFrame(&canMsg->msgObj.rxObj, canMsg->can_data))
+        {
+            return true;
+        }
+#endif
+#ifdef CAN_J1939_ENABLE
+        if (CAN_J1939_RxFrame(&canMsg->msgObj.rxObj, canMsg->can_data))
+        {
+            return true;
+        }
+#endif
+#ifdef CAN_CYCLIC_ENABLE
+        // Tag cyclic frames with their period, the peer repeats the last payload
+        if (CAN_CACHE_RxFrame(&canMsg->msgObj.rxObj, canMsg->can_data, &periodMs))
+        {
+            return true;
+        }
+        canMsg->msgObj.rxObj.bF.timeStamp = CAN_CYCLIC_Stamp(periodMs);
+#elif defined(CAN_CACHE_ENABLE)
+        if (CAN_CACHE_RxFrame(&canMsg->msgObj.rxObj, canMsg->can_data, NULL))
+        {
+            return true;
+        }
+#endif
+#ifdef CAN_MBOX_ENABLE
+        if (CAN_MBOX_RxFrame(&canMsg->msgObj.rxObj, canMsg->can_data))
+        {
+#ifdef APP_CAN_BCAST_ENABLE
+            // The advertising train does not wait for the link
+            APP_BcastFrameAdd(&canMsg->msgObj.rxObj, canMsg->can_data);
+#endif
+            return true;
+        }
+#endif
+#ifdef CAN_QOS_ENABLE
+        // Sent by APP_QosService in the order of the classes
+        CAN_QOS_RxFrame(&canMsg->msgObj.rxObj, canMsg->can_data);
+#ifdef APP_CAN_BCAST_ENABLE
+        // The advertising train does not wait for the link
+        APP_BcastFrameAdd(&canMsg->msgObj.rxObj, canMsg->can_data);
+#endif
+        return true;
+#elif defined(APP_DIR_SCHED_ENABLE)
+        if (!APP_DirPost(APP_DIR_CAN_TO_BLE, (uint8_t *)canMsg, sizeof(CAN_MSG_t)))
+        {
+            CAN_LOG1(CAN_LOG_CAN_RX_DROP, APP_LOG_CAN_ID(canMsg->msgObj.rxObj));
+            return false;
+        }
+        return true;
+#else
         appCANMsgQueue.msgId = APP_MSG_BLE_TX_CAN_RX_EVT;
-        OSAL_QUEUE_Send(&appData.appQueue, &appCANMsgQueue, 0);
+        if (OSAL_QUEUE_Send(&appData.appQueue, &appCANMsgQueue, 0) != OSAL_RESULT_TRUE)
+        {
+            CAN_LOG1(CAN_LOG_CAN_RX_DROP, APP_LOG_CAN_ID(canMsg->msgObj.rxObj));
+            return false;
+        }
+        return true;
+#endif
+    }
+    return false;
+}
+
+#ifdef CAN_STATS_ENABLE
+/* Counts a frame no bridge filter took, only its header is read. */
+static bool APP_StatsReceive_Tasks(void)
+{
+    CAN_RX_MSGOBJ rxObj;
+    CAN_RX_FIFO_EVENT rxFlags;
+
+    DRV_CANFDSPI_ReceiveChannelEventGet(DRV_CANFDSPI_INDEX_0, APP_STATS_FIFO, &rxFlags);
+    if (!(rxFlags & CAN_RX_FIFO_NOT_EMPTY_EVENT))
+    {
+        return false;
+    }
+    DRV_CANFDSPI_ReceiveMessageGet(DRV_CANFDSPI_INDEX_0, APP_STATS_FIFO, &rxObj, NULL, 0);
+    CAN_STATS_RxFrame(&rxObj);
+    return true;
+}
+#endif
+
+/* CiINT flags of the sources APP_CANFDSPI_Init enables on the INT pin */
+#if defined(CAN_ERR_ENABLE) && defined(APP_RX_ADAPT_ENABLE)
+#define APP_CAN_INT_EVENTS      (CAN_RX_EVENT | CAN_BUS_ERROR_EVENT | CAN_RX_OVERFLOW_EVENT)
+#elif defined(CAN_ERR_ENABLE)
+#define APP_CAN_INT_EVENTS      (CAN_RX_EVENT | CAN_BUS_ERROR_EVENT)
+#elif defined(APP_RX_ADAPT_ENABLE)
+#define APP_CAN_INT_EVENTS      (CAN_RX_EVENT | CAN_RX_OVERFLOW_EVENT)
+#else
+#define APP_CAN_INT_EVENTS      CAN_RX_EVENT
+#endif
+
+static void APP_EvtTasks(void)
+{
+    APP_Evt_T evt;
+    CAN_MODULE_EVENT modFlags = CAN_NO_EVENT;
+    bool canRx = s_appCanIntPending;
+    uint8_t passes = 0;
+
+    while (SPSC_RING_Pop(&s_appEvtRing, &evt))
+    {
+        switch (evt.evtId)
+        {
+            case APP_EVT_CAN_RX:
+                canRx = true;
+            break;
+
+            default:
+            break;
+        }
+    }
+
+    if (!canRx)
+    {
+        return;
+    }
+
+    BLUE_LED_Set();
+#ifdef CAN_ERR_ENABLE
+    // The bus error interrupt shares the pin, poll the error state at once
+    DRV_CANFDSPI_ModuleEventGet(DRV_CANFDSPI_INDEX_0, &modFlags);
+#endif
+    // INT is the OR of the enabled sources and the EIC only sees
+    // its falling edge, so leave once they all read clear
+    do
+    {
+#ifdef CAN_ERR_ENABLE
+        if (modFlags & CAN_BUS_ERROR_EVENT)
+        {
+            DRV_CANFDSPI_ModuleEventClear(DRV_CANFDSPI_INDEX_0, CAN_BUS_ERROR_EVENT);
+            CAN_ERR_Event();
+        }
+#endif
+#ifdef APP_RX_ADAPT_ENABLE
+        if (modFlags & CAN_RX_OVERFLOW_EVENT)
+        {
+            // Also clears an overflow of a FIFO other than the bridge FIFO
+            APP_RxOverflowCount();
+        }
+#endif
+        while (APP_ReceiveMessage_Tasks())
+        {
+        }
+#ifdef CAN_STATS_ENABLE
+        while (APP_StatsReceive_Tasks())
+        {
+        }
+#endif
+        DRV_CANFDSPI_ModuleEventGet(DRV_CANFDSPI_INDEX_0, &modFlags);
+    }
+    while ((modFlags & APP_CAN_INT_EVENTS) && (++passes < APP_CAN_INT_PASSES));
+#ifdef APP_RX_ADAPT_ENABLE
+    APP_RxBoostEnd();
+#endif
+
+    // Under sustained traffic the appQueue fills first: let APP_Tasks serve
+    // it and come straight back, no new edge arrives while INT is held low
+    s_appCanIntPending = ((modFlags & APP_CAN_INT_EVENTS) != 0U);
+    if (s_appCanIntPending)
+    {
+        xTaskNotify(xAPP_Tasks, APP_NOTIFY_EVT, eSetBits);
+    }
+}
+
+#ifdef APP_TELEMETRY_ENABLE
+/* Sends the pending telemetry fragments while appQueue is empty. Returns
+   the time until the next telemetry work. */
+static uint16_t APP_TelemetryService(uint16_t waitMs)
+{
+    uint8_t frag[APP_TELEMETRY_FRAG_LEN];
+    uint8_t len;
+    uint16_t result;
+    uint16_t nextMs = APP_TelemetryTasks();
+
+    while (uxQueueMessagesWaiting(appData.appQueue) == 0)
+    {
+        len = APP_TelemetryFragmentGet(frag);
+        if (len == 0)
+        {
+            break;
+        }
+
+        result = BLE_TRSPS_SendVendorCommand(conn_hdl, APP_TELEMETRY_VENDOR_OPCODE, len, frag);
+        if (result == MBA_RES_SUCCESS)
+        {
+            APP_TelemetryFragmentSent();
+        }
+        else if ((result == MBA_RES_OOM) || (result == MBA_RES_NO_RESOURCE) || (result == MBA_RES_BUSY))
+        {
+            nextMs = APP_TELEMETRY_RETRY_MS;
+            break;
+        }
+        else
+        {
+            APP_TelemetryRecordDrop();
+            break;
+        }
+    }
+    return (nextMs < waitMs) ? nextMs : waitMs;
+}
+#endif
+
+#if defined(CAN_BENCH_ENABLE) || defined(CAN_REPLAY_ENABLE) || defined(CAN_ISOTP_ENABLE) || defined(CAN_J1939_ENABLE) \
+    || defined(CAN_CYCLIC_ENABLE) || defined(CAN_ERR_ENABLE)
+/* Loads a frame into a TX FIFO if it has room. */
+static bool APP_CanTx(CAN_FIFO_CHANNEL fifo, CAN_TX_MSGOBJ *p_obj, const uint8_t *p_data)
+{
+    CAN_TX_FIFO_EVENT txFlags;
+
+    DRV_CANFDSPI_TransmitChannelEventGet(DRV_CANFDSPI_INDEX_0, fifo, &txFlags);
+    if (!(txFlags & CAN_TX_FIFO_NOT_FULL_EVENT))
+    {
+        return false;
+    }
+    return (DRV_CANFDSPI_TransmitChannelLoad(DRV_CANFDSPI_INDEX_0, fifo, p_obj, (uint8_t *)p_data,
+                                             DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)p_obj->bF.ctrl.DLC), true) == 0);
+}
+#endif
+
+#ifdef CAN_BENCH_ENABLE
+/* Loads a benchmark frame into the TX FIFO if it has room. */
+static bool APP_BenchTx(uint16_t sid, uint8_t dlc, const uint8_t *p_data)
+{
+    CAN_TX_MSGOBJ txObj;
+
+    memset(&txObj, 0, sizeof(txObj));
+    txObj.bF.id.SID = sid;
+    txObj.bF.ctrl.DLC = dlc;
+    return APP_CanTx(APP_TX_FIFO, &txObj, p_data);
+}
+
+#ifdef CAN_BENCH_LOCAL_LOOP
+/* Hands an encoded frame to the BLE receive path of this board, in the
+   format the TRS event handler posts. */
+static void APP_BenchLocalLoop(uint8_t size, const uint8_t *p_data)
+{
+#ifdef APP_DIR_SCHED_ENABLE
+    APP_DirPost(APP_DIR_BLE_TO_CAN, p_data, size);
+#else
+    APP_Msg_T appMsg;
+
+    appMsg.msgId = APP_MSG_BLE_RX_CAN_TX_EVT;
+    appMsg.msgData[0] = size;
+    memcpy(&appMsg.msgData[1], p_data, size);
+    OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
+#endif
+}
+#endif
+#endif
+
+#ifdef CAN_REPLAY_ENABLE
+/* Loads a trace frame into the TX FIFO if it has room. */
+static bool APP_ReplayTx(const CAN_REPLAY_Frame_T *p_frame)
+{
+    CAN_TX_MSGOBJ txObj;
+
+    memset(&txObj, 0, sizeof(txObj));
+    if (p_frame->ctrl & CAN_REPLAY_CTRL_IDE)
+    {
+        txObj.bF.id.SID = p_frame->id >> 18;
+        txObj.bF.id.EID = p_frame->id & 0x3FFFFU;
+        txObj.bF.ctrl.IDE = 1;
+    }
+    else
+    {
+        txObj.bF.id.SID = p_frame->id;
+    }
+    txObj.bF.ctrl.DLC = p_frame->ctrl & CAN_REPLAY_CTRL_DLC_MASK;
+    txObj.bF.ctrl.RTR = (p_frame->ctrl & CAN_REPLAY_CTRL_RTR) ? 1 : 0;
+    txObj.bF.ctrl.BRS = (p_frame->ctrl & CAN_REPLAY_CTRL_BRS) ? 1 : 0;
+    txObj.bF.ctrl.FDF = (p_frame->ctrl & CAN_REPLAY_CTRL_FDF) ? 1 : 0;
+    return APP_CanTx(APP_TX_FIFO, &txObj, p_frame->data);
+}
+#endif
+
+#if defined(CAN_ISOTP_ENABLE) || defined(CAN_J1939_ENABLE) || defined(CAN_MBOX_ENABLE) || defined(CAN_QOS_ENABLE)
+/* Maps a BLE send result: retry when the stack is out of buffers. */
+static bool APP_BleRetry(uint16_t result)
+{
+    return ((result == MBA_RES_OOM) || (result == MBA_RES_NO_RESOURCE) || (result == MBA_RES_BUSY));
+}
+#endif
+
+#if defined(CAN_ISOTP_ENABLE) || defined(CAN_J1939_ENABLE)
+/* Loads an 8 byte frame into the TX FIFO if it has room. */
+static bool APP_FrameTx(uint32_t id, bool extended, const uint8_t *p_data)
+{
+    CAN_TX_MSGOBJ txObj;
+
+    memset(&txObj, 0, sizeof(txObj));
+    if (extended)
+    {
+        txObj.bF.id.SID = id >> 18;
+        txObj.bF.id.EID = id & 0x3FFFFU;
+        txObj.bF.ctrl.IDE = 1;
+    }
+    else
+    {
+        txObj.bF.id.SID = id;
+    }
+    txObj.bF.ctrl.DLC = CAN_DLC_8;
+    return APP_CanTx(APP_TX_FIFO, &txObj, p_data);
+}
+
+/* Sends a vendor command to the connected central. */
+static uint16_t APP_VendorSend(uint8_t opcode, uint8_t len, const uint8_t *p_payload)
+{
+    if (conn_hdl == 0xFFFF)
+    {
+        return MBA_RES_FAIL;
+    }
+    return BLE_TRSPS_SendVendorCommand(conn_hdl, opcode, len, (uint8_t *)p_payload);
+}
+#endif
+
+#ifdef CAN_ISOTP_ENABLE
+static CAN_ISOTP_BleResult_T APP_IsotpBleTx(const uint8_t *p_seg, uint8_t len)
+{
+    uint16_t result = APP_VendorSend(CAN_ISOTP_VENDOR_OPCODE, len, p_seg);
+
+    if (result == MBA_RES_SUCCESS)
+    {
+        return CAN_ISOTP_BLE_SENT;
+    }
+    return APP_BleRetry(result) ? CAN_ISOTP_BLE_BUSY : CAN_ISOTP_BLE_FAILED;
+}
+#endif
+
+#ifdef CAN_J1939_ENABLE
+static CAN_J1939_BleResult_T APP_J1939BleTx(const uint8_t *p_seg, uint8_t len)
+{
+    uint16_t result = APP_VendorSend(CAN_J1939_VENDOR_OPCODE, len, p_seg);
+
+    if (result == MBA_RES_SUCCESS)
+    {
+        return CAN_J1939_BLE_SENT;
+    }
+    return APP_BleRetry(result) ? CAN_J1939_BLE_BUSY : CAN_J1939_BLE_FAILED;
+}
+#endif
+
+#ifdef CAN_CYCLIC_ENABLE
+/* Loads a scheduled frame into the TX FIFO of its period class if it has room. */
+static bool APP_CyclicTx(CAN_CYCLIC_Class_T cls, CAN_TX_MSGOBJ *p_obj, uint8_t *p_data)
+{
+#ifdef CAN_CYCLIC_CLASS_FIFO
+    CAN_FIFO_CHANNEL fifo = (cls == CAN_CYCLIC_CLASS_FAST) ? APP_CYCLIC_FAST_FIFO : APP_CYCLIC_SLOW_FIFO;
+#else
+    CAN_FIFO_CHANNEL fifo = APP_TX_FIFO;
+#endif
+
+    return APP_CanTx(fifo, p_obj, p_data);
+}
+#endif
+
+#ifdef CAN_MBOX_ENABLE
+/* Sends the pending mailbox frames until the stack is out of buffers. */
+static uint16_t APP_MboxService(uint16_t waitMs)
+{
+    CAN_MSG_t canMsg;
+    uint8_t size;
+
+    if (conn_hdl == 0xFFFF)
+    {
+        // Keep the newest values for the next connection
+        return waitMs;
     }
+    while (CAN_MBOX_Peek(&canMsg.msgObj.rxObj, canMsg.can_data))
+    {
+        size = sizeof(CAN_RX_MSGOBJ) + canMsg.msgObj.rxObj.bF.ctrl.DLC;
+        if (APP_BleRetry(BLE_TRSPS_SendData(conn_hdl, size, (uint8_t *)&canMsg)))
+        {
+            return (CAN_MBOX_RETRY_MS < waitMs) ? CAN_MBOX_RETRY_MS : waitMs;
+        }
+        CAN_MBOX_Pop();
+    }
+    return waitMs;
 }
+#endif
+
+#ifdef CAN_QOS_ENABLE
+/* Sends the frames chosen by the QoS scheduler until the stack is out of
+   buffers or the classes must wait. */
+static uint16_t APP_QosService(uint16_t waitMs)
+{
+    CAN_MSG_t canMsg;
+    uint16_t qosWaitMs;
+    uint8_t size;
+
+    if (conn_hdl == 0xFFFF)
+    {
+        CAN_QOS_Flush();
+        return waitMs;
+    }
+    while (CAN_QOS_Peek(&canMsg.msgObj.rxObj, canMsg.can_data, &qosWaitMs))
+    {
+        size = sizeof(CAN_RX_MSGOBJ) + canMsg.msgObj.rxObj.bF.ctrl.DLC;
+        if (APP_BleRetry(BLE_TRSPS_SendData(conn_hdl, size, (uint8_t *)&canMsg)))
+        {
+            return (CAN_QOS_RETRY_MS < waitMs) ? CAN_QOS_RETRY_MS : waitMs;
+        }
+        CAN_QOS_Pop();
+    }
+    return (qosWaitMs < waitMs) ? qosWaitMs : waitMs;
+}
+#endif
+
+#ifdef CAN_ERR_ENABLE
+// Operation mode selected by APP_CANFDSPI_Init, restored after a restart
+#if defined(CAN_BENCH_ENABLE) || defined(CAN_REPLAY_ENABLE)
+#define APP_ERR_OPERATION_MODE      CAN_INTERNAL_LOOPBACK_MODE
+#elif defined(CAN_STATS_ENABLE) && defined(CAN_STATS_LISTEN_ONLY)
+#define APP_ERR_OPERATION_MODE      CAN_LISTEN_ONLY_MODE
+#else
+#define APP_ERR_OPERATION_MODE      CAN_NORMAL_MODE
+#endif
+#define APP_ERR_MODE_ATTEMPTS       50
+
+/* Reads CiTREC and CiBDIAG0/1, the diagnostic flags are cleared for the next poll. */
+static bool APP_ErrRead(CAN_ERR_Status_T *p_status)
+{
+    if (DRV_CANFDSPI_ErrorCountStateGet(DRV_CANFDSPI_INDEX_0, &p_status->tec, &p_status->rec, &p_status->flags) != 0)
+    {
+        return false;
+    }
+    if (DRV_CANFDSPI_BusDiagnosticsGet(DRV_CANFDSPI_INDEX_0, &p_status->diag) != 0)
+    {
+        return false;
+    }
+    DRV_CANFDSPI_BusDiagnosticsClear(DRV_CANFDSPI_INDEX_0);
+    return true;
+}
+
+/* Configuration mode clears the error counters and keeps the FIFO and filter
+   setup. The request to leave it is only taken once the mode is reached. */
+static bool APP_ErrRestart(void)
+{
+    uint8_t attempts = APP_ERR_MODE_ATTEMPTS;
+
+    DRV_CANFDSPI_OperationModeSelect(DRV_CANFDSPI_INDEX_0, CAN_CONFIGURATION_MODE);
+    while (DRV_CANFDSPI_OperationModeGet(DRV_CANFDSPI_INDEX_0) != CAN_CONFIGURATION_MODE)
+    {
+        if (attempts == 0)
+        {
+            return false;
+        }
+        attempts--;
+    }
+    return (DRV_CANFDSPI_OperationModeSelect(DRV_CANFDSPI_INDEX_0, APP_ERR_OPERATION_MODE) == 0);
+}
+
+/* Loads a held frame into the bridge TX FIFO if it has room. */
+static bool APP_ErrTx(CAN_TX_MSGOBJ *p_obj, uint8_t *p_data)
+{
+    return APP_CanTx(APP_TX_FIFO, p_obj, p_data);
+}
+#endif
 
 void APP_CANFDSPI_Init()
 {
@@ -150,6 +768,9 @@ void APP_CANFDSPI_Init()
     CAN_RX_FIFO_CONFIG rxConfig;
     REG_CiFLTOBJ fObj;
     REG_CiMASK mObj;
+#ifdef CAN_J1939_ENABLE
+    uint8_t filter;
+#endif
     
     // Reset device
     DRV_CANFDSPI_Reset(DRV_CANFDSPI_INDEX_0);
@@ -177,12 +798,27 @@ void APP_CANFDSPI_Init()
 
     DRV_CANFDSPI_TransmitChannelConfigure(DRV_CANFDSPI_INDEX_0, APP_TX_FIFO, &txConfig);
 
+#if defined(CAN_CYCLIC_ENABLE) && defined(CAN_CYCLIC_CLASS_FIFO)
+    // Setup cyclic TX FIFOs, sent ahead of the bridged frames
+    txConfig.TxPriority = 3;
+    DRV_CANFDSPI_TransmitChannelConfigure(DRV_CANFDSPI_INDEX_0, APP_CYCLIC_FAST_FIFO, &txConfig);
+    txConfig.TxPriority = 2;
+    DRV_CANFDSPI_TransmitChannelConfigure(DRV_CANFDSPI_INDEX_0, APP_CYCLIC_SLOW_FIFO, &txConfig);
+#endif
+
     // Setup RX FIFO
     DRV_CANFDSPI_ReceiveChannelConfigureObjectReset(&rxConfig);
     rxConfig.FifoSize = 15;
     rxConfig.PayLoadSize = CAN_PLSIZE_8;
+#ifdef CAN_STATS_ENABLE
+    rxConfig.RxTimeStampEnable = 1;
+#endif
 
     DRV_CANFDSPI_ReceiveChannelConfigure(DRV_CANFDSPI_INDEX_0, APP_RX_FIFO, &rxConfig);
+#ifdef CAN_STATS_ENABLE
+    // Statistics RX FIFO, frame headers and time stamps only
+    DRV_CANFDSPI_ReceiveChannelConfigure(DRV_CANFDSPI_INDEX_0, APP_STATS_FIFO, &rxConfig);
+#endif
 
     // Setup RX Filter
     fObj.word = 0;
@@ -202,17 +838,60 @@ void APP_CANFDSPI_Init()
     // Link FIFO and Filter
     DRV_CANFDSPI_FilterToFifoLink(DRV_CANFDSPI_INDEX_0, CAN_FILTER0, APP_RX_FIFO, true);
 
+#ifdef CAN_J1939_ENABLE
+    // J1939 PGN filters on extended IDs, add CAN_J1939_FilterAdd() calls after the init
+    CAN_J1939_Init(APP_FrameTx, APP_J1939BleTx);
+    for (filter = 0; filter < CAN_J1939_HwFilterNum(); filter++)
+    {
+        CAN_J1939_HwFilterGet(filter, &fObj.bF, &mObj.bF);
+        DRV_CANFDSPI_FilterObjectConfigure(DRV_CANFDSPI_INDEX_0, (CAN_FILTER)(CAN_FILTER1 + filter), &fObj.bF);
+        DRV_CANFDSPI_FilterMaskConfigure(DRV_CANFDSPI_INDEX_0, (CAN_FILTER)(CAN_FILTER1 + filter), &mObj.bF);
+        DRV_CANFDSPI_FilterToFifoLink(DRV_CANFDSPI_INDEX_0, (CAN_FILTER)(CAN_FILTER1 + filter), APP_RX_FIFO, true);
+    }
+#endif
+
+#ifdef CAN_STATS_ENABLE
+    // Catch-all filter, the lowest priority filter behind the bridge filters
+    fObj.word = 0;
+    mObj.word = 0;
+    DRV_CANFDSPI_FilterObjectConfigure(DRV_CANFDSPI_INDEX_0, CAN_FILTER31, &fObj.bF);
+    DRV_CANFDSPI_FilterMaskConfigure(DRV_CANFDSPI_INDEX_0, CAN_FILTER31, &mObj.bF);
+    DRV_CANFDSPI_FilterToFifoLink(DRV_CANFDSPI_INDEX_0, CAN_FILTER31, APP_STATS_FIFO, true);
+
+    // Time stamps in us from the 40 MHz SYSCLK
+    DRV_CANFDSPI_TimeStampPrescalerSet(DRV_CANFDSPI_INDEX_0, 40 - 1);
+    DRV_CANFDSPI_TimeStampEnable(DRV_CANFDSPI_INDEX_0);
+#endif
+
     // Setup Bit Time
     DRV_CANFDSPI_BitTimeConfigure(DRV_CANFDSPI_INDEX_0, selectedBitTime, CAN_SSP_MODE_AUTO, CAN_SYSCLK_40M);
 
     // Setup Transmit and Receive Interrupts
     DRV_CANFDSPI_GpioModeConfigure(DRV_CANFDSPI_INDEX_0, GPIO_MODE_INT, GPIO_MODE_INT);
     DRV_CANFDSPI_TransmitChannelEventEnable(DRV_CANFDSPI_INDEX_0, APP_TX_FIFO, CAN_TX_FIFO_NOT_FULL_EVENT);
+#ifdef APP_RX_ADAPT_ENABLE
+    DRV_CANFDSPI_ReceiveChannelEventEnable(DRV_CANFDSPI_INDEX_0, APP_RX_FIFO, CAN_RX_FIFO_NOT_EMPTY_EVENT | CAN_RX_FIFO_OVERFLOW_EVENT);
+    DRV_CANFDSPI_ModuleEventEnable(DRV_CANFDSPI_INDEX_0, CAN_RX_OVERFLOW_EVENT);
+#else
     DRV_CANFDSPI_ReceiveChannelEventEnable(DRV_CANFDSPI_INDEX_0, APP_RX_FIFO, CAN_RX_FIFO_NOT_EMPTY_EVENT);
+#endif
+#ifdef CAN_STATS_ENABLE
+    DRV_CANFDSPI_ReceiveChannelEventEnable(DRV_CANFDSPI_INDEX_0, APP_STATS_FIFO, CAN_RX_FIFO_NOT_EMPTY_EVENT);
+#endif
+#ifdef CAN_ERR_ENABLE
+    DRV_CANFDSPI_ModuleEventEnable(DRV_CANFDSPI_INDEX_0, /*CAN_TX_EVENT |*/ CAN_RX_EVENT | CAN_BUS_ERROR_EVENT);
+#else
     DRV_CANFDSPI_ModuleEventEnable(DRV_CANFDSPI_INDEX_0, /*CAN_TX_EVENT |*/ CAN_RX_EVENT);
+#endif
 
-    // Select Normal Mode
+    // Select Normal Mode, internal loopback for the benchmark and the trace replay
+#if defined(CAN_BENCH_ENABLE) || defined(CAN_REPLAY_ENABLE)
+    DRV_CANFDSPI_OperationModeSelect(DRV_CANFDSPI_INDEX_0, CAN_INTERNAL_LOOPBACK_MODE);
+#elif defined(CAN_STATS_ENABLE) && defined(CAN_STATS_LISTEN_ONLY)
+    DRV_CANFDSPI_OperationModeSelect(DRV_CANFDSPI_INDEX_0, CAN_LISTEN_ONLY_MODE);
+#else
     DRV_CANFDSPI_OperationModeSelect(DRV_CANFDSPI_INDEX_0, CAN_NORMAL_MODE);
+#endif
     
     CAN_STDBY_Clear();
     EIC_CallbackRegister(EIC_PIN_2, (EIC_CALLBACK)CAN_Receive_Callback, 0);
@@ -269,13 +948,26 @@ void APP_TransmitMessageQueue(CAN_MSG_t *canMsg)
     uint8_t rec;
     CAN_ERROR_STATE errorFlags;
 
+#ifdef CAN_ERR_ENABLE
+    // Held while the bus is off, loaded in order once it is usable again
+    if (!CAN_ERR_TxReady())
+    {
+        CAN_ERR_Hold(&canMsg->msgObj.txObj, canMsg->can_data);
+        return;
+    }
+#endif
     // Check if FIFO is not full
     do {
         DRV_CANFDSPI_TransmitChannelEventGet(DRV_CANFDSPI_INDEX_0, APP_TX_FIFO, &txFlags);
         if (attempts == 0)
         {
             DRV_CANFDSPI_ErrorCountStateGet(DRV_CANFDSPI_INDEX_0, &tec, &rec, &errorFlags);
-            SYS_CONSOLE_PRINT("[CAN] Tx Failed: 0x%X\r\n",errorFlags);
+            CAN_LOG1(CAN_LOG_CAN_TX_FAIL, errorFlags);
+#ifdef CAN_ERR_ENABLE
+            // The FIFO does not drain, check the error state and keep the frame
+            CAN_ERR_Event();
+            CAN_ERR_Hold(&canMsg->msgObj.txObj, canMsg->can_data);
+#endif
             return;
         }
         attempts--;
@@ -285,17 +977,144 @@ void APP_TransmitMessageQueue(CAN_MSG_t *canMsg)
     // Load message and transmit
     uint8_t n = DRV_CANFDSPI_DlcToDataBytes(canMsg->msgObj.txObj.bF.ctrl.DLC);
 
+    CAN_TRACE_BEGIN(loadStamp);
     DRV_CANFDSPI_TransmitChannelLoad(DRV_CANFDSPI_INDEX_0, APP_TX_FIFO, &canMsg->msgObj.txObj, canMsg->can_data, n, true);
+    CAN_TRACE_END(CAN_TRACE_P_TX_LOAD, loadStamp);
     GREEN_LED_Clear();
-#ifdef ENABLE_CONSOLE_PRINT
-    SYS_CONSOLE_PRINT("New Message Received from BLE\r\nMessage ID: 0x%X, DLC: 0x%X\r\nMessage: ", canMsg->msgObj.txObj.bF.id.SID, canMsg->msgObj.txObj.bF.ctrl.DLC);
-    for(uint8_t i = 0; i<canMsg->msgObj.txObj.bF.ctrl.DLC; i++)
+    CAN_LOG4(CAN_LOG_CAN_TX, APP_LOG_CAN_ID(canMsg->msgObj.txObj), canMsg->msgObj.txObj.bF.ctrl.DLC,
+             CAN_LOG_BE32(&canMsg->can_data[0]), CAN_LOG_BE32(&canMsg->can_data[4]));
+}
+
+/* Sends a frame received from the CAN bus to the connected client. */
+static void APP_CanRxBleTx(CAN_MSG_t *canMsg)
+{
+    CAN_TRACE_BEGIN(encodeStamp);
+    BLUE_LED_Clear();
+    uint8_t size = sizeof(CAN_RX_MSGOBJ) + canMsg->msgObj.rxObj.bF.ctrl.DLC;
+    CAN_TRACE_END(CAN_TRACE_P_ENCODE, encodeStamp);
+#if defined(CAN_BENCH_ENABLE) && defined(CAN_BENCH_LOCAL_LOOP)
+    APP_BenchLocalLoop(size, (uint8_t *)canMsg);
+#else
+    CAN_TRACE_BEGIN(sendStamp);
+    BLE_TRSPS_SendData(conn_hdl, size, (uint8_t *)canMsg);
+    CAN_TRACE_END(CAN_TRACE_P_SEND, sendStamp);
+#endif
+    CAN_TRACE_SINCE(CAN_TRACE_P_E2E, canMsg->traceEdge);
+#ifdef APP_CAN_BCAST_ENABLE
+    APP_BcastFrameAdd(&canMsg->msgObj.rxObj, canMsg->can_data);
+#endif
+}
+
+/* Transmits a frame received over BLE on the CAN bus. */
+static void APP_BleRxCanTx(CAN_MSG_t *canMsg)
+{
+    GREEN_LED_Set();
+#ifdef CAN_BENCH_ENABLE
+    CAN_BENCH_Decoded(&canMsg->msgObj.txObj, canMsg->can_data);
+#endif
+#ifdef CAN_CYCLIC_ENABLE
+    // Cyclic frames are sent by the scheduler at the period of their source
+    if (CAN_CYCLIC_Update(&canMsg->msgObj.txObj, canMsg->can_data))
     {
-        SYS_CONSOLE_PRINT(" 0x%X",canMsg->can_data[i]);
+        return;
     }
-    SYS_CONSOLE_PRINT("\r\n[CAN] TX Done\r\n");
 #endif
+    APP_TransmitMessageQueue(canMsg);
+}
+
+#ifdef APP_DIR_SCHED_ENABLE
+bool APP_DirPost(APP_Dir_T dir, const uint8_t *p_frame, uint8_t size)
+{
+    APP_DirMsg_T dirMsg;
+    uint8_t depth;
+
+    dirMsg.tick = xTaskGetTickCount();
+    memcpy(&dirMsg.canMsg, p_frame, (size < sizeof(CAN_MSG_t)) ? size : sizeof(CAN_MSG_t));
+    if (OSAL_QUEUE_Send(&s_appDirQueue[dir], &dirMsg, 0) != OSAL_RESULT_TRUE)
+    {
+        s_appDirStats[dir].dropped++;
+        return false;
+    }
+    depth = (uint8_t)uxQueueMessagesWaiting(s_appDirQueue[dir]);
+    if (depth > s_appDirStats[dir].depthMax)
+    {
+        s_appDirStats[dir].depthMax = depth;
+    }
+    return true;
+}
+
+const APP_DirStats_T *APP_DirStatsGet(APP_Dir_T dir)
+{
+    return &s_appDirStats[dir];
+}
+
+/* Serves the two directions by deficit round robin. Per round a direction
+   with frames may send its quantum of data PDU bytes, the overdraft of its
+   last frame is charged to the next round. An idle direction saves up no
+   credit, so the other one runs alone at full speed. The CAN RX FIFOs are
+   read between the rounds, a BLE to CAN flood does not leave them to
+   overflow. After APP_DIR_ROUND_MAX rounds the other services get a turn,
+   the notification brings the task straight back. */
+static void APP_DirTasks(void)
+{
+    static const int16_t quantum[APP_DIR_NUM] = {APP_DIR_QUANTUM_CAN_TO_BLE, APP_DIR_QUANTUM_BLE_TO_CAN};
+    APP_DirMsg_T dirMsg;
+    APP_DirStats_T *p_stats;
+    uint16_t latencyMs;
+    uint8_t round = 0;
+    uint8_t dir;
+    bool pending;
+
+    do
+    {
+        for (dir = 0; dir < APP_DIR_NUM; dir++)
+        {
+            if (uxQueueMessagesWaiting(s_appDirQueue[dir]) == 0)
+            {
+                s_appDirDeficit[dir] = 0;
+                continue;
+            }
+            s_appDirDeficit[dir] += quantum[dir];
+            while ((s_appDirDeficit[dir] > 0) && OSAL_QUEUE_Receive(&s_appDirQueue[dir], &dirMsg, 0))
+            {
+                s_appDirDeficit[dir] -= (int16_t)(sizeof(CAN_RX_MSGOBJ) + dirMsg.canMsg.msgObj.rxObj.bF.ctrl.DLC);
+
+                p_stats = &s_appDirStats[dir];
+                latencyMs = (uint16_t)((xTaskGetTickCount() - dirMsg.tick) * portTICK_PERIOD_MS);
+                p_stats->frames++;
+                p_stats->latencySumMs += latencyMs;
+                if (latencyMs > p_stats->latencyMaxMs)
+                {
+                    p_stats->latencyMaxMs = latencyMs;
+                }
+
+                if (dir == APP_DIR_CAN_TO_BLE)
+                {
+                    APP_CanRxBleTx(&dirMsg.canMsg);
+                }
+                else
+                {
+                    APP_BleRxCanTx(&dirMsg.canMsg);
+                }
+            }
+        }
+        APP_EvtTasks();
+
+        pending = false;
+        for (dir = 0; dir < APP_DIR_NUM; dir++)
+        {
+            pending = pending || (uxQueueMessagesWaiting(s_appDirQueue[dir]) != 0);
+        }
+        round++;
+    }
+    while (pending && (round < APP_DIR_ROUND_MAX));
+
+    if (pending)
+    {
+        APP_MsgNotify();
+    }
 }
+#endif
 
 // *****************************************************************************
 // *****************************************************************************
@@ -313,11 +1132,66 @@ void APP_TransmitMessageQueue(CAN_MSG_t *canMsg)
 
 void APP_Initialize ( void )
 {
+#ifdef APP_DIR_SCHED_ENABLE
+    uint8_t dir;
+
+#endif
     /* Place the App state machine in its initial state. */
     appData.state = APP_STATE_INIT;
 
 
-    appData.appQueue = xQueueCreate( 64, sizeof(APP_Msg_T) );
+#ifdef CAN_TRACE_ENABLE
+    CAN_TRACE_Init();
+#endif
+#ifdef CAN_ERR_ENABLE
+    CAN_ERR_Init(APP_ErrRead, APP_ErrRestart, APP_ErrTx);
+#endif
+#ifdef APP_TELEMETRY_ENABLE
+    APP_TelemetryInit();
+#endif
+#ifdef CAN_BENCH_ENABLE
+    CAN_BENCH_Init(APP_BenchTx);
+#endif
+#ifdef CAN_REPLAY_ENABLE
+    CAN_REPLAY_Init(APP_ReplayTx);
+#endif
+#ifdef CAN_ISOTP_ENABLE
+    CAN_ISOTP_Init(APP_FrameTx, APP_IsotpBleTx);
+    CAN_ISOTP_PairAdd(CAN_ISOTP_DEFAULT_ID_A, CAN_ISOTP_DEFAULT_ID_B, false);
+#endif
+#ifdef CAN_CACHE_ENABLE
+    CAN_CACHE_Init();
+#endif
+#ifdef CAN_CYCLIC_ENABLE
+    CAN_CYCLIC_Init(APP_CyclicTx);
+#endif
+#ifdef CAN_MBOX_ENABLE
+    // Add CAN_MBOX_RangeAdd() calls for the state-like IDs after the init
+    CAN_MBOX_Init();
+#endif
+#ifdef CAN_QOS_ENABLE
+    // Add CAN_QOS_RangeAdd() and the ..RateSet() calls after the init
+    CAN_QOS_Init();
+#endif
+#ifdef CAN_STATS_ENABLE
+    CAN_STATS_Init(APP_CAN_BITRATE_KBPS);
+#endif
+
+#ifdef APP_STATIC_ALLOCATION
+    appData.appQueue = xQueueCreateStatic( APP_QUEUE_LEN, sizeof(APP_Msg_T), s_appQueueStorage, &s_appQueueObj );
+#else
+    appData.appQueue = xQueueCreate( APP_QUEUE_LEN, sizeof(APP_Msg_T) );
+#endif
+#ifdef APP_DIR_SCHED_ENABLE
+    for (dir = 0; dir < APP_DIR_NUM; dir++)
+    {
+#ifdef APP_STATIC_ALLOCATION
+        s_appDirQueue[dir] = xQueueCreateStatic(APP_DIR_QUEUE_LEN, sizeof(APP_DirMsg_T), s_appDirQueueStorage[dir], &s_appDirQueueObj[dir]);
+#else
+        s_appDirQueue[dir] = xQueueCreate(APP_DIR_QUEUE_LEN, sizeof(APP_DirMsg_T));
+#endif
+    }
+#endif
     /* TODO: Initialize your application's state machine and other
      * parameters.
      */
@@ -363,7 +1237,7 @@ void APP_Tasks ( void )
             APP_CANFDSPI_Init();
 
             SYS_CONSOLE_MESSAGE("BLE - CAN Peripheral Application\r\n");
-            BLE_GAP_SetAdvEnable(true, 0);
+            APP_BleAdvStart();
             if (appInitialized)
             {
                 appData.state = APP_STATE_TEST_RAM;
@@ -380,12 +1254,59 @@ void APP_Tasks ( void )
             {
                 SYS_CONSOLE_PRINT("RAM Test: Failed\r\n");
             }
+#ifdef CAN_BENCH_ENABLE
+            CAN_BENCH_Start(NULL);
+#endif
+#ifdef CAN_REPLAY_ENABLE
+            CAN_REPLAY_Start(CAN_REPLAY_SPEEDUP, CAN_REPLAY_START_MS);
+#endif
             appData.state = APP_STATE_SERVICE_TASKS;
             break;
         }
         case APP_STATE_SERVICE_TASKS:
         {
-            if (OSAL_QUEUE_Receive(&appData.appQueue, &appMsg, OSAL_WAIT_FOREVER))
+            uint16_t waitMs = OSAL_WAIT_FOREVER;
+
+#ifdef APP_CAN_BCAST_ENABLE
+            waitMs = APP_BcastTasks();
+#endif
+#ifdef APP_TELEMETRY_ENABLE
+            waitMs = APP_TelemetryService(waitMs);
+#endif
+#ifdef CAN_LOG_ENABLE
+            waitMs = CAN_LOG_Tasks(waitMs);
+#endif
+#ifdef CAN_BENCH_ENABLE
+            waitMs = CAN_BENCH_Tasks(waitMs);
+#endif
+#ifdef CAN_REPLAY_ENABLE
+            waitMs = CAN_REPLAY_Tasks(waitMs);
+#endif
+#ifdef CAN_ERR_ENABLE
+            waitMs = CAN_ERR_Tasks(waitMs);
+#endif
+#ifdef CAN_ISOTP_ENABLE
+            waitMs = CAN_ISOTP_Tasks(waitMs);
+#endif
+#ifdef CAN_J1939_ENABLE
+            waitMs = CAN_J1939_Tasks(waitMs);
+#endif
+#ifdef CAN_CYCLIC_ENABLE
+            waitMs = CAN_CYCLIC_Tasks(waitMs);
+#endif
+#ifdef CAN_QOS_ENABLE
+            waitMs = APP_QosService(waitMs);
+#endif
+#ifdef CAN_MBOX_ENABLE
+            waitMs = APP_MboxService(waitMs);
+#endif
+            APP_WaitNotify(waitMs);
+#ifdef APP_TELEMETRY_ENABLE
+            APP_TelemetryDepthSample(&s_appEvtRing);
+#endif
+            APP_EvtTasks();
+
+            while (OSAL_QUEUE_Receive(&appData.appQueue, &appMsg, 0))
             {
                 if(p_appMsg->msgId==APP_MSG_BLE_STACK_EVT)
                 {
@@ -397,25 +1318,18 @@ void APP_Tasks ( void )
                     // Pass BLE LOG Event Message to User Application for handling
                     APP_BleStackLogHandler((BT_SYS_LogEvent_T *)p_appMsg->msgData);
                 }
-                else if (p_appMsg->msgId==APP_MSG_CAN_RECV_CB)
-                {
-                    BLUE_LED_Set();
-                    APP_ReceiveMessage_Tasks();
-                }
                 else if(p_appMsg->msgId==APP_MSG_BLE_TX_CAN_RX_EVT)
                 {
-                    BLUE_LED_Clear();
-                    CAN_MSG_t *canMsg = (CAN_MSG_t *)&p_appMsg->msgData;
-                    uint8_t size = sizeof(CAN_RX_MSGOBJ) + canMsg->msgObj.rxObj.bF.ctrl.DLC;
-                    BLE_TRSPS_SendData(conn_hdl, size, p_appMsg->msgData);
+                    APP_CanRxBleTx((CAN_MSG_t *)&p_appMsg->msgData);
                 }
                 else if (p_appMsg->msgId==APP_MSG_BLE_RX_CAN_TX_EVT)
                 {
-                    GREEN_LED_Set();
-                    CAN_MSG_t *canMsg = (CAN_MSG_t *)&p_appMsg->msgData[1];
-                    APP_TransmitMessageQueue(canMsg);
+                    APP_BleRxCanTx((CAN_MSG_t *)&p_appMsg->msgData[1]);
                 }
             }
+#ifdef APP_DIR_SCHED_ENABLE
+            APP_DirTasks();
+#endif
             break;
         }
 
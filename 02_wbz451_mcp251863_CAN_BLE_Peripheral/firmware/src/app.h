@@ -80,9 +80,27 @@ extern "C" {
 
     // Transmit Channels
 #define APP_TX_FIFO CAN_FIFO_CH2
+#define APP_CYCLIC_FAST_FIFO CAN_FIFO_CH3
+#define APP_CYCLIC_SLOW_FIFO CAN_FIFO_CH4
 
 // Receive Channels
 #define APP_RX_FIFO CAN_FIFO_CH1
+#define APP_STATS_FIFO CAN_FIFO_CH5     /* Frames no bridge filter takes, with CAN_STATS_ENABLE */
+
+// Nominal bit rate of the CAN_500K_2M bit time setup
+#define APP_CAN_BITRATE_KBPS        500
+
+// Uncomment to publish received CAN frames in a periodic advertising train
+//#define APP_CAN_BCAST_ENABLE
+#define APP_ADV_HANDLE_CONN         0       /* Connectable legacy advertising set */
+#define APP_ADV_HANDLE_BCAST        1       /* Periodic advertising set carrying CAN frames */
+#define APP_BCAST_ADV_SID           1
+#define APP_BCAST_PERI_INTERVAL     0x10    /* 20 ms (Unit: 1.25 ms) */
+#define APP_BCAST_PERIOD_MS         ((APP_BCAST_PERI_INTERVAL * 5) / 4)
+
+// High duty cycle directed advertising toward the last central, the controller
+// limits it to 1.28 s before undirected advertising takes over
+#define APP_DIRECT_ADV_DURATION     128     /* 1.28 s (Unit: 10 ms) */
     
 // *****************************************************************************
 /* Application states
@@ -112,18 +130,77 @@ typedef enum APP_MsgId_T
     APP_MSG_ZB_STACK_EVT,
     APP_MSG_ZB_STACK_CB,
     APP_MSG_BLE_CONN_EVT,
-    APP_MSG_CAN_RECV_CB,
     APP_MSG_BLE_TX_CAN_RX_EVT,
     APP_MSG_BLE_RX_CAN_TX_EVT,
     APP_MSG_STACK_END
 } APP_MsgId_T;
 
+// Depth of appData.appQueue
+#define APP_QUEUE_LEN               64
+
 typedef struct APP_Msg_T
 {
     uint8_t msgId;
     uint8_t msgData[256];
 } APP_Msg_T;
 
+// Per-direction queues of APP_DIR_SCHED_ENABLE (user.h)
+#define APP_DIR_QUEUE_LEN           16
+#define APP_DIR_QUANTUM_CAN_TO_BLE  80      /* Data PDU bytes per round, 4 classic frames */
+#define APP_DIR_QUANTUM_BLE_TO_CAN  80
+#define APP_DIR_ROUND_MAX           8       /* Rounds per pass before the other services run */
+
+typedef enum APP_Dir_T
+{
+    APP_DIR_CAN_TO_BLE,
+    APP_DIR_BLE_TO_CAN,
+    APP_DIR_NUM
+} APP_Dir_T;
+
+typedef struct APP_DirStats_T
+{
+    uint32_t    frames;
+    uint32_t    dropped;                /* Queue full */
+    uint32_t    latencySumMs;           /* Over frames, for the mean queueing latency */
+    uint16_t    latencyMaxMs;
+    uint8_t     depthMax;
+} APP_DirStats_T;
+
+// RX FIFO accounting and burst draining of APP_RX_ADAPT_ENABLE (user.h)
+#define APP_RX_BURST_LEN            8       /* Frames read per half full status, <= half the RX FIFO */
+#define APP_RX_BOOST_PRIORITY       (configMAX_PRIORITIES - 1)  /* APP_Tasks while above half full */
+#define APP_RX_OVF_CH_NUM           8       /* FIFO channels 0..7 with a loss counter */
+
+typedef struct APP_RxStats_T
+{
+    uint32_t    overflow[APP_RX_OVF_CH_NUM];    /* Overflow events per FIFO, each lost at least one frame */
+    uint32_t    boosts;                 /* RX FIFO found above half full */
+    uint32_t    burstFrames;            /* Read without a status read of their own */
+} APP_RxStats_T;
+
+// Compact events posted from interrupts through a lock-free ring
+#define APP_EVT_RING_SIZE           16      /* Power of two */
+
+typedef enum APP_EvtId_T
+{
+    APP_EVT_CAN_RX,                         /* MCP251863 RX FIFO interrupt */
+    APP_EVT_END
+} APP_EvtId_T;
+
+typedef struct APP_Evt_T
+{
+    uint8_t     evtId;
+    uint8_t     arg;
+    uint16_t    param;
+} APP_Evt_T;
+
+// APP_Tasks notification bits
+#define APP_NOTIFY_EVT              0x01    /* Event ring has records */
+#define APP_NOTIFY_MSG              0x02    /* appQueue has messages */
+
+// RX FIFO drain passes per interrupt before the appQueue is served
+#define APP_CAN_INT_PASSES          4
+
 // *****************************************************************************
 /* Application Data
 
@@ -228,6 +305,57 @@ void APP_Initialize ( void );
 
 void APP_Tasks( void );
 
+/*******************************************************************************
+  Function:
+    void APP_MsgNotify(void)
+
+  Summary:
+    Wakes APP_Tasks after a message was sent to appData.appQueue from another
+    task.
+
+  Remarks:
+    APP_Tasks waits on its task notification, not on the queue. Messages the
+    application task sends to itself do not need a notification.
+ */
+
+void APP_MsgNotify(void);
+
+/*******************************************************************************
+  Function:
+    bool APP_DirPost(APP_Dir_T dir, const uint8_t *p_frame, uint8_t size)
+
+  Summary:
+    Queues a frame for the direction with APP_DIR_SCHED_ENABLE.
+
+  Description:
+    p_frame is laid out as a data PDU, the message object followed by the
+    data. Must be called from the application task.
+
+  Returns:
+    true  - Frame queued.
+    false - Queue of the direction full, the frame is dropped.
+*/
+bool APP_DirPost(APP_Dir_T dir, const uint8_t *p_frame, uint8_t size);
+
+/*******************************************************************************
+  Function:
+    const APP_DirStats_T *APP_DirStatsGet(APP_Dir_T dir)
+
+  Summary:
+    Returns the frame, drop and queueing latency counts of a direction.
+*/
+const APP_DirStats_T *APP_DirStatsGet(APP_Dir_T dir);
+
+/*******************************************************************************
+  Function:
+    const APP_RxStats_T *APP_RxStatsGet(void)
+
+  Summary:
+    Returns the RX FIFO overflow and burst drain counts since start, with
+    APP_RX_ADAPT_ENABLE.
+*/
+const APP_RxStats_T *APP_RxStatsGet(void);
+
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus
 }
@@ -43,9 +43,12 @@
 #include "osal/osal_freertos_extend.h"
 #include "app_ble.h"
 #include "app_ble_handler.h"
+#include "app_ble_peer.h"
+#include "app_ble_evt_pool.h"
 
 
 #include "app_trsps_handler.h"
+#include "can_bridge/can_bcast.h"
 
 
 
@@ -69,6 +72,11 @@
 // Section: Global Variables
 // *****************************************************************************
 // *****************************************************************************
+#ifdef APP_CAN_BCAST_ENABLE
+static CAN_BCAST_Encoder_T  s_bcastEnc;
+static uint32_t             s_bcastLastUpdate;
+uint32_t                    appBcastDropCnt;
+#endif
 
 // *****************************************************************************
 // *****************************************************************************
@@ -76,6 +84,8 @@
 // *****************************************************************************
 // *****************************************************************************
 
+static void APP_BleStackEvtRelease(STACK_Event_T *p_stackEvt);
+
 
 // *****************************************************************************
 // *****************************************************************************
@@ -90,13 +100,12 @@ void APP_BleStackCb(STACK_Event_T *p_stack)
     APP_Msg_T   *p_appMsg;
 
     memcpy((uint8_t *)&stackEvent, (uint8_t *)p_stack, sizeof(STACK_Event_T));
-    stackEvent.p_event=OSAL_Malloc(p_stack->evtLen);
+    stackEvent.p_event=APP_BleEvtPoolAlloc(p_stack->evtLen);
     if(stackEvent.p_event==NULL)
     {
         return;
     }
     memcpy(stackEvent.p_event, p_stack->p_event, p_stack->evtLen);
-    stackEvent.p_event=stackEvent.p_event;
 
     if (p_stack->groupId==STACK_GRP_GATT)
     {
@@ -106,12 +115,15 @@ void APP_BleStackCb(STACK_Event_T *p_stack)
         {
             uint8_t *p_payload;
 
-            p_payload = (uint8_t *)OSAL_Malloc((p_evtGatt->eventField.onClientCccdListChange.numOfCccd*4));
-            if (p_payload != NULL)
+            p_payload = (uint8_t *)APP_BleEvtPoolAlloc((p_evtGatt->eventField.onClientCccdListChange.numOfCccd*4));
+            if (p_payload == NULL)
             {
-                memcpy(p_payload, (uint8_t *)p_evtGatt->eventField.onClientCccdListChange.p_cccdList, (p_evtGatt->eventField.onClientCccdListChange.numOfCccd*4));
-                p_evtGatt->eventField.onClientCccdListChange.p_cccdList = (GATTS_CccdList_T *)p_payload;
+                /* The stack owned list is gone once this callback returns. */
+                APP_BleEvtPoolFree(stackEvent.p_event);
+                return;
             }
+            memcpy(p_payload, (uint8_t *)p_evtGatt->eventField.onClientCccdListChange.p_cccdList, (p_evtGatt->eventField.onClientCccdListChange.numOfCccd*4));
+            p_evtGatt->eventField.onClientCccdListChange.p_cccdList = (GATTS_CccdList_T *)p_payload;
         }
     }
 
@@ -122,7 +134,27 @@ void APP_BleStackCb(STACK_Event_T *p_stack)
     ((STACK_Event_T *)appMsg.msgData)->p_event=stackEvent.p_event;
 
     p_appMsg = &appMsg;
-    OSAL_QUEUE_Send(&appData.appQueue, p_appMsg, 0);
+    if (OSAL_QUEUE_Send(&appData.appQueue, p_appMsg, 0) != OSAL_RESULT_TRUE)
+    {
+        APP_BleStackEvtRelease(&stackEvent);
+        return;
+    }
+    APP_MsgNotify();
+}
+
+static void APP_BleStackEvtRelease(STACK_Event_T *p_stackEvt)
+{
+    if (p_stackEvt->groupId==STACK_GRP_GATT)
+    {
+        GATT_Event_T *p_evtGatt = (GATT_Event_T *)p_stackEvt->p_event;
+
+        if (p_evtGatt->eventId == GATTS_EVT_CLIENT_CCCDLIST_CHANGE)
+        {
+            APP_BleEvtPoolFree(p_evtGatt->eventField.onClientCccdListChange.p_cccdList);
+        }
+    }
+
+    APP_BleEvtPoolFree(p_stackEvt->p_event);
 }
 
 void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt)
@@ -175,7 +207,7 @@ void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt)
 
 
 
-    OSAL_Free(p_stackEvt->p_event);
+    APP_BleStackEvtRelease(p_stackEvt);
 }
 
 
@@ -185,15 +217,180 @@ void APP_BleStackLogHandler(BT_SYS_LogEvent_T *p_logEvt)
 
 
 
+#ifdef APP_CAN_BCAST_ENABLE
+static void APP_BleConfigExtAdv(uint8_t *p_advData, uint8_t advLen, uint8_t *p_scanRspData, uint8_t scanRspLen)
+{
+    int8_t                          selectedTxPower;
+    BLE_GAP_ExtAdvParams_T          extAdvParam;
+    BLE_GAP_ExtAdvDataParams_T      extAdvData;
+    BLE_GAP_PeriAdvParams_T         periAdvParam;
+    BLE_GAP_PeriAdvDataParams_T     periAdvData;
+    uint8_t                         bcastLen;
+
+    // Advertising set 0: connectable legacy advertising, as without broadcast
+    memset(&extAdvParam, 0, sizeof(BLE_GAP_ExtAdvParams_T));
+    extAdvParam.advHandle = APP_ADV_HANDLE_CONN;
+    extAdvParam.evtProperies = BLE_GAP_EXT_ADV_EVT_PROP_LEGACY_ADV | BLE_GAP_EXT_ADV_EVT_PROP_CONNECTABLE_ADV | BLE_GAP_EXT_ADV_EVT_PROP_SCANNABLE_ADV;
+    extAdvParam.priIntervalMin = 32;
+    extAdvParam.priIntervalMax = 32;
+    extAdvParam.priChannelMap = BLE_GAP_ADV_CHANNEL_37 | BLE_GAP_ADV_CHANNEL_38 | BLE_GAP_ADV_CHANNEL_39;
+    extAdvParam.filterPolicy = BLE_GAP_ADV_FILTER_DEFAULT;
+    extAdvParam.txPower = 9;
+    extAdvParam.priPhy = BLE_GAP_PHY_TYPE_LE_1M;
+    extAdvParam.secPhy = BLE_GAP_PHY_TYPE_LE_1M;
+    extAdvParam.sid = 0;
+    BLE_GAP_SetExtAdvParams(&extAdvParam, &selectedTxPower);
+
+    extAdvData.advHandle = APP_ADV_HANDLE_CONN;
+    extAdvData.operation = BLE_GAP_EXT_ADV_DATA_OP_COMPLETE;
+    extAdvData.fragPreference = BLE_GAP_EXT_ADV_DATA_FRAG_PREF_MIN;
+    extAdvData.advLen = advLen;
+    extAdvData.p_advData = p_advData;
+    BLE_GAP_SetExtAdvData(&extAdvData);
+
+    extAdvData.advLen = scanRspLen;
+    extAdvData.p_advData = p_scanRspData;
+    BLE_GAP_SetExtScanRspData(&extAdvData);
+
+    // Advertising set 1: non-connectable extended advertising that points
+    // scanners to the periodic train. The secondary channel uses LE 2M to
+    // halve the air time of every train.
+    extAdvParam.advHandle = APP_ADV_HANDLE_BCAST;
+    extAdvParam.evtProperies = 0;
+    extAdvParam.priIntervalMin = 160;
+    extAdvParam.priIntervalMax = 160;
+    extAdvParam.secPhy = BLE_GAP_PHY_TYPE_LE_2M;
+    extAdvParam.sid = APP_BCAST_ADV_SID;
+    BLE_GAP_SetExtAdvParams(&extAdvParam, &selectedTxPower);
+
+    // Same service data as the connectable set, without the flags AD
+    extAdvData.advHandle = APP_ADV_HANDLE_BCAST;
+    extAdvData.advLen = advLen - 3;
+    extAdvData.p_advData = &p_advData[3];
+    BLE_GAP_SetExtAdvData(&extAdvData);
+
+    periAdvParam.advHandle = APP_ADV_HANDLE_BCAST;
+    periAdvParam.intervalMin = APP_BCAST_PERI_INTERVAL;
+    periAdvParam.intervalMax = APP_BCAST_PERI_INTERVAL;
+    periAdvParam.properties = 0;
+    BLE_GAP_SetPeriAdvParams(&periAdvParam);
+
+    CAN_BCAST_EncoderReset(&s_bcastEnc);
+    bcastLen = CAN_BCAST_EncoderFinish(&s_bcastEnc);
+    periAdvData.advHandle = APP_ADV_HANDLE_BCAST;
+    periAdvData.operation = BLE_GAP_EXT_ADV_DATA_OP_COMPLETE;
+    periAdvData.advLen = bcastLen;
+    periAdvData.p_advData = s_bcastEnc.buf;
+    BLE_GAP_SetPeriAdvData(&periAdvData);
+    CAN_BCAST_EncoderReset(&s_bcastEnc);
+
+    BLE_GAP_SetPeriAdvEnable(true, APP_ADV_HANDLE_BCAST);
+}
+
+void APP_BcastFrameAdd(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+{
+    if (!CAN_BCAST_EncoderAdd(&s_bcastEnc, p_obj, p_data))
+    {
+        appBcastDropCnt++;
+    }
+}
+
+uint16_t APP_BcastTasks(void)
+{
+    BLE_GAP_PeriAdvDataParams_T periAdvData;
+    uint32_t elapsed;
+
+    if (s_bcastEnc.frameNum == 0)
+    {
+        return OSAL_WAIT_FOREVER;
+    }
+
+    elapsed = (xTaskGetTickCount() - s_bcastLastUpdate) * portTICK_PERIOD_MS;
+    if (elapsed < APP_BCAST_PERIOD_MS)
+    {
+        return (uint16_t)(APP_BCAST_PERIOD_MS - elapsed);
+    }
+
+    periAdvData.advHandle = APP_ADV_HANDLE_BCAST;
+    periAdvData.operation = BLE_GAP_EXT_ADV_DATA_OP_COMPLETE;
+    periAdvData.advLen = CAN_BCAST_EncoderFinish(&s_bcastEnc);
+    periAdvData.p_advData = s_bcastEnc.buf;
+    BLE_GAP_SetPeriAdvData(&periAdvData);
+
+    CAN_BCAST_EncoderReset(&s_bcastEnc);
+    s_bcastLastUpdate = xTaskGetTickCount();
+    return OSAL_WAIT_FOREVER;
+}
+#endif
+
+#ifndef APP_CAN_BCAST_ENABLE
+static void APP_BleAdvParamsSet(uint8_t type, const BLE_GAP_Addr_T *p_peerAddr)
+{
+    BLE_GAP_AdvParams_T             advParam;
+
+    memset(&advParam, 0, sizeof(BLE_GAP_AdvParams_T));
+    advParam.intervalMin = 32;     /* Advertising Interval Min */
+    advParam.intervalMax = 32;     /* Advertising Interval Max */
+    advParam.type = type;        /* Advertising Type */
+    if (p_peerAddr != NULL)
+    {
+        memcpy(&advParam.peerAddr, p_peerAddr, sizeof(BLE_GAP_Addr_T));
+    }
+    advParam.advChannelMap = BLE_GAP_ADV_CHANNEL_ALL;        /* Advertising Channel Map */
+    advParam.filterPolicy = BLE_GAP_ADV_FILTER_DEFAULT;     /* Advertising Filter Policy */
+    BLE_GAP_SetAdvParams(&advParam);
+}
+#endif
+
+void APP_BleAdvUndirectedStart(void)
+{
+#ifdef APP_CAN_BCAST_ENABLE
+    APP_BleAdvStart();
+#else
+    APP_BleAdvParamsSet(BLE_GAP_ADV_TYPE_ADV_IND, NULL);
+    BLE_GAP_SetAdvEnable(true, 0);
+#endif
+}
+
+void APP_BleAdvStart(void)
+{
+#ifdef APP_CAN_BCAST_ENABLE
+    BLE_GAP_ExtAdvEnableParams_T extAdvEnable[2];
+
+    extAdvEnable[0].advHandle = APP_ADV_HANDLE_CONN;
+    extAdvEnable[0].duration = 0;
+    extAdvEnable[0].maxExtAdvEvts = 0;
+    extAdvEnable[1].advHandle = APP_ADV_HANDLE_BCAST;
+    extAdvEnable[1].duration = 0;
+    extAdvEnable[1].maxExtAdvEvts = 0;
+    BLE_GAP_SetExtAdvEnable(true, 2, extAdvEnable);
+#else
+    BLE_GAP_Addr_T centralAddr;
+
+    // The known central is initiating from its accept list: ADV_DIRECT_IND is
+    // sent back to back on all channels and connects within a few ms.
+    if (APP_BlePeerGet(&centralAddr))
+    {
+        APP_BleAdvParamsSet(BLE_GAP_ADV_TYPE_ADV_DIRECT_IND, &centralAddr);
+        if (BLE_GAP_SetAdvEnable(true, APP_DIRECT_ADV_DURATION) == MBA_RES_SUCCESS)
+        {
+            return;
+        }
+    }
+    APP_BleAdvUndirectedStart();
+#endif
+}
+
 void APP_BleConfigBasic()
 {
     int8_t                          connTxPower;
+#ifndef APP_CAN_BCAST_ENABLE
     int8_t                          advTxPower;
-    BLE_GAP_AdvParams_T             advParam;
-    uint8_t advData[]={0x02, 0x01, 0x04, 0x05, 0x16, 0xDA, 0xFE, 0xFF, 0xBC};
     BLE_GAP_AdvDataParams_T         appAdvData;
-    uint8_t scanRspData[]={0x0F, 0x09, 0x43, 0x41, 0x4E, 0x20, 0x42, 0x4C, 0x45, 0x20, 0x42, 0x72, 0x69, 0x64, 0x67, 0x65};
     BLE_GAP_AdvDataParams_T         appScanRspData;
+#endif
+    uint8_t advData[]={0x02, 0x01, 0x04, 0x05, 0x16, 0xDA, 0xFE, 0xFF, 0xBC};
+    uint8_t scanRspData[]={0x0F, 0x09, 0x43, 0x41, 0x4E, 0x20, 0x42, 0x4C, 0x45, 0x20, 0x42, 0x72, 0x69, 0x64, 0x67, 0x65};
     
     BLE_GAP_Addr_T devAddr;
     if (!IB_GetBdAddr(&devAddr.addr[0]) )
@@ -210,16 +407,12 @@ void APP_BleConfigBasic()
         BLE_GAP_SetDeviceAddr(&devAddr);
     }
 
+#ifdef APP_CAN_BCAST_ENABLE
+    APP_BleConfigExtAdv(advData, sizeof(advData), scanRspData, sizeof(scanRspData));
+#else
     // Configure advertising parameters
     BLE_GAP_SetAdvTxPowerLevel(9,&advTxPower);      /* Advertising TX Power */
-    
-    memset(&advParam, 0, sizeof(BLE_GAP_AdvParams_T));
-    advParam.intervalMin = 32;     /* Advertising Interval Min */
-    advParam.intervalMax = 32;     /* Advertising Interval Max */
-    advParam.type = BLE_GAP_ADV_TYPE_ADV_IND;        /* Advertising Type */
-    advParam.advChannelMap = BLE_GAP_ADV_CHANNEL_ALL;        /* Advertising Channel Map */
-    advParam.filterPolicy = BLE_GAP_ADV_FILTER_DEFAULT;     /* Advertising Filter Policy */
-    BLE_GAP_SetAdvParams(&advParam);
+    APP_BleAdvParamsSet(BLE_GAP_ADV_TYPE_ADV_IND, NULL);
     
     // Configure advertising data
     appAdvData.advLen=sizeof(advData);
@@ -230,6 +423,7 @@ void APP_BleConfigBasic()
     appScanRspData.advLen=sizeof(scanRspData);
     memcpy(appScanRspData.advData, scanRspData, appScanRspData.advLen);     /* Scan Response Data */
     BLE_GAP_SetScanRspData(&appScanRspData);
+#endif
 
     BLE_GAP_SetConnTxPowerLevel(15, &connTxPower);      /* Connection TX Power */
 }
@@ -281,7 +475,12 @@ void APP_BleStackInitBasic()
 {
     BLE_GAP_Init();
 
+#ifdef APP_CAN_BCAST_ENABLE
+    BLE_GAP_ExtAdvInit();       /* Extended Advertising */
+    BLE_GAP_PeriodicAdvInit();  /* Periodic Advertising */
+#else
     BLE_GAP_AdvInit();  /* Advertising */
+#endif
 
     BLE_GAP_ConnPeripheralInit();   /* Peripheral */
 }
@@ -333,7 +532,9 @@ void APP_BleStackInitAdvance()
 
 void APP_BleStackInit()
 {
+    APP_BleEvtPoolInit();
     APP_BleStackInitBasic();
     APP_BleConfigBasic();
     APP_BleStackInitAdvance();
+    APP_BlePeerInit();
 }
\ No newline at end of file
@@ -60,6 +60,7 @@
 #include "ble_l2cap.h"
 #include "ble_smp.h"
 #include "gatt.h"
+#include "canfdspi/drv_canfdspi_api.h"
 
 
 // DOM-IGNORE-BEGIN
@@ -193,6 +194,97 @@ void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt);
 */
 void APP_BleStackLogHandler(BT_SYS_LogEvent_T *p_logEvt);
 
+/*******************************************************************************
+  Function:
+    void APP_BleAdvStart(void)
+
+  Summary:
+     Starts connectable advertising, and the broadcast train when
+     APP_CAN_BCAST_ENABLE is defined.
+
+  Description:
+    If a central was connected before, high duty cycle directed advertising
+    toward it is used first so the link comes back without a scan phase.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_BleAdvStart(void);
+
+/*******************************************************************************
+  Function:
+    void APP_BleAdvUndirectedStart(void)
+
+  Summary:
+     Starts undirected connectable advertising, used once directed advertising
+     toward the last central timed out.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_BleAdvUndirectedStart(void);
+
+#ifdef APP_CAN_BCAST_ENABLE
+/*******************************************************************************
+  Function:
+    void APP_BcastFrameAdd(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+
+  Summary:
+     Queues a received CAN frame for the next periodic advertising update.
+
+  Description:
+    Frames that do not fit into the pending train are dropped and counted.
+
+  Precondition:
+
+  Parameters:
+    p_obj  - Message object as read from the controller.
+    p_data - Frame data.
+
+  Returns:
+    None.
+
+*/
+void APP_BcastFrameAdd(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_BcastTasks(void)
+
+  Summary:
+     Publishes the pending frames once per periodic advertising interval.
+
+  Description:
+    Data is updated at most once per interval so every update is aired at
+    least once.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    Time in ms until the next call is due, or OSAL_WAIT_FOREVER when nothing
+    is pending.
+
+*/
+uint16_t APP_BcastTasks(void);
+#endif
+
 #endif /* _APP_BLE_H */
 
 //DOM-IGNORE-BEGIN
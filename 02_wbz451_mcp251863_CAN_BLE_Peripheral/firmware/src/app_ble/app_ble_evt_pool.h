@@ -0,0 +1,171 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application BLE Event Pool Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_ble_evt_pool.h
+
+  Summary:
+    Fixed block pool for BLE stack events and their payloads.
+
+  Description:
+    APP_BleStackCb copies every stack event before it is posted to the
+    application queue. The copies are taken from a small set of statically
+    allocated size classes instead of the heap, so the BLE event path does not
+    call OSAL_Malloc/OSAL_Free at all. Each size class keeps usage and
+    exhaustion counters which can be read at run time to tune the block
+    numbers below.
+*******************************************************************************/
+
+#ifndef _APP_BLE_EVT_POOL_H
+#define _APP_BLE_EVT_POOL_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Size classes. Block sizes are multiples of 4 to keep the blocks word
+ * aligned. The large class has to hold a complete GATT_Event_T. */
+#define APP_BLE_EVT_POOL_SMALL_SIZE     32
+#define APP_BLE_EVT_POOL_SMALL_NUM      16
+#define APP_BLE_EVT_POOL_MEDIUM_SIZE    80
+#define APP_BLE_EVT_POOL_MEDIUM_NUM     8
+#define APP_BLE_EVT_POOL_LARGE_SIZE     268
+#define APP_BLE_EVT_POOL_LARGE_NUM      8
+
+#define APP_BLE_EVT_POOL_CLASS_NUM      3
+
+typedef struct APP_BleEvtPoolStats_T
+{
+    uint16_t    blockSize;          /* Size of one block in bytes. */
+    uint8_t     blockNum;           /* Number of blocks in the class. */
+    uint8_t     inUse;              /* Blocks currently allocated. */
+    uint8_t     highWater;          /* Highest inUse value seen. */
+    uint32_t    allocCnt;           /* Successful allocations. */
+    uint32_t    exhaustCnt;         /* Requests that found the class empty. */
+} APP_BleEvtPoolStats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_BleEvtPoolInit(void)
+
+  Summary:
+    Builds the free lists and clears the counters.
+
+  Precondition:
+    Must be called before the BLE stack callbacks are registered.
+*/
+void APP_BleEvtPoolInit(void);
+
+/*******************************************************************************
+  Function:
+    void *APP_BleEvtPoolAlloc(size_t size)
+
+  Summary:
+    Takes one block from the smallest class that fits size.
+
+  Description:
+    When the best fitting class is empty the next larger class is tried.
+    Safe to call from any task.
+
+  Returns:
+    Pointer to the block or NULL if no class can serve the request.
+*/
+void *APP_BleEvtPoolAlloc(size_t size);
+
+/*******************************************************************************
+  Function:
+    void APP_BleEvtPoolFree(void *p_block)
+
+  Summary:
+    Returns a block obtained from APP_BleEvtPoolAlloc.
+
+  Description:
+    NULL is ignored. Safe to call from any task.
+*/
+void APP_BleEvtPoolFree(void *p_block);
+
+/*******************************************************************************
+  Function:
+    bool APP_BleEvtPoolStatsGet(uint8_t classIdx, APP_BleEvtPoolStats_T *p_stats)
+
+  Summary:
+    Returns a snapshot of the counters of one size class.
+
+  Returns:
+    true  - p_stats is filled.
+    false - classIdx is out of range.
+*/
+bool APP_BleEvtPoolStatsGet(uint8_t classIdx, APP_BleEvtPoolStats_T *p_stats);
+
+/*******************************************************************************
+  Function:
+    uint32_t APP_BleEvtPoolOversizeCntGet(void)
+
+  Summary:
+    Returns the number of requests larger than the largest block size.
+*/
+uint32_t APP_BleEvtPoolOversizeCntGet(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_BLE_EVT_POOL_H */
+
+/*******************************************************************************
+ End of File
+ */
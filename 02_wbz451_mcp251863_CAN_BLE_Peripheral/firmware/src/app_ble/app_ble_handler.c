@@ -50,6 +50,12 @@
 
 #include "system/console/sys_console.h"
 #include "app.h"
+#include "app_ble.h"
+#include "app_ble_peer.h"
+#include "can_bridge/can_isotp.h"
+#include "can_bridge/can_j1939.h"
+#include "can_bridge/can_cache.h"
+#include "can_bridge/can_cyclic.h"
 // *****************************************************************************
 // *****************************************************************************
 // Section: Global Variables
@@ -69,8 +75,19 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
     {
         case BLE_GAP_EVT_CONNECTED:
         {
+            if (p_event->eventField.evtConnect.status != GAP_STATUS_SUCCESS)
+            {
+                // Directed advertising ended without the central
+                APP_BleAdvUndirectedStart();
+                break;
+            }
             conn_hdl = p_event->eventField.evtConnect.connHandle;
+            APP_BlePeerSave(&p_event->eventField.evtConnect.remoteAddr);
             USER_LED_Clear();
+#ifdef CAN_CACHE_ENABLE
+            // The new peer has none of the cached values
+            CAN_CACHE_Reset();
+#endif
             SYS_CONSOLE_PRINT("[BLE]Connected - ");
             extern void PrintBtAddress(uint8_t *addr);
             PrintBtAddress(p_event->eventField.evtConnect.remoteAddr.addr);
@@ -80,7 +97,17 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
         case BLE_GAP_EVT_DISCONNECTED:
         {
             conn_hdl = 0xFFFF;
-            BLE_GAP_SetAdvEnable(true, 0);
+#ifdef CAN_ISOTP_ENABLE
+            CAN_ISOTP_MtuSet(BLE_ATT_DEFAULT_MTU_LEN);
+#endif
+#ifdef CAN_J1939_ENABLE
+            CAN_J1939_MtuSet(BLE_ATT_DEFAULT_MTU_LEN);
+#endif
+#ifdef CAN_CYCLIC_ENABLE
+            // No peer is left to refresh the schedule
+            CAN_CYCLIC_Reset();
+#endif
+            APP_BleAdvStart();
 			USER_LED_Set();
             SYS_CONSOLE_PRINT("[BLE]Disconnected: 0x%x\r\n",p_event->eventField.evtDisconnect.reason);
         }
@@ -124,7 +151,7 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_ADV_TIMEOUT:
         {
-            /* TODO: implement your application code.*/
+            APP_BleAdvUndirectedStart();
         }
         break;
 
@@ -353,7 +380,12 @@ void APP_GattEvtHandler(GATT_Event_T *p_event)
 
         case ATT_EVT_UPDATE_MTU:
         {
-            /* TODO: implement your application code.*/
+#ifdef CAN_ISOTP_ENABLE
+            CAN_ISOTP_MtuSet(p_event->eventField.onUpdateMTU.exchangedMTU);
+#endif
+#ifdef CAN_J1939_ENABLE
+            CAN_J1939_MtuSet(p_event->eventField.onUpdateMTU.exchangedMTU);
+#endif
         }
         break;
 
@@ -378,7 +410,6 @@ void APP_GattEvtHandler(GATT_Event_T *p_event)
         case GATTS_EVT_CLIENT_CCCDLIST_CHANGE:
         {
             /* TODO: implement your application code.*/
-            OSAL_Free(p_event->eventField.onClientCccdListChange.p_cccdList);
         }
         break;
 
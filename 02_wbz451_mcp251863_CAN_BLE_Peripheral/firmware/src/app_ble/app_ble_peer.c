@@ -0,0 +1,155 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application BLE Peer Persistence Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_ble_peer.c
+
+  Summary:
+    Keeps the address of the last connected BLE peer in persistent storage.
+
+  Description:
+    See app_ble_peer.h.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "app_ble_peer.h"
+#include "ble_dm/ble_dm.h"
+#include "mba_error_defs.h"
+#include "pds.h"
+#include "pds_config.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_BLE_PEER_MARK               0xA5
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct APP_BlePeerRecord_T
+{
+    uint8_t         mark;
+    BLE_GAP_Addr_T  addr;
+} APP_BlePeerRecord_T;
+
+static APP_BlePeerRecord_T s_peerRecord;
+
+_Static_assert((APP_BLE_PDS_ITEM_END - PDS_MODULE_APP_OFFSET) <= PDS_APP_MAX_ITEMS_AMOUNT,
+               "PDS_APP_MAX_ITEMS_AMOUNT does not cover every APP_BlePdsItem_T item");
+
+PDS_DECLARE_FILE(APP_BLE_PEER_ITEM_ID, sizeof(APP_BlePeerRecord_T), &s_peerRecord, FILE_INTEGRITY_CONTROL_MARK);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void APP_BlePeerInit(void)
+{
+    if (!PDS_IsAbleToRestore(APP_BLE_PEER_ITEM_ID) || !PDS_Restore(APP_BLE_PEER_ITEM_ID))
+    {
+        memset(&s_peerRecord, 0, sizeof(APP_BlePeerRecord_T));
+    }
+}
+
+bool APP_BlePeerGet(BLE_GAP_Addr_T *p_addr)
+{
+    if (s_peerRecord.mark != APP_BLE_PEER_MARK)
+    {
+        return false;
+    }
+    memcpy(p_addr, &s_peerRecord.addr, sizeof(BLE_GAP_Addr_T));
+    return true;
+}
+
+void APP_BlePeerSave(const BLE_GAP_Addr_T *p_addr)
+{
+    if ((s_peerRecord.mark == APP_BLE_PEER_MARK)
+        && (memcmp(&s_peerRecord.addr, p_addr, sizeof(BLE_GAP_Addr_T)) == 0))
+    {
+        return;
+    }
+
+    s_peerRecord.mark = APP_BLE_PEER_MARK;
+    memcpy(&s_peerRecord.addr, p_addr, sizeof(BLE_GAP_Addr_T));
+    PDS_Store(APP_BLE_PEER_ITEM_ID);
+}
+
+uint8_t APP_BlePeerPairedDevId(const BLE_GAP_Addr_T *p_addr)
+{
+    uint8_t devIds[BLE_DM_MAX_PAIRED_DEVICE_NUM];
+    uint8_t devCnt = 0;
+    uint8_t i;
+    BLE_DM_PairedDevInfo_T pairedInfo;
+
+    BLE_DM_GetPairedDeviceList(devIds, &devCnt);
+    for (i = 0; i < devCnt; i++)
+    {
+        if ((BLE_DM_GetPairedDevice(devIds[i], &pairedInfo) == MBA_RES_SUCCESS)
+            && (memcmp(&pairedInfo.remoteAddr, p_addr, sizeof(BLE_GAP_Addr_T)) == 0))
+        {
+            return devIds[i];
+        }
+    }
+    return APP_BLE_PEER_DEV_ID_NONE;
+}
+
+bool APP_BlePeerAcceptListLoad(void)
+{
+    BLE_GAP_Addr_T addr;
+    uint8_t devId;
+
+    if (!APP_BlePeerGet(&addr))
+    {
+        return false;
+    }
+
+    devId = APP_BlePeerPairedDevId(&addr);
+    if (devId != APP_BLE_PEER_DEV_ID_NONE)
+    {
+        return (BLE_DM_SetFilterAcceptList(1, &devId) == MBA_RES_SUCCESS);
+    }
+    return (BLE_GAP_SetFilterAcceptList(1, &addr) == MBA_RES_SUCCESS);
+}
+
+/*******************************************************************************
+ End of File
+ */
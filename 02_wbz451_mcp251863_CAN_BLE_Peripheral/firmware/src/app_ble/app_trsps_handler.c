@@ -45,9 +45,14 @@
 // *****************************************************************************
 #include <string.h>
 #include <stdint.h>
+#include "mba_error_defs.h"
 #include "ble_trsps/ble_trsps.h"
 
 #include "app.h"
+#include "can_bridge/can_trace.h"
+#include "can_bridge/can_isotp.h"
+#include "can_bridge/can_j1939.h"
+#include "can_bridge/can_stats.h"
 
 // *****************************************************************************
 // *****************************************************************************
@@ -94,19 +99,73 @@ void APP_TrspsEvtHandler(BLE_TRSPS_Event_T *p_event)
         {
             APP_Msg_T appCANTxMsg;
             uint16_t data_len = 0;
-
-            BLE_TRSPS_GetDataLength(p_event->eventField.onReceiveData.connHandle, &data_len);
+            uint8_t *p_data;
+
+            if (BLE_TRSPS_PeekData(p_event->eventField.onReceiveData.connHandle, &p_data, &data_len) != MBA_RES_SUCCESS)
+            {
+                break;
+            }
+#ifdef APP_DIR_SCHED_ENABLE
+            APP_DirPost(APP_DIR_BLE_TO_CAN, p_data, (uint8_t)data_len);
+            BLE_TRSPS_ReleaseData(p_event->eventField.onReceiveData.connHandle);
+#else
             appCANTxMsg.msgData[0] = data_len;
-            BLE_TRSPS_GetData(p_event->eventField.onReceiveData.connHandle, &appCANTxMsg.msgData[1]);
+            memcpy(&appCANTxMsg.msgData[1], p_data, data_len);
+            BLE_TRSPS_ReleaseData(p_event->eventField.onReceiveData.connHandle);
 
             appCANTxMsg.msgId = APP_MSG_BLE_RX_CAN_TX_EVT;
             OSAL_QUEUE_SendISR(&appData.appQueue, &appCANTxMsg);
+#endif
         }
         break;
         
         case BLE_TRSPS_EVT_VENDOR_CMD:
         {
-            /* TODO: implement your application code.*/
+#if defined(CAN_TRACE_ENABLE) || defined(CAN_ISOTP_ENABLE) || defined(CAN_J1939_ENABLE) || defined(CAN_STATS_ENABLE)
+            BLE_TRSPS_EvtVendorCmd_T *p_cmd = &p_event->eventField.onVendorCmd;
+
+            // The opcode is the first payload byte
+            if (p_cmd->length < 1)
+            {
+                break;
+            }
+#endif
+#ifdef CAN_TRACE_ENABLE
+            if (p_cmd->p_payLoad[0] == CAN_TRACE_VENDOR_OPCODE)
+            {
+                uint8_t rsp[CAN_TRACE_VENDOR_RSP_LEN];
+                uint8_t rspLen = CAN_TRACE_VendorCmd(p_cmd->p_payLoad, p_cmd->length, rsp);
+
+                if (rspLen > 0)
+                {
+                    BLE_TRSPS_SendVendorCommand(p_cmd->connHandle, CAN_TRACE_VENDOR_OPCODE, rspLen, rsp);
+                }
+            }
+#endif
+#ifdef CAN_ISOTP_ENABLE
+            if ((p_cmd->p_payLoad[0] == CAN_ISOTP_VENDOR_OPCODE) && (p_cmd->length > 1))
+            {
+                CAN_ISOTP_BleRx(&p_cmd->p_payLoad[1], p_cmd->length - 1);
+            }
+#endif
+#ifdef CAN_J1939_ENABLE
+            if ((p_cmd->p_payLoad[0] == CAN_J1939_VENDOR_OPCODE) && (p_cmd->length > 1))
+            {
+                CAN_J1939_BleRx(&p_cmd->p_payLoad[1], p_cmd->length - 1);
+            }
+#endif
+#ifdef CAN_STATS_ENABLE
+            if (p_cmd->p_payLoad[0] == CAN_STATS_VENDOR_OPCODE)
+            {
+                uint8_t statsRsp[CAN_STATS_VENDOR_RSP_LEN];
+                uint8_t statsRspLen = CAN_STATS_VendorCmd(p_cmd->p_payLoad, p_cmd->length, statsRsp);
+
+                if (statsRspLen > 0)
+                {
+                    BLE_TRSPS_SendVendorCommand(p_cmd->connHandle, CAN_STATS_VENDOR_OPCODE, statsRspLen, statsRsp);
+                }
+            }
+#endif
         }
         break;
 
@@ -0,0 +1,228 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Broadcast Codec Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_bcast.c
+
+  Summary:
+    Packs CAN frames into periodic advertising data and unpacks them again.
+
+  Description:
+    See can_bcast.h for the PDU layout.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "can_bcast.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+#define CAN_BCAST_AD_TYPE_MANUFACTURER  0xFF
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_BCAST_EncoderReset(CAN_BCAST_Encoder_T *p_enc)
+{
+    p_enc->buf[1] = CAN_BCAST_AD_TYPE_MANUFACTURER;
+    p_enc->buf[2] = (uint8_t)(CAN_BCAST_COMPANY_ID & 0xFF);
+    p_enc->buf[3] = (uint8_t)(CAN_BCAST_COMPANY_ID >> 8);
+    p_enc->buf[4] = CAN_BCAST_FORMAT;
+    p_enc->len = CAN_BCAST_HDR_LEN;
+    p_enc->frameNum = 0;
+}
+
+bool CAN_BCAST_EncoderAdd(CAN_BCAST_Encoder_T *p_enc, const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+{
+    uint8_t dataLen = p_obj->bF.ctrl.RTR ? 0 : DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)p_obj->bF.ctrl.DLC);
+    uint8_t idLen = p_obj->bF.ctrl.IDE ? 4 : 2;
+    uint8_t *p_rec;
+
+    if (dataLen > CAN_BCAST_MAX_DATA_BYTES)
+    {
+        return false;
+    }
+    if ((p_enc->len + 1 + idLen + dataLen) > CAN_BCAST_PDU_MAX)
+    {
+        return false;
+    }
+
+    p_rec = &p_enc->buf[p_enc->len];
+    *p_rec = (uint8_t)(p_obj->bF.ctrl.DLC & CAN_BCAST_REC_DLC_MASK);
+    if (p_obj->bF.ctrl.RTR)
+    {
+        *p_rec |= CAN_BCAST_REC_RTR;
+    }
+    p_rec++;
+
+    if (p_obj->bF.ctrl.IDE)
+    {
+        uint32_t id = ((uint32_t)p_obj->bF.id.SID << 18) | p_obj->bF.id.EID;
+
+        p_enc->buf[p_enc->len] |= CAN_BCAST_REC_IDE;
+        *p_rec++ = (uint8_t)id;
+        *p_rec++ = (uint8_t)(id >> 8);
+        *p_rec++ = (uint8_t)(id >> 16);
+        *p_rec++ = (uint8_t)(id >> 24);
+    }
+    else
+    {
+        *p_rec++ = (uint8_t)p_obj->bF.id.SID;
+        *p_rec++ = (uint8_t)(p_obj->bF.id.SID >> 8);
+    }
+
+    memcpy(p_rec, p_data, dataLen);
+    p_enc->len += 1 + idLen + dataLen;
+    p_enc->frameNum++;
+    return true;
+}
+
+uint8_t CAN_BCAST_EncoderFinish(CAN_BCAST_Encoder_T *p_enc)
+{
+    p_enc->buf[0] = p_enc->len - 1;
+    p_enc->buf[5] = p_enc->seq;
+    p_enc->seq++;
+    return p_enc->len;
+}
+
+void CAN_BCAST_DecoderReset(CAN_BCAST_Decoder_T *p_dec)
+{
+    memset(p_dec, 0, sizeof(CAN_BCAST_Decoder_T));
+}
+
+uint8_t CAN_BCAST_Decode(CAN_BCAST_Decoder_T *p_dec, const uint8_t *p_adv, uint8_t len, CAN_BCAST_FrameCb_T frameCb)
+{
+    uint16_t pos = 0;
+    uint16_t end;
+    uint8_t frames = 0;
+    uint8_t seq;
+
+    // Locate our Manufacturer Specific Data AD structure
+    while ((pos + CAN_BCAST_HDR_LEN) <= len)
+    {
+        if ((p_adv[pos + 1] == CAN_BCAST_AD_TYPE_MANUFACTURER)
+            && (p_adv[pos + 2] == (uint8_t)(CAN_BCAST_COMPANY_ID & 0xFF))
+            && (p_adv[pos + 3] == (uint8_t)(CAN_BCAST_COMPANY_ID >> 8))
+            && (p_adv[pos + 4] == CAN_BCAST_FORMAT))
+        {
+            break;
+        }
+        // An empty or truncated AD structure ends the data: advancing past it
+        // could wrap or leave the buffer
+        if ((p_adv[pos] == 0) || ((pos + p_adv[pos] + 1) > len))
+        {
+            return 0;
+        }
+        pos += p_adv[pos] + 1;
+    }
+    if ((pos + CAN_BCAST_HDR_LEN) > len)
+    {
+        return 0;
+    }
+
+    end = pos + p_adv[pos] + 1;
+    if (end > len)
+    {
+        return 0;
+    }
+
+    seq = p_adv[pos + 5];
+    if (p_dec->synced)
+    {
+        if (seq == p_dec->lastSeq)
+        {
+            // Repetition of a train already decoded
+            return 0;
+        }
+        p_dec->trainMissCnt += (uint8_t)(seq - p_dec->lastSeq - 1);
+    }
+    p_dec->synced = true;
+    p_dec->lastSeq = seq;
+    p_dec->trainCnt++;
+
+    pos += CAN_BCAST_HDR_LEN;
+    while (pos < end)
+    {
+        CAN_RX_MSGOBJ obj;
+        uint8_t hdr = p_adv[pos++];
+        uint8_t idLen = (hdr & CAN_BCAST_REC_IDE) ? 4 : 2;
+        uint8_t dataLen = (hdr & CAN_BCAST_REC_RTR) ? 0 : DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)(hdr & CAN_BCAST_REC_DLC_MASK));
+
+        if ((pos + idLen + dataLen) > end)
+        {
+            break;
+        }
+        if (dataLen > CAN_BCAST_MAX_DATA_BYTES)
+        {
+            // CAN FD length: the TX FIFOs only hold classic frames
+            pos += idLen + dataLen;
+            continue;
+        }
+
+        obj.word[0] = 0;
+        obj.word[1] = 0;
+        obj.word[2] = 0;
+        obj.bF.ctrl.DLC = hdr & CAN_BCAST_REC_DLC_MASK;
+        obj.bF.ctrl.RTR = (hdr & CAN_BCAST_REC_RTR) ? 1 : 0;
+        if (hdr & CAN_BCAST_REC_IDE)
+        {
+            uint32_t id = (uint32_t)p_adv[pos] | ((uint32_t)p_adv[pos + 1] << 8)
+                        | ((uint32_t)p_adv[pos + 2] << 16) | ((uint32_t)p_adv[pos + 3] << 24);
+
+            obj.bF.ctrl.IDE = 1;
+            obj.bF.id.SID = (id >> 18) & 0x7FF;
+            obj.bF.id.EID = id & 0x3FFFF;
+        }
+        else
+        {
+            obj.bF.id.SID = ((uint16_t)p_adv[pos] | ((uint16_t)p_adv[pos + 1] << 8)) & 0x7FF;
+        }
+        pos += idLen;
+
+        frameCb(&obj, &p_adv[pos]);
+        pos += dataLen;
+        frames++;
+    }
+
+    p_dec->frameCnt += frames;
+    return frames;
+}
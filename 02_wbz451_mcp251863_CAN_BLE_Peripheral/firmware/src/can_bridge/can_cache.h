@@ -0,0 +1,191 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Change-Only Forwarding Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_cache.h
+
+  Summary:
+    Last value cache per CAN identifier, so cyclic frames with an unchanged
+    payload are not forwarded over BLE.
+
+  Description:
+    The last forwarded DLC and payload of each identifier is kept in an
+    open addressed hash table with linear probing, keyed by the identifier
+    and the IDE bit. A bitmap marks the used slots. A frame is suppressed
+    when its payload equals the cached one and the keep-alive period of the
+    identifier has not expired; changed payloads and keep-alive repetitions
+    are forwarded and update the cache.
+
+    The keep-alive period is CAN_CACHE_KEEPALIVE_MS unless set per
+    identifier with CAN_CACHE_KeepAliveSet; a period of 0 forwards every
+    frame of the identifier. When the table is full, identifiers not yet
+    cached are forwarded unfiltered. Remote frames are never suppressed.
+
+    For the cyclic transmit offload (can_cyclic.h) the period of every
+    identifier is measured from the arrival times. It locks after
+    CAN_CACHE_PERIOD_LOCK intervals within the tolerance and unlocks after
+    three consecutive intervals outside of it; the frame that locks or unlocks the period
+    is forwarded, so the receiving node starts or stops its schedule at
+    once. While locked the keep-alive period is at most
+    CAN_CACHE_CYCLIC_REFRESH_MS.
+*******************************************************************************/
+
+#ifndef _CAN_CACHE_H
+#define _CAN_CACHE_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "canfdspi/drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* Uncomment to forward changed payloads and keep-alive repetitions only. */
+//#define CAN_CACHE_ENABLE
+
+#define CAN_CACHE_SLOT_BITS         7       /* 128 identifiers */
+#define CAN_CACHE_SLOT_NUM          (1U << CAN_CACHE_SLOT_BITS)
+#define CAN_CACHE_KEEPALIVE_MS      1000    /* Unchanged frames are forwarded at least this often */
+#define CAN_CACHE_CYCLIC_REFRESH_MS 1000    /* Keep-alive limit of identifiers with a locked period */
+#define CAN_CACHE_PERIOD_LOCK       3       /* Matching intervals before a period is reported */
+#define CAN_CACHE_PERIOD_MAX_MS     1000
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct CAN_CACHE_Stats_T
+{
+    uint32_t    changed;                /* First frames and changed payloads forwarded */
+    uint32_t    keepAlive;              /* Unchanged frames forwarded after the keep-alive period */
+    uint32_t    suppressed;
+    uint32_t    uncached;               /* Forwarded because the table was full */
+    uint32_t    periodLock;             /* Forwarded because the period locked or unlocked */
+} CAN_CACHE_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_CACHE_Init(void)
+
+  Summary:
+    Empties the table, including the keep-alive periods.
+*/
+void CAN_CACHE_Init(void);
+
+/*******************************************************************************
+  Function:
+    void CAN_CACHE_Reset(void)
+
+  Summary:
+    Forgets the cached payloads, so the next frame of every identifier is
+    forwarded.
+
+  Description:
+    Called when a BLE link connects, the new peer has none of the values.
+    The keep-alive periods are kept.
+*/
+void CAN_CACHE_Reset(void);
+
+/*******************************************************************************
+  Function:
+    bool CAN_CACHE_KeepAliveSet(uint32_t id, bool extended, uint16_t periodMs)
+
+  Summary:
+    Sets the keep-alive period of one identifier, 0 to forward every frame.
+
+  Returns:
+    true  - Period set.
+    false - Table full.
+*/
+bool CAN_CACHE_KeepAliveSet(uint32_t id, bool extended, uint16_t periodMs);
+
+/*******************************************************************************
+  Function:
+    bool CAN_CACHE_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data,
+                           uint16_t *p_periodMs)
+
+  Summary:
+    Compares a received frame with the cached payload of its identifier.
+
+  Description:
+    With p_periodMs the period of the identifier is measured, it is set to
+    the locked period in ms or to 0. NULL skips the measurement.
+
+  Returns:
+    true  - Unchanged within the keep-alive period, do not forward.
+    false - Forward the frame.
+*/
+bool CAN_CACHE_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data,
+                       uint16_t *p_periodMs);
+
+/*******************************************************************************
+  Function:
+    const CAN_CACHE_Stats_T *CAN_CACHE_StatsGet(void)
+
+  Summary:
+    Returns the counters since CAN_CACHE_Init.
+*/
+const CAN_CACHE_Stats_T *CAN_CACHE_StatsGet(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _CAN_CACHE_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,252 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+/*******************************************************************************
+  CAN Bridge Error Management Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_err.h
+
+  Summary:
+    Watches the error state of the CAN controller, recovers from bus off
+    and holds the frames for the bus while it is off.
+
+  Description:
+    Without error management a bus off ended in CAN_LOG_CAN_TX_FAIL for
+    every frame received over BLE, until the controller recovered on its
+    own or the board was reset.
+
+    CAN_ERR_Tasks reads the error counters (CiTREC) and the bus diagnostics
+    (CiBDIAG0/1) every CAN_ERR_POLL_MS, every CAN_ERR_POLL_FAST_MS while the
+    controller is error passive or bus off, and at once after CAN_ERR_Event,
+    called on the bus error interrupt and on a TX FIFO that does not drain.
+    The diagnostic flags of each poll are collected and cleared.
+
+    Recovery from bus off follows the policy:
+      - CAN_ERR_POLICY_AUTO: the controller recovers by itself after 128
+        occurrences of 11 recessive bits, as ISO 11898-1 specifies,
+      - CAN_ERR_POLICY_RESTART: the restart function takes the controller
+        through Configuration mode back to its operation mode after
+        CAN_ERR_RESTART_MS, which clears the error counters. The delay
+        doubles, up to CAN_ERR_RESTART_MAX_MS, for every bus off within
+        CAN_ERR_STABLE_MS of the previous restart, so a broken bus is not
+        flooded with error frames.
+
+    While the controller is bus off, or frames are still held from that
+    time, the frames for the bus are held in a ring of CAN_ERR_HOLD_LEN
+    frames. CAN_ERR_Tasks loads them in order through the transmit function
+    at the first poll that finds the bus usable again.
+*******************************************************************************/
+
+#ifndef _CAN_ERR_H
+#define _CAN_ERR_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "canfdspi/drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* Uncomment to watch the error state and recover from bus off. */
+//#define CAN_ERR_ENABLE
+
+#define CAN_ERR_POLICY_DEFAULT      CAN_ERR_POLICY_RESTART
+#define CAN_ERR_POLL_MS             100
+#define CAN_ERR_POLL_FAST_MS        2       /* Error passive, bus off or frames held */
+#define CAN_ERR_RESTART_MS          5       /* First restart after a bus off */
+#define CAN_ERR_RESTART_MAX_MS      1000
+#define CAN_ERR_STABLE_MS           2000    /* Bus off free time that resets the restart delay */
+#define CAN_ERR_HOLD_LEN            16      /* Frames, power of 2 */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef enum CAN_ERR_Policy_T
+{
+    CAN_ERR_POLICY_AUTO = 0,
+    CAN_ERR_POLICY_RESTART
+} CAN_ERR_Policy_T;
+
+typedef enum CAN_ERR_State_T
+{
+    CAN_ERR_STATE_ACTIVE = 0,
+    CAN_ERR_STATE_WARNING,              /* A counter reached 96 */
+    CAN_ERR_STATE_PASSIVE,              /* A counter reached 128 */
+    CAN_ERR_STATE_BUS_OFF
+} CAN_ERR_State_T;
+
+typedef struct CAN_ERR_Status_T
+{
+    uint8_t             tec;
+    uint8_t             rec;
+    CAN_ERROR_STATE     flags;
+    CAN_BUS_DIAGNOSTIC  diag;
+} CAN_ERR_Status_T;
+
+/* Reads the error counters and the bus diagnostics and clears the latter. */
+typedef bool (*CAN_ERR_ReadFunc_T)(CAN_ERR_Status_T *p_status);
+
+/* Takes the controller through Configuration mode back to its operation mode. */
+typedef bool (*CAN_ERR_RestartFunc_T)(void);
+
+/* Loads a frame into the TX FIFO, false when it is full. */
+typedef bool (*CAN_ERR_TxFunc_T)(CAN_TX_MSGOBJ *p_obj, uint8_t *p_data);
+
+typedef struct CAN_ERR_Stats_T
+{
+    uint32_t    polls;
+    uint32_t    warning;                /* Entries into each state */
+    uint32_t    passive;
+    uint32_t    busOff;
+    uint32_t    restarts;
+    uint32_t    held;
+    uint32_t    dropped;                /* Hold ring full */
+    uint16_t    recoverMaxMs;           /* Longest time from bus off to a usable bus */
+    uint16_t    diagFlags;              /* CAN_BUS_DIAG_FLAGS collected from every poll */
+    uint8_t     tecMax;
+    uint8_t     recMax;
+} CAN_ERR_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_ERR_Init(CAN_ERR_ReadFunc_T readFunc, CAN_ERR_RestartFunc_T restartFunc,
+                      CAN_ERR_TxFunc_T txFunc)
+
+  Summary:
+    Sets the controller access functions and the default policy, the first
+    poll follows at once.
+*/
+void CAN_ERR_Init(CAN_ERR_ReadFunc_T readFunc, CAN_ERR_RestartFunc_T restartFunc, CAN_ERR_TxFunc_T txFunc);
+
+/*******************************************************************************
+  Function:
+    void CAN_ERR_PolicySet(CAN_ERR_Policy_T policy)
+
+  Summary:
+    Selects how the controller leaves bus off.
+*/
+void CAN_ERR_PolicySet(CAN_ERR_Policy_T policy);
+
+/*******************************************************************************
+  Function:
+    void CAN_ERR_Event(void)
+
+  Summary:
+    Requests a poll at the next CAN_ERR_Tasks call.
+*/
+void CAN_ERR_Event(void);
+
+/*******************************************************************************
+  Function:
+    bool CAN_ERR_TxReady(void)
+
+  Summary:
+    Returns false while frames for the bus must be held, bus off or frames
+    from that time still held.
+*/
+bool CAN_ERR_TxReady(void);
+
+/*******************************************************************************
+  Function:
+    bool CAN_ERR_Hold(const CAN_TX_MSGOBJ *p_obj, const uint8_t *p_data)
+
+  Summary:
+    Holds a frame for the bus until it can be loaded.
+
+  Returns:
+    true  - Frame held.
+    false - Hold ring full, the frame is dropped.
+*/
+bool CAN_ERR_Hold(const CAN_TX_MSGOBJ *p_obj, const uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    uint16_t CAN_ERR_Tasks(uint16_t waitMs)
+
+  Summary:
+    Polls the error state when due, restarts the controller and loads the
+    held frames.
+
+  Returns:
+    waitMs, or less when the next poll or restart is due earlier.
+*/
+uint16_t CAN_ERR_Tasks(uint16_t waitMs);
+
+/*******************************************************************************
+  Function:
+    CAN_ERR_State_T CAN_ERR_StateGet(void)
+
+  Summary:
+    Returns the error state of the last poll.
+*/
+CAN_ERR_State_T CAN_ERR_StateGet(void);
+
+/*******************************************************************************
+  Function:
+    const CAN_ERR_Stats_T *CAN_ERR_StatsGet(void)
+
+  Summary:
+    Returns the state transition, restart and hold counts.
+*/
+const CAN_ERR_Stats_T *CAN_ERR_StatsGet(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _CAN_ERR_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,713 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge ISO-TP Offload Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_isotp.c
+
+  Summary:
+    ISO 15765-2 transport layer on both ends of the bridge.
+
+  Description:
+    See can_isotp.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "gatt.h"
+#include "can_isotp.h"
+#include "can_log.h"
+
+#ifdef CAN_ISOTP_ENABLE
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+#define CAN_ISOTP_PCI_SF            0x0
+#define CAN_ISOTP_PCI_FF            0x1
+#define CAN_ISOTP_PCI_CF            0x2
+#define CAN_ISOTP_PCI_FC            0x3
+
+#define CAN_ISOTP_FS_CTS            0x0
+#define CAN_ISOTP_FS_WAIT           0x1
+#define CAN_ISOTP_FS_OVFLW          0x2
+
+#define CAN_ISOTP_SF_MAX            7
+#define CAN_ISOTP_FF_DATA_LEN       6
+#define CAN_ISOTP_CF_DATA_LEN       7
+#define CAN_ISOTP_ATT_HDR_LEN       4       /* ATT write header and vendor opcode */
+#define CAN_ISOTP_EXT_FLAG          0x80000000UL
+
+#define CAN_ISOTP_MS_TO_TICKS(ms)   ((TickType_t)(((ms) + portTICK_PERIOD_MS - 1U) / portTICK_PERIOD_MS))
+
+typedef enum CAN_ISOTP_State_T
+{
+    CAN_ISOTP_IDLE,
+    CAN_ISOTP_CAN_RX,               /* Collecting Consecutive Frames */
+    CAN_ISOTP_BLE_TX,               /* Sending the PDU over BLE */
+    CAN_ISOTP_BLE_RX,               /* Collecting BLE segments */
+    CAN_ISOTP_CAN_TX_FIRST,         /* Single or First Frame not loaded yet */
+    CAN_ISOTP_CAN_TX_FC_WAIT,       /* Waiting for Flow Control */
+    CAN_ISOTP_CAN_TX_CF             /* Sending Consecutive Frames */
+} CAN_ISOTP_State_T;
+
+typedef struct CAN_ISOTP_Pair_T
+{
+    uint32_t            id[2];
+    bool                extended;
+    CAN_ISOTP_State_T   state;
+    uint8_t             dataIdx;        /* Index in id[] of the PDU identifier */
+    uint16_t            len;
+    uint16_t            pos;
+    uint8_t             sn;
+    uint8_t             bs;             /* Block size, 0: no limit */
+    uint8_t             blockCnt;
+    uint8_t             stMinMs;
+    uint8_t             wftCnt;
+    uint8_t             fcPending;      /* Flow Control status + 1 still to send, 0: none */
+    TickType_t          deadline;       /* Timeout of the waiting states */
+    TickType_t          nextTick;       /* Next Consecutive Frame after STmin */
+    uint8_t             buf[CAN_ISOTP_PDU_MAX];
+} CAN_ISOTP_Pair_T;
+
+static CAN_ISOTP_TxFunc_T   s_isotpTx;
+static CAN_ISOTP_BleFunc_T  s_isotpBle;
+static CAN_ISOTP_Pair_T     s_isotpPair[CAN_ISOTP_PAIR_NUM];
+static uint8_t              s_isotpPairNum;
+static uint8_t              s_isotpSegMax;
+static CAN_ISOTP_Pair_T    *s_isotpBleTxPair;   /* One PDU at a time over BLE */
+static uint8_t              s_isotpBleTxCnt;
+static CAN_ISOTP_Pair_T    *s_isotpBleRxPair;
+static uint8_t              s_isotpBleRxCnt;
+static CAN_ISOTP_Stats_T    s_isotpStats;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static CAN_ISOTP_Pair_T *CAN_ISOTP_PairFind(uint32_t id, bool extended, uint8_t *p_idx)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_isotpPairNum; i++)
+    {
+        if (s_isotpPair[i].extended != extended)
+        {
+            continue;
+        }
+        if (s_isotpPair[i].id[0] == id)
+        {
+            *p_idx = 0;
+            return &s_isotpPair[i];
+        }
+        if (s_isotpPair[i].id[1] == id)
+        {
+            *p_idx = 1;
+            return &s_isotpPair[i];
+        }
+    }
+    return NULL;
+}
+
+static void CAN_ISOTP_Abort(CAN_ISOTP_Pair_T *p_pair, uint32_t *p_counter)
+{
+    if (p_pair->state != CAN_ISOTP_IDLE)
+    {
+        (*p_counter)++;
+        CAN_LOG2(CAN_LOG_ISOTP_ABORT, p_pair->id[p_pair->dataIdx], p_pair->state);
+    }
+    if (s_isotpBleTxPair == p_pair)
+    {
+        s_isotpBleTxPair = NULL;
+    }
+    if (s_isotpBleRxPair == p_pair)
+    {
+        s_isotpBleRxPair = NULL;
+    }
+    p_pair->state = CAN_ISOTP_IDLE;
+    p_pair->fcPending = 0;
+}
+
+static bool CAN_ISOTP_FrameSend(const CAN_ISOTP_Pair_T *p_pair, uint8_t idIdx, const uint8_t *p_data, uint8_t len)
+{
+    uint8_t frame[8];
+
+    memcpy(frame, p_data, len);
+    memset(&frame[len], CAN_ISOTP_PAD, sizeof(frame) - len);
+    return s_isotpTx(p_pair->id[idIdx], p_pair->extended, frame);
+}
+
+/* Flow Control to the local sender, with the identifier paired to the
+   one of the PDU. Retried from CAN_ISOTP_Tasks while the TX FIFO is full. */
+static void CAN_ISOTP_FcSend(CAN_ISOTP_Pair_T *p_pair, uint8_t status)
+{
+    uint8_t fc[3];
+
+    fc[0] = (CAN_ISOTP_PCI_FC << 4) | status;
+    fc[1] = CAN_ISOTP_BS;
+    fc[2] = CAN_ISOTP_STMIN;
+    p_pair->fcPending = CAN_ISOTP_FrameSend(p_pair, p_pair->dataIdx ^ 1U, fc, sizeof(fc)) ? 0U : (status + 1U);
+}
+
+static uint8_t CAN_ISOTP_StMinMs(uint8_t stMin)
+{
+    if (stMin <= 0x7FU)
+    {
+        return stMin;
+    }
+    if ((stMin >= 0xF1U) && (stMin <= 0xF9U))
+    {
+        return 1;                       /* 100..900 us, rounded up to the tick */
+    }
+    return 0x7F;                        /* Reserved values: the longest STmin */
+}
+
+static void CAN_ISOTP_Received(CAN_ISOTP_Pair_T *p_pair)
+{
+    p_pair->state = CAN_ISOTP_BLE_TX;
+    p_pair->pos = 0;
+}
+
+static void CAN_ISOTP_RxData(CAN_ISOTP_Pair_T *p_pair, uint8_t idx, const uint8_t *p_data, uint8_t n)
+{
+    TickType_t now = xTaskGetTickCount();
+    uint16_t len;
+
+    switch (p_data[0] >> 4)
+    {
+        case CAN_ISOTP_PCI_SF:
+            len = p_data[0] & 0x0FU;
+            if ((len == 0U) || (len > CAN_ISOTP_SF_MAX) || (len >= n))
+            {
+                s_isotpStats.errors++;
+                break;
+            }
+            CAN_ISOTP_Abort(p_pair, &s_isotpStats.aborted);
+            p_pair->dataIdx = idx;
+            memcpy(p_pair->buf, &p_data[1], len);
+            p_pair->len = len;
+            CAN_ISOTP_Received(p_pair);
+            break;
+
+        case CAN_ISOTP_PCI_FF:
+            len = (uint16_t)(((uint16_t)(p_data[0] & 0x0FU) << 8) | p_data[1]);
+            if ((len <= CAN_ISOTP_SF_MAX) || (n < 8U))
+            {
+                s_isotpStats.errors++;
+                break;
+            }
+            CAN_ISOTP_Abort(p_pair, &s_isotpStats.aborted);
+            p_pair->dataIdx = idx;
+            if (len > CAN_ISOTP_PDU_MAX)
+            {
+                s_isotpStats.errors++;
+                CAN_ISOTP_FcSend(p_pair, CAN_ISOTP_FS_OVFLW);
+                break;
+            }
+            memcpy(p_pair->buf, &p_data[2], CAN_ISOTP_FF_DATA_LEN);
+            p_pair->len = len;
+            p_pair->pos = CAN_ISOTP_FF_DATA_LEN;
+            p_pair->sn = 1;
+            p_pair->blockCnt = 0;
+            p_pair->state = CAN_ISOTP_CAN_RX;
+            p_pair->deadline = now + CAN_ISOTP_MS_TO_TICKS(CAN_ISOTP_N_CR_MS);
+            CAN_ISOTP_FcSend(p_pair, CAN_ISOTP_FS_CTS);
+            break;
+
+        case CAN_ISOTP_PCI_CF:
+            if ((p_pair->state != CAN_ISOTP_CAN_RX) || (p_pair->dataIdx != idx))
+            {
+                break;
+            }
+            if ((p_data[0] & 0x0FU) != p_pair->sn)
+            {
+                s_isotpStats.errors++;
+                CAN_ISOTP_Abort(p_pair, &s_isotpStats.aborted);
+                break;
+            }
+            len = p_pair->len - p_pair->pos;
+            if (len > CAN_ISOTP_CF_DATA_LEN)
+            {
+                len = CAN_ISOTP_CF_DATA_LEN;
+            }
+            if (len >= n)
+            {
+                s_isotpStats.errors++;
+                CAN_ISOTP_Abort(p_pair, &s_isotpStats.aborted);
+                break;
+            }
+            memcpy(&p_pair->buf[p_pair->pos], &p_data[1], len);
+            p_pair->pos += len;
+            p_pair->sn = (p_pair->sn + 1U) & 0x0FU;
+            p_pair->deadline = now + CAN_ISOTP_MS_TO_TICKS(CAN_ISOTP_N_CR_MS);
+            if (p_pair->pos == p_pair->len)
+            {
+                CAN_ISOTP_Received(p_pair);
+            }
+            else if ((CAN_ISOTP_BS != 0) && (++p_pair->blockCnt == CAN_ISOTP_BS))
+            {
+                p_pair->blockCnt = 0;
+                CAN_ISOTP_FcSend(p_pair, CAN_ISOTP_FS_CTS);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void CAN_ISOTP_RxFc(CAN_ISOTP_Pair_T *p_pair, const uint8_t *p_data, uint8_t n)
+{
+    TickType_t now = xTaskGetTickCount();
+
+    if ((p_pair->state != CAN_ISOTP_CAN_TX_FC_WAIT) || (n < 3U))
+    {
+        return;
+    }
+
+    switch (p_data[0] & 0x0FU)
+    {
+        case CAN_ISOTP_FS_CTS:
+            p_pair->bs = p_data[1];
+            p_pair->stMinMs = CAN_ISOTP_StMinMs(p_data[2]);
+            p_pair->blockCnt = 0;
+            p_pair->wftCnt = 0;
+            p_pair->nextTick = now;
+            p_pair->state = CAN_ISOTP_CAN_TX_CF;
+            break;
+
+        case CAN_ISOTP_FS_WAIT:
+            if (++p_pair->wftCnt > CAN_ISOTP_WFT_MAX)
+            {
+                CAN_ISOTP_Abort(p_pair, &s_isotpStats.aborted);
+                break;
+            }
+            p_pair->deadline = now + CAN_ISOTP_MS_TO_TICKS(CAN_ISOTP_N_BS_MS);
+            break;
+
+        default:
+            CAN_ISOTP_Abort(p_pair, &s_isotpStats.aborted);
+            break;
+    }
+}
+
+/* Loads Single, First and Consecutive Frames while the TX FIFO takes them.
+   Returns the ms until the next frame is due. */
+static uint16_t CAN_ISOTP_CanTx(CAN_ISOTP_Pair_T *p_pair, TickType_t now)
+{
+    uint8_t frame[8];
+    uint16_t n;
+
+    if (p_pair->state == CAN_ISOTP_CAN_TX_FIRST)
+    {
+        if (p_pair->len <= CAN_ISOTP_SF_MAX)
+        {
+            frame[0] = (CAN_ISOTP_PCI_SF << 4) | (uint8_t)p_pair->len;
+            memcpy(&frame[1], p_pair->buf, p_pair->len);
+            if (!CAN_ISOTP_FrameSend(p_pair, p_pair->dataIdx, frame, 1U + p_pair->len))
+            {
+                return 1;
+            }
+            p_pair->state = CAN_ISOTP_IDLE;
+            s_isotpStats.toCan++;
+            CAN_LOG2(CAN_LOG_ISOTP_TO_CAN, p_pair->id[p_pair->dataIdx], p_pair->len);
+            return OSAL_WAIT_FOREVER;
+        }
+
+        frame[0] = (CAN_ISOTP_PCI_FF << 4) | (uint8_t)(p_pair->len >> 8);
+        frame[1] = (uint8_t)p_pair->len;
+        memcpy(&frame[2], p_pair->buf, CAN_ISOTP_FF_DATA_LEN);
+        if (!CAN_ISOTP_FrameSend(p_pair, p_pair->dataIdx, frame, sizeof(frame)))
+        {
+            return 1;
+        }
+        p_pair->pos = CAN_ISOTP_FF_DATA_LEN;
+        p_pair->sn = 1;
+        p_pair->wftCnt = 0;
+        p_pair->deadline = now + CAN_ISOTP_MS_TO_TICKS(CAN_ISOTP_N_BS_MS);
+        p_pair->state = CAN_ISOTP_CAN_TX_FC_WAIT;
+        return OSAL_WAIT_FOREVER;
+    }
+
+    while ((p_pair->state == CAN_ISOTP_CAN_TX_CF) && ((int32_t)(now - p_pair->nextTick) >= 0))
+    {
+        n = p_pair->len - p_pair->pos;
+        if (n > CAN_ISOTP_CF_DATA_LEN)
+        {
+            n = CAN_ISOTP_CF_DATA_LEN;
+        }
+        frame[0] = (CAN_ISOTP_PCI_CF << 4) | p_pair->sn;
+        memcpy(&frame[1], &p_pair->buf[p_pair->pos], n);
+        if (!CAN_ISOTP_FrameSend(p_pair, p_pair->dataIdx, frame, (uint8_t)(1U + n)))
+        {
+            return 1;
+        }
+        p_pair->pos += n;
+        p_pair->sn = (p_pair->sn + 1U) & 0x0FU;
+
+        if (p_pair->pos == p_pair->len)
+        {
+            p_pair->state = CAN_ISOTP_IDLE;
+            s_isotpStats.toCan++;
+            CAN_LOG2(CAN_LOG_ISOTP_TO_CAN, p_pair->id[p_pair->dataIdx], p_pair->len);
+        }
+        else if ((p_pair->bs != 0U) && (++p_pair->blockCnt == p_pair->bs))
+        {
+            p_pair->deadline = now + CAN_ISOTP_MS_TO_TICKS(CAN_ISOTP_N_BS_MS);
+            p_pair->state = CAN_ISOTP_CAN_TX_FC_WAIT;
+        }
+        else if (p_pair->stMinMs != 0U)
+        {
+            p_pair->nextTick = now + CAN_ISOTP_MS_TO_TICKS(p_pair->stMinMs);
+        }
+    }
+
+    if (p_pair->state == CAN_ISOTP_CAN_TX_CF)
+    {
+        return (uint16_t)((p_pair->nextTick - now) * portTICK_PERIOD_MS);
+    }
+    return OSAL_WAIT_FOREVER;
+}
+
+/* Sends the segments of the PDU in s_isotpBleTxPair. Returns the ms until
+   the next attempt. */
+static uint16_t CAN_ISOTP_BleTx(void)
+{
+    CAN_ISOTP_Pair_T *p_pair = s_isotpBleTxPair;
+    uint8_t seg[UINT8_MAX];
+    uint32_t id;
+    uint16_t hdr;
+    uint16_t n;
+
+    while (p_pair->pos < p_pair->len)
+    {
+        hdr = 1;
+        seg[0] = s_isotpBleTxCnt & CAN_ISOTP_SEG_CNT_MASK;
+        if (p_pair->pos == 0U)
+        {
+            id = p_pair->id[p_pair->dataIdx] | (p_pair->extended ? CAN_ISOTP_EXT_FLAG : 0U);
+            seg[0] |= CAN_ISOTP_SEG_FIRST;
+            seg[1] = (uint8_t)id;
+            seg[2] = (uint8_t)(id >> 8);
+            seg[3] = (uint8_t)(id >> 16);
+            seg[4] = (uint8_t)(id >> 24);
+            seg[5] = (uint8_t)p_pair->len;
+            seg[6] = (uint8_t)(p_pair->len >> 8);
+            hdr = CAN_ISOTP_SEG_HDR_LEN;
+        }
+        n = p_pair->len - p_pair->pos;
+        if (n > (uint16_t)(s_isotpSegMax - hdr))
+        {
+            n = s_isotpSegMax - hdr;
+        }
+        else
+        {
+            seg[0] |= CAN_ISOTP_SEG_LAST;
+        }
+        memcpy(&seg[hdr], &p_pair->buf[p_pair->pos], n);
+
+        switch (s_isotpBle(seg, (uint8_t)(hdr + n)))
+        {
+            case CAN_ISOTP_BLE_SENT:
+                p_pair->pos += n;
+                s_isotpBleTxCnt++;
+                break;
+
+            case CAN_ISOTP_BLE_BUSY:
+                return CAN_ISOTP_BLE_RETRY_MS;
+
+            default:
+                CAN_ISOTP_Abort(p_pair, &s_isotpStats.aborted);
+                return OSAL_WAIT_FOREVER;
+        }
+    }
+
+    s_isotpStats.toBle++;
+    CAN_LOG2(CAN_LOG_ISOTP_TO_BLE, p_pair->id[p_pair->dataIdx], p_pair->len);
+    p_pair->state = CAN_ISOTP_IDLE;
+    s_isotpBleTxPair = NULL;
+    return 0;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_ISOTP_Init(CAN_ISOTP_TxFunc_T txFunc, CAN_ISOTP_BleFunc_T bleFunc)
+{
+    s_isotpTx = txFunc;
+    s_isotpBle = bleFunc;
+    s_isotpPairNum = 0;
+    s_isotpBleTxPair = NULL;
+    s_isotpBleRxPair = NULL;
+    memset(&s_isotpStats, 0, sizeof(s_isotpStats));
+    CAN_ISOTP_MtuSet(BLE_ATT_DEFAULT_MTU_LEN);
+}
+
+bool CAN_ISOTP_PairAdd(uint32_t idA, uint32_t idB, bool extended)
+{
+    CAN_ISOTP_Pair_T *p_pair;
+    uint32_t idMax = extended ? 0x1FFFFFFFU : 0x7FFU;
+    uint8_t idx;
+
+    if ((s_isotpPairNum == CAN_ISOTP_PAIR_NUM) || (idA == idB) || (idA > idMax) || (idB > idMax)
+        || (CAN_ISOTP_PairFind(idA, extended, &idx) != NULL) || (CAN_ISOTP_PairFind(idB, extended, &idx) != NULL))
+    {
+        return false;
+    }
+
+    p_pair = &s_isotpPair[s_isotpPairNum];
+    memset(p_pair, 0, offsetof(CAN_ISOTP_Pair_T, buf));
+    p_pair->id[0] = idA;
+    p_pair->id[1] = idB;
+    p_pair->extended = extended;
+    p_pair->state = CAN_ISOTP_IDLE;
+    s_isotpPairNum++;
+    return true;
+}
+
+void CAN_ISOTP_MtuSet(uint16_t attMtu)
+{
+    uint16_t segMax = attMtu - CAN_ISOTP_ATT_HDR_LEN;
+
+    s_isotpSegMax = (segMax > UINT8_MAX) ? UINT8_MAX : (uint8_t)segMax;
+}
+
+bool CAN_ISOTP_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+{
+    CAN_ISOTP_Pair_T *p_pair;
+    bool extended = (p_obj->bF.ctrl.IDE != 0U);
+    uint32_t id = extended ? (((uint32_t)p_obj->bF.id.SID << 18) | p_obj->bF.id.EID) : p_obj->bF.id.SID;
+    uint8_t n = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)p_obj->bF.ctrl.DLC);
+    uint8_t idx;
+
+    p_pair = CAN_ISOTP_PairFind(id, extended, &idx);
+    if (p_pair == NULL)
+    {
+        return false;
+    }
+    if ((n == 0U) || p_obj->bF.ctrl.RTR)
+    {
+        return true;
+    }
+
+    if ((p_data[0] >> 4) == CAN_ISOTP_PCI_FC)
+    {
+        /* Flow Control for the PDU this node sends with the other identifier. */
+        if (p_pair->dataIdx != idx)
+        {
+            CAN_ISOTP_RxFc(p_pair, p_data, n);
+        }
+    }
+    else
+    {
+        CAN_ISOTP_RxData(p_pair, idx, p_data, n);
+    }
+    return true;
+}
+
+void CAN_ISOTP_BleRx(const uint8_t *p_seg, uint16_t len)
+{
+    CAN_ISOTP_Pair_T *p_pair;
+    uint32_t id;
+    uint16_t pduLen;
+    uint16_t hdr = 1;
+    uint8_t idx;
+
+    if (len < 1U)
+    {
+        return;
+    }
+
+    if (p_seg[0] & CAN_ISOTP_SEG_FIRST)
+    {
+        if (s_isotpBleRxPair != NULL)
+        {
+            CAN_ISOTP_Abort(s_isotpBleRxPair, &s_isotpStats.aborted);
+        }
+        if (len < CAN_ISOTP_SEG_HDR_LEN)
+        {
+            s_isotpStats.errors++;
+            return;
+        }
+        id = (uint32_t)p_seg[1] | ((uint32_t)p_seg[2] << 8) | ((uint32_t)p_seg[3] << 16) | ((uint32_t)p_seg[4] << 24);
+        pduLen = (uint16_t)p_seg[5] | ((uint16_t)p_seg[6] << 8);
+        p_pair = CAN_ISOTP_PairFind(id & ~CAN_ISOTP_EXT_FLAG, (id & CAN_ISOTP_EXT_FLAG) != 0U, &idx);
+        if ((p_pair == NULL) || (pduLen == 0U) || (pduLen > CAN_ISOTP_PDU_MAX))
+        {
+            s_isotpStats.errors++;
+            return;
+        }
+        CAN_ISOTP_Abort(p_pair, &s_isotpStats.aborted);
+        p_pair->dataIdx = idx;
+        p_pair->len = pduLen;
+        p_pair->pos = 0;
+        p_pair->state = CAN_ISOTP_BLE_RX;
+        s_isotpBleRxPair = p_pair;
+        s_isotpBleRxCnt = p_seg[0];
+        hdr = CAN_ISOTP_SEG_HDR_LEN;
+    }
+    else
+    {
+        p_pair = s_isotpBleRxPair;
+        if (p_pair == NULL)
+        {
+            return;
+        }
+        s_isotpBleRxCnt++;
+        if ((p_seg[0] & CAN_ISOTP_SEG_CNT_MASK) != (s_isotpBleRxCnt & CAN_ISOTP_SEG_CNT_MASK))
+        {
+            s_isotpStats.errors++;
+            CAN_ISOTP_Abort(p_pair, &s_isotpStats.aborted);
+            return;
+        }
+    }
+
+    if ((len - hdr) > (p_pair->len - p_pair->pos))
+    {
+        s_isotpStats.errors++;
+        CAN_ISOTP_Abort(p_pair, &s_isotpStats.aborted);
+        return;
+    }
+    memcpy(&p_pair->buf[p_pair->pos], &p_seg[hdr], len - hdr);
+    p_pair->pos += len - hdr;
+    p_pair->deadline = xTaskGetTickCount() + CAN_ISOTP_MS_TO_TICKS(CAN_ISOTP_BLE_RX_MS);
+
+    if (p_seg[0] & CAN_ISOTP_SEG_LAST)
+    {
+        s_isotpBleRxPair = NULL;
+        if (p_pair->pos != p_pair->len)
+        {
+            s_isotpStats.errors++;
+            CAN_ISOTP_Abort(p_pair, &s_isotpStats.aborted);
+            return;
+        }
+        p_pair->state = CAN_ISOTP_CAN_TX_FIRST;
+        (void)CAN_ISOTP_CanTx(p_pair, xTaskGetTickCount());
+    }
+}
+
+uint16_t CAN_ISOTP_Tasks(uint16_t waitMs)
+{
+    CAN_ISOTP_Pair_T *p_pair;
+    TickType_t now = xTaskGetTickCount();
+    uint16_t ms;
+    uint8_t i;
+
+    for (i = 0; i < s_isotpPairNum; i++)
+    {
+        p_pair = &s_isotpPair[i];
+        if (p_pair->fcPending != 0U)
+        {
+            CAN_ISOTP_FcSend(p_pair, p_pair->fcPending - 1U);
+            if (p_pair->fcPending != 0U)
+            {
+                waitMs = 1;
+            }
+        }
+
+        switch (p_pair->state)
+        {
+            case CAN_ISOTP_CAN_RX:
+            case CAN_ISOTP_BLE_RX:
+            case CAN_ISOTP_CAN_TX_FC_WAIT:
+                if ((int32_t)(now - p_pair->deadline) >= 0)
+                {
+                    CAN_ISOTP_Abort(p_pair, &s_isotpStats.timeouts);
+                }
+                else
+                {
+                    ms = (uint16_t)((p_pair->deadline - now) * portTICK_PERIOD_MS);
+                    waitMs = (ms < waitMs) ? ms : waitMs;
+                }
+                break;
+
+            case CAN_ISOTP_CAN_TX_FIRST:
+            case CAN_ISOTP_CAN_TX_CF:
+                ms = CAN_ISOTP_CanTx(p_pair, now);
+                waitMs = (ms < waitMs) ? ms : waitMs;
+                break;
+
+            case CAN_ISOTP_BLE_TX:
+                if (s_isotpBleTxPair == NULL)
+                {
+                    s_isotpBleTxPair = p_pair;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    while (s_isotpBleTxPair != NULL)
+    {
+        ms = CAN_ISOTP_BleTx();
+        if (ms != 0U)
+        {
+            waitMs = (ms < waitMs) ? ms : waitMs;
+            break;
+        }
+        /* Next PDU waiting for BLE, if any. */
+        for (i = 0; i < s_isotpPairNum; i++)
+        {
+            if (s_isotpPair[i].state == CAN_ISOTP_BLE_TX)
+            {
+                s_isotpBleTxPair = &s_isotpPair[i];
+                break;
+            }
+        }
+    }
+    return waitMs;
+}
+
+const CAN_ISOTP_Stats_T *CAN_ISOTP_StatsGet(void)
+{
+    return &s_isotpStats;
+}
+
+#endif /* CAN_ISOTP_ENABLE */
+
+/*******************************************************************************
+ End of File
+ */
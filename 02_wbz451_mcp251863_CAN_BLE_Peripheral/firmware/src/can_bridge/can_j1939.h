@@ -0,0 +1,270 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge J1939 Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_j1939.h
+
+  Summary:
+    SAE J1939 mode: PGN and source address filtering and reassembly of the
+    transport protocol, so multi-packet PGNs cross BLE once.
+
+  Description:
+    The PGN/source address filters are mapped onto extended identifier
+    filters of the MCP251863, so frames of other PGNs do not reach the
+    bridge. Without filters every extended frame is accepted. The filters
+    are checked again in software, also against the PGN a transport
+    session carries.
+
+    TP.CM and TP.DT frames are not forwarded. Broadcast (BAM) and
+    connection mode (RTS/CTS) sessions are reassembled from the frames on
+    the local segment and the complete PGN is sent over BLE. The bridge
+    never answers an RTS itself: a connection mode session is reassembled
+    when its destination is on the same segment, as seen by any other
+    node. The other node sends PGNs received with the global destination
+    again as BAM with the original source address; PGNs for a specific
+    destination are only reported (J1939-31 routes those through a
+    network interconnect ECU).
+
+    BLE transport: TRS vendor command CAN_J1939_VENDOR_OPCODE, one PGN at a
+    time in segments sized to the ATT MTU. Segment (after the opcode):
+      0      bit 7 first segment, bit 6 last segment, bits 5..0 counter
+      first segment only:
+      1..3   PGN, little endian
+      4      source address
+      5      destination address, 0xFF global
+      6      priority
+      7..8   length, little endian
+      then   PGN data bytes
+*******************************************************************************/
+
+#ifndef _CAN_J1939_H
+#define _CAN_J1939_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "canfdspi/drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* Uncomment to run the bridge in J1939 mode on both nodes. */
+//#define CAN_J1939_ENABLE
+
+#define CAN_J1939_FILTER_NUM        8       /* PGN/source address filters */
+#define CAN_J1939_HW_FILTER_NUM     31      /* Controller filters after CAN_FILTER0 */
+#define CAN_J1939_SESSION_NUM       4       /* Transport sessions reassembled at the same time */
+#define CAN_J1939_PDU_MAX           1785    /* 255 packets of 7 bytes */
+
+#define CAN_J1939_ADDR_ANY          0xFF    /* Filter: any source address */
+#define CAN_J1939_ADDR_GLOBAL       0xFF
+
+#define CAN_J1939_T_SESSION_MS      1250    /* Gap between frames of a session (T1/T2) */
+#define CAN_J1939_BAM_GAP_MS        50      /* Between the packets of a BAM sent */
+#define CAN_J1939_BLE_RX_MS         2000    /* Timeout between BLE segments */
+#define CAN_J1939_BLE_RETRY_MS      20      /* Retry after the BLE stack was out of buffers */
+
+#define CAN_J1939_VENDOR_OPCODE     0x33
+#define CAN_J1939_SEG_FIRST         0x80
+#define CAN_J1939_SEG_LAST          0x40
+#define CAN_J1939_SEG_CNT_MASK      0x3F
+#define CAN_J1939_SEG_HDR_LEN       9       /* Header of the first segment */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Loads one 8 byte frame into the TX FIFO without waiting. Returns false
+   when the FIFO is full. */
+typedef bool (*CAN_J1939_TxFunc_T)(uint32_t id, bool extended, const uint8_t *p_data);
+
+typedef enum CAN_J1939_BleResult_T
+{
+    CAN_J1939_BLE_SENT,
+    CAN_J1939_BLE_BUSY,                 /* Out of buffers, try again later */
+    CAN_J1939_BLE_FAILED                /* Not connected */
+} CAN_J1939_BleResult_T;
+
+/* Sends one segment as vendor command CAN_J1939_VENDOR_OPCODE. */
+typedef CAN_J1939_BleResult_T (*CAN_J1939_BleFunc_T)(const uint8_t *p_seg, uint8_t len);
+
+typedef struct CAN_J1939_Stats_T
+{
+    uint32_t    toBle;                  /* Reassembled PGNs sent over BLE */
+    uint32_t    bamSent;                /* PGNs from BLE sent as BAM */
+    uint32_t    directed;               /* PGNs from BLE for a specific destination, not sent */
+    uint32_t    filtered;               /* Frames and sessions of PGNs not selected */
+    uint32_t    dropped;                /* No free session or BAM still being sent */
+    uint32_t    aborted;                /* Connection abort, superseded or BLE link lost */
+    uint32_t    timeouts;
+    uint32_t    errors;                 /* Sequence and length errors */
+} CAN_J1939_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_J1939_Init(CAN_J1939_TxFunc_T txFunc, CAN_J1939_BleFunc_T bleFunc)
+
+  Summary:
+    Removes all filters and sessions and registers the CAN and BLE send
+    functions.
+*/
+void CAN_J1939_Init(CAN_J1939_TxFunc_T txFunc, CAN_J1939_BleFunc_T bleFunc);
+
+/*******************************************************************************
+  Function:
+    bool CAN_J1939_FilterAdd(uint32_t pgn, uint8_t sa)
+
+  Summary:
+    Selects a PGN, from one source address or from CAN_J1939_ADDR_ANY.
+
+  Description:
+    Once a filter exists only the selected PGNs are forwarded. Must be
+    called before the controller filters are read with
+    CAN_J1939_HwFilterGet.
+
+  Returns:
+    true  - Filter added.
+    false - Table full or invalid PGN.
+*/
+bool CAN_J1939_FilterAdd(uint32_t pgn, uint8_t sa);
+
+/*******************************************************************************
+  Function:
+    uint8_t CAN_J1939_HwFilterNum(void)
+
+  Summary:
+    Returns the number of controller filters the PGN filters map onto.
+
+  Description:
+    One filter per PGN filter and one each for TP.CM and TP.DT, or a single
+    filter accepting every extended frame when there are no PGN filters or
+    more than CAN_J1939_HW_FILTER_NUM would be needed.
+*/
+uint8_t CAN_J1939_HwFilterNum(void);
+
+/*******************************************************************************
+  Function:
+    bool CAN_J1939_HwFilterGet(uint8_t idx, CAN_FILTEROBJ_ID *p_obj, CAN_MASKOBJ_ID *p_mask)
+
+  Summary:
+    Returns a controller filter and mask for extended identifiers.
+
+  Returns:
+    true  - Filter idx exists.
+    false - idx is not below CAN_J1939_HwFilterNum().
+*/
+bool CAN_J1939_HwFilterGet(uint8_t idx, CAN_FILTEROBJ_ID *p_obj, CAN_MASKOBJ_ID *p_mask);
+
+/*******************************************************************************
+  Function:
+    void CAN_J1939_MtuSet(uint16_t attMtu)
+
+  Summary:
+    Sets the ATT MTU the BLE segments are sized to.
+*/
+void CAN_J1939_MtuSet(uint16_t attMtu);
+
+/*******************************************************************************
+  Function:
+    bool CAN_J1939_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+
+  Summary:
+    Handles an extended frame received on the CAN segment.
+
+  Returns:
+    true  - Transport protocol frame or PGN not selected, consumed.
+    false - Forward the frame.
+*/
+bool CAN_J1939_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    void CAN_J1939_BleRx(const uint8_t *p_seg, uint16_t len)
+
+  Summary:
+    Handles a CAN_J1939_VENDOR_OPCODE segment, without the opcode.
+*/
+void CAN_J1939_BleRx(const uint8_t *p_seg, uint16_t len);
+
+/*******************************************************************************
+  Function:
+    uint16_t CAN_J1939_Tasks(uint16_t waitMs)
+
+  Summary:
+    Sends pending segments and BAM packets and checks the timeouts.
+
+  Returns:
+    waitMs, shortened to the time until the next J1939 work.
+*/
+uint16_t CAN_J1939_Tasks(uint16_t waitMs);
+
+/*******************************************************************************
+  Function:
+    const CAN_J1939_Stats_T *CAN_J1939_StatsGet(void)
+
+  Summary:
+    Returns the counters since CAN_J1939_Init.
+*/
+const CAN_J1939_Stats_T *CAN_J1939_StatsGet(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _CAN_J1939_H */
+
+/*******************************************************************************
+ End of File
+ */
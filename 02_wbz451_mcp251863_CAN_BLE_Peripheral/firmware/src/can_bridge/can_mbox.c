@@ -0,0 +1,253 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Latest Value Mailbox Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_mbox.c
+
+  Summary:
+    Latest value mailbox of the CAN to BLE direction.
+
+  Description:
+    See can_mbox.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "can_mbox.h"
+
+#ifdef CAN_MBOX_ENABLE
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+#define CAN_MBOX_EXT_FLAG           0x80000000UL
+#define CAN_MBOX_KEY_FREE           0xFFFFFFFFUL    /* Not a valid identifier */
+#define CAN_MBOX_PROBE_MAX          8
+#define CAN_MBOX_DATA_MAX           8
+
+typedef struct CAN_MBOX_Slot_T
+{
+    uint32_t        key;                /* Identifier, CAN_MBOX_EXT_FLAG for extended */
+    CAN_RX_MSGOBJ   obj;
+    uint8_t         data[CAN_MBOX_DATA_MAX];
+    bool            pending;
+} CAN_MBOX_Slot_T;
+
+typedef struct CAN_MBOX_Range_T
+{
+    uint32_t    first;
+    uint32_t    last;
+    bool        extended;
+} CAN_MBOX_Range_T;
+
+static CAN_MBOX_Slot_T      s_mboxSlot[CAN_MBOX_SLOT_NUM];
+static uint8_t              s_mboxRing[CAN_MBOX_SLOT_NUM];  /* Pending slots, each at most once */
+static uint8_t              s_mboxHead;
+static uint8_t              s_mboxCount;
+static CAN_MBOX_Range_T     s_mboxRange[CAN_MBOX_RANGE_NUM];
+static uint8_t              s_mboxRangeNum;
+static CAN_MBOX_Stats_T     s_mboxStats;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool CAN_MBOX_InRange(uint32_t id, bool extended)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_mboxRangeNum; i++)
+    {
+        if ((s_mboxRange[i].extended == extended) && (id >= s_mboxRange[i].first) && (id <= s_mboxRange[i].last))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Returns the index of the slot of key, assigning a free one if it has none
+   yet, or CAN_MBOX_SLOT_NUM when no free slot is within CAN_MBOX_PROBE_MAX. */
+static uint8_t CAN_MBOX_SlotGet(uint32_t key)
+{
+    uint32_t idx = (uint32_t)(key * 2654435761U) >> (32U - CAN_MBOX_SLOT_BITS);
+    uint8_t probe;
+
+    for (probe = 0; probe < CAN_MBOX_PROBE_MAX; probe++)
+    {
+        if (s_mboxSlot[idx].key == key)
+        {
+            return (uint8_t)idx;
+        }
+        if (s_mboxSlot[idx].key == CAN_MBOX_KEY_FREE)
+        {
+            s_mboxSlot[idx].key = key;
+            s_mboxSlot[idx].pending = false;
+            return (uint8_t)idx;
+        }
+        idx = (idx + 1U) & (CAN_MBOX_SLOT_NUM - 1U);
+    }
+    return CAN_MBOX_SLOT_NUM;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_MBOX_Init(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < CAN_MBOX_SLOT_NUM; i++)
+    {
+        s_mboxSlot[i].key = CAN_MBOX_KEY_FREE;
+        s_mboxSlot[i].pending = false;
+    }
+    s_mboxHead = 0;
+    s_mboxCount = 0;
+    s_mboxRangeNum = 0;
+    memset(&s_mboxStats, 0, sizeof(s_mboxStats));
+}
+
+bool CAN_MBOX_RangeAdd(uint32_t first, uint32_t last, bool extended)
+{
+    if ((s_mboxRangeNum >= CAN_MBOX_RANGE_NUM) || (first > last))
+    {
+        return false;
+    }
+    s_mboxRange[s_mboxRangeNum].first = first;
+    s_mboxRange[s_mboxRangeNum].last = last;
+    s_mboxRange[s_mboxRangeNum].extended = extended;
+    s_mboxRangeNum++;
+    return true;
+}
+
+bool CAN_MBOX_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+{
+    CAN_MBOX_Slot_T *p_slot;
+    uint32_t id;
+    uint8_t idx;
+    uint8_t n = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)p_obj->bF.ctrl.DLC);
+
+    if (p_obj->bF.ctrl.RTR || (n > CAN_MBOX_DATA_MAX))
+    {
+        return false;
+    }
+
+    if (p_obj->bF.ctrl.IDE)
+    {
+        id = ((uint32_t)p_obj->bF.id.SID << 18) | p_obj->bF.id.EID;
+    }
+    else
+    {
+        id = p_obj->bF.id.SID;
+    }
+    if (!CAN_MBOX_InRange(id, p_obj->bF.ctrl.IDE != 0U))
+    {
+        return false;
+    }
+
+    idx = CAN_MBOX_SlotGet(p_obj->bF.ctrl.IDE ? (id | CAN_MBOX_EXT_FLAG) : id);
+    if (idx == CAN_MBOX_SLOT_NUM)
+    {
+        s_mboxStats.full++;
+        return false;
+    }
+
+    p_slot = &s_mboxSlot[idx];
+    if (p_slot->pending)
+    {
+        s_mboxStats.overwritten++;
+    }
+    else
+    {
+        s_mboxRing[(s_mboxHead + s_mboxCount) & (CAN_MBOX_SLOT_NUM - 1U)] = idx;
+        s_mboxCount++;
+        p_slot->pending = true;
+        if (s_mboxCount > s_mboxStats.pendingMax)
+        {
+            s_mboxStats.pendingMax = s_mboxCount;
+        }
+    }
+    s_mboxStats.held++;
+    p_slot->obj = *p_obj;
+    memcpy(p_slot->data, p_data, n);
+    return true;
+}
+
+bool CAN_MBOX_Peek(CAN_RX_MSGOBJ *p_obj, uint8_t *p_data)
+{
+    const CAN_MBOX_Slot_T *p_slot;
+
+    if (s_mboxCount == 0U)
+    {
+        return false;
+    }
+    p_slot = &s_mboxSlot[s_mboxRing[s_mboxHead]];
+    *p_obj = p_slot->obj;
+    memcpy(p_data, p_slot->data, CAN_MBOX_DATA_MAX);
+    return true;
+}
+
+void CAN_MBOX_Pop(void)
+{
+    if (s_mboxCount == 0U)
+    {
+        return;
+    }
+    s_mboxSlot[s_mboxRing[s_mboxHead]].pending = false;
+    s_mboxHead = (s_mboxHead + 1U) & (CAN_MBOX_SLOT_NUM - 1U);
+    s_mboxCount--;
+    s_mboxStats.sent++;
+}
+
+const CAN_MBOX_Stats_T *CAN_MBOX_StatsGet(void)
+{
+    return &s_mboxStats;
+}
+
+#endif /* CAN_MBOX_ENABLE */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,187 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Latest Value Mailbox Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_mbox.h
+
+  Summary:
+    Mailbox class for state-like CAN identifiers: while a frame waits for
+    BLE, a newer frame of the same identifier replaces it.
+
+  Description:
+    Frames of the identifiers in the configured ranges do not go through
+    the application queue. Each identifier owns a slot holding its latest
+    frame, and a pending slot is queued once in a ring of slot indices in
+    the order the identifier first became pending. A newer frame of a
+    pending identifier overwrites the slot in place and keeps its position,
+    so a backlog holds one frame per identifier, always the newest one.
+
+    The slots form an open addressed hash table with linear probing keyed
+    by the identifier and the IDE bit, like the change-only cache, so the
+    slot of a frame is found in constant time. A slot stays assigned to its
+    identifier; identifiers beyond CAN_MBOX_SLOT_NUM take the regular path.
+
+    A pending frame leaves the mailbox only when the BLE stack accepted it.
+    While the stack is out of buffers or no link is connected the frames
+    stay pending and keep being updated.
+*******************************************************************************/
+
+#ifndef _CAN_MBOX_H
+#define _CAN_MBOX_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "canfdspi/drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* Uncomment to send the newest frame only of the identifiers in the mailbox ranges. */
+//#define CAN_MBOX_ENABLE
+
+#define CAN_MBOX_SLOT_BITS          6       /* 64 identifiers */
+#define CAN_MBOX_SLOT_NUM           (1U << CAN_MBOX_SLOT_BITS)
+#define CAN_MBOX_RANGE_NUM          8
+#define CAN_MBOX_RETRY_MS           10      /* BLE send retry while the stack is out of buffers */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct CAN_MBOX_Stats_T
+{
+    uint32_t    held;                   /* Frames taken into the mailbox */
+    uint32_t    overwritten;            /* Pending frames replaced by a newer one */
+    uint32_t    sent;
+    uint32_t    full;                   /* Mailbox identifiers beyond the slots */
+    uint8_t     pendingMax;
+} CAN_MBOX_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_MBOX_Init(void)
+
+  Summary:
+    Empties the mailbox and the range table.
+*/
+void CAN_MBOX_Init(void);
+
+/*******************************************************************************
+  Function:
+    bool CAN_MBOX_RangeAdd(uint32_t first, uint32_t last, bool extended)
+
+  Summary:
+    Puts the identifiers first to last of one format into the mailbox class.
+
+  Returns:
+    true  - Range added.
+    false - Range table full or first > last.
+*/
+bool CAN_MBOX_RangeAdd(uint32_t first, uint32_t last, bool extended);
+
+/*******************************************************************************
+  Function:
+    bool CAN_MBOX_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+
+  Summary:
+    Takes a received frame of a mailbox identifier into its slot.
+
+  Returns:
+    true  - Frame held by the mailbox.
+    false - Not a mailbox identifier or no free slot, queue it as before.
+*/
+bool CAN_MBOX_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    bool CAN_MBOX_Peek(CAN_RX_MSGOBJ *p_obj, uint8_t *p_data)
+
+  Summary:
+    Copies the oldest pending frame, 8 bytes of data at most.
+
+  Returns:
+    true  - Frame copied, CAN_MBOX_Pop() releases it once sent.
+    false - Nothing pending.
+*/
+bool CAN_MBOX_Peek(CAN_RX_MSGOBJ *p_obj, uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    void CAN_MBOX_Pop(void)
+
+  Summary:
+    Releases the frame returned by the last CAN_MBOX_Peek().
+*/
+void CAN_MBOX_Pop(void);
+
+/*******************************************************************************
+  Function:
+    const CAN_MBOX_Stats_T *CAN_MBOX_StatsGet(void)
+
+  Summary:
+    Returns the counters since CAN_MBOX_Init.
+*/
+const CAN_MBOX_Stats_T *CAN_MBOX_StatsGet(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _CAN_MBOX_H */
+
+/*******************************************************************************
+ End of File
+ */
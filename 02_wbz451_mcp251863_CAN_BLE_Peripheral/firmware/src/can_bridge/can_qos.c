@@ -0,0 +1,460 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Quality of Service Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_qos.c
+
+  Summary:
+    Class queues, token buckets and the strict priority and deficit round
+    robin scheduler of the CAN to BLE direction.
+
+  Description:
+    See can_qos.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "can_qos.h"
+#include "can_log.h"
+
+#ifdef CAN_QOS_ENABLE
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+#define CAN_QOS_EXT_FLAG            0x80000000UL
+#define CAN_QOS_DATA_MAX            8
+#define CAN_QOS_TOKEN               1000U   /* Bucket fill in 1/1000 frame, refilled per ms */
+
+typedef struct CAN_QOS_Bucket_T
+{
+    uint32_t    tokens;
+    TickType_t  tick;
+    uint16_t    rate;                   /* Frames per second, 0 without limit */
+    uint16_t    burst;
+} CAN_QOS_Bucket_T;
+
+typedef struct CAN_QOS_Entry_T
+{
+    CAN_RX_MSGOBJ   obj;
+    uint8_t         data[CAN_QOS_DATA_MAX];
+    TickType_t      tick;               /* Queued at */
+} CAN_QOS_Entry_T;
+
+typedef struct CAN_QOS_Class_T
+{
+    CAN_QOS_Entry_T     queue[CAN_QOS_QUEUE_LEN];
+    uint8_t             head;
+    uint8_t             count;
+    bool                headShaped;     /* Head frame already counted as shaped */
+    uint16_t            quantum;
+    uint16_t            deficit;
+    CAN_QOS_Bucket_T    bucket;
+    CAN_QOS_Stats_T     stats;
+} CAN_QOS_Class_T;
+
+typedef struct CAN_QOS_Range_T
+{
+    uint32_t    first;
+    uint32_t    last;
+    bool        extended;
+    uint8_t     cls;
+} CAN_QOS_Range_T;
+
+typedef struct CAN_QOS_IdLimit_T
+{
+    uint32_t            key;            /* Identifier, CAN_QOS_EXT_FLAG for extended */
+    CAN_QOS_Bucket_T    bucket;
+} CAN_QOS_IdLimit_T;
+
+static CAN_QOS_Class_T      s_qosClass[CAN_QOS_CLASS_NUM];
+static CAN_QOS_Range_T      s_qosRange[CAN_QOS_RANGE_NUM];
+static uint8_t              s_qosRangeNum;
+static CAN_QOS_IdLimit_T    s_qosIdLimit[CAN_QOS_ID_LIMIT_NUM];
+static uint8_t              s_qosIdLimitNum;
+static uint8_t              s_qosRr;        /* Round robin class */
+static bool                 s_qosRrFresh;   /* s_qosRr has not got its quantum for this visit */
+static uint8_t              s_qosSel;       /* Class of the frame returned by CAN_QOS_Peek */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void CAN_QOS_BucketSet(CAN_QOS_Bucket_T *p_bucket, uint16_t framesPerSec, uint16_t burst)
+{
+    p_bucket->rate = framesPerSec;
+    p_bucket->burst = (burst != 0U) ? burst : 1U;
+    p_bucket->tokens = (uint32_t)p_bucket->burst * CAN_QOS_TOKEN;
+    p_bucket->tick = xTaskGetTickCount();
+}
+
+/* Refills the bucket and reports whether it holds a token. */
+static bool CAN_QOS_BucketReady(CAN_QOS_Bucket_T *p_bucket, TickType_t now)
+{
+    uint32_t full = (uint32_t)p_bucket->burst * CAN_QOS_TOKEN;
+    uint32_t elapsedMs;
+
+    if (p_bucket->rate == 0U)
+    {
+        return true;
+    }
+    elapsedMs = (uint32_t)(TickType_t)(now - p_bucket->tick) * portTICK_PERIOD_MS;
+    p_bucket->tick = now;
+    if (elapsedMs >= (full / p_bucket->rate) + 1U)
+    {
+        p_bucket->tokens = full;
+    }
+    else
+    {
+        p_bucket->tokens += elapsedMs * p_bucket->rate;
+        p_bucket->tokens = (p_bucket->tokens < full) ? p_bucket->tokens : full;
+    }
+    return (p_bucket->tokens >= CAN_QOS_TOKEN);
+}
+
+static uint16_t CAN_QOS_BucketWaitMs(const CAN_QOS_Bucket_T *p_bucket)
+{
+    return (uint16_t)((CAN_QOS_TOKEN - p_bucket->tokens + p_bucket->rate - 1U) / p_bucket->rate);
+}
+
+static void CAN_QOS_BucketTake(CAN_QOS_Bucket_T *p_bucket)
+{
+    if (p_bucket->rate != 0U)
+    {
+        p_bucket->tokens -= CAN_QOS_TOKEN;
+    }
+}
+
+static uint8_t CAN_QOS_ClassOf(uint32_t id, bool extended)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_qosRangeNum; i++)
+    {
+        if ((s_qosRange[i].extended == extended) && (id >= s_qosRange[i].first) && (id <= s_qosRange[i].last))
+        {
+            return s_qosRange[i].cls;
+        }
+    }
+    return CAN_QOS_CLASS_DEFAULT;
+}
+
+static CAN_QOS_IdLimit_T *CAN_QOS_IdLimitFind(uint32_t key)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_qosIdLimitNum; i++)
+    {
+        if (s_qosIdLimit[i].key == key)
+        {
+            return &s_qosIdLimit[i];
+        }
+    }
+    return NULL;
+}
+
+static uint8_t CAN_QOS_HeadSize(const CAN_QOS_Class_T *p_cls)
+{
+    const CAN_QOS_Entry_T *p_entry = &p_cls->queue[p_cls->head];
+
+    return (uint8_t)(sizeof(CAN_RX_MSGOBJ) + DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)p_entry->obj.bF.ctrl.DLC));
+}
+
+/* Checks the class bucket for the head frame, lowers *p_waitMs to the time
+   until its token when there is none. */
+static bool CAN_QOS_ClassReady(CAN_QOS_Class_T *p_cls, TickType_t now, uint16_t *p_waitMs)
+{
+    uint16_t ms;
+
+    if (CAN_QOS_BucketReady(&p_cls->bucket, now))
+    {
+        return true;
+    }
+    if (!p_cls->headShaped)
+    {
+        p_cls->headShaped = true;
+        p_cls->stats.shaped++;
+    }
+    ms = CAN_QOS_BucketWaitMs(&p_cls->bucket);
+    *p_waitMs = (ms < *p_waitMs) ? ms : *p_waitMs;
+    return false;
+}
+
+static void CAN_QOS_RrNext(void)
+{
+    s_qosRr = ((s_qosRr + 1U) < CAN_QOS_CLASS_NUM) ? (s_qosRr + 1U) : CAN_QOS_STRICT_NUM;
+    s_qosRrFresh = true;
+}
+
+/* Returns the class to send from next, CAN_QOS_CLASS_NUM if none may send. */
+static uint8_t CAN_QOS_Select(TickType_t now, uint16_t *p_waitMs)
+{
+    CAN_QOS_Class_T *p_cls;
+    uint8_t cls;
+    uint8_t visit;
+
+    *p_waitMs = OSAL_WAIT_FOREVER;
+    for (cls = 0; cls < CAN_QOS_STRICT_NUM; cls++)
+    {
+        if ((s_qosClass[cls].count != 0U) && CAN_QOS_ClassReady(&s_qosClass[cls], now, p_waitMs))
+        {
+            return cls;
+        }
+    }
+
+    // Each visit of a ready class gives it at least one frame, two rounds cover all
+    for (visit = 0; visit < (2U * (CAN_QOS_CLASS_NUM - CAN_QOS_STRICT_NUM)); visit++)
+    {
+        p_cls = &s_qosClass[s_qosRr];
+        if (p_cls->count == 0U)
+        {
+            p_cls->deficit = 0;
+        }
+        else if (CAN_QOS_ClassReady(p_cls, now, p_waitMs))
+        {
+            if (s_qosRrFresh)
+            {
+                p_cls->deficit += p_cls->quantum;
+                s_qosRrFresh = false;
+            }
+            if (p_cls->deficit >= CAN_QOS_HeadSize(p_cls))
+            {
+                return s_qosRr;
+            }
+        }
+        CAN_QOS_RrNext();
+    }
+    return CAN_QOS_CLASS_NUM;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_QOS_Init(void)
+{
+    uint8_t cls;
+
+    memset(s_qosClass, 0, sizeof(s_qosClass));
+    for (cls = CAN_QOS_STRICT_NUM; cls < CAN_QOS_CLASS_NUM; cls++)
+    {
+        s_qosClass[cls].quantum = (uint16_t)(CAN_QOS_QUANTUM_BYTES << (CAN_QOS_CLASS_NUM - 1U - cls));
+    }
+    s_qosRangeNum = 0;
+    s_qosIdLimitNum = 0;
+    s_qosRr = CAN_QOS_STRICT_NUM;
+    s_qosRrFresh = true;
+    s_qosSel = CAN_QOS_CLASS_NUM;
+}
+
+bool CAN_QOS_RangeAdd(uint32_t first, uint32_t last, bool extended, uint8_t cls)
+{
+    if ((s_qosRangeNum >= CAN_QOS_RANGE_NUM) || (first > last) || (cls >= CAN_QOS_CLASS_NUM))
+    {
+        return false;
+    }
+    s_qosRange[s_qosRangeNum].first = first;
+    s_qosRange[s_qosRangeNum].last = last;
+    s_qosRange[s_qosRangeNum].extended = extended;
+    s_qosRange[s_qosRangeNum].cls = cls;
+    s_qosRangeNum++;
+    return true;
+}
+
+bool CAN_QOS_WeightSet(uint8_t cls, uint8_t weight)
+{
+    if ((cls < CAN_QOS_STRICT_NUM) || (cls >= CAN_QOS_CLASS_NUM) || (weight == 0U))
+    {
+        return false;
+    }
+    s_qosClass[cls].quantum = (uint16_t)(CAN_QOS_QUANTUM_BYTES * weight);
+    return true;
+}
+
+bool CAN_QOS_ClassRateSet(uint8_t cls, uint16_t framesPerSec, uint16_t burst)
+{
+    if (cls >= CAN_QOS_CLASS_NUM)
+    {
+        return false;
+    }
+    CAN_QOS_BucketSet(&s_qosClass[cls].bucket, framesPerSec, burst);
+    return true;
+}
+
+bool CAN_QOS_IdRateSet(uint32_t id, bool extended, uint16_t framesPerSec, uint16_t burst)
+{
+    uint32_t key = extended ? (id | CAN_QOS_EXT_FLAG) : id;
+    CAN_QOS_IdLimit_T *p_limit = CAN_QOS_IdLimitFind(key);
+
+    if (p_limit == NULL)
+    {
+        if (s_qosIdLimitNum >= CAN_QOS_ID_LIMIT_NUM)
+        {
+            return false;
+        }
+        p_limit = &s_qosIdLimit[s_qosIdLimitNum++];
+        p_limit->key = key;
+    }
+    CAN_QOS_BucketSet(&p_limit->bucket, framesPerSec, burst);
+    return true;
+}
+
+void CAN_QOS_RxFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+{
+    CAN_QOS_Class_T *p_cls;
+    CAN_QOS_Entry_T *p_entry;
+    CAN_QOS_IdLimit_T *p_limit;
+    TickType_t now = xTaskGetTickCount();
+    bool extended = (p_obj->bF.ctrl.IDE != 0U);
+    uint32_t id;
+    uint8_t n = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)p_obj->bF.ctrl.DLC);
+
+    if (extended)
+    {
+        id = ((uint32_t)p_obj->bF.id.SID << 18) | p_obj->bF.id.EID;
+    }
+    else
+    {
+        id = p_obj->bF.id.SID;
+    }
+    p_cls = &s_qosClass[CAN_QOS_ClassOf(id, extended)];
+
+    p_limit = CAN_QOS_IdLimitFind(extended ? (id | CAN_QOS_EXT_FLAG) : id);
+    if (p_limit != NULL)
+    {
+        if (!CAN_QOS_BucketReady(&p_limit->bucket, now))
+        {
+            p_cls->stats.policed++;
+            return;
+        }
+        CAN_QOS_BucketTake(&p_limit->bucket);
+    }
+
+    if (p_cls->count >= CAN_QOS_QUEUE_LEN)
+    {
+        p_cls->stats.dropped++;
+        CAN_LOG2(CAN_LOG_QOS_DROP, id, (uint32_t)(p_cls - s_qosClass));
+        return;
+    }
+
+    p_entry = &p_cls->queue[(p_cls->head + p_cls->count) & (CAN_QOS_QUEUE_LEN - 1U)];
+    p_entry->obj = *p_obj;
+    memcpy(p_entry->data, p_data, (n < CAN_QOS_DATA_MAX) ? n : CAN_QOS_DATA_MAX);
+    p_entry->tick = now;
+    p_cls->count++;
+    p_cls->stats.queued++;
+    if (p_cls->count > p_cls->stats.depthMax)
+    {
+        p_cls->stats.depthMax = p_cls->count;
+    }
+}
+
+bool CAN_QOS_Peek(CAN_RX_MSGOBJ *p_obj, uint8_t *p_data, uint16_t *p_waitMs)
+{
+    const CAN_QOS_Entry_T *p_entry;
+
+    s_qosSel = CAN_QOS_Select(xTaskGetTickCount(), p_waitMs);
+    if (s_qosSel == CAN_QOS_CLASS_NUM)
+    {
+        return false;
+    }
+    p_entry = &s_qosClass[s_qosSel].queue[s_qosClass[s_qosSel].head];
+    *p_obj = p_entry->obj;
+    memcpy(p_data, p_entry->data, CAN_QOS_DATA_MAX);
+    return true;
+}
+
+void CAN_QOS_Pop(void)
+{
+    CAN_QOS_Class_T *p_cls;
+    uint16_t latencyMs;
+    uint8_t size;
+
+    if ((s_qosSel >= CAN_QOS_CLASS_NUM) || (s_qosClass[s_qosSel].count == 0U))
+    {
+        return;
+    }
+    p_cls = &s_qosClass[s_qosSel];
+    size = CAN_QOS_HeadSize(p_cls);
+    if (s_qosSel >= CAN_QOS_STRICT_NUM)
+    {
+        p_cls->deficit = (p_cls->deficit > size) ? (p_cls->deficit - size) : 0U;
+    }
+    CAN_QOS_BucketTake(&p_cls->bucket);
+
+    latencyMs = (uint16_t)((xTaskGetTickCount() - p_cls->queue[p_cls->head].tick) * portTICK_PERIOD_MS);
+    if (latencyMs > p_cls->stats.latencyMaxMs)
+    {
+        p_cls->stats.latencyMaxMs = latencyMs;
+    }
+    p_cls->head = (p_cls->head + 1U) & (CAN_QOS_QUEUE_LEN - 1U);
+    p_cls->count--;
+    p_cls->headShaped = false;
+    p_cls->stats.sent++;
+    s_qosSel = CAN_QOS_CLASS_NUM;
+}
+
+void CAN_QOS_Flush(void)
+{
+    uint8_t cls;
+
+    for (cls = 0; cls < CAN_QOS_CLASS_NUM; cls++)
+    {
+        s_qosClass[cls].stats.dropped += s_qosClass[cls].count;
+        s_qosClass[cls].count = 0;
+        s_qosClass[cls].deficit = 0;
+        s_qosClass[cls].headShaped = false;
+    }
+    s_qosSel = CAN_QOS_CLASS_NUM;
+}
+
+const CAN_QOS_Stats_T *CAN_QOS_StatsGet(uint8_t cls)
+{
+    return (cls < CAN_QOS_CLASS_NUM) ? &s_qosClass[cls].stats : NULL;
+}
+
+#endif /* CAN_QOS_ENABLE */
+
+/*******************************************************************************
+ End of File
+ */
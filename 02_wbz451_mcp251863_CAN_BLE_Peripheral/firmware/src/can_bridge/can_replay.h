@@ -0,0 +1,172 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Trace Replay Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_replay.h
+
+  Summary:
+    Replays a recorded CAN trace through the bridge on the device.
+
+  Description:
+    With CAN_REPLAY_ENABLE the MCP251863 runs in internal loopback mode and
+    the frames of the trace in can_replay_trace.h are loaded into the TX
+    FIFO at their recorded times, CAN_REPLAY_SPEEDUP times faster. They come
+    back through the RX interrupt and take the normal path to BLE, so the
+    peer receives the traffic of the recorded bus.
+
+    can_replay_trace.h is generated from a candump, Vector ASC or BLF log
+    with "tools/can_replay.py header". The time resolution is the RTOS
+    tick. A frame the TX FIFO does not take is retried on the next call and
+    the delay is reported as lag; the replay itself drops nothing, drops
+    happen where the bridge would drop on the real bus.
+
+    The replay starts CAN_REPLAY_START_MS after start-up, to give the peer
+    time to connect, and prints the number of frames, TX FIFO retries and
+    the maximum lag when the trace ends.
+*******************************************************************************/
+
+#ifndef _CAN_REPLAY_H
+#define _CAN_REPLAY_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* Uncomment to replay can_replay_trace.h. The CAN bus is not used then. */
+//#define CAN_REPLAY_ENABLE
+
+#define CAN_REPLAY_SPEEDUP          1       /* 1: recorded timing */
+#define CAN_REPLAY_START_MS         10000   /* Delay for the peer to connect */
+#define CAN_REPLAY_LOOPS            1       /* 0: repeat until CAN_REPLAY_Stop() */
+
+/* ctrl byte of a trace frame, laid out like byte 0 of the message object
+   control word. */
+#define CAN_REPLAY_CTRL_DLC_MASK    0x0FU
+#define CAN_REPLAY_CTRL_IDE         0x10U
+#define CAN_REPLAY_CTRL_RTR         0x20U
+#define CAN_REPLAY_CTRL_BRS         0x40U
+#define CAN_REPLAY_CTRL_FDF         0x80U
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct CAN_REPLAY_Frame_T
+{
+    uint32_t    timeUs;                 /* Since the first frame of the trace */
+    uint32_t    id;                     /* 11 bit SID or 29 bit SID:EID */
+    uint8_t     ctrl;
+    uint8_t     data[8];
+} CAN_REPLAY_Frame_T;
+
+/* Loads one frame into the TX FIFO without waiting. Returns false when the
+   FIFO is full. */
+typedef bool (*CAN_REPLAY_TxFunc_T)(const CAN_REPLAY_Frame_T *p_frame);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_REPLAY_Init(CAN_REPLAY_TxFunc_T txFunc)
+
+  Summary:
+    Registers the TX FIFO load function.
+*/
+void CAN_REPLAY_Init(CAN_REPLAY_TxFunc_T txFunc);
+
+/*******************************************************************************
+  Function:
+    bool CAN_REPLAY_Start(uint16_t speedup, uint32_t delayMs)
+
+  Summary:
+    Starts the replay of the trace after delayMs.
+
+  Returns:
+    true  - Replay scheduled.
+    false - No TX function, an empty trace or a speedup of 0.
+*/
+bool CAN_REPLAY_Start(uint16_t speedup, uint32_t delayMs);
+
+/*******************************************************************************
+  Function:
+    void CAN_REPLAY_Stop(void)
+
+  Summary:
+    Stops the replay and prints its totals.
+*/
+void CAN_REPLAY_Stop(void);
+
+/*******************************************************************************
+  Function:
+    uint16_t CAN_REPLAY_Tasks(uint16_t waitMs)
+
+  Summary:
+    Loads the frames that are due.
+
+  Returns:
+    waitMs, shortened to the time until the next frame is due.
+*/
+uint16_t CAN_REPLAY_Tasks(uint16_t waitMs);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _CAN_REPLAY_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,206 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Trace Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_trace.c
+
+  Summary:
+    Cycle counter tracepoints with log2 latency histograms.
+
+  Description:
+    See can_trace.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "can_trace.h"
+
+#ifdef CAN_TRACE_ENABLE
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+static CAN_TRACE_Hist_T s_canTraceHist[CAN_TRACE_P_NUM];
+static volatile uint32_t s_canTraceEdge;
+
+static const char * const s_canTraceName[CAN_TRACE_P_NUM] =
+{
+    "isr-wake", "spi", "fifo-read", "encode", "send", "tx-load", "e2e"
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void CAN_TRACE_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    s_canTraceEdge = 0;
+    CAN_TRACE_Reset();
+}
+
+void CAN_TRACE_Record(CAN_TRACE_Probe_T probe, uint32_t cycles)
+{
+    CAN_TRACE_Hist_T *p_hist = &s_canTraceHist[probe];
+    uint32_t b = 31U - __CLZ(cycles | 1U);
+
+    if (b >= CAN_TRACE_BUCKET_NUM)
+    {
+        b = CAN_TRACE_BUCKET_NUM - 1;
+    }
+    p_hist->bucket[b]++;
+    p_hist->count++;
+    if (cycles > p_hist->maxCycles)
+    {
+        p_hist->maxCycles = cycles;
+    }
+}
+
+void CAN_TRACE_EdgeMark(void)
+{
+    if (s_canTraceEdge == 0U)
+    {
+        /* Keep 0 for "no edge pending". */
+        s_canTraceEdge = DWT->CYCCNT | 1U;
+    }
+}
+
+uint32_t CAN_TRACE_EdgeTake(void)
+{
+    uint32_t edge = s_canTraceEdge;
+
+    /* An edge arriving in between is lost, it is only not measured. */
+    s_canTraceEdge = 0;
+    return edge;
+}
+
+const CAN_TRACE_Hist_T *CAN_TRACE_HistGet(CAN_TRACE_Probe_T probe)
+{
+    if (probe >= CAN_TRACE_P_NUM)
+    {
+        return NULL;
+    }
+    return &s_canTraceHist[probe];
+}
+
+void CAN_TRACE_Reset(void)
+{
+    memset(s_canTraceHist, 0, sizeof(s_canTraceHist));
+}
+
+void CAN_TRACE_Dump(void)
+{
+    uint8_t p;
+    uint8_t b;
+
+    SYS_CONSOLE_PRINT("[TRACE] %lu Hz, bucket b: [2^b, 2^(b+1)) cycles\r\n", (unsigned long)configCPU_CLOCK_HZ);
+    for (p = 0; p < CAN_TRACE_P_NUM; p++)
+    {
+        const CAN_TRACE_Hist_T *p_hist = &s_canTraceHist[p];
+
+        SYS_CONSOLE_PRINT("[TRACE] %-9s n=%lu max=%lu\r\n", s_canTraceName[p],
+            (unsigned long)p_hist->count, (unsigned long)p_hist->maxCycles);
+        for (b = 0; b < CAN_TRACE_BUCKET_NUM; b++)
+        {
+            if (p_hist->bucket[b] != 0U)
+            {
+                SYS_CONSOLE_PRINT("  %2u: %lu\r\n", b, (unsigned long)p_hist->bucket[b]);
+            }
+        }
+    }
+}
+
+uint8_t CAN_TRACE_VendorCmd(const uint8_t *p_cmd, uint16_t cmdLen, uint8_t *p_rsp)
+{
+    uint8_t probe;
+    uint8_t first;
+    uint8_t n;
+    uint8_t i;
+
+    if (cmdLen < 3)
+    {
+        return 0;
+    }
+    probe = p_cmd[1];
+    first = p_cmd[2];
+
+    if (probe == CAN_TRACE_VENDOR_DUMP)
+    {
+        CAN_TRACE_Dump();
+        return 0;
+    }
+    if (probe == CAN_TRACE_VENDOR_RESET)
+    {
+        CAN_TRACE_Reset();
+        return 0;
+    }
+    if ((probe >= CAN_TRACE_P_NUM) || (first >= CAN_TRACE_BUCKET_NUM))
+    {
+        return 0;
+    }
+
+    n = CAN_TRACE_BUCKET_NUM - first;
+    if (n > CAN_TRACE_VENDOR_BUCKETS)
+    {
+        n = CAN_TRACE_VENDOR_BUCKETS;
+    }
+    p_rsp[0] = probe;
+    p_rsp[1] = first;
+    p_rsp[2] = n;
+    for (i = 0; i < n; i++)
+    {
+        uint32_t cnt = s_canTraceHist[probe].bucket[first + i];
+
+        p_rsp[3 + i * 4]     = (uint8_t)cnt;
+        p_rsp[3 + i * 4 + 1] = (uint8_t)(cnt >> 8);
+        p_rsp[3 + i * 4 + 2] = (uint8_t)(cnt >> 16);
+        p_rsp[3 + i * 4 + 3] = (uint8_t)(cnt >> 24);
+    }
+    return 3 + n * 4;
+}
+
+#endif /* CAN_TRACE_ENABLE */
+
+/*******************************************************************************
+ End of File
+ */
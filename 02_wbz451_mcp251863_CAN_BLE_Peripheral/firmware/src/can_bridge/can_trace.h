@@ -0,0 +1,237 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge Trace Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_trace.h
+
+  Summary:
+    Cycle counter tracepoints with log2 latency histograms.
+
+  Description:
+    Fixed probes along the CAN to BLE and BLE to CAN data path measure their
+    section with the DWT cycle counter and count the result in a log2
+    histogram kept in RAM. Bucket b counts durations of [2^b, 2^(b+1)) CPU
+    cycles, the last bucket is open ended.
+
+    The probes are compiled in only when CAN_TRACE_ENABLE is defined. Without
+    it the macros expand to nothing and the module has no code or data.
+
+    Histograms are updated from the application task only. The EIC interrupt
+    only takes the edge time stamp.
+*******************************************************************************/
+
+#ifndef _CAN_TRACE_H
+#define _CAN_TRACE_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "device.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* Uncomment to compile in the tracepoints. */
+//#define CAN_TRACE_ENABLE
+
+#define CAN_TRACE_BUCKET_NUM        24      /* 2^23 cycles = 131 ms at 64 MHz */
+
+/* TRS vendor command reading the histograms. Request: opcode, probe, first
+   bucket. Response: opcode, probe, first bucket, bucket count, bucket
+   counters (uint32_t, little endian). CAN_TRACE_VENDOR_BUCKETS counters fit
+   into a 23 byte ATT MTU. */
+#define CAN_TRACE_VENDOR_OPCODE     0x30
+#define CAN_TRACE_VENDOR_BUCKETS    4
+#define CAN_TRACE_VENDOR_RSP_LEN    (3 + (CAN_TRACE_VENDOR_BUCKETS * 4))
+#define CAN_TRACE_VENDOR_DUMP       0xFE    /* Probe value: print all histograms on the console */
+#define CAN_TRACE_VENDOR_RESET      0xFF    /* Probe value: clear all histograms */
+
+#ifdef CAN_TRACE_ENABLE
+/* Declares stamp and loads it with the current cycle count. */
+#define CAN_TRACE_BEGIN(stamp)          uint32_t stamp = DWT->CYCCNT
+/* Counts the cycles since stamp for probe. */
+#define CAN_TRACE_END(probe, stamp)     CAN_TRACE_Record((probe), DWT->CYCCNT - (stamp))
+/* Same as CAN_TRACE_END for a stamp that may be 0 (not taken). */
+#define CAN_TRACE_SINCE(probe, stamp)   do { if ((stamp) != 0U) { CAN_TRACE_END((probe), (stamp)); } } while (0)
+/* Takes the EIC edge time stamp. Interrupt context. */
+#define CAN_TRACE_EDGE()                CAN_TRACE_EdgeMark()
+#else
+#define CAN_TRACE_BEGIN(stamp)
+#define CAN_TRACE_END(probe, stamp)
+#define CAN_TRACE_SINCE(probe, stamp)
+#define CAN_TRACE_EDGE()
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef enum CAN_TRACE_Probe_T
+{
+    CAN_TRACE_P_ISR_WAKE,                   /* EIC edge to the RX FIFO found not empty */
+    CAN_TRACE_P_SPI,                        /* One SPI transfer to the MCP251863 */
+    CAN_TRACE_P_FIFO_READ,                  /* RX FIFO read of one frame */
+    CAN_TRACE_P_ENCODE,                     /* Dequeued frame to first BLE send (routing, sizing) */
+    CAN_TRACE_P_SEND,                       /* One BLE_TRSPx_SendData() call */
+    CAN_TRACE_P_TX_LOAD,                    /* TX FIFO load of one frame */
+    CAN_TRACE_P_E2E,                        /* EIC edge to the last BLE send return of the frame */
+    CAN_TRACE_P_NUM
+} CAN_TRACE_Probe_T;
+
+typedef struct CAN_TRACE_Hist_T
+{
+    uint32_t    count;
+    uint32_t    maxCycles;
+    uint32_t    bucket[CAN_TRACE_BUCKET_NUM];
+} CAN_TRACE_Hist_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CAN_TRACE_Init(void)
+
+  Summary:
+    Starts the DWT cycle counter and clears the histograms.
+*/
+void CAN_TRACE_Init(void);
+
+/*******************************************************************************
+  Function:
+    void CAN_TRACE_Record(CAN_TRACE_Probe_T probe, uint32_t cycles)
+
+  Summary:
+    Counts one measurement of probe. Use the CAN_TRACE_END macro instead.
+*/
+void CAN_TRACE_Record(CAN_TRACE_Probe_T probe, uint32_t cycles);
+
+/*******************************************************************************
+  Function:
+    void CAN_TRACE_EdgeMark(void)
+
+  Summary:
+    Stores the cycle count of an EIC edge. Interrupt context.
+
+  Description:
+    Only the first edge after the last CAN_TRACE_EdgeTake() is kept, so the
+    latency is measured from the edge that started the current RX FIFO drain.
+*/
+void CAN_TRACE_EdgeMark(void);
+
+/*******************************************************************************
+  Function:
+    uint32_t CAN_TRACE_EdgeTake(void)
+
+  Summary:
+    Returns and clears the pending EIC edge time stamp.
+
+  Returns:
+    Cycle count of the edge, 0 if none is pending.
+*/
+uint32_t CAN_TRACE_EdgeTake(void);
+
+/*******************************************************************************
+  Function:
+    const CAN_TRACE_Hist_T *CAN_TRACE_HistGet(CAN_TRACE_Probe_T probe)
+
+  Summary:
+    Returns the histogram of probe, NULL for an invalid probe.
+*/
+const CAN_TRACE_Hist_T *CAN_TRACE_HistGet(CAN_TRACE_Probe_T probe);
+
+/*******************************************************************************
+  Function:
+    void CAN_TRACE_Reset(void)
+
+  Summary:
+    Clears all histograms.
+*/
+void CAN_TRACE_Reset(void);
+
+/*******************************************************************************
+  Function:
+    void CAN_TRACE_Dump(void)
+
+  Summary:
+    Prints count, maximum and the non-empty buckets of every probe on the
+    console.
+*/
+void CAN_TRACE_Dump(void);
+
+/*******************************************************************************
+  Function:
+    uint8_t CAN_TRACE_VendorCmd(const uint8_t *p_cmd, uint16_t cmdLen, uint8_t *p_rsp)
+
+  Summary:
+    Handles a CAN_TRACE_VENDOR_OPCODE vendor command.
+
+  Parameters:
+    p_cmd  - Received payload, starting with the opcode.
+    cmdLen - Length of p_cmd.
+    p_rsp  - Response payload without the opcode, CAN_TRACE_VENDOR_RSP_LEN
+             bytes.
+
+  Returns:
+    Length of the response to send back, 0 for none.
+*/
+uint8_t CAN_TRACE_VendorCmd(const uint8_t *p_cmd, uint16_t cmdLen, uint8_t *p_rsp);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _CAN_TRACE_H */
+
+/*******************************************************************************
+ End of File
+ */
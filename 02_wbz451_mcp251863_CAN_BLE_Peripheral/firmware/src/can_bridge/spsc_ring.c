@@ -0,0 +1,120 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  CAN Bridge SPSC Ring Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    spsc_ring.c
+
+  Summary:
+    Lock-free single producer / single consumer ring of fixed size records.
+
+  Description:
+    See spsc_ring.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "definitions.h"
+#include "spsc_ring.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+bool SPSC_RING_Init(SPSC_RING_T *p_ring, void *p_storage, uint16_t elemSize, uint16_t elemNum)
+{
+    if ((elemNum == 0) || ((elemNum & (elemNum - 1)) != 0))
+    {
+        return false;
+    }
+
+    p_ring->p_storage = (uint8_t *)p_storage;
+    p_ring->elemSize = elemSize;
+    p_ring->mask = elemNum - 1;
+    p_ring->wrIdx = 0;
+    p_ring->rdIdx = 0;
+    p_ring->dropCnt = 0;
+
+    return true;
+}
+
+bool SPSC_RING_Push(SPSC_RING_T *p_ring, const void *p_elem)
+{
+    uint32_t wrIdx = p_ring->wrIdx;
+
+    if ((wrIdx - p_ring->rdIdx) > p_ring->mask)
+    {
+        p_ring->dropCnt++;
+        return false;
+    }
+
+    memcpy(&p_ring->p_storage[(wrIdx & p_ring->mask) * p_ring->elemSize], p_elem, p_ring->elemSize);
+
+    /* The record must be complete before the consumer can see the new index. */
+    __DMB();
+    p_ring->wrIdx = wrIdx + 1;
+
+    return true;
+}
+
+bool SPSC_RING_Pop(SPSC_RING_T *p_ring, void *p_elem)
+{
+    uint32_t rdIdx = p_ring->rdIdx;
+
+    if (rdIdx == p_ring->wrIdx)
+    {
+        return false;
+    }
+
+    /* Do not read the record before the write index that published it. */
+    __DMB();
+    memcpy(p_elem, &p_ring->p_storage[(rdIdx & p_ring->mask) * p_ring->elemSize], p_ring->elemSize);
+
+    /* The copy must be done before the producer may reuse the slot. */
+    __DMB();
+    p_ring->rdIdx = rdIdx + 1;
+
+    return true;
+}
+
+uint16_t SPSC_RING_Count(const SPSC_RING_T *p_ring)
+{
+    return (uint16_t)(p_ring->wrIdx - p_ring->rdIdx);
+}
+
+/*******************************************************************************
+ End of File
+ */
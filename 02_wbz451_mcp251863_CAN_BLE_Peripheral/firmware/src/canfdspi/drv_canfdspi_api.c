@@ -49,6 +49,7 @@
 #include "drv_canfdspi_defines.h"
 
 #include <xc.h>
+#include "can_bridge/can_trace.h"
 
 
 // *****************************************************************************
@@ -64,6 +65,9 @@
 
 #define SPI_DEFAULT_BUFFER_LENGTH       96
 
+//! RAM initialization chunk: divides the RAM and fits the buffer with the instruction
+#define RAM_INIT_CHUNK_LENGTH           64
+
 //! SPI Transmit buffer
 uint8_t spiTransmitBuffer[SPI_DEFAULT_BUFFER_LENGTH];
 
@@ -133,7 +137,9 @@ const uint16_t crc16_table[256] = {
 
 int8_t DRV_SPI_TransferData(CANFDSPI_MODULE_ID index, void* txb, void* rxb, uint16_t txs)
 {
+    CAN_TRACE_BEGIN(spiStamp);
     bool isSuccess = DRV_SPI_WriteReadTransfer(index, txb, txs, rxb, txs);
+    CAN_TRACE_END(CAN_TRACE_P_SPI, spiStamp);
     return !isSuccess;
 }
 
@@ -2609,23 +2615,23 @@ int8_t DRV_CANFDSPI_CrcValueGet(CANFDSPI_MODULE_ID index, uint16_t* crc)
 
 int8_t DRV_CANFDSPI_RamInit(CANFDSPI_MODULE_ID index, uint8_t d)
 {
-    uint8_t txd[SPI_DEFAULT_BUFFER_LENGTH];
+    uint8_t txd[RAM_INIT_CHUNK_LENGTH];
     uint32_t k;
     int8_t spiTransferError = 0;
 
     // Prepare data
-    for (k = 0; k < SPI_DEFAULT_BUFFER_LENGTH; k++) {
+    for (k = 0; k < RAM_INIT_CHUNK_LENGTH; k++) {
         txd[k] = d;
     }
 
     uint16_t a = cRAMADDR_START;
 
-    for (k = 0; k < (cRAM_SIZE / SPI_DEFAULT_BUFFER_LENGTH); k++) {
-        spiTransferError = DRV_CANFDSPI_WriteByteArray(index, a, txd, SPI_DEFAULT_BUFFER_LENGTH);
+    for (k = 0; k < (cRAM_SIZE / RAM_INIT_CHUNK_LENGTH); k++) {
+        spiTransferError = DRV_CANFDSPI_WriteByteArray(index, a, txd, RAM_INIT_CHUNK_LENGTH);
         if (spiTransferError) {
             return -1;
         }
-        a += SPI_DEFAULT_BUFFER_LENGTH;
+        a += RAM_INIT_CHUNK_LENGTH;
     }
 
     return spiTransferError;
@@ -74,6 +74,16 @@
 #define BLE_TRSPS_MAX_BUF_IN                    (BLE_TRSPS_INIT_CREDIT*BLE_TRSPS_MAX_CONN_NBR)     /**< Maximum incoming queue number */
 /** @} */
 
+/**@defgroup BLE_TRSPS_RX_BUF BLE_TRSPS_RX_BUF
+ * @brief The definition of the per connection receive buffer. Received packets are stored back to back,
+ *        so the buffer holds INIT_CREDIT packets of the average length or fewer longer ones.
+ * @{ */
+#ifndef BLE_TRSPS_RX_PACKET_AVG_LEN
+#define BLE_TRSPS_RX_PACKET_AVG_LEN             64      /**< Expected average length of a received packet. */
+#endif
+#define BLE_TRSPS_RX_BUF_SIZE                   (BLE_TRSPS_INIT_CREDIT*BLE_TRSPS_RX_PACKET_AVG_LEN)     /**< Receive buffer size of one connection. */
+/** @} */
+
 /**@defgroup BLE_TRSPS_MAX_RETURN_CREDIT BLE_TRSPS_MAX_RETURN_CREDIT
  * @brief The definition of maximum return credit number.
  * @{ */
@@ -128,7 +138,7 @@ typedef struct BLE_TRSPS_PacketList_T
 {
     uint8_t                    writeType;               /**< Write Type. @ref BLE_GATT_WRITE_TYPES*/
     uint16_t                   length;                  /**< Data length. */
-    uint8_t                    *p_packet;               /**< Pointer to the TX/RX data buffer */
+    uint16_t                   offset;                  /**< Offset of the data in the receive buffer. */
 } BLE_TRSPS_PacketList_T;
 
 /**@brief The structure contains information about packet input queue format of BLE transparent profile. */
@@ -137,9 +147,18 @@ typedef struct BLE_TRSPS_QueueIn_T
     uint8_t                    usedNum;                    /**< The number of data list of packetIn buffer. */
     uint8_t                    writeIndex;                 /**< The Index of data, written in packet buffer. */
     uint8_t                    readIndex;                  /**< The Index of data, read in packet buffer. */
+    uint16_t                   writeOffset;                /**< Offset of the first free byte behind the newest packet. */
     BLE_TRSPS_PacketList_T     packetList[BLE_TRSPS_INIT_CREDIT];  /**< Written in packet buffer. @ref BLE_TRSPS_PacketBufferIn_T.*/
+    uint8_t                    buffer[BLE_TRSPS_RX_BUF_SIZE];      /**< Receive buffer holding the packet data. */
 } BLE_TRSPS_QueueIn_T;
 
+/**@brief Storage for a pending write response or error response. */
+typedef union BLE_TRSPS_RetryParams_T
+{
+    GATTS_SendWriteRespParams_T writeResp;                 /**< Write response parameters. */
+    GATTS_SendErrRespParams_T   errResp;                   /**< Error response parameters. */
+} BLE_TRSPS_RetryParams_T;
+
 /**@brief The structure contains information about BLE transparent profile connection parameters for recording connection information. */
 typedef struct BLE_TRSPS_ConnList_T
 {
@@ -150,7 +169,8 @@ typedef struct BLE_TRSPS_ConnList_T
     uint8_t                    peerCredit;              /**< Credit number from Central to Peripheral. */
     uint8_t                    localCredit;             /**< Credit number from Peripheral to Central. */
     uint8_t                    retryType;               /**< Retry type. @ref BLE_TRSPS_RETRY_TYPE. */
-    uint8_t                    *p_retryData;            /**< Retry data pointer. */
+    uint8_t                    *p_retryData;            /**< Retry data pointer, NULL or pointing to retryParams. */
+    BLE_TRSPS_RetryParams_T    retryParams;             /**< Retry data storage. */
     BLE_TRSPS_QueueIn_T        inputQueue;              /**< Input queue to store Rx packets. */
 } BLE_TRSPS_ConnList_T;
 
@@ -171,7 +191,11 @@ static BLE_TRSPS_EventCb_T      bleTrspsProcess;
 static BLE_TRSPS_ConnList_T     s_trsConnList[BLE_TRSPS_MAX_CONN_NBR];
 static BLE_TRSPS_Params_T       s_trsParams;
 
+/* GATTS_SendHandleValue() copies the parameters before it returns, so one block serves all notifications. */
+static GATTS_HandleValueParams_T    s_trspsHvParams;
+
 MW_ASSERT((BLE_TRSPS_MAX_CONN_NBR*BLE_TRSPS_INIT_CREDIT)==BLE_TRSPS_MAX_BUF_IN);
+MW_ASSERT(BLE_TRSPS_RX_BUF_SIZE>=(BLE_ATT_MAX_MTU_LEN-ATT_WRITE_HEADER_SIZE));
 
 // *****************************************************************************
 // *****************************************************************************
@@ -217,23 +241,23 @@ static BLE_TRSPS_ConnList_T *ble_trsps_GetFreeConnList()
 
 static uint16_t ble_trsps_ServerReturnCredit(BLE_TRSPS_ConnList_T *p_conn)
 {
-    GATTS_HandleValueParams_T hvParams;
+    GATTS_HandleValueParams_T *p_hvParams = &s_trspsHvParams;
     uint8_t *p_buf;
 
     if (p_conn->peerCredit == 0)
         return MBA_RES_SUCCESS;
 
-    hvParams.sendType = ATT_HANDLE_VALUE_NTF;
-    hvParams.charHandle = TRS_HDL_CHARVAL_CTRL;
-    hvParams.charLength = 0x05;
+    p_hvParams->sendType = ATT_HANDLE_VALUE_NTF;
+    p_hvParams->charHandle = TRS_HDL_CHARVAL_CTRL;
+    p_hvParams->charLength = 0x05;
 
-    p_buf=hvParams.charValue;
+    p_buf=p_hvParams->charValue;
     U8_TO_STREAM(&p_buf, BLE_TRSPS_CBFC_OPCODE_SUCCESS);
     U8_TO_STREAM(&p_buf, BLE_TRSPS_CBFC_OPCODE_SERVER_ENABLED);
     U16_TO_STREAM_BE(&p_buf, p_conn->attMtu)
     U8_TO_STREAM(&p_buf, p_conn->peerCredit)
 
-    if (GATTS_SendHandleValue(p_conn->connHandle, &hvParams) == MBA_RES_SUCCESS)
+    if (GATTS_SendHandleValue(p_conn->connHandle, p_hvParams) == MBA_RES_SUCCESS)
     {
         p_conn ->peerCredit = 0;
         return MBA_RES_SUCCESS;
@@ -244,6 +268,65 @@ static uint16_t ble_trsps_ServerReturnCredit(BLE_TRSPS_ConnList_T *p_conn)
     }
 }
 
+static uint8_t *ble_trsps_QueueInAlloc(BLE_TRSPS_QueueIn_T *p_queue, uint8_t writeType, uint16_t length)
+{
+    uint16_t offset;
+    uint16_t readOffset;
+
+    if (length > BLE_TRSPS_RX_BUF_SIZE)
+    {
+        return NULL;
+    }
+
+    if (p_queue->usedNum == 0)
+    {
+        offset = 0;
+    }
+    else
+    {
+        readOffset = p_queue->packetList[p_queue->readIndex].offset;
+        offset = p_queue->writeOffset;
+
+        if (offset > readOffset)
+        {
+            // Packets are kept contiguous: wrap to the start if the tail is too short.
+            if ((BLE_TRSPS_RX_BUF_SIZE - offset) < length)
+            {
+                if (readOffset < length)
+                {
+                    return NULL;
+                }
+                offset = 0;
+            }
+        }
+        else if ((readOffset - offset) < length)
+        {
+            return NULL;
+        }
+    }
+
+    p_queue->packetList[p_queue->writeIndex].writeType = writeType;
+    p_queue->packetList[p_queue->writeIndex].length = length;
+    p_queue->packetList[p_queue->writeIndex].offset = offset;
+    p_queue->writeOffset = offset + length;
+    p_queue->writeIndex++;
+    if (p_queue->writeIndex >= BLE_TRSPS_INIT_CREDIT)
+        p_queue->writeIndex = 0;
+
+    p_queue->usedNum++;
+
+    return &p_queue->buffer[offset];
+}
+
+static void ble_trsps_QueueInRelease(BLE_TRSPS_QueueIn_T *p_queue)
+{
+    p_queue->readIndex++;
+    if (p_queue->readIndex >= BLE_TRSPS_INIT_CREDIT)
+        p_queue->readIndex = 0;
+
+    p_queue->usedNum--;
+}
+
 static void ble_trsps_RcvData(BLE_TRSPS_ConnList_T *p_conn, uint8_t writeType, uint16_t receivedLen, uint8_t *p_receivedValue)
 {
     if (p_conn->inputQueue.usedNum < BLE_TRSPS_INIT_CREDIT)
@@ -253,7 +336,7 @@ static void ble_trsps_RcvData(BLE_TRSPS_ConnList_T *p_conn, uint8_t writeType, u
 
 
         memset((uint8_t *) &evtPara, 0, sizeof(evtPara));
-        p_buffer = OSAL_Malloc(receivedLen);
+        p_buffer = ble_trsps_QueueInAlloc(&p_conn->inputQueue, writeType, receivedLen);
         
         if (p_buffer == NULL)
         {
@@ -267,14 +350,6 @@ static void ble_trsps_RcvData(BLE_TRSPS_ConnList_T *p_conn, uint8_t writeType, u
         }
 
         memcpy(p_buffer, p_receivedValue, receivedLen);
-        p_conn->inputQueue.packetList[p_conn->inputQueue.writeIndex].writeType = writeType;
-        p_conn->inputQueue.packetList[p_conn->inputQueue.writeIndex].length = receivedLen;
-        p_conn->inputQueue.packetList[p_conn->inputQueue.writeIndex].p_packet = p_buffer;
-        p_conn->inputQueue.writeIndex++;
-        if (p_conn->inputQueue.writeIndex >= BLE_TRSPS_INIT_CREDIT)
-            p_conn->inputQueue.writeIndex = 0;
-
-        p_conn->inputQueue.usedNum++;
 
         evtPara.eventId=BLE_TRSPS_EVT_RECEIVE_DATA;
         evtPara.eventField.onReceiveData.connHandle = p_conn->connHandle;
@@ -290,7 +365,6 @@ static void ble_trsps_FreeRetryData(BLE_TRSPS_ConnList_T *p_conn)
 {
     if (p_conn->p_retryData)
     {
-        OSAL_Free(p_conn->p_retryData);
         p_conn->p_retryData = NULL;
         p_conn->retryType = 0;
     }
@@ -401,28 +475,20 @@ uint16_t BLE_TRSPS_SendVendorCommand(uint16_t connHandle, uint8_t commandID, uin
         return MBA_RES_INVALID_PARA;
     }
 
-    p_hvParams = OSAL_Malloc(sizeof(GATTS_HandleValueParams_T));
-    if (p_hvParams != NULL)
-    {
-        p_hvParams->charHandle = TRS_HDL_CHARVAL_CTRL;
-        p_hvParams->charLength = (commandLength+1);
-        p_hvParams->charValue[0] = commandID;
-        memcpy(&p_hvParams->charValue[1], p_commandPayload, commandLength);
-        p_hvParams->sendType = ATT_HANDLE_VALUE_NTF;
-        result = GATTS_SendHandleValue(p_conn->connHandle, p_hvParams);
-        OSAL_Free(p_hvParams);
-        
-        return result;
-    }
-    else
-    {
-        return MBA_RES_OOM;
-    }
+    p_hvParams = &s_trspsHvParams;
+    p_hvParams->charHandle = TRS_HDL_CHARVAL_CTRL;
+    p_hvParams->charLength = (commandLength+1);
+    p_hvParams->charValue[0] = commandID;
+    memcpy(&p_hvParams->charValue[1], p_commandPayload, commandLength);
+    p_hvParams->sendType = ATT_HANDLE_VALUE_NTF;
+    result = GATTS_SendHandleValue(p_conn->connHandle, p_hvParams);
+
+    return result;
 }
 
 uint16_t BLE_TRSPS_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data)
 {
-    GATTS_HandleValueParams_T  hvParams;
+    GATTS_HandleValueParams_T  *p_hvParams;
     BLE_TRSPS_ConnList_T *p_conn;
     uint16_t result;
 
@@ -452,12 +518,13 @@ uint16_t BLE_TRSPS_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data)
         return MBA_RES_FAIL;
     }
 
-    hvParams.charHandle = TRS_HDL_CHARVAL_TX;
-    hvParams.charLength = len;
-    memcpy(hvParams.charValue, p_data, hvParams.charLength);
-    hvParams.sendType = ATT_HANDLE_VALUE_NTF;
+    p_hvParams = &s_trspsHvParams;
+    p_hvParams->charHandle = TRS_HDL_CHARVAL_TX;
+    p_hvParams->charLength = len;
+    memcpy(p_hvParams->charValue, p_data, p_hvParams->charLength);
+    p_hvParams->sendType = ATT_HANDLE_VALUE_NTF;
 
-    result = GATTS_SendHandleValue(p_conn->connHandle, &hvParams);
+    result = GATTS_SendHandleValue(p_conn->connHandle, p_hvParams);
     if (result == MBA_RES_SUCCESS)
     {
         if (p_conn->cbfcEnable&BLE_TRSPS_CBFC_TX_ENABLED)
@@ -485,48 +552,62 @@ void BLE_TRSPS_GetDataLength(uint16_t connHandle, uint16_t *p_dataLength)
         *p_dataLength = 0;
 }
 
-uint16_t BLE_TRSPS_GetData(uint16_t connHandle, uint8_t *p_data)
+uint16_t BLE_TRSPS_PeekData(uint16_t connHandle, uint8_t **pp_data, uint16_t *p_dataLength)
 {
     BLE_TRSPS_ConnList_T *p_conn = NULL;
-    uint8_t writeType = 0;
+    BLE_TRSPS_PacketList_T *p_packet;
 
     p_conn = ble_trsps_GetConnListByHandle(connHandle);
-    if (p_conn)
+    if ((p_conn == NULL) || (p_conn->inputQueue.usedNum == 0))
     {
-        if ((p_conn->inputQueue.usedNum) > 0)
-        {
-            if (p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet)
-            {
-                memcpy(p_data, p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet, 
-                    p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].length);
-                OSAL_Free(p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet);
-                p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet = NULL;
-            }
-            
-            writeType = p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].writeType;
+        return MBA_RES_FAIL;
+    }
 
-            p_conn->inputQueue.readIndex++;
-            if (p_conn->inputQueue.readIndex >= BLE_TRSPS_INIT_CREDIT)
-                p_conn->inputQueue.readIndex = 0;
+    p_packet = &p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex];
+    *pp_data = &p_conn->inputQueue.buffer[p_packet->offset];
+    *p_dataLength = p_packet->length;
 
-            p_conn->inputQueue.usedNum --;
-            
-            if ((p_conn->cbfcEnable&BLE_TRSPS_CBFC_RX_ENABLED)
-            && (writeType == ATT_WRITE_CMD))
-            {
-                p_conn->peerCredit++;
-                if (p_conn->peerCredit >= BLE_TRSPS_MAX_RETURN_CREDIT)
-                    ble_trsps_ServerReturnCredit(p_conn);
-            }
+    return MBA_RES_SUCCESS;
+}
 
-            return MBA_RES_SUCCESS;
-        }
-        else
-            return MBA_RES_FAIL;
+uint16_t BLE_TRSPS_ReleaseData(uint16_t connHandle)
+{
+    BLE_TRSPS_ConnList_T *p_conn = NULL;
+    uint8_t writeType;
+
+    p_conn = ble_trsps_GetConnListByHandle(connHandle);
+    if ((p_conn == NULL) || (p_conn->inputQueue.usedNum == 0))
+    {
+        return MBA_RES_FAIL;
     }
-    else
+
+    writeType = p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].writeType;
+    ble_trsps_QueueInRelease(&p_conn->inputQueue);
+
+    if ((p_conn->cbfcEnable&BLE_TRSPS_CBFC_RX_ENABLED)
+    && (writeType == ATT_WRITE_CMD))
+    {
+        p_conn->peerCredit++;
+        if (p_conn->peerCredit >= BLE_TRSPS_MAX_RETURN_CREDIT)
+            ble_trsps_ServerReturnCredit(p_conn);
+    }
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_TRSPS_GetData(uint16_t connHandle, uint8_t *p_data)
+{
+    uint8_t *p_packet;
+    uint16_t length;
+
+    if (BLE_TRSPS_PeekData(connHandle, &p_packet, &length) != MBA_RES_SUCCESS)
+    {
         return MBA_RES_FAIL;
+    }
+
+    memcpy(p_data, p_packet, length);
 
+    return BLE_TRSPS_ReleaseData(connHandle);
 }
 
 static uint8_t ble_trsps_TxCccd(BLE_TRSPS_ConnList_T *p_conn, uint8_t *p_value)
@@ -727,17 +808,7 @@ static void ble_trsps_GattsWriteProcess(GATT_Event_T *p_event)
         }
         if (!error)
         {
-            p_conn->p_retryData = OSAL_Malloc(sizeof(GATTS_SendWriteRespParams_T));
-            if (p_conn->p_retryData == NULL)
-            {
-                BLE_TRSPS_Event_T evtPara;
-                evtPara.eventId = BLE_TRSPS_EVT_ERR_NO_MEM;
-                if (bleTrspsProcess)
-                {
-                    bleTrspsProcess(&evtPara);
-                }
-                return;
-            }
+            p_conn->p_retryData = (uint8_t *)&p_conn->retryParams;
             p_trsRespParams = (GATTS_SendWriteRespParams_T *)p_conn->p_retryData;
             p_trsRespParams->responseType = ATT_WRITE_RSP;
             p_conn->retryType = BLE_TRSPS_RETRY_TYPE_RESP;
@@ -749,17 +820,7 @@ static void ble_trsps_GattsWriteProcess(GATT_Event_T *p_event)
         }
         else
         {
-            p_conn->p_retryData = OSAL_Malloc(sizeof(GATTS_SendErrRespParams_T));
-            if (p_conn->p_retryData == NULL)
-            {
-                BLE_TRSPS_Event_T evtPara;
-                evtPara.eventId = BLE_TRSPS_EVT_ERR_NO_MEM;
-                if (bleTrspsProcess)
-                {
-                    bleTrspsProcess(&evtPara);
-                }
-                return;
-            }
+            p_conn->p_retryData = (uint8_t *)&p_conn->retryParams;
             p_trsErrParams = (GATTS_SendErrRespParams_T *)p_conn->p_retryData;
             p_trsErrParams->reqOpcode = p_event->eventField.onWrite.writeType;
             p_trsErrParams->attrHandle = p_event->eventField.onWrite.attrHandle;
@@ -841,21 +902,7 @@ void ble_trsps_GapEventProcess(BLE_GAP_Event_T *p_event)
 
             if (p_conn != NULL)
             {
-                // Flush all queued data.
-                while (p_conn->inputQueue.usedNum > 0)
-                {
-                    if (p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet)
-                    {
-                        OSAL_Free(p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet);
-                        p_conn->inputQueue.packetList[p_conn->inputQueue.readIndex].p_packet = NULL;
-                    }
-
-                    p_conn->inputQueue.readIndex++;
-                    if (p_conn->inputQueue.readIndex >= BLE_TRSPS_INIT_CREDIT)
-                        p_conn->inputQueue.readIndex = 0;
-
-                    p_conn->inputQueue.usedNum --;
-                }
+                // Queued data is dropped together with the connection context.
                 // Free retry data
                 if (p_conn->p_retryData)
                 {
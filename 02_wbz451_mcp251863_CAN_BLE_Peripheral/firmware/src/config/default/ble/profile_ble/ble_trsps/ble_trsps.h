@@ -95,7 +95,7 @@ typedef enum BLE_TRSPS_EventId_T
     BLE_TRSPS_EVT_RECEIVE_DATA,                         /**< Transparent Profile Data Channel received notification event. See @ref BLE_TRSPS_EvtReceiveData_T for event details. */
     BLE_TRSPS_EVT_VENDOR_CMD,                           /**< Transparent Profile vendor command received notification event. See @ref BLE_TRSPS_EvtVendorCmd_T for event details. */
     BLE_TRSPS_EVT_ERR_UNSPECIFIED,                      /**< Profile internal unspecified error occurs. */
-    BLE_TRSPS_EVT_ERR_NO_MEM,                           /**< Profile internal error occurs due to insufficient heap memory. */
+    BLE_TRSPS_EVT_ERR_NO_MEM,                           /**< Profile internal error occurs because the receive buffer has no room for the packet. */
     BLE_TRSPS_EVT_END
 }BLE_TRSPS_EventId_T;
 
@@ -259,6 +259,29 @@ void BLE_TRSPS_GetDataLength(uint16_t connHandle, uint16_t *p_dataLength);
  */
 uint16_t BLE_TRSPS_GetData(uint16_t connHandle, uint8_t *p_data);
 
+/**@brief Get a borrowed pointer to the oldest queued packet without copying it.
+ *        The data stays valid until @ref BLE_TRSPS_ReleaseData or @ref BLE_TRSPS_GetData consumes the packet.
+ *
+ * @param[in]  connHandle                   Connection handle associated with the queued data
+ * @param[out] pp_data                      Pointer to the packet data in the profile receive buffer.
+ * @param[out] p_dataLength                 Data length.
+ *
+ * @retval MBA_RES_SUCCESS                  Successfully get the packet.
+ * @retval MBA_RES_FAIL                     No data in the input queue or can not find the link.
+ *
+ */
+uint16_t BLE_TRSPS_PeekData(uint16_t connHandle, uint8_t **pp_data, uint16_t *p_dataLength);
+
+/**@brief Consume the oldest queued packet after it was read with @ref BLE_TRSPS_PeekData.
+ *
+ * @param[in]  connHandle                   Connection handle associated with the queued data
+ *
+ * @retval MBA_RES_SUCCESS                  Successfully release the packet.
+ * @retval MBA_RES_FAIL                     No data in the input queue or can not find the link.
+ *
+ */
+uint16_t BLE_TRSPS_ReleaseData(uint16_t connHandle);
+
 /**@brief Handle BLE_Stack events.
  *       This API should be called in the application while caching BLE_Stack events
  *
@@ -38,7 +38,7 @@
 // DOM-IGNORE-END
 
 
-#define PDS_APP_MAX_ITEMS_AMOUNT        0
+#define PDS_APP_MAX_ITEMS_AMOUNT        1   /* APP_BLE_PEER_ITEM_ID */
 #define PDS_APP_MAX_DIR_MEM_ID_AMOUNT   0
 
 #define MAX_PDS_ITEMS_COUNT         (PDS_APP_MAX_ITEMS_AMOUNT)
@@ -61,10 +61,19 @@
 // *****************************************************************************
 #define TASK_BLE_STACK_SIZE (2 *1024 / sizeof(portSTACK_TYPE))
 #define TASK_BLE_PRIORITY (tskIDLE_PRIORITY + 3)
+#define TASK_APP_STACK_SIZE 1024
+#define TASK_APP_PRIORITY 1
 
 /* Handle for the APP_Tasks. */
 TaskHandle_t xAPP_Tasks;
 
+#ifdef APP_STATIC_ALLOCATION
+static StackType_t  s_bleTaskStack[TASK_BLE_STACK_SIZE] APP_STATIC_SECTION("rtos");
+static StaticTask_t s_bleTaskTcb APP_STATIC_SECTION("rtos");
+static StackType_t  s_appTaskStack[TASK_APP_STACK_SIZE] APP_STATIC_SECTION("rtos");
+static StaticTask_t s_appTaskTcb APP_STATIC_SECTION("rtos");
+#endif
+
 void _APP_Tasks(  void *pvParameters  )
 {   
     while(1)
@@ -100,19 +109,33 @@ void SYS_Tasks ( void )
 
     /* Maintain Middleware & Other Libraries */
     
+#ifdef APP_STATIC_ALLOCATION
+    xTaskCreateStatic(BM_Task, "BLE", TASK_BLE_STACK_SIZE, NULL, TASK_BLE_PRIORITY, s_bleTaskStack, &s_bleTaskTcb);
+#else
     if (xTaskCreate(BM_Task,     "BLE", TASK_BLE_STACK_SIZE, NULL  , TASK_BLE_PRIORITY, NULL) != pdPASS)
         while (1);
+#endif
 
 
 
     /* Maintain the application's state machine. */
         /* Create OS Thread for APP_Tasks. */
+#ifdef APP_STATIC_ALLOCATION
+    xAPP_Tasks = xTaskCreateStatic((TaskFunction_t) _APP_Tasks,
+                "APP_Tasks",
+                TASK_APP_STACK_SIZE,
+                NULL,
+                TASK_APP_PRIORITY,
+                s_appTaskStack,
+                &s_appTaskTcb);
+#else
     xTaskCreate((TaskFunction_t) _APP_Tasks,
                 "APP_Tasks",
-                1024,
+                TASK_APP_STACK_SIZE,
                 NULL,
-                1,
+                TASK_APP_PRIORITY,
                 &xAPP_Tasks);
+#endif
 
 
 
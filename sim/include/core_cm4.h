@@ -0,0 +1,192 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Host Simulation CMSIS Core Header
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    core_cm4.h
+
+  Summary:
+    Cortex-M4 core header for the Linux host simulation.
+
+  Description:
+    Found before the CMSIS copy of the project, so the device header of the
+    WBZ451 pulls in this file. It takes the place of cmsis_gcc.h, whose
+    intrinsics are ARM assembly, with host equivalents and then includes the
+    real core_cm4.h for the register structures and base addresses.
+
+    The core and peripheral register windows are mapped as plain memory by
+    SIM_BOARD_Init, so SCB, DWT and the GPIO registers can be written as on
+    the target. DWT->CYCCNT is set from the virtual time.
+
+    The simulation runs APP_Tasks and the "interrupts" on one host thread.
+    Interrupts only fire between SPI transfers and while waiting, never
+    between an exclusive load and store, so __STREXW always succeeds.
+*******************************************************************************/
+
+#ifndef SIM_CORE_CM4_H
+#define SIM_CORE_CM4_H
+
+#include <stdint.h>
+
+/* Claims the include guard of cmsis_gcc.h. */
+#define __CMSIS_GCC_H
+
+#define __ASM                                  __asm
+#define __INLINE                               inline
+#define __STATIC_INLINE                        static inline
+#define __STATIC_FORCEINLINE                   __attribute__((always_inline)) static inline
+#define __NO_RETURN                            __attribute__((__noreturn__))
+#define __USED                                 __attribute__((used))
+#define __WEAK                                 __attribute__((weak))
+#define __PACKED                               __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT                        struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION                         union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)                           __attribute__((aligned(x)))
+#define __RESTRICT                             __restrict
+#define __COMPILER_BARRIER()                   __ASM volatile("":::"memory")
+
+#define __UNALIGNED_UINT16_READ(addr)          (*(const uint16_t *)(const void *)(addr))
+#define __UNALIGNED_UINT16_WRITE(addr, val)    (void)(*(uint16_t *)(void *)(addr) = (val))
+#define __UNALIGNED_UINT32_READ(addr)          (*(const uint32_t *)(const void *)(addr))
+#define __UNALIGNED_UINT32_WRITE(addr, val)    (void)(*(uint32_t *)(void *)(addr) = (val))
+
+#define __NOP()                                ((void)0)
+#define __WFI()                                ((void)0)
+#define __WFE()                                ((void)0)
+#define __SEV()                                ((void)0)
+#define __BKPT(value)                          __builtin_trap()
+
+__STATIC_FORCEINLINE void __ISB(void)
+{
+    __sync_synchronize();
+}
+
+__STATIC_FORCEINLINE void __DSB(void)
+{
+    __sync_synchronize();
+}
+
+__STATIC_FORCEINLINE void __DMB(void)
+{
+    __sync_synchronize();
+}
+
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t value)
+{
+    return __builtin_bswap32(value);
+}
+
+__STATIC_FORCEINLINE uint32_t __REV16(uint32_t value)
+{
+    return ((value & 0x00FF00FFUL) << 8) | ((value & 0xFF00FF00UL) >> 8);
+}
+
+__STATIC_FORCEINLINE uint32_t __RBIT(uint32_t value)
+{
+    uint32_t result = 0;
+    uint8_t i;
+
+    for (i = 0; i < 32U; i++)
+    {
+        result = (result << 1) | ((value >> i) & 1U);
+    }
+    return result;
+}
+
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t value)
+{
+    return (value == 0U) ? 32U : (uint8_t)__builtin_clz(value);
+}
+
+__STATIC_FORCEINLINE uint32_t __LDREXW(volatile uint32_t *addr)
+{
+    return *addr;
+}
+
+__STATIC_FORCEINLINE uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)
+{
+    *addr = value;
+    return 0U;
+}
+
+__STATIC_FORCEINLINE void __CLREX(void)
+{
+}
+
+/* PRIMASK and BASEPRI are kept, nothing reads them but the code under test. */
+extern uint32_t simCorePrimask;
+extern uint32_t simCoreBasepri;
+
+__STATIC_FORCEINLINE void __enable_irq(void)
+{
+    simCorePrimask = 0U;
+}
+
+__STATIC_FORCEINLINE void __disable_irq(void)
+{
+    simCorePrimask = 1U;
+}
+
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void)
+{
+    return simCorePrimask;
+}
+
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t priMask)
+{
+    simCorePrimask = priMask;
+}
+
+__STATIC_FORCEINLINE uint32_t __get_BASEPRI(void)
+{
+    return simCoreBasepri;
+}
+
+__STATIC_FORCEINLINE void __set_BASEPRI(uint32_t basePri)
+{
+    simCoreBasepri = basePri;
+}
+
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void)
+{
+    return 0U;
+}
+
+__STATIC_FORCEINLINE uint32_t __get_FPSCR(void)
+{
+    return 0U;
+}
+
+__STATIC_FORCEINLINE void __set_FPSCR(uint32_t fpscr)
+{
+    (void)fpscr;
+}
+
+#include_next <core_cm4.h>
+
+#endif /* SIM_CORE_CM4_H */
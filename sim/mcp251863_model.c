@@ -0,0 +1,1174 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  MCP251863 Software Model Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mcp251863_model.c
+
+  Summary:
+    Register level model of the MCP251863 CAN FD controller for the Linux
+    host simulation.
+
+  Description:
+    See mcp251863_model.h. Register addresses and bit positions are taken
+    from the MCP251863 datasheet, not from the driver headers, so a mismatch
+    between the driver and the device shows up in the simulation.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "sim_time.h"
+#include "mcp251863_model.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* SPI instructions */
+#define SIM_MCP_INS_RESET       0x0U
+#define SIM_MCP_INS_WRITE       0x2U
+#define SIM_MCP_INS_READ        0x3U
+#define SIM_MCP_INS_WRITE_CRC   0xAU
+#define SIM_MCP_INS_READ_CRC    0xBU
+#define SIM_MCP_INS_WRITE_SAFE  0xCU
+
+/* Address map */
+#define SIM_MCP_SFR_SIZE        0x300U
+#define SIM_MCP_RAM_START       0x400U
+#define SIM_MCP_RAM_SIZE        2048U
+#define SIM_MCP_DEV_START       0xE00U
+#define SIM_MCP_DEV_SIZE        0x18U
+
+/* CAN FD controller SFRs */
+#define SIM_MCP_CiCON           0x000U
+#define SIM_MCP_CiNBTCFG        0x004U
+#define SIM_MCP_CiDBTCFG        0x008U
+#define SIM_MCP_CiTBC           0x010U
+#define SIM_MCP_CiTSCON         0x014U
+#define SIM_MCP_CiVEC           0x018U
+#define SIM_MCP_CiINT           0x01CU
+#define SIM_MCP_CiRXIF          0x020U
+#define SIM_MCP_CiTXIF          0x024U
+#define SIM_MCP_CiRXOVIF        0x028U
+#define SIM_MCP_CiTXATIF        0x02CU
+#define SIM_MCP_CiTXREQ         0x030U
+#define SIM_MCP_CiTREC          0x034U
+#define SIM_MCP_CiTEFCON        0x040U
+#define SIM_MCP_CiTEFSTA        0x044U
+#define SIM_MCP_CiTEFUA         0x048U
+#define SIM_MCP_CiFIFOBA        0x04CU
+#define SIM_MCP_CiFIFOCON0      0x050U  /* TXQ, then FIFO 1-31 every 12 bytes */
+#define SIM_MCP_CiFLTCON        0x1D0U
+#define SIM_MCP_CiFLTOBJ0       0x1F0U  /* CiFLTOBJm, CiMASKm pairs */
+
+/* MCP251863 specific registers */
+#define SIM_MCP_OSC             0xE00U
+#define SIM_MCP_IOCON           0xE04U
+#define SIM_MCP_CRC             0xE08U
+#define SIM_MCP_ECCCON          0xE0CU
+#define SIM_MCP_ECCSTAT         0xE10U
+#define SIM_MCP_DEVIDREG        0xE14U
+
+#define SIM_MCP_FIFO_NUM        32U     /* TXQ and FIFO 1-31 */
+#define SIM_MCP_FILTER_NUM      32U
+
+/* CiCON */
+#define SIM_MCP_CON_STEF        (1UL << 19)
+#define SIM_MCP_CON_TXQEN       (1UL << 20)
+#define SIM_MCP_CON_OPMOD_POS   21U
+#define SIM_MCP_CON_REQOP_POS   24U
+#define SIM_MCP_CON_ABAT        (1UL << 27)
+
+/* CiFIFOCONm */
+#define SIM_MCP_FIFO_IE_MASK    0x1FUL
+#define SIM_MCP_FIFO_RXTSEN     (1UL << 5)
+#define SIM_MCP_FIFO_TXEN       (1UL << 7)
+#define SIM_MCP_FIFO_UINC       (1UL << 8)
+#define SIM_MCP_FIFO_TXREQ      (1UL << 9)
+#define SIM_MCP_FIFO_FRESET     (1UL << 10)
+#define SIM_MCP_FIFO_TXPRI(con) (((con) >> 16) & 0x1FU)
+#define SIM_MCP_FIFO_FSIZE(con) (((con) >> 24) & 0x1FU)
+#define SIM_MCP_FIFO_PLSIZE(con) (((con) >> 29) & 0x7U)
+
+/* CiFIFOSTAm flags */
+#define SIM_MCP_STA_RXOVIF      (1UL << 3)
+#define SIM_MCP_STA_TXATIF      (1UL << 4)
+
+/* CiINT flags */
+#define SIM_MCP_INT_TXIF        (1UL << 0)
+#define SIM_MCP_INT_RXIF        (1UL << 1)
+#define SIM_MCP_INT_MODIF       (1UL << 3)
+#define SIM_MCP_INT_SPICRCIF    (1UL << 9)
+#define SIM_MCP_INT_TXATIF      (1UL << 10)
+#define SIM_MCP_INT_RXOVIF      (1UL << 11)
+
+/* CRC register */
+#define SIM_MCP_CRC_CRCERRIF    (1UL << 16)
+#define SIM_MCP_CRC_FERRIF      (1UL << 17)
+
+/* OSC register */
+#define SIM_MCP_OSC_PLLEN       (1UL << 0)
+#define SIM_MCP_OSC_PLLRDY      (1UL << 8)
+#define SIM_MCP_OSC_OSCRDY      (1UL << 10)
+#define SIM_MCP_OSC_SCLKRDY     (1UL << 12)
+
+/* Operation modes */
+#define SIM_MCP_MODE_NORMAL     0U
+#define SIM_MCP_MODE_SLEEP      1U
+#define SIM_MCP_MODE_INT_LOOP   2U
+#define SIM_MCP_MODE_LISTEN     3U
+#define SIM_MCP_MODE_CONFIG     4U
+#define SIM_MCP_MODE_EXT_LOOP   5U
+#define SIM_MCP_MODE_CLASSIC    6U
+#define SIM_MCP_MODE_RESTRICTED 7U
+
+#define SIM_MCP_CODE_NONE       0x40U   /* CiVEC code when nothing is pending */
+#define SIM_MCP_RAM_FILL        0xA5U
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct SIM_MCP_Fifo_T
+{
+    uint16_t    base;                   /* RAM offset of object 0 */
+    uint8_t     objSize;
+    uint8_t     size;                   /* Objects, 0 for a disabled TXQ */
+    uint8_t     head;                   /* Next object written */
+    uint8_t     tail;                   /* Next object read or sent */
+    uint8_t     count;
+    bool        txReq;
+    bool        rxOv;
+} SIM_MCP_Fifo_T;
+
+static const uint8_t s_mcpPayload[8] = { 8, 12, 16, 20, 24, 32, 48, 64 };
+static const uint8_t s_mcpFdLen[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64 };
+
+/* Reset values of 0x000-0x04C */
+static const uint32_t s_mcpCtrlReset[20] =
+{
+    0x04980760UL, 0x003E0F0FUL, 0x000E0303UL, 0x00021000UL,
+    0x00000000UL, 0x00000000UL, 0x40400040UL, 0x00000000UL,
+    0x00000000UL, 0x00000000UL, 0x00000000UL, 0x00000000UL,
+    0x00000000UL, 0x00200000UL, 0x00000000UL, 0x00000000UL,
+    0x00000400UL, 0x00000000UL, 0x00000000UL, 0x00000000UL
+};
+#define SIM_MCP_FIFOCON_RESET   0x00600400UL
+
+static uint8_t              s_mcpSfr[SIM_MCP_SFR_SIZE];
+static uint8_t              s_mcpRam[SIM_MCP_RAM_SIZE];
+static uint8_t              s_mcpDev[SIM_MCP_DEV_SIZE];
+static SIM_MCP_Fifo_T       s_mcpFifo[SIM_MCP_FIFO_NUM];
+static uint8_t              s_mcpMode;
+static uint32_t             s_mcpIntSticky;     /* CiINT flags set by events */
+static bool                 s_mcpIntPin;
+static uint8_t              s_mcpFilterHit;
+
+static bool                 s_mcpTxBusy;
+static uint8_t              s_mcpTxFifo;
+static uint32_t             s_mcpTxGen;         /* Invalidates a transmission in flight */
+static SIM_MCP_Frame_T      s_mcpTxFrame;
+static uint64_t             s_mcpBusFree;
+
+static SIM_MCP_TxFunc_T     s_mcpTxFunc;
+static SIM_MCP_IntFunc_T    s_mcpIntFunc;
+static SIM_MCP_Stats_T      s_mcpStats;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t SIM_MCP_Get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void SIM_MCP_Put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t SIM_MCP_FifoCon(uint8_t m)
+{
+    return SIM_MCP_Get32(&s_mcpSfr[SIM_MCP_CiFIFOCON0 + 12U * m]);
+}
+
+static bool SIM_MCP_FifoIsTx(uint8_t m)
+{
+    return (m == 0U) || ((SIM_MCP_FifoCon(m) & SIM_MCP_FIFO_TXEN) != 0U);
+}
+
+static uint8_t SIM_MCP_DlcToLen(uint8_t dlc, bool fdf)
+{
+    dlc &= 0xFU;
+    if (!fdf && (dlc > 8U))
+    {
+        return 8U;
+    }
+    return s_mcpFdLen[dlc];
+}
+
+static uint32_t SIM_MCP_FifoSta(uint8_t m)
+{
+    const SIM_MCP_Fifo_T *p_fifo = &s_mcpFifo[m];
+    uint32_t sta = 0;
+
+    if (p_fifo->size == 0U)
+    {
+        return 0;
+    }
+    if (SIM_MCP_FifoIsTx(m))
+    {
+        sta |= (p_fifo->count < p_fifo->size) ? (1UL << 0) : 0U;
+        sta |= (p_fifo->count <= (p_fifo->size / 2U)) ? (1UL << 1) : 0U;
+        sta |= (p_fifo->count == 0U) ? (1UL << 2) : 0U;
+        sta |= (uint32_t)p_fifo->head << 8;
+    }
+    else
+    {
+        sta |= (p_fifo->count > 0U) ? (1UL << 0) : 0U;
+        sta |= (p_fifo->count >= ((p_fifo->size + 1U) / 2U)) ? (1UL << 1) : 0U;
+        sta |= (p_fifo->count == p_fifo->size) ? (1UL << 2) : 0U;
+        sta |= p_fifo->rxOv ? SIM_MCP_STA_RXOVIF : 0U;
+        sta |= (uint32_t)p_fifo->tail << 8;
+    }
+    return sta;
+}
+
+static uint32_t SIM_MCP_FifoUa(uint8_t m)
+{
+    const SIM_MCP_Fifo_T *p_fifo = &s_mcpFifo[m];
+    uint8_t idx = SIM_MCP_FifoIsTx(m) ? p_fifo->head : p_fifo->tail;
+
+    if ((s_mcpMode == SIM_MCP_MODE_CONFIG) || (p_fifo->size == 0U))
+    {
+        return 0;
+    }
+    return (uint32_t)p_fifo->base + (uint32_t)idx * p_fifo->objSize;
+}
+
+/* Pending FIFO interrupts: per FIFO flag AND enable, for RX or TX FIFOs. */
+static uint32_t SIM_MCP_FifoIntMask(bool tx)
+{
+    uint32_t mask = 0;
+    uint8_t m;
+
+    for (m = 0; m < SIM_MCP_FIFO_NUM; m++)
+    {
+        if ((s_mcpFifo[m].size != 0U) && (SIM_MCP_FifoIsTx(m) == tx)
+            && ((SIM_MCP_FifoSta(m) & SIM_MCP_FifoCon(m) & 0x7U) != 0U))
+        {
+            mask |= 1UL << m;
+        }
+    }
+    return mask;
+}
+
+static uint32_t SIM_MCP_RxOvMask(void)
+{
+    uint32_t mask = 0;
+    uint8_t m;
+
+    for (m = 1; m < SIM_MCP_FIFO_NUM; m++)
+    {
+        if (s_mcpFifo[m].rxOv)
+        {
+            mask |= 1UL << m;
+        }
+    }
+    return mask;
+}
+
+static uint32_t SIM_MCP_IntFlags(void)
+{
+    uint32_t flags = s_mcpIntSticky;
+
+    flags |= (SIM_MCP_FifoIntMask(true) != 0U) ? SIM_MCP_INT_TXIF : 0U;
+    flags |= (SIM_MCP_FifoIntMask(false) != 0U) ? SIM_MCP_INT_RXIF : 0U;
+    flags |= (SIM_MCP_RxOvMask() != 0U) ? SIM_MCP_INT_RXOVIF : 0U;
+    flags |= ((SIM_MCP_Get32(&s_mcpDev[SIM_MCP_CRC - SIM_MCP_DEV_START])
+               & (SIM_MCP_CRC_CRCERRIF | SIM_MCP_CRC_FERRIF)) != 0U) ? SIM_MCP_INT_SPICRCIF : 0U;
+    return flags;
+}
+
+static uint8_t SIM_MCP_LowestBit(uint32_t mask)
+{
+    return (mask == 0U) ? SIM_MCP_CODE_NONE : (uint8_t)__builtin_ctz(mask);
+}
+
+static uint32_t SIM_MCP_Tbc(void)
+{
+    uint32_t tscon = SIM_MCP_Get32(&s_mcpSfr[SIM_MCP_CiTSCON]);
+    uint64_t ticks;
+
+    if ((tscon & (1UL << 16)) == 0U)
+    {
+        return 0;
+    }
+    ticks = (SIM_TIME_Now() * (SIM_MCP_SYSCLK_HZ / 1000000UL)) / 1000ULL;
+    return (uint32_t)(ticks / ((tscon & 0x3FFU) + 1U));
+}
+
+static uint32_t SIM_MCP_SfrRead(uint16_t a)
+{
+    uint32_t v = SIM_MCP_Get32(&s_mcpSfr[a]);
+    uint32_t rxMask;
+    uint32_t txMask;
+    uint8_t m;
+
+    if ((a >= SIM_MCP_CiFIFOCON0) && (a < SIM_MCP_CiFLTCON))
+    {
+        m = (uint8_t)((a - SIM_MCP_CiFIFOCON0) / 12U);
+        switch ((a - SIM_MCP_CiFIFOCON0) % 12U)
+        {
+            case 0:
+                v &= ~(SIM_MCP_FIFO_UINC | SIM_MCP_FIFO_TXREQ | SIM_MCP_FIFO_FRESET);
+                v |= s_mcpFifo[m].txReq ? SIM_MCP_FIFO_TXREQ : 0U;
+                v |= (m == 0U) ? SIM_MCP_FIFO_TXEN : 0U;
+                return v;
+            case 4:
+                return SIM_MCP_FifoSta(m);
+            default:
+                return SIM_MCP_FifoUa(m);
+        }
+    }
+
+    switch (a)
+    {
+        case SIM_MCP_CiCON:
+            v &= ~(7UL << SIM_MCP_CON_OPMOD_POS);
+            return v | ((uint32_t)s_mcpMode << SIM_MCP_CON_OPMOD_POS);
+        case SIM_MCP_CiTBC:
+            return SIM_MCP_Tbc();
+        case SIM_MCP_CiVEC:
+            rxMask = SIM_MCP_FifoIntMask(false);
+            txMask = SIM_MCP_FifoIntMask(true);
+            return (uint32_t)SIM_MCP_LowestBit(rxMask | txMask) | ((uint32_t)s_mcpFilterHit << 8)
+                   | ((uint32_t)SIM_MCP_LowestBit(txMask) << 16) | ((uint32_t)SIM_MCP_LowestBit(rxMask) << 24);
+        case SIM_MCP_CiINT:
+            return (v & 0xFFFF0000UL) | SIM_MCP_IntFlags();
+        case SIM_MCP_CiRXIF:
+            return SIM_MCP_FifoIntMask(false);
+        case SIM_MCP_CiTXIF:
+            return SIM_MCP_FifoIntMask(true);
+        case SIM_MCP_CiRXOVIF:
+            return SIM_MCP_RxOvMask();
+        case SIM_MCP_CiTXATIF:
+        case SIM_MCP_CiTEFSTA:
+        case SIM_MCP_CiTEFUA:
+            return 0;
+        case SIM_MCP_CiTXREQ:
+            v = 0;
+            for (m = 0; m < SIM_MCP_FIFO_NUM; m++)
+            {
+                v |= s_mcpFifo[m].txReq ? (1UL << m) : 0U;
+            }
+            return v;
+        case SIM_MCP_CiFIFOBA:
+            return SIM_MCP_RAM_START;
+        default:
+            return v;
+    }
+}
+
+static uint8_t SIM_MCP_ReadByte(uint16_t addr)
+{
+    uint32_t v;
+
+    if (addr < SIM_MCP_SFR_SIZE)
+    {
+        return (uint8_t)(SIM_MCP_SfrRead(addr & ~3U) >> (8U * (addr & 3U)));
+    }
+    if ((addr >= SIM_MCP_RAM_START) && (addr < (SIM_MCP_RAM_START + SIM_MCP_RAM_SIZE)))
+    {
+        return s_mcpRam[addr - SIM_MCP_RAM_START];
+    }
+    if ((addr >= SIM_MCP_DEV_START) && (addr < (SIM_MCP_DEV_START + SIM_MCP_DEV_SIZE)))
+    {
+        v = SIM_MCP_Get32(&s_mcpDev[(addr & ~3U) - SIM_MCP_DEV_START]);
+        if ((addr & ~3U) == SIM_MCP_OSC)
+        {
+            v |= SIM_MCP_OSC_OSCRDY | SIM_MCP_OSC_SCLKRDY | ((v & SIM_MCP_OSC_PLLEN) ? SIM_MCP_OSC_PLLRDY : 0U);
+        }
+        return (uint8_t)(v >> (8U * (addr & 3U)));
+    }
+    return 0;
+}
+
+/* Lays out the TEF, the TXQ and the FIFOs in RAM and empties them. */
+static void SIM_MCP_Layout(void)
+{
+    uint32_t con = SIM_MCP_Get32(&s_mcpSfr[SIM_MCP_CiCON]);
+    uint32_t tefCon = SIM_MCP_Get32(&s_mcpSfr[SIM_MCP_CiTEFCON]);
+    uint32_t fifoCon;
+    uint32_t offset = 0;
+    SIM_MCP_Fifo_T *p_fifo;
+    uint8_t m;
+
+    if (con & SIM_MCP_CON_STEF)
+    {
+        offset += (SIM_MCP_FIFO_FSIZE(tefCon) + 1U) * ((tefCon & SIM_MCP_FIFO_RXTSEN) ? 12U : 8U);
+    }
+
+    for (m = 0; m < SIM_MCP_FIFO_NUM; m++)
+    {
+        p_fifo = &s_mcpFifo[m];
+        fifoCon = SIM_MCP_FifoCon(m);
+        memset(p_fifo, 0, sizeof(*p_fifo));
+        if ((m == 0U) && !(con & SIM_MCP_CON_TXQEN))
+        {
+            continue;
+        }
+        p_fifo->base = (uint16_t)offset;
+        p_fifo->size = (uint8_t)(SIM_MCP_FIFO_FSIZE(fifoCon) + 1U);
+        p_fifo->objSize = 8U + s_mcpPayload[SIM_MCP_FIFO_PLSIZE(fifoCon)];
+        if (!SIM_MCP_FifoIsTx(m) && (fifoCon & SIM_MCP_FIFO_RXTSEN))
+        {
+            p_fifo->objSize += 4U;
+        }
+        offset += (uint32_t)p_fifo->size * p_fifo->objSize;
+    }
+
+    if (offset > SIM_MCP_RAM_SIZE)
+    {
+        s_mcpStats.cfgErrors++;
+    }
+    s_mcpTxBusy = false;
+    s_mcpTxGen++;
+}
+
+static void SIM_MCP_ModeRequest(uint8_t mode)
+{
+    if (mode == s_mcpMode)
+    {
+        return;
+    }
+    if (s_mcpMode == SIM_MCP_MODE_CONFIG)
+    {
+        SIM_MCP_Layout();
+        SIM_MCP_Put32(&s_mcpSfr[SIM_MCP_CiTREC], 0);
+    }
+    else if (mode == SIM_MCP_MODE_CONFIG)
+    {
+        s_mcpTxBusy = false;
+        s_mcpTxGen++;
+    }
+    s_mcpMode = mode;
+    s_mcpIntSticky |= SIM_MCP_INT_MODIF;
+}
+
+static void SIM_MCP_FifoControl(uint8_t m, uint8_t ctrl)
+{
+    SIM_MCP_Fifo_T *p_fifo = &s_mcpFifo[m];
+
+    if ((s_mcpMode == SIM_MCP_MODE_CONFIG) || (p_fifo->size == 0U))
+    {
+        return;
+    }
+
+    if (ctrl & (SIM_MCP_FIFO_FRESET >> 8))
+    {
+        p_fifo->head = 0;
+        p_fifo->tail = 0;
+        p_fifo->count = 0;
+        p_fifo->txReq = false;
+        p_fifo->rxOv = false;
+        if (s_mcpTxBusy && (s_mcpTxFifo == m))
+        {
+            s_mcpTxBusy = false;
+            s_mcpTxGen++;
+        }
+    }
+
+    if (ctrl & (SIM_MCP_FIFO_UINC >> 8))
+    {
+        if (SIM_MCP_FifoIsTx(m))
+        {
+            if (p_fifo->count < p_fifo->size)
+            {
+                p_fifo->head = (uint8_t)((p_fifo->head + 1U) % p_fifo->size);
+                p_fifo->count++;
+            }
+            else
+            {
+                s_mcpStats.spiErrors++;
+            }
+        }
+        else
+        {
+            if (p_fifo->count > 0U)
+            {
+                p_fifo->tail = (uint8_t)((p_fifo->tail + 1U) % p_fifo->size);
+                p_fifo->count--;
+            }
+            else
+            {
+                s_mcpStats.spiErrors++;
+            }
+        }
+    }
+
+    if ((ctrl & (SIM_MCP_FIFO_TXREQ >> 8)) && SIM_MCP_FifoIsTx(m) && (p_fifo->count > 0U))
+    {
+        p_fifo->txReq = true;
+    }
+}
+
+static void SIM_MCP_SfrWriteByte(uint16_t addr, uint8_t value)
+{
+    uint16_t a = addr & ~3U;
+    uint8_t b = addr & 3U;
+    uint8_t m;
+
+    if ((a >= SIM_MCP_CiFIFOCON0) && (a < SIM_MCP_CiFLTCON))
+    {
+        m = (uint8_t)((a - SIM_MCP_CiFIFOCON0) / 12U);
+        switch ((a - SIM_MCP_CiFIFOCON0) % 12U)
+        {
+            case 0:
+                if (b == 1U)
+                {
+                    SIM_MCP_FifoControl(m, value);
+                }
+                else
+                {
+                    s_mcpSfr[addr] = value;
+                }
+                break;
+            case 4:
+                /* RXOVIF and TXATIF are cleared by writing 0. */
+                if ((b == 0U) && !(value & SIM_MCP_STA_RXOVIF))
+                {
+                    s_mcpFifo[m].rxOv = false;
+                }
+                break;
+            default:
+                break;
+        }
+        return;
+    }
+
+    switch (a)
+    {
+        case SIM_MCP_CiCON:
+            if (b == 2U)
+            {
+                /* OPMOD is read only. */
+                s_mcpSfr[addr] = (s_mcpSfr[addr] & 0xE0U) | (value & 0x1FU);
+            }
+            else if (b == 3U)
+            {
+                s_mcpSfr[addr] = value & ~(uint8_t)(SIM_MCP_CON_ABAT >> 24);
+                if (value & (SIM_MCP_CON_ABAT >> 24))
+                {
+                    for (m = 0; m < SIM_MCP_FIFO_NUM; m++)
+                    {
+                        s_mcpFifo[m].txReq = false;
+                    }
+                }
+                SIM_MCP_ModeRequest(value & 0x7U);
+            }
+            else
+            {
+                s_mcpSfr[addr] = value;
+            }
+            break;
+
+        case SIM_MCP_CiINT:
+            if (b < 2U)
+            {
+                /* Flags set by events are cleared by writing 0. */
+                s_mcpIntSticky &= ~((uint32_t)(uint8_t)~value << (8U * b));
+            }
+            else
+            {
+                s_mcpSfr[addr] = value;
+            }
+            break;
+
+        case SIM_MCP_CiTXREQ:
+            for (m = 0; m < 8U; m++)
+            {
+                if (value & (1U << m))
+                {
+                    SIM_MCP_FifoControl((uint8_t)(8U * b + m), (uint8_t)(SIM_MCP_FIFO_TXREQ >> 8));
+                }
+            }
+            break;
+
+        case SIM_MCP_CiTBC:
+        case SIM_MCP_CiVEC:
+        case SIM_MCP_CiRXIF:
+        case SIM_MCP_CiTXIF:
+        case SIM_MCP_CiRXOVIF:
+        case SIM_MCP_CiTXATIF:
+        case SIM_MCP_CiTREC:
+        case SIM_MCP_CiTEFSTA:
+        case SIM_MCP_CiTEFUA:
+        case SIM_MCP_CiFIFOBA:
+            break;
+
+        default:
+            s_mcpSfr[addr] = value;
+            break;
+    }
+}
+
+static void SIM_MCP_WriteByte(uint16_t addr, uint8_t value)
+{
+    if (addr < SIM_MCP_SFR_SIZE)
+    {
+        SIM_MCP_SfrWriteByte(addr, value);
+    }
+    else if ((addr >= SIM_MCP_DEV_START) && (addr < SIM_MCP_DEVIDREG))
+    {
+        if (((addr & ~3U) == SIM_MCP_CRC) && ((addr & 3U) == 2U))
+        {
+            /* CRCERRIF and FERRIF are cleared by writing 0. */
+            s_mcpDev[addr - SIM_MCP_DEV_START] &= value | 0xFCU;
+        }
+        else if ((addr & ~3U) != SIM_MCP_CRC)
+        {
+            s_mcpDev[addr - SIM_MCP_DEV_START] = value;
+        }
+    }
+}
+
+static void SIM_MCP_Read(uint16_t addr, uint8_t *p_data, uint16_t n)
+{
+    uint16_t i;
+
+    if ((addr >= SIM_MCP_RAM_START) && (addr < (SIM_MCP_RAM_START + SIM_MCP_RAM_SIZE)) && (addr & 3U))
+    {
+        s_mcpStats.spiErrors++;
+    }
+    for (i = 0; i < n; i++)
+    {
+        p_data[i] = SIM_MCP_ReadByte((uint16_t)((addr + i) & 0xFFFU));
+    }
+}
+
+static void SIM_MCP_Write(uint16_t addr, const uint8_t *p_data, uint16_t n)
+{
+    uint16_t i;
+    uint16_t ramOfs;
+
+    if ((addr >= SIM_MCP_RAM_START) && (addr < (SIM_MCP_RAM_START + SIM_MCP_RAM_SIZE)))
+    {
+        /* RAM takes whole, aligned words. A partial word is not written. */
+        if ((addr & 3U) || (n & 3U))
+        {
+            s_mcpStats.spiErrors++;
+        }
+        ramOfs = addr - SIM_MCP_RAM_START;
+        for (i = 0; (i + 4U) <= n; i += 4U)
+        {
+            if ((ramOfs + i + 4U) <= SIM_MCP_RAM_SIZE)
+            {
+                memcpy(&s_mcpRam[ramOfs + i], &p_data[i], 4);
+            }
+        }
+        return;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        SIM_MCP_WriteByte((uint16_t)((addr + i) & 0xFFFU), p_data[i]);
+    }
+}
+
+/* CRC-16 of the SPI CRC instructions: polynomial 0x8005, seed 0xFFFF. */
+static uint16_t SIM_MCP_Crc16(const uint8_t *p_data, uint16_t n)
+{
+    uint16_t crc = 0xFFFFU;
+    uint8_t bit;
+
+    while (n-- != 0U)
+    {
+        crc ^= (uint16_t)(*p_data++) << 8;
+        for (bit = 0; bit < 8U; bit++)
+        {
+            crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ 0x8005U) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void SIM_MCP_CrcError(void)
+{
+    s_mcpDev[SIM_MCP_CRC - SIM_MCP_DEV_START + 2U] |= (uint8_t)(SIM_MCP_CRC_CRCERRIF >> 16);
+    s_mcpStats.spiErrors++;
+}
+
+static void SIM_MCP_Reset(void)
+{
+    uint8_t m;
+
+    memset(s_mcpSfr, 0, sizeof(s_mcpSfr));
+    for (m = 0; m < (sizeof(s_mcpCtrlReset) / sizeof(s_mcpCtrlReset[0])); m++)
+    {
+        SIM_MCP_Put32(&s_mcpSfr[4U * m], s_mcpCtrlReset[m]);
+    }
+    for (m = 0; m < SIM_MCP_FIFO_NUM; m++)
+    {
+        SIM_MCP_Put32(&s_mcpSfr[SIM_MCP_CiFIFOCON0 + 12U * m], SIM_MCP_FIFOCON_RESET);
+    }
+    memset(s_mcpFifo, 0, sizeof(s_mcpFifo));
+
+    memset(s_mcpDev, 0, sizeof(s_mcpDev));
+    SIM_MCP_Put32(&s_mcpDev[SIM_MCP_OSC - SIM_MCP_DEV_START], 0x00000460UL);
+    SIM_MCP_Put32(&s_mcpDev[SIM_MCP_IOCON - SIM_MCP_DEV_START], 0x00000003UL);
+    SIM_MCP_Put32(&s_mcpDev[SIM_MCP_DEVIDREG - SIM_MCP_DEV_START], SIM_MCP_DEVID);
+
+    s_mcpMode = SIM_MCP_MODE_CONFIG;
+    s_mcpIntSticky = 0;
+    s_mcpFilterHit = 0;
+    s_mcpTxBusy = false;
+    s_mcpTxGen++;
+}
+
+static void SIM_MCP_ReadFrame(const SIM_MCP_Fifo_T *p_fifo, SIM_MCP_Frame_T *p_frame)
+{
+    const uint8_t *p_obj = &s_mcpRam[p_fifo->base + (uint16_t)p_fifo->tail * p_fifo->objSize];
+    uint32_t id = SIM_MCP_Get32(&p_obj[0]);
+    uint32_t ctrl = SIM_MCP_Get32(&p_obj[4]);
+    uint8_t len;
+    uint8_t maxLen = p_fifo->objSize - 8U;
+
+    memset(p_frame, 0, sizeof(*p_frame));
+    p_frame->dlc = (uint8_t)(ctrl & 0xFU);
+    p_frame->ide = (ctrl & (1UL << 4)) != 0U;
+    p_frame->rtr = (ctrl & (1UL << 5)) != 0U;
+    p_frame->brs = (ctrl & (1UL << 6)) != 0U;
+    p_frame->fdf = (ctrl & (1UL << 7)) != 0U;
+    p_frame->id = p_frame->ide ? (((id & 0x7FFU) << 18) | ((id >> 11) & 0x3FFFFU)) : (id & 0x7FFU);
+
+    len = SIM_MCP_DlcToLen(p_frame->dlc, p_frame->fdf);
+    memcpy(p_frame->data, &p_obj[8], (len < maxLen) ? len : maxLen);
+}
+
+/* Acceptance filtering. Returns the FIFO of the first matching filter, or 0. */
+static uint8_t SIM_MCP_Filter(const SIM_MCP_Frame_T *p_frame, uint8_t *p_hit)
+{
+    uint32_t sid = p_frame->ide ? (p_frame->id >> 18) : p_frame->id;
+    uint32_t eid = p_frame->ide ? (p_frame->id & 0x3FFFFU) : 0U;
+    uint32_t obj;
+    uint32_t mask;
+    uint8_t con;
+    uint8_t n;
+
+    for (n = 0; n < SIM_MCP_FILTER_NUM; n++)
+    {
+        con = s_mcpSfr[SIM_MCP_CiFLTCON + n];
+        if (!(con & 0x80U))
+        {
+            continue;
+        }
+        obj = SIM_MCP_Get32(&s_mcpSfr[SIM_MCP_CiFLTOBJ0 + 8U * n]);
+        mask = SIM_MCP_Get32(&s_mcpSfr[SIM_MCP_CiFLTOBJ0 + 8U * n + 4U]);
+
+        /* MIDE: only frames of the type selected by EXIDE match. */
+        if ((mask & (1UL << 30)) && (((obj >> 30) & 1U) != (p_frame->ide ? 1U : 0U)))
+        {
+            continue;
+        }
+        if (((sid ^ obj) & mask & 0x7FFU) != 0U)
+        {
+            continue;
+        }
+        if (p_frame->ide && ((((eid << 11) ^ obj) & mask & (0x3FFFFUL << 11)) != 0U))
+        {
+            continue;
+        }
+        *p_hit = n;
+        return con & 0x1FU;
+    }
+    return 0;
+}
+
+static bool SIM_MCP_Store(const SIM_MCP_Frame_T *p_frame)
+{
+    SIM_MCP_Fifo_T *p_fifo;
+    uint8_t *p_obj;
+    uint8_t hit = 0;
+    uint8_t m = SIM_MCP_Filter(p_frame, &hit);
+    uint8_t ofs = 8;
+    uint8_t len;
+    uint8_t maxLen;
+    uint32_t sid = p_frame->ide ? (p_frame->id >> 18) : p_frame->id;
+    uint32_t eid = p_frame->ide ? (p_frame->id & 0x3FFFFU) : 0U;
+
+    if ((m == 0U) || SIM_MCP_FifoIsTx(m) || (s_mcpFifo[m].size == 0U))
+    {
+        s_mcpStats.rxFiltered++;
+        return false;
+    }
+
+    p_fifo = &s_mcpFifo[m];
+    if (p_fifo->count == p_fifo->size)
+    {
+        p_fifo->rxOv = true;
+        s_mcpStats.rxOverflows++;
+        return false;
+    }
+
+    p_obj = &s_mcpRam[p_fifo->base + (uint16_t)p_fifo->head * p_fifo->objSize];
+    SIM_MCP_Put32(&p_obj[0], (sid & 0x7FFU) | (eid << 11));
+    SIM_MCP_Put32(&p_obj[4], (uint32_t)(p_frame->dlc & 0xFU) | (p_frame->ide ? (1UL << 4) : 0U)
+                  | (p_frame->rtr ? (1UL << 5) : 0U) | (p_frame->brs ? (1UL << 6) : 0U)
+                  | (p_frame->fdf ? (1UL << 7) : 0U) | ((uint32_t)hit << 11));
+    if (SIM_MCP_FifoCon(m) & SIM_MCP_FIFO_RXTSEN)
+    {
+        SIM_MCP_Put32(&p_obj[8], SIM_MCP_Tbc());
+        ofs = 12;
+    }
+    len = p_frame->rtr ? 0U : SIM_MCP_DlcToLen(p_frame->dlc, p_frame->fdf);
+    maxLen = p_fifo->objSize - ofs;
+    memcpy(&p_obj[ofs], p_frame->data, (len < maxLen) ? len : maxLen);
+
+    p_fifo->head = (uint8_t)((p_fifo->head + 1U) % p_fifo->size);
+    p_fifo->count++;
+    s_mcpFilterHit = hit;
+    s_mcpStats.rxFrames++;
+    return true;
+}
+
+static void SIM_MCP_Update(void);
+
+static void SIM_MCP_TxDone(void *p_arg)
+{
+    SIM_MCP_Fifo_T *p_fifo = &s_mcpFifo[s_mcpTxFifo];
+
+    if ((uint32_t)(uintptr_t)p_arg != s_mcpTxGen)
+    {
+        return;
+    }
+    s_mcpTxBusy = false;
+
+    p_fifo->tail = (uint8_t)((p_fifo->tail + 1U) % p_fifo->size);
+    p_fifo->count--;
+    if (p_fifo->count == 0U)
+    {
+        p_fifo->txReq = false;
+    }
+    s_mcpStats.txFrames++;
+
+    if ((s_mcpMode == SIM_MCP_MODE_INT_LOOP) || (s_mcpMode == SIM_MCP_MODE_EXT_LOOP))
+    {
+        (void)SIM_MCP_Store(&s_mcpTxFrame);
+    }
+    if ((s_mcpMode != SIM_MCP_MODE_INT_LOOP) && (s_mcpTxFunc != NULL))
+    {
+        s_mcpTxFunc(&s_mcpTxFrame);
+    }
+    SIM_MCP_Update();
+}
+
+/* Starts the next transmission: the highest TXPRI with a pending request,
+   the lowest FIFO number among equals. */
+static void SIM_MCP_TxStart(void)
+{
+    uint64_t start;
+    uint8_t best = SIM_MCP_FIFO_NUM;
+    uint8_t m;
+
+    if (s_mcpTxBusy || ((s_mcpMode != SIM_MCP_MODE_NORMAL) && (s_mcpMode != SIM_MCP_MODE_INT_LOOP)
+                        && (s_mcpMode != SIM_MCP_MODE_EXT_LOOP) && (s_mcpMode != SIM_MCP_MODE_CLASSIC)))
+    {
+        return;
+    }
+
+    for (m = 0; m < SIM_MCP_FIFO_NUM; m++)
+    {
+        if (s_mcpFifo[m].txReq && (s_mcpFifo[m].count > 0U)
+            && ((best == SIM_MCP_FIFO_NUM)
+                || (SIM_MCP_FIFO_TXPRI(SIM_MCP_FifoCon(m)) > SIM_MCP_FIFO_TXPRI(SIM_MCP_FifoCon(best)))))
+        {
+            best = m;
+        }
+    }
+    if (best == SIM_MCP_FIFO_NUM)
+    {
+        return;
+    }
+
+    SIM_MCP_ReadFrame(&s_mcpFifo[best], &s_mcpTxFrame);
+    start = (s_mcpBusFree > SIM_TIME_Now()) ? s_mcpBusFree : SIM_TIME_Now();
+    s_mcpBusFree = start + SIM_MCP_FrameTimeNs(&s_mcpTxFrame);
+    s_mcpTxBusy = true;
+    s_mcpTxFifo = best;
+    (void)SIM_TIME_EventAdd(s_mcpBusFree, SIM_MCP_TxDone, (void *)(uintptr_t)s_mcpTxGen);
+}
+
+static void SIM_MCP_Update(void)
+{
+    uint32_t ie = SIM_MCP_Get32(&s_mcpSfr[SIM_MCP_CiINT]) >> 16;
+    bool pin;
+
+    SIM_MCP_TxStart();
+
+    pin = (SIM_MCP_IntFlags() & ie) != 0U;
+    if (pin && !s_mcpIntPin)
+    {
+        s_mcpIntPin = true;
+        s_mcpStats.intEdges++;
+        if (s_mcpIntFunc != NULL)
+        {
+            s_mcpIntFunc();
+        }
+    }
+    s_mcpIntPin = pin;
+}
+
+static void SIM_MCP_BitsPush(uint8_t *p_bits, uint16_t *p_n, uint32_t value, uint8_t width)
+{
+    while (width-- != 0U)
+    {
+        p_bits[(*p_n)++] = (uint8_t)((value >> width) & 1U);
+    }
+}
+
+static uint32_t SIM_MCP_BitNs(uint32_t cfg, bool data)
+{
+    uint32_t brp = (cfg >> 24) + 1U;
+    uint32_t tq = data ? (((cfg >> 16) & 0x1FU) + ((cfg >> 8) & 0xFU) + 3U)
+                       : (((cfg >> 16) & 0xFFU) + ((cfg >> 8) & 0x7FU) + 3U);
+
+    return (uint32_t)((1000000000ULL * brp * tq) / SIM_MCP_SYSCLK_HZ);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SIM_MCP_Init(SIM_MCP_TxFunc_T txFunc, SIM_MCP_IntFunc_T intFunc)
+{
+    s_mcpTxFunc = txFunc;
+    s_mcpIntFunc = intFunc;
+    memset(&s_mcpStats, 0, sizeof(s_mcpStats));
+    memset(s_mcpRam, SIM_MCP_RAM_FILL, sizeof(s_mcpRam));
+    s_mcpBusFree = 0;
+    s_mcpIntPin = false;
+    SIM_MCP_Reset();
+}
+
+void SIM_MCP_SpiTransfer(const uint8_t *p_tx, uint8_t *p_rx, uint16_t len)
+{
+    uint16_t addr;
+    uint16_t n;
+    uint16_t crc;
+
+    memset(p_rx, 0, len);
+    s_mcpStats.spiTransfers++;
+    s_mcpStats.spiBytes += len;
+    if (len < 2U)
+    {
+        s_mcpStats.spiErrors++;
+        return;
+    }
+
+    addr = (uint16_t)(((p_tx[0] & 0xFU) << 8) | p_tx[1]);
+    switch (p_tx[0] >> 4)
+    {
+        case SIM_MCP_INS_RESET:
+            SIM_MCP_Reset();
+            break;
+
+        case SIM_MCP_INS_READ:
+            SIM_MCP_Read(addr, &p_rx[2], len - 2U);
+            break;
+
+        case SIM_MCP_INS_WRITE:
+            SIM_MCP_Write(addr, &p_tx[2], len - 2U);
+            break;
+
+        case SIM_MCP_INS_READ_CRC:
+        case SIM_MCP_INS_WRITE_CRC:
+            /* N counts words for the RAM, bytes for the registers. */
+            n = ((addr >= SIM_MCP_RAM_START) && (addr < (SIM_MCP_RAM_START + SIM_MCP_RAM_SIZE))) ? (uint16_t)(4U * p_tx[2]) : p_tx[2];
+            if ((len < 3U) || (len != (n + 5U)))
+            {
+                s_mcpStats.spiErrors++;
+                break;
+            }
+            if ((p_tx[0] >> 4) == SIM_MCP_INS_READ_CRC)
+            {
+                SIM_MCP_Read(addr, &p_rx[3], n);
+                memcpy(p_rx, p_tx, 3);
+                crc = SIM_MCP_Crc16(p_rx, n + 3U);
+                memset(p_rx, 0, 3);
+                p_rx[n + 3U] = (uint8_t)(crc >> 8);
+                p_rx[n + 4U] = (uint8_t)crc;
+            }
+            else if (SIM_MCP_Crc16(p_tx, n + 3U) == (uint16_t)((p_tx[n + 3U] << 8) | p_tx[n + 4U]))
+            {
+                SIM_MCP_Write(addr, &p_tx[3], n);
+            }
+            else
+            {
+                SIM_MCP_CrcError();
+            }
+            break;
+
+        case SIM_MCP_INS_WRITE_SAFE:
+            n = len - 4U;
+            if ((len < 5U) || (len > 8U))
+            {
+                s_mcpStats.spiErrors++;
+            }
+            else if (SIM_MCP_Crc16(p_tx, n + 2U) == (uint16_t)((p_tx[n + 2U] << 8) | p_tx[n + 3U]))
+            {
+                SIM_MCP_Write(addr, &p_tx[2], n);
+            }
+            else
+            {
+                SIM_MCP_CrcError();
+            }
+            break;
+
+        default:
+            s_mcpStats.spiErrors++;
+            break;
+    }
+
+    SIM_MCP_Update();
+}
+
+bool SIM_MCP_BusReceive(const SIM_MCP_Frame_T *p_frame)
+{
+    bool stored;
+
+    if (SIM_TIME_Now() > s_mcpBusFree)
+    {
+        s_mcpBusFree = SIM_TIME_Now();
+    }
+    if ((s_mcpMode == SIM_MCP_MODE_CONFIG) || (s_mcpMode == SIM_MCP_MODE_SLEEP)
+        || (s_mcpMode == SIM_MCP_MODE_INT_LOOP))
+    {
+        return false;
+    }
+
+    stored = SIM_MCP_Store(p_frame);
+    SIM_MCP_Update();
+    return stored;
+}
+
+uint64_t SIM_MCP_FrameTimeNs(const SIM_MCP_Frame_T *p_frame)
+{
+    uint8_t bits[16 + 29 + 8 * 64 + 32];
+    uint16_t n = 0;
+    uint16_t i;
+    uint16_t crc = 0;
+    uint16_t stuff = 0;
+    uint8_t run = 0;
+    uint8_t last = 2;
+    uint8_t len = p_frame->rtr ? 0U : SIM_MCP_DlcToLen(p_frame->dlc, p_frame->fdf);
+    uint32_t nbt = SIM_MCP_BitNs(SIM_MCP_Get32(&s_mcpSfr[SIM_MCP_CiNBTCFG]), false);
+    uint32_t dbt = SIM_MCP_BitNs(SIM_MCP_Get32(&s_mcpSfr[SIM_MCP_CiDBTCFG]), true);
+    uint32_t arbBits;
+    uint32_t dataBits;
+
+    if (p_frame->fdf)
+    {
+        /* SOF, ID, SRR/RRS, IDE, FDF, res, BRS at the nominal rate, then ESI,
+           DLC, data, stuff count and CRC with its fixed stuff bits. */
+        arbBits = p_frame->ide ? 36U : 17U;
+        dataBits = 1U + 4U + 8U * len + 4U + ((len > 16U) ? (21U + 6U) : (17U + 5U));
+        arbBits += arbBits / 4U;
+        dataBits += (1U + 4U + 8U * len) / 4U;
+        return (uint64_t)(arbBits + 13U) * nbt + (uint64_t)dataBits * (p_frame->brs ? dbt : nbt);
+    }
+
+    SIM_MCP_BitsPush(bits, &n, 0, 1);
+    if (p_frame->ide)
+    {
+        SIM_MCP_BitsPush(bits, &n, p_frame->id >> 18, 11);
+        SIM_MCP_BitsPush(bits, &n, 3, 2);                       /* SRR, IDE */
+        SIM_MCP_BitsPush(bits, &n, p_frame->id & 0x3FFFFU, 18);
+        SIM_MCP_BitsPush(bits, &n, p_frame->rtr ? 1U : 0U, 1);
+        SIM_MCP_BitsPush(bits, &n, 0, 2);                       /* r1, r0 */
+    }
+    else
+    {
+        SIM_MCP_BitsPush(bits, &n, p_frame->id, 11);
+        SIM_MCP_BitsPush(bits, &n, p_frame->rtr ? 1U : 0U, 1);
+        SIM_MCP_BitsPush(bits, &n, 0, 2);                       /* IDE, r0 */
+    }
+    SIM_MCP_BitsPush(bits, &n, p_frame->dlc, 4);
+    for (i = 0; i < len; i++)
+    {
+        SIM_MCP_BitsPush(bits, &n, p_frame->data[i], 8);
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        crc = (uint16_t)((crc << 1) & 0x7FFFU) ^ ((bits[i] ^ (crc >> 14)) ? 0x4599U : 0U);
+    }
+    SIM_MCP_BitsPush(bits, &n, crc, 15);
+
+    for (i = 0; i < n; i++)
+    {
+        run = (bits[i] == last) ? (uint8_t)(run + 1U) : 1U;
+        last = bits[i];
+        if (run == 5U)
+        {
+            stuff++;
+            last ^= 1U;
+            run = 1;
+        }
+    }
+
+    /* CRC delimiter, ACK, ACK delimiter, EOF and intermission are not stuffed. */
+    return (uint64_t)(n + stuff + 13U) * nbt;
+}
+
+bool SIM_MCP_IntAsserted(void)
+{
+    return s_mcpIntPin;
+}
+
+const SIM_MCP_Stats_T *SIM_MCP_StatsGet(void)
+{
+    return &s_mcpStats;
+}
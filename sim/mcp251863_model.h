@@ -0,0 +1,198 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  MCP251863 Software Model Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mcp251863_model.h
+
+  Summary:
+    Register level model of the MCP251863 CAN FD controller for the Linux
+    host simulation.
+
+  Description:
+    The model decodes the SPI instructions of the device (RESET, READ, WRITE,
+    READ_CRC, WRITE_CRC and WRITE_SAFE) and implements:
+      - The CAN FD controller SFRs at 0x000-0x2FF and the OSC, IOCON, CRC,
+        ECCCON, ECCSTAT and DEVID registers at 0xE00-0xE17, with their reset
+        values.
+      - The 2 KB message RAM at 0x400-0xBFF. The TEF, the TXQ and FIFO 1-31
+        are laid out in it in this order when the device leaves
+        configuration mode, with the object sizes of the datasheet.
+      - FIFO pointer semantics: the user address register follows the head
+        of a TX FIFO and the tail of a RX FIFO, UINC, TXREQ and FRESET act
+        on them, and the FIFO status flags and index are derived from the
+        fill level.
+      - Acceptance filters and masks, RX overflow, transmission in priority
+        order with the frame duration of the configured bit rates, and the
+        internal and external loopback modes.
+      - The interrupt flags of CiINT, CiVEC, CiRXIF, CiTXIF, CiRXOVIF and
+        CiTXREQ, and the INT pin. A falling edge of the pin calls the
+        registered interrupt function.
+
+    Not modeled: the TEF contents, transmit attempts and errors, bus
+    arbitration against other nodes, ECC errors, sleep and the GPIO pins.
+    Accesses the device would not handle as expected, unaligned or partial
+    RAM words and CRC mismatches, are counted in spiErrors.
+
+    The bus side is SIM_MCP_BusReceive for frames of other nodes and the
+    TX function for frames the device sends. Times come from sim_time.h.
+*******************************************************************************/
+
+#ifndef SIM_MCP251863_MODEL_H
+#define SIM_MCP251863_MODEL_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_MCP_SYSCLK_HZ       40000000UL  /* 40 MHz oscillator, PLL off */
+#define SIM_MCP_DEVID           0x14U       /* DEV 1 (MCP2518FD die), REV 4 */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct SIM_MCP_Frame_T
+{
+    uint32_t    id;             /* 11 bit standard or 29 bit extended ID */
+    uint8_t     dlc;
+    bool        ide;
+    bool        rtr;
+    bool        fdf;
+    bool        brs;
+    uint8_t     data[64];
+} SIM_MCP_Frame_T;
+
+typedef struct SIM_MCP_Stats_T
+{
+    uint32_t    spiTransfers;
+    uint32_t    spiBytes;
+    uint32_t    spiErrors;      /* Accesses the device would reject or corrupt */
+    uint32_t    cfgErrors;      /* FIFO configurations exceeding the RAM */
+    uint32_t    rxFrames;       /* Stored in a RX FIFO */
+    uint32_t    rxFiltered;     /* No filter matched */
+    uint32_t    rxOverflows;    /* Lost to a full RX FIFO */
+    uint32_t    txFrames;       /* Transmitted, including loopback */
+    uint32_t    intEdges;       /* Falling edges of the INT pin */
+} SIM_MCP_Stats_T;
+
+/* A frame transmitted onto the bus. Called when its EOF completes. */
+typedef void (*SIM_MCP_TxFunc_T)(const SIM_MCP_Frame_T *p_frame);
+
+/* Falling edge of the INT pin. */
+typedef void (*SIM_MCP_IntFunc_T)(void);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void SIM_MCP_Init(SIM_MCP_TxFunc_T txFunc, SIM_MCP_IntFunc_T intFunc)
+
+  Summary:
+    Power-on reset. The message RAM is filled with a pattern, like the
+    undefined contents after power-up. Statistics are cleared.
+*/
+void SIM_MCP_Init(SIM_MCP_TxFunc_T txFunc, SIM_MCP_IntFunc_T intFunc);
+
+/*******************************************************************************
+  Function:
+    void SIM_MCP_SpiTransfer(const uint8_t *p_tx, uint8_t *p_rx, uint16_t len)
+
+  Summary:
+    One SPI transaction, from the falling to the rising edge of nCS.
+*/
+void SIM_MCP_SpiTransfer(const uint8_t *p_tx, uint8_t *p_rx, uint16_t len);
+
+/*******************************************************************************
+  Function:
+    bool SIM_MCP_BusReceive(const SIM_MCP_Frame_T *p_frame)
+
+  Summary:
+    A frame of another node completes on the bus now.
+
+  Description:
+    The frame is ignored in configuration, sleep and internal loopback mode.
+    The bus is busy until now, a transmission of the device starts after it.
+
+  Returns:
+    true  - Stored in a RX FIFO.
+    false - Ignored, filtered out or lost to a full FIFO.
+*/
+bool SIM_MCP_BusReceive(const SIM_MCP_Frame_T *p_frame);
+
+/*******************************************************************************
+  Function:
+    uint64_t SIM_MCP_FrameTimeNs(const SIM_MCP_Frame_T *p_frame)
+
+  Summary:
+    Duration of the frame on the bus at the configured nominal and data bit
+    rates, including stuff bits and the intermission.
+
+  Remarks:
+    Stuff bits are counted exactly for classic frames. CAN FD frames use the
+    fixed stuff bits of the CRC field and a worst case of one stuff bit per
+    four bits before it.
+*/
+uint64_t SIM_MCP_FrameTimeNs(const SIM_MCP_Frame_T *p_frame);
+
+/*******************************************************************************
+  Function:
+    bool SIM_MCP_IntAsserted(void)
+
+  Summary:
+    Returns true while the INT pin is driven low.
+*/
+bool SIM_MCP_IntAsserted(void);
+
+/*******************************************************************************
+  Function:
+    const SIM_MCP_Stats_T *SIM_MCP_StatsGet(void)
+
+  Summary:
+    Returns the counters since SIM_MCP_Init.
+*/
+const SIM_MCP_Stats_T *SIM_MCP_StatsGet(void);
+
+#endif /* SIM_MCP251863_MODEL_H */
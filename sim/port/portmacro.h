@@ -0,0 +1,118 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Host Simulation FreeRTOS Port Header
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    portmacro.h
+
+  Summary:
+    FreeRTOS port definitions for the Linux host simulation.
+
+  Description:
+    Replaces the GCC/SAM/ARM_CM4F port in the include path of the host build.
+    The types match the target port, so the application sees the same
+    TickType_t and BaseType_t widths as on the WBZ451, apart from long.
+
+    There is no scheduler: sim_rtos.c implements the kernel calls the
+    application uses on one host thread. Yields and critical sections are
+    therefore empty.
+*******************************************************************************/
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Type definitions. */
+#define portCHAR                char
+#define portFLOAT               float
+#define portDOUBLE              double
+#define portLONG                long
+#define portSHORT               short
+#define portSTACK_TYPE          uint32_t
+#define portBASE_TYPE           long
+
+typedef portSTACK_TYPE          StackType_t;
+typedef long                    BaseType_t;
+typedef unsigned long           UBaseType_t;
+
+#if ( configUSE_16_BIT_TICKS == 1 )
+typedef uint16_t                TickType_t;
+#define portMAX_DELAY           ( TickType_t ) 0xffff
+#else
+typedef uint32_t                TickType_t;
+#define portMAX_DELAY           ( TickType_t ) 0xffffffffUL
+#define portTICK_TYPE_IS_ATOMIC 1
+#endif
+
+/* Architecture specifics. */
+#define portSTACK_GROWTH        ( -1 )
+#define portTICK_PERIOD_MS      ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portBYTE_ALIGNMENT      8
+#define portDONT_DISCARD        __attribute__( ( used ) )
+
+/* Scheduler utilities. The only task runs again as soon as the "interrupt"
+   returns, a context switch request has nothing to do. */
+#define portYIELD()                                 do { } while( 0 )
+#define portEND_SWITCHING_ISR( xSwitchRequired )    do { ( void ) ( xSwitchRequired ); } while( 0 )
+#define portYIELD_FROM_ISR( x )                     portEND_SWITCHING_ISR( x )
+
+/* Critical section management. */
+#define portSET_INTERRUPT_MASK_FROM_ISR()           0U
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )      ( ( void ) ( x ) )
+#define portDISABLE_INTERRUPTS()                    do { } while( 0 )
+#define portENABLE_INTERRUPTS()                     do { } while( 0 )
+#define portENTER_CRITICAL()                        do { } while( 0 )
+#define portEXIT_CRITICAL()                         do { } while( 0 )
+
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters )    void vFunction( void * pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters )          void vFunction( void * pvParameters )
+
+/* Idle time passes in SIM_TIME_Wait, not in a sleep hook. */
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    ( ( void ) ( xExpectedIdleTime ) )
+
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION    0
+#endif
+
+#define portNOP()
+#define portINLINE              __inline
+
+#ifndef portFORCE_INLINE
+#define portFORCE_INLINE        inline __attribute__( ( always_inline ) )
+#endif
+
+#define portMEMORY_BARRIER()    __asm volatile ( "" ::: "memory" )
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORTMACRO_H */
@@ -0,0 +1,326 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Host Simulation BLE Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sim_ble.c
+
+  Summary:
+    BLE stack and transparent profile stand-ins of the Linux host simulation.
+
+  Description:
+    See sim_ble.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "app.h"
+#include "app_ble.h"
+#include "mba_error_defs.h"
+#ifdef SIM_APP_CENTRAL
+#include "ble_trspc/ble_trspc.h"
+#include "app_trspc_handler.h"
+#else
+#include "ble_trsps/ble_trsps.h"
+#include "app_trsps_handler.h"
+#endif
+#include "sim_time.h"
+#include "sim_ble.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct SIM_BLE_Pdu_T
+{
+    uint16_t    len;
+    uint8_t     data[SIM_BLE_PDU_MAX];
+} SIM_BLE_Pdu_T;
+
+static SIM_BLE_Pdu_T        s_bleRx[SIM_BLE_RX_NUM];
+static uint8_t              s_bleRxHead;        /* Oldest PDU */
+static uint8_t              s_bleRxCount;
+static uint8_t              s_bleRxEvts;        /* Stack events not yet handled */
+static bool                 s_bleConnected;
+static SIM_BLE_SinkFunc_T   s_bleSink;
+static SIM_BLE_Stats_T      s_bleStats;
+
+#ifndef SIM_APP_CENTRAL
+extern uint16_t conn_hdl;
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint16_t SIM_BLE_Send(uint16_t connHandle, const uint8_t *p_data, uint16_t len, bool vendor)
+{
+    SIM_TIME_Spend(SIM_BLE_CALL_NS);
+    if (!s_bleConnected || (connHandle != SIM_BLE_CONN_HANDLE) || (len > SIM_BLE_PDU_MAX))
+    {
+        s_bleStats.txErrors++;
+        return MBA_RES_FAIL;
+    }
+
+    if (vendor)
+    {
+        s_bleStats.txVendorPdus++;
+    }
+    else
+    {
+        s_bleStats.txPdus++;
+        s_bleStats.txBytes += len;
+    }
+    if (s_bleSink != NULL)
+    {
+        s_bleSink(p_data, len, vendor);
+    }
+    return MBA_RES_SUCCESS;
+}
+
+static uint16_t SIM_BLE_Vendor(uint16_t connHandle, uint8_t commandID, uint8_t commandLength, const uint8_t *p_commandPayload)
+{
+    uint8_t pdu[SIM_BLE_PDU_MAX];
+
+    if ((uint16_t)commandLength + 1U > SIM_BLE_PDU_MAX)
+    {
+        s_bleStats.txErrors++;
+        return MBA_RES_FAIL;
+    }
+    pdu[0] = commandID;
+    memcpy(&pdu[1], p_commandPayload, commandLength);
+    return SIM_BLE_Send(connHandle, pdu, (uint16_t)commandLength + 1U, true);
+}
+
+static uint16_t SIM_BLE_Peek(uint16_t connHandle, uint8_t **pp_data, uint16_t *p_dataLength)
+{
+    if ((connHandle != SIM_BLE_CONN_HANDLE) || (s_bleRxCount == 0U))
+    {
+        return MBA_RES_FAIL;
+    }
+    *pp_data = s_bleRx[s_bleRxHead].data;
+    *p_dataLength = s_bleRx[s_bleRxHead].len;
+    return MBA_RES_SUCCESS;
+}
+
+static uint16_t SIM_BLE_Release(uint16_t connHandle)
+{
+    if ((connHandle != SIM_BLE_CONN_HANDLE) || (s_bleRxCount == 0U))
+    {
+        return MBA_RES_FAIL;
+    }
+    s_bleStats.rxPdus++;
+    s_bleStats.rxBytes += s_bleRx[s_bleRxHead].len;
+    s_bleRxHead = (uint8_t)((s_bleRxHead + 1U) % SIM_BLE_RX_NUM);
+    s_bleRxCount--;
+    return MBA_RES_SUCCESS;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SIM_BLE_Init(SIM_BLE_SinkFunc_T sinkFunc)
+{
+    s_bleSink = sinkFunc;
+    s_bleRxHead = 0;
+    s_bleRxCount = 0;
+    s_bleRxEvts = 0;
+    s_bleConnected = false;
+    memset(&s_bleStats, 0, sizeof(s_bleStats));
+}
+
+void SIM_BLE_Connect(void)
+{
+    s_bleConnected = true;
+#ifdef SIM_APP_CENTRAL
+    (void)APP_LinkAdd(SIM_BLE_CONN_HANDLE);
+#else
+    conn_hdl = SIM_BLE_CONN_HANDLE;
+#endif
+}
+
+bool SIM_BLE_Receive(const uint8_t *p_data, uint16_t len)
+{
+    APP_Msg_T appMsg;
+    SIM_BLE_Pdu_T *p_pdu;
+
+    if (!s_bleConnected || (len > SIM_BLE_PDU_MAX) || (s_bleRxCount == SIM_BLE_RX_NUM))
+    {
+        s_bleStats.rxDrops++;
+        return false;
+    }
+
+    p_pdu = &s_bleRx[(s_bleRxHead + s_bleRxCount) % SIM_BLE_RX_NUM];
+    p_pdu->len = len;
+    memcpy(p_pdu->data, p_data, len);
+    s_bleRxCount++;
+
+    /* One stack event per PDU, as the profile raises one per notification. */
+    memset(&appMsg, 0, sizeof(appMsg));
+    appMsg.msgId = APP_MSG_BLE_STACK_EVT;
+    if (OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0) == OSAL_RESULT_TRUE)
+    {
+        s_bleRxEvts++;
+        APP_MsgNotify();
+    }
+    return true;
+}
+
+const SIM_BLE_Stats_T *SIM_BLE_StatsGet(void)
+{
+    return &s_bleStats;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: app_ble Stand-ins
+// *****************************************************************************
+// *****************************************************************************
+
+void APP_BleStackInit(void)
+{
+}
+
+void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt)
+{
+    (void)p_stackEvt;
+    if (s_bleRxEvts == 0U)
+    {
+        return;
+    }
+    s_bleRxEvts--;
+
+#ifdef SIM_APP_CENTRAL
+    BLE_TRSPC_Event_T evt;
+
+    evt.eventId = BLE_TRSPC_EVT_RECEIVE_DATA;
+    evt.eventField.onReceiveData.connHandle = SIM_BLE_CONN_HANDLE;
+    APP_TrspcEvtHandler(&evt);
+#else
+    BLE_TRSPS_Event_T evt;
+
+    evt.eventId = BLE_TRSPS_EVT_RECEIVE_DATA;
+    evt.eventField.onReceiveData.connHandle = SIM_BLE_CONN_HANDLE;
+    APP_TrspsEvtHandler(&evt);
+#endif
+}
+
+void APP_BleStackLogHandler(BT_SYS_LogEvent_T *p_logEvt)
+{
+    (void)p_logEvt;
+}
+
+#ifdef SIM_APP_CENTRAL
+void APP_BleScanStart(void)
+{
+}
+
+bool APP_BleReconnStart(void)
+{
+    return false;
+}
+
+uint16_t APP_BleConnTasks(void)
+{
+    return OSAL_WAIT_FOREVER;
+}
+
+void APP_BleGattCacheUpdate(uint16_t connHandle)
+{
+    (void)connHandle;
+}
+
+void APP_BleGattCacheInvalidate(uint16_t connHandle)
+{
+    (void)connHandle;
+}
+#else
+void APP_BleAdvStart(void)
+{
+}
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Profile Stand-ins
+// *****************************************************************************
+// *****************************************************************************
+
+#ifdef SIM_APP_CENTRAL
+uint16_t BLE_TRSPC_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data)
+{
+    return SIM_BLE_Send(connHandle, p_data, len, false);
+}
+
+uint16_t BLE_TRSPC_SendVendorCommand(uint16_t connHandle, uint8_t commandID, uint8_t commandLength, uint8_t *p_commandPayload)
+{
+    return SIM_BLE_Vendor(connHandle, commandID, commandLength, p_commandPayload);
+}
+
+uint16_t BLE_TRSPC_PeekData(uint16_t connHandle, uint8_t **pp_data, uint16_t *p_dataLength)
+{
+    return SIM_BLE_Peek(connHandle, pp_data, p_dataLength);
+}
+
+uint16_t BLE_TRSPC_ReleaseData(uint16_t connHandle)
+{
+    return SIM_BLE_Release(connHandle);
+}
+#else
+uint16_t BLE_TRSPS_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data)
+{
+    return SIM_BLE_Send(connHandle, p_data, len, false);
+}
+
+uint16_t BLE_TRSPS_SendVendorCommand(uint16_t connHandle, uint8_t commandID, uint8_t commandLength, uint8_t *p_commandPayload)
+{
+    return SIM_BLE_Vendor(connHandle, commandID, commandLength, p_commandPayload);
+}
+
+uint16_t BLE_TRSPS_PeekData(uint16_t connHandle, uint8_t **pp_data, uint16_t *p_dataLength)
+{
+    return SIM_BLE_Peek(connHandle, pp_data, p_dataLength);
+}
+
+uint16_t BLE_TRSPS_ReleaseData(uint16_t connHandle)
+{
+    return SIM_BLE_Release(connHandle);
+}
+#endif
@@ -0,0 +1,155 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Host Simulation BLE Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sim_ble.h
+
+  Summary:
+    BLE stack and transparent profile stand-ins of the Linux host simulation.
+
+  Description:
+    Replaces the BLE stack, the app_ble connection handling and the TRSPC
+    (central, SIM_APP_CENTRAL defined) or TRSPS (peripheral) profile with a
+    single link whose far end is the simulation scenario:
+      - Data and vendor PDUs the application sends are counted and handed to
+        the sink function.
+      - SIM_BLE_Receive queues a PDU from the peer. It reaches the
+        application as a stack event and then as the RECEIVE_DATA event of
+        the profile, the same path as on the target.
+
+    Every profile call costs SIM_BLE_CALL_NS of virtual time. Air time,
+    connection events and credits are not modeled, sends always succeed
+    while the link is connected.
+*******************************************************************************/
+
+#ifndef SIM_BLE_H
+#define SIM_BLE_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_BLE_CONN_HANDLE     0x0040U
+#define SIM_BLE_CALL_NS         15000U  /* Estimated cost of a profile send call */
+#define SIM_BLE_RX_NUM          16      /* PDUs from the peer not yet read */
+#define SIM_BLE_PDU_MAX         244     /* Largest PDU with the negotiated MTU */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* PDU sent by the application. vendor: vendor command, opcode in p_data[0]. */
+typedef void (*SIM_BLE_SinkFunc_T)(const uint8_t *p_data, uint16_t len, bool vendor);
+
+typedef struct SIM_BLE_Stats_T
+{
+    uint32_t    txPdus;         /* Data PDUs sent by the application */
+    uint32_t    txBytes;
+    uint32_t    txVendorPdus;
+    uint32_t    txErrors;       /* Sends while not connected or oversized */
+    uint32_t    rxPdus;         /* PDUs delivered to the application */
+    uint32_t    rxBytes;
+    uint32_t    rxDrops;        /* SIM_BLE_Receive calls with a full queue */
+} SIM_BLE_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void SIM_BLE_Init(SIM_BLE_SinkFunc_T sinkFunc)
+
+  Summary:
+    Resets the link and the statistics.
+*/
+void SIM_BLE_Init(SIM_BLE_SinkFunc_T sinkFunc);
+
+/*******************************************************************************
+  Function:
+    void SIM_BLE_Connect(void)
+
+  Summary:
+    Connects the link with SIM_BLE_CONN_HANDLE, like the connection event
+    of the stack does on the target.
+*/
+void SIM_BLE_Connect(void);
+
+/*******************************************************************************
+  Function:
+    bool SIM_BLE_Receive(const uint8_t *p_data, uint16_t len)
+
+  Summary:
+    Queues a data PDU from the peer and signals a stack event.
+
+  Returns:
+    true  - The PDU is queued.
+    false - Not connected, too long or the queue is full.
+*/
+bool SIM_BLE_Receive(const uint8_t *p_data, uint16_t len);
+
+/*******************************************************************************
+  Function:
+    const SIM_BLE_Stats_T *SIM_BLE_StatsGet(void)
+
+  Summary:
+    Returns the link statistics.
+*/
+const SIM_BLE_Stats_T *SIM_BLE_StatsGet(void);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif /* SIM_BLE_H */
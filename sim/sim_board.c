@@ -0,0 +1,186 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Host Simulation Board Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sim_board.c
+
+  Summary:
+    Register windows, EIC and console stand-ins of the Linux host simulation.
+
+  Description:
+    See sim_board.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#define _GNU_SOURCE
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "definitions.h"
+#include "sim_board.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_BOARD_PERIPH_BASE   0x40000000UL    /* EIC up to the GPIO ports */
+#define SIM_BOARD_PERIPH_SIZE   0x05000000UL
+#define SIM_BOARD_PPB_BASE      0xE0000000UL    /* DWT, SysTick, NVIC, SCB */
+#define SIM_BOARD_PPB_SIZE      0x00100000UL
+
+#define SIM_BOARD_EIC_PIN_NUM   16U
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Interrupt masks of the core_cm4.h intrinsics. */
+uint32_t simCorePrimask;
+uint32_t simCoreBasepri;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+static EIC_CALLBACK s_boardEicCb[SIM_BOARD_EIC_PIN_NUM];
+static uintptr_t    s_boardEicCtx[SIM_BOARD_EIC_PIN_NUM];
+static bool         s_boardEicEn[SIM_BOARD_EIC_PIN_NUM];
+static bool         s_boardQuiet;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool SIM_BOARD_Map(uintptr_t base, size_t size)
+{
+    void *p_map = mmap((void *)base, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE | MAP_NORESERVE, -1, 0);
+
+    if (p_map != (void *)base)
+    {
+        fprintf(stderr, "sim: cannot map 0x%08lx-0x%08lx\n", (unsigned long)base, (unsigned long)(base + size - 1U));
+        return false;
+    }
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+bool SIM_BOARD_Init(bool quiet)
+{
+    s_boardQuiet = quiet;
+    memset(s_boardEicCb, 0, sizeof(s_boardEicCb));
+    memset(s_boardEicEn, 0, sizeof(s_boardEicEn));
+    simCorePrimask = 0;
+    simCoreBasepri = 0;
+
+    return SIM_BOARD_Map(SIM_BOARD_PERIPH_BASE, SIM_BOARD_PERIPH_SIZE)
+           && SIM_BOARD_Map(SIM_BOARD_PPB_BASE, SIM_BOARD_PPB_SIZE);
+}
+
+void SIM_BOARD_CanInt(void)
+{
+    if (s_boardEicEn[EIC_PIN_2] && (s_boardEicCb[EIC_PIN_2] != NULL))
+    {
+        s_boardEicCb[EIC_PIN_2](s_boardEicCtx[EIC_PIN_2]);
+    }
+}
+
+void EIC_CallbackRegister(EIC_PIN pin, EIC_CALLBACK callback, uintptr_t context)
+{
+    if (pin < SIM_BOARD_EIC_PIN_NUM)
+    {
+        s_boardEicCb[pin] = callback;
+        s_boardEicCtx[pin] = context;
+    }
+}
+
+void EIC_InterruptEnable(EIC_PIN pin)
+{
+    if (pin < SIM_BOARD_EIC_PIN_NUM)
+    {
+        s_boardEicEn[pin] = true;
+    }
+}
+
+void SYS_CONSOLE_Print(const SYS_CONSOLE_HANDLE handle, const char *format, ...)
+{
+    va_list args;
+
+    (void)handle;
+    if (!s_boardQuiet)
+    {
+        va_start(args, format);
+        (void)vprintf(format, args);
+        va_end(args);
+    }
+}
+
+void SYS_CONSOLE_Message(const SYS_CONSOLE_HANDLE handle, const char *message)
+{
+    (void)handle;
+    if (!s_boardQuiet)
+    {
+        (void)fputs(message, stdout);
+    }
+}
+
+ssize_t SYS_CONSOLE_Write(const SYS_CONSOLE_HANDLE handle, const void *buf, size_t count)
+{
+    (void)handle;
+    if (!s_boardQuiet)
+    {
+        (void)fwrite(buf, 1, count, stdout);
+    }
+    return (ssize_t)count;
+}
+
+ssize_t SYS_CONSOLE_WriteFreeBufferCountGet(const SYS_CONSOLE_HANDLE handle)
+{
+    (void)handle;
+    return SYS_CONSOLE_PRINT_BUFFER_SIZE;
+}
@@ -0,0 +1,105 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Host Simulation Board Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sim_board.h
+
+  Summary:
+    Board level stand-ins of the Linux host simulation.
+
+  Description:
+    SIM_BOARD_Init maps the peripheral and the Cortex-M system register
+    windows at their target addresses as plain memory, so the LED and
+    standby pin macros and the DWT accesses of the firmware work unchanged.
+    The file also stands in for the EIC and console PLIBs: the EIC callback
+    of the CAN INT pin is called by SIM_BOARD_CanInt, which is the interrupt
+    function given to the MCP251863 model, and the console writes to stdout.
+*******************************************************************************/
+
+#ifndef SIM_BOARD_H
+#define SIM_BOARD_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    bool SIM_BOARD_Init(bool quiet)
+
+  Summary:
+    Maps the register windows and sets up the console.
+
+  Parameters:
+    quiet - true: console output of the firmware is discarded.
+
+  Returns:
+    true  - The register windows are mapped.
+    false - An address range is not available in the host process.
+*/
+bool SIM_BOARD_Init(bool quiet);
+
+/*******************************************************************************
+  Function:
+    void SIM_BOARD_CanInt(void)
+
+  Summary:
+    Falling edge of the CAN controller INT pin on EIC pin 2.
+
+  Description:
+    Calls the callback registered with EIC_CallbackRegister once the
+    interrupt is enabled, like the EIC interrupt handler.
+*/
+void SIM_BOARD_CanInt(void);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif /* SIM_BOARD_H */
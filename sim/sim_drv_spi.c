@@ -0,0 +1,112 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Host Simulation SPI Driver Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sim_drv_spi.c
+
+  Summary:
+    Synchronous SPI driver of the Linux host simulation.
+
+  Description:
+    Stands in for the DRV_SPI functions the CAN FD driver uses. A transfer is
+    handed to the MCP251863 model and costs the bus time at the configured
+    clock plus a fixed driver and chip select overhead, so SPI bound paths
+    take as long as on the target.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "definitions.h"
+#include "sim_time.h"
+#include "mcp251863_model.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_DRV_SPI_HANDLE          1U
+#define SIM_DRV_SPI_OVERHEAD_NS     2000U   /* Driver call, DMA setup and CS timing, estimated */
+#define SIM_DRV_SPI_BUF_SIZE        256U
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t s_spiBaud = 1000000UL;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+DRV_HANDLE DRV_SPI_Open(const SYS_MODULE_INDEX index, const DRV_IO_INTENT ioIntent)
+{
+    (void)ioIntent;
+    return (index == DRV_SPI_INDEX_0) ? SIM_DRV_SPI_HANDLE : DRV_HANDLE_INVALID;
+}
+
+bool DRV_SPI_TransferSetup(const DRV_HANDLE handle, DRV_SPI_TRANSFER_SETUP *setup)
+{
+    if ((handle != SIM_DRV_SPI_HANDLE) || (setup == NULL) || (setup->baudRateInHz == 0U))
+    {
+        return false;
+    }
+    s_spiBaud = setup->baudRateInHz;
+    return true;
+}
+
+bool DRV_SPI_WriteReadTransfer(const DRV_HANDLE handle, void *pTransmitData, size_t txSize,
+                               void *pReceiveData, size_t rxSize)
+{
+    uint8_t rx[SIM_DRV_SPI_BUF_SIZE];
+    size_t len = (txSize > rxSize) ? txSize : rxSize;
+
+    if ((handle != SIM_DRV_SPI_HANDLE) || (len > SIM_DRV_SPI_BUF_SIZE) || (txSize < len))
+    {
+        return false;
+    }
+
+    SIM_MCP_SpiTransfer(pTransmitData, rx, (uint16_t)len);
+    if (pReceiveData != NULL)
+    {
+        memcpy(pReceiveData, rx, rxSize);
+    }
+    SIM_TIME_Spend(SIM_DRV_SPI_OVERHEAD_NS + ((uint64_t)len * 8U * 1000000000ULL) / s_spiBaud);
+    return true;
+}
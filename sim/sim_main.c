@@ -0,0 +1,516 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Host Simulation Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sim_main.c
+
+  Summary:
+    Bridge self-test of the Linux host simulation.
+
+  Description:
+    Runs APP_Initialize and APP_Tasks of the project against the MCP251863
+    model, the SPI driver, the FreeRTOS kernel and the BLE stand-ins, all on
+    virtual time, and drives both directions of the bridge:
+      - CAN to BLE: a classic frame appears on the bus every period. The
+        data PDU the application sends must carry its identifier, DLC and
+        data.
+      - BLE to CAN: half a period later the peer writes a PDU with a TX
+        message object. The frame the controller sends must match it.
+
+    The report gives the latencies in virtual time, the SPI traffic per frame
+    and the model and link statistics. The broadcast decoder is then fed
+    valid and malformed advertising data, and with CAN_J1939_ENABLE the
+    J1939 reassembly hostile TP.CM_CTS. The exit code is 0 when every frame
+    arrived in order and unchanged, the model saw no invalid access and these
+    checks passed. With a period too short for the bus or the link, lost
+    frames are counted.
+
+    With -r the recorded trace of sim_replay.h is played onto the bus
+    instead, -s times faster, and the replay report is given; -o writes its
+    results file.
+
+    Usage: sim [-n frames] [-p period_us] [-r trace [-s speed] [-o results]] [-q]
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "definitions.h"
+#include "app.h"
+#include "canfdspi/drv_canfdspi_api.h"
+#include "can_bridge/can_bcast.h"
+#include "can_bridge/can_j1939.h"
+#include "sim_time.h"
+#include "sim_board.h"
+#include "sim_ble.h"
+#include "sim_replay.h"
+#include "mcp251863_model.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_MAIN_FRAMES_MAX     10000U
+#define SIM_MAIN_CONNECT_NS     SIM_TIME_MS(5)      /* Link up */
+#define SIM_MAIN_START_NS       SIM_TIME_MS(10)     /* First frame */
+#define SIM_MAIN_DRAIN_NS       SIM_TIME_MS(200)    /* Run time after the last frame */
+#define SIM_MAIN_OBJ_LEN        sizeof(CAN_RX_MSGOBJ)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct SIM_MAIN_Dir_T
+{
+    const char *p_name;
+    uint32_t    sent;
+    uint32_t    received;
+    uint32_t    next;           /* Index of the next frame expected */
+    uint32_t    lost;           /* Skipped by a later frame */
+    uint32_t    errors;         /* Matching no later frame */
+    uint64_t    latencySum;
+    uint64_t    latencyMin;
+    uint64_t    latencyMax;
+    uint64_t    sentAt[SIM_MAIN_FRAMES_MAX];
+} SIM_MAIN_Dir_T;
+
+static SIM_MAIN_Dir_T   s_mainCanToBle = { .p_name = "CAN -> BLE" };
+static SIM_MAIN_Dir_T   s_mainBleToCan = { .p_name = "BLE -> CAN" };
+static uint32_t         s_mainFrames = 100;
+static uint64_t         s_mainPeriodNs = SIM_TIME_MS(1);
+static uint32_t         s_mainBcastFrames;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Frame i of a direction: SID base + i, DLC i mod 9, data i + byte index. */
+static void SIM_MAIN_Frame(uint32_t i, uint16_t sidBase, SIM_MCP_Frame_T *p_frame)
+{
+    uint8_t k;
+
+    memset(p_frame, 0, sizeof(*p_frame));
+    p_frame->id = (sidBase + i) & 0x7FFU;
+    p_frame->dlc = (uint8_t)(i % 9U);
+    for (k = 0; k < p_frame->dlc; k++)
+    {
+        p_frame->data[k] = (uint8_t)(i + k);
+    }
+}
+
+static bool SIM_MAIN_Match(const SIM_MCP_Frame_T *p_got, uint32_t i, uint16_t sidBase)
+{
+    SIM_MCP_Frame_T expect;
+
+    SIM_MAIN_Frame(i, sidBase, &expect);
+    return (p_got->id == expect.id) && (p_got->dlc == expect.dlc) && !p_got->ide
+           && (memcmp(p_got->data, expect.data, expect.dlc) == 0);
+}
+
+/* Frames must arrive in order. A frame that matches a later one than
+   expected marks the ones in between as lost. */
+static void SIM_MAIN_Arrived(SIM_MAIN_Dir_T *p_dir, const SIM_MCP_Frame_T *p_got, uint16_t sidBase)
+{
+    uint64_t latency;
+    uint32_t i;
+
+    p_dir->received++;
+    for (i = p_dir->next; i < p_dir->sent; i++)
+    {
+        if (SIM_MAIN_Match(p_got, i, sidBase))
+        {
+            break;
+        }
+    }
+    if (i == p_dir->sent)
+    {
+        p_dir->errors++;
+        return;
+    }
+    p_dir->lost += i - p_dir->next;
+    p_dir->next = i + 1U;
+
+    latency = SIM_TIME_Now() - p_dir->sentAt[i];
+    p_dir->latencySum += latency;
+    if ((p_dir->latencyMin == 0U) || (latency < p_dir->latencyMin))
+    {
+        p_dir->latencyMin = latency;
+    }
+    if (latency > p_dir->latencyMax)
+    {
+        p_dir->latencyMax = latency;
+    }
+}
+
+/* Frame sent by the controller. */
+static void SIM_MAIN_BusTx(const SIM_MCP_Frame_T *p_frame)
+{
+    SIM_MAIN_Arrived(&s_mainBleToCan, p_frame, 0x200U);
+}
+
+/* PDU sent by the application: RX message object and data. */
+static void SIM_MAIN_BleTx(const uint8_t *p_data, uint16_t len, bool vendor)
+{
+    CAN_RX_MSGOBJ obj;
+    SIM_MCP_Frame_T got;
+
+    if (vendor)
+    {
+        return;
+    }
+    if (len < SIM_MAIN_OBJ_LEN)
+    {
+        s_mainCanToBle.errors++;
+        return;
+    }
+
+    memcpy(&obj, p_data, SIM_MAIN_OBJ_LEN);
+    memset(&got, 0, sizeof(got));
+    got.id = obj.bF.id.SID;
+    got.ide = obj.bF.ctrl.IDE;
+    got.dlc = obj.bF.ctrl.DLC;
+    if ((len - SIM_MAIN_OBJ_LEN) != got.dlc)
+    {
+        s_mainCanToBle.errors++;
+        return;
+    }
+    memcpy(got.data, &p_data[SIM_MAIN_OBJ_LEN], got.dlc);
+    SIM_MAIN_Arrived(&s_mainCanToBle, &got, 0x100U);
+}
+
+static void SIM_MAIN_Connect(void *p_arg)
+{
+    (void)p_arg;
+    SIM_BLE_Connect();
+}
+
+static void SIM_MAIN_BusFrame(void *p_arg)
+{
+    uint32_t i = (uint32_t)(uintptr_t)p_arg;
+    SIM_MCP_Frame_T frame;
+
+    SIM_MAIN_Frame(i, 0x100U, &frame);
+    s_mainCanToBle.sentAt[i] = SIM_TIME_Now();
+    s_mainCanToBle.sent++;
+    (void)SIM_MCP_BusReceive(&frame);
+
+    if ((i + 1U) < s_mainFrames)
+    {
+        (void)SIM_TIME_EventAdd(SIM_TIME_Now() + s_mainPeriodNs, SIM_MAIN_BusFrame, (void *)(uintptr_t)(i + 1U));
+    }
+}
+
+/* PDU of the peer: TX message object, 4 unused bytes and data, as the
+   application expects it in CAN_MSG_t. */
+static void SIM_MAIN_BlePdu(void *p_arg)
+{
+    uint32_t i = (uint32_t)(uintptr_t)p_arg;
+    uint8_t pdu[SIM_MAIN_OBJ_LEN + 8U];
+    CAN_TX_MSGOBJ obj;
+    SIM_MCP_Frame_T frame;
+
+    SIM_MAIN_Frame(i, 0x200U, &frame);
+    memset(&obj, 0, sizeof(obj));
+    obj.bF.id.SID = frame.id;
+    obj.bF.ctrl.DLC = frame.dlc;
+    memcpy(pdu, &obj, SIM_MAIN_OBJ_LEN);
+    memcpy(&pdu[SIM_MAIN_OBJ_LEN], frame.data, frame.dlc);
+
+    s_mainBleToCan.sentAt[i] = SIM_TIME_Now();
+    s_mainBleToCan.sent++;
+    (void)SIM_BLE_Receive(pdu, (uint16_t)(SIM_MAIN_OBJ_LEN + frame.dlc));
+
+    if ((i + 1U) < s_mainFrames)
+    {
+        (void)SIM_TIME_EventAdd(SIM_TIME_Now() + s_mainPeriodNs, SIM_MAIN_BlePdu, (void *)(uintptr_t)(i + 1U));
+    }
+}
+
+static void SIM_MAIN_BcastFrame(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+{
+    if ((p_obj->bF.id.SID == 0x123U) && (p_obj->bF.ctrl.DLC == 2U) && (p_data[0] == 0xA1U) && (p_data[1] == 0xB2U))
+    {
+        s_mainBcastFrames++;
+    }
+}
+
+/* Broadcast decoder on advertising data from the air: a valid PDU after a
+   Flags AD structure, the same PDU cut short, the same PDU behind a CAN FD
+   length record that must be skipped, and an AD length of 0xFF that used to
+   wrap the offset back onto itself. Returns only if the decoder does. */
+static bool SIM_MAIN_BcastCheck(void)
+{
+    static const uint8_t badLen[8] = { 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    static const uint8_t data[2] = { 0xA1, 0xB2 };
+    CAN_BCAST_Encoder_T enc;
+    CAN_BCAST_Decoder_T dec;
+    CAN_RX_MSGOBJ obj;
+    uint8_t adv[3 + CAN_BCAST_PDU_MAX] = { 0x02, 0x01, 0x06 };
+    uint8_t fd[CAN_BCAST_PDU_MAX];
+    uint8_t fdLen;
+    uint8_t len;
+    bool pass;
+
+    memset(&enc, 0, sizeof(enc));
+    memset(&obj, 0, sizeof(obj));
+    obj.bF.id.SID = 0x123U;
+    obj.bF.ctrl.DLC = 2U;
+    CAN_BCAST_EncoderReset(&enc);
+    (void)CAN_BCAST_EncoderAdd(&enc, &obj, data);
+    len = CAN_BCAST_EncoderFinish(&enc);
+    memcpy(&adv[3], enc.buf, len);
+
+    /* DLC 15 record (64 data bytes) ahead of the valid one */
+    memset(fd, 0, sizeof(fd));
+    memcpy(fd, enc.buf, CAN_BCAST_HDR_LEN);
+    fd[CAN_BCAST_HDR_LEN] = CAN_DLC_64;
+    memcpy(&fd[CAN_BCAST_HDR_LEN + 3 + 64], &enc.buf[CAN_BCAST_HDR_LEN], len - CAN_BCAST_HDR_LEN);
+    fdLen = (uint8_t)(len + 3U + 64U);
+    fd[0] = fdLen - 1U;
+
+    CAN_BCAST_DecoderReset(&dec);
+    pass = (CAN_BCAST_Decode(&dec, badLen, sizeof(badLen), SIM_MAIN_BcastFrame) == 0U);
+    CAN_BCAST_DecoderReset(&dec);
+    pass = (CAN_BCAST_Decode(&dec, adv, (uint8_t)(3U + len - 1U), SIM_MAIN_BcastFrame) == 0U) && pass;
+    CAN_BCAST_DecoderReset(&dec);
+    pass = (CAN_BCAST_Decode(&dec, adv, (uint8_t)(3U + len), SIM_MAIN_BcastFrame) == 1U) && pass;
+    CAN_BCAST_DecoderReset(&dec);
+    pass = (CAN_BCAST_Decode(&dec, fd, fdLen, SIM_MAIN_BcastFrame) == 1U) && pass;
+    pass = pass && (s_mainBcastFrames == 2U);
+    printf("BCAST decoder: %s\n", pass ? "ok" : "failed");
+    return pass;
+}
+
+#ifdef CAN_J1939_ENABLE
+typedef struct SIM_MAIN_J1939Frame_T
+{
+    uint32_t    id;
+    uint8_t     data[8];
+} SIM_MAIN_J1939Frame_T;
+
+/* Hostile J1939 transport sessions from node 0x20 to node 0x30: a TP.CM_CTS
+   asking for packet 0, then one clearing packets past the end of the PGN,
+   each followed by the TP.DT it invites. Both CTS must abort the session
+   and the TP.DT must find none. Returns only if the reassembly does not
+   write past its buffer. */
+static bool SIM_MAIN_J1939Check(void)
+{
+    static const SIM_MAIN_J1939Frame_T trace[] =
+    {
+        { 0x1CEC3020U, { 0x10, 0x09, 0x00, 0x02, 0xFF, 0x00, 0xEF, 0x00 } },    /* RTS, 9 bytes in 2 packets */
+        { 0x1CEC2030U, { 0x11, 0x01, 0x00, 0xFF, 0xFF, 0x00, 0xEF, 0x00 } },    /* CTS 1 packet from 0 */
+        { 0x1CEB3020U, { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 } },    /* DT 0 */
+        { 0x1CEC3020U, { 0x10, 0x09, 0x00, 0x02, 0xFF, 0x00, 0xEF, 0x00 } },    /* RTS, 9 bytes in 2 packets */
+        { 0x1CEC2030U, { 0x11, 0x02, 0x02, 0xFF, 0xFF, 0x00, 0xEF, 0x00 } },    /* CTS 2 packets from 2 */
+        { 0x1CEB3020U, { 0x02, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 } },    /* DT 2 */
+    };
+    const CAN_J1939_Stats_T *p_stats = CAN_J1939_StatsGet();
+    uint32_t errors = p_stats->errors;
+    uint32_t aborted = p_stats->aborted;
+    CAN_RX_MSGOBJ obj;
+    uint8_t i;
+    bool pass;
+
+    for (i = 0; i < (sizeof(trace) / sizeof(trace[0])); i++)
+    {
+        memset(&obj, 0, sizeof(obj));
+        obj.bF.id.SID = trace[i].id >> 18;
+        obj.bF.id.EID = trace[i].id & 0x3FFFFU;
+        obj.bF.ctrl.IDE = 1;
+        obj.bF.ctrl.DLC = CAN_DLC_8;
+        (void)CAN_J1939_RxFrame(&obj, trace[i].data);
+    }
+
+    pass = ((p_stats->errors - errors) == 2U) && ((p_stats->aborted - aborted) == 2U);
+    printf("J1939 TP: %s\n", pass ? "ok" : "failed");
+    return pass;
+}
+#endif
+
+static bool SIM_MAIN_Report(SIM_MAIN_Dir_T *p_dir)
+{
+    uint32_t matched = p_dir->received - p_dir->errors;
+
+    /* Frames after the last one received are lost as well. */
+    p_dir->lost += p_dir->sent - p_dir->next;
+    printf("%s: %lu sent, %lu received, %lu lost, %lu errors", p_dir->p_name, (unsigned long)p_dir->sent,
+           (unsigned long)p_dir->received, (unsigned long)p_dir->lost, (unsigned long)p_dir->errors);
+    if (matched > 0U)
+    {
+        printf(", latency min/avg/max %.1f/%.1f/%.1f us",
+               p_dir->latencyMin / 1000.0, p_dir->latencySum / 1000.0 / matched, p_dir->latencyMax / 1000.0);
+    }
+    printf("\n");
+    return (p_dir->errors == 0U) && (p_dir->lost == 0U);
+}
+
+/* Runs the bridge with the recorded trace on the bus and no traffic from the
+   peer. Frames sent onto the bus count as errors of the BLE -> CAN side. */
+static bool SIM_MAIN_Replay(double speed, const char *p_results)
+{
+    const SIM_MCP_Stats_T *p_mcp;
+    bool pass;
+
+    SIM_TIME_Init(SIM_TIME_FOREVER);
+    SIM_MCP_Init(SIM_MAIN_BusTx, SIM_BOARD_CanInt);
+    SIM_BLE_Init(SIM_REPLAY_BleTx);
+    (void)SIM_TIME_EventAdd(SIM_MAIN_CONNECT_NS, SIM_MAIN_Connect, NULL);
+    SIM_REPLAY_Start(SIM_MAIN_START_NS, speed, SIM_MAIN_DRAIN_NS);
+
+    APP_Initialize();
+    while (!SIM_TIME_Finished())
+    {
+        APP_Tasks();
+    }
+
+    p_mcp = SIM_MCP_StatsGet();
+    pass = SIM_REPLAY_Report(p_results);
+    printf("SPI: %lu transfers, %lu bytes, %lu errors, %lu config errors\n",
+           (unsigned long)p_mcp->spiTransfers, (unsigned long)p_mcp->spiBytes,
+           (unsigned long)p_mcp->spiErrors, (unsigned long)p_mcp->cfgErrors);
+    pass = pass && (s_mainBleToCan.errors == 0U) && (p_mcp->spiErrors == 0U) && (p_mcp->cfgErrors == 0U);
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char *argv[])
+{
+    const SIM_MCP_Stats_T *p_mcp;
+    const SIM_BLE_Stats_T *p_ble;
+    const char *p_trace = NULL;
+    const char *p_results = NULL;
+    double speed = 1.0;
+    bool quiet = false;
+    bool pass;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:p:r:s:o:q")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                s_mainFrames = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'p':
+                s_mainPeriodNs = SIM_TIME_US(strtoul(optarg, NULL, 0));
+                break;
+            case 'r':
+                p_trace = optarg;
+                break;
+            case 's':
+                speed = strtod(optarg, NULL);
+                break;
+            case 'o':
+                p_results = optarg;
+                break;
+            case 'q':
+                quiet = true;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n frames] [-p period_us] [-r trace [-s speed] [-o results]] [-q]\n",
+                        argv[0]);
+                return 2;
+        }
+    }
+    if ((s_mainFrames == 0U) || (s_mainFrames > SIM_MAIN_FRAMES_MAX) || (s_mainPeriodNs == 0U))
+    {
+        fprintf(stderr, "sim: 1 to %u frames, period above 0\n", SIM_MAIN_FRAMES_MAX);
+        return 2;
+    }
+
+    if ((p_trace != NULL) && (!(speed > 0.0) || !SIM_REPLAY_Load(p_trace)))
+    {
+        return 2;
+    }
+    if (!SIM_BOARD_Init(quiet))
+    {
+        return 2;
+    }
+    if (p_trace != NULL)
+    {
+        return SIM_MAIN_Replay(speed, p_results) ? 0 : 1;
+    }
+    SIM_TIME_Init(SIM_MAIN_START_NS + (uint64_t)s_mainFrames * s_mainPeriodNs + SIM_MAIN_DRAIN_NS);
+    SIM_MCP_Init(SIM_MAIN_BusTx, SIM_BOARD_CanInt);
+    SIM_BLE_Init(SIM_MAIN_BleTx);
+
+    (void)SIM_TIME_EventAdd(SIM_MAIN_CONNECT_NS, SIM_MAIN_Connect, NULL);
+    (void)SIM_TIME_EventAdd(SIM_MAIN_START_NS, SIM_MAIN_BusFrame, (void *)0);
+    (void)SIM_TIME_EventAdd(SIM_MAIN_START_NS + s_mainPeriodNs / 2U, SIM_MAIN_BlePdu, (void *)0);
+
+    APP_Initialize();
+    while (!SIM_TIME_Finished())
+    {
+        APP_Tasks();
+    }
+
+    p_mcp = SIM_MCP_StatsGet();
+    p_ble = SIM_BLE_StatsGet();
+    printf("\n--- %lu frames each way, period %.1f us, %.1f ms simulated ---\n", (unsigned long)s_mainFrames,
+           s_mainPeriodNs / 1000.0, SIM_TIME_Now() / 1e6);
+    pass = SIM_MAIN_Report(&s_mainCanToBle);
+    pass = SIM_MAIN_Report(&s_mainBleToCan) && pass;
+    printf("SPI: %lu transfers, %lu bytes, %.1f bytes per frame, %lu errors, %lu config errors\n",
+           (unsigned long)p_mcp->spiTransfers, (unsigned long)p_mcp->spiBytes,
+           (double)p_mcp->spiBytes / (s_mainCanToBle.sent + s_mainBleToCan.sent),
+           (unsigned long)p_mcp->spiErrors, (unsigned long)p_mcp->cfgErrors);
+    printf("MCP251863: %lu RX, %lu filtered, %lu overflows, %lu TX, %lu INT edges\n",
+           (unsigned long)p_mcp->rxFrames, (unsigned long)p_mcp->rxFiltered, (unsigned long)p_mcp->rxOverflows,
+           (unsigned long)p_mcp->txFrames, (unsigned long)p_mcp->intEdges);
+    printf("BLE: %lu data PDUs (%lu bytes), %lu vendor PDUs, %lu send errors, %lu PDUs received, %lu dropped\n",
+           (unsigned long)p_ble->txPdus, (unsigned long)p_ble->txBytes, (unsigned long)p_ble->txVendorPdus,
+           (unsigned long)p_ble->txErrors, (unsigned long)p_ble->rxPdus, (unsigned long)p_ble->rxDrops);
+
+    pass = SIM_MAIN_BcastCheck() && pass;
+#ifdef CAN_J1939_ENABLE
+    pass = SIM_MAIN_J1939Check() && pass;
+#endif
+    pass = pass && (p_mcp->spiErrors == 0U) && (p_mcp->cfgErrors == 0U);
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,443 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Host Simulation Trace Replay Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sim_replay.c
+
+  Summary:
+    Replays a recorded CAN trace into the MCP251863 model.
+
+  Description:
+    See sim_replay.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "definitions.h"
+#include "canfdspi/drv_canfdspi_api.h"
+#include "can_bridge/can_replay.h"
+#include "sim_time.h"
+#include "sim_ble.h"
+#include "sim_replay.h"
+#include "mcp251863_model.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_REPLAY_OBJ_LEN      sizeof(CAN_RX_MSGOBJ)
+#define SIM_REPLAY_LINE_MAX     256
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct SIM_REPLAY_Frame_T
+{
+    uint64_t    timeUs;
+    uint32_t    id;
+    uint8_t     ctrl;
+    uint8_t     data[8];
+    char        status;         /* S stored, F filtered, O overflow, 0 not yet on the bus */
+    uint64_t    busNs;
+    uint64_t    bleNs;          /* 0: not sent over BLE */
+} SIM_REPLAY_Frame_T;
+
+typedef struct SIM_REPLAY_Pdu_T
+{
+    uint64_t    ns;
+    uint16_t    len;
+    uint8_t     frames;
+} SIM_REPLAY_Pdu_T;
+
+static SIM_REPLAY_Frame_T  *s_replayFrame;
+static uint32_t             s_replayFrameNum;
+static SIM_REPLAY_Pdu_T    *s_replayPdu;
+static uint32_t             s_replayPduNum;
+static uint32_t             s_replayPduMax;
+static uint64_t             s_replayStartNs;
+static double               s_replaySpeed;
+static uint64_t             s_replayDrainNs;
+static uint32_t             s_replayNext;       /* First frame not yet matched or passed over */
+static uint32_t             s_replayLost;
+static uint32_t             s_replayErrors;     /* Records matching no frame */
+static uint32_t             s_replayBusDelayed; /* Frames held back by the previous one */
+static uint32_t             s_replayPduFrames;  /* Records in all PDUs */
+static uint64_t             s_replayPduBytes;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool SIM_REPLAY_Parse(const char *p_line, SIM_REPLAY_Frame_T *p_frame)
+{
+    char hex[SIM_REPLAY_LINE_MAX];
+    unsigned int id;
+    unsigned int ctrl;
+    unsigned int byte;
+    uint8_t dlc;
+    uint8_t k;
+    int n;
+
+    memset(p_frame, 0, sizeof(*p_frame));
+    hex[0] = '\0';
+    n = sscanf(p_line, "%" SCNu64 " %x %x %255s", &p_frame->timeUs, &id, &ctrl, hex);
+    if ((n < 3) || (ctrl > 0xFFU))
+    {
+        return false;
+    }
+    dlc = ctrl & CAN_REPLAY_CTRL_DLC_MASK;
+    if ((dlc > 8U) || (id > ((ctrl & CAN_REPLAY_CTRL_IDE) ? 0x1FFFFFFFU : 0x7FFU)))
+    {
+        return false;
+    }
+    p_frame->id = id;
+    p_frame->ctrl = (uint8_t)ctrl;
+    if ((ctrl & CAN_REPLAY_CTRL_RTR) || (dlc == 0U))
+    {
+        return (n == 3) || (strcmp(hex, "-") == 0);
+    }
+    if (strlen(hex) != 2U * dlc)
+    {
+        return false;
+    }
+    for (k = 0; k < dlc; k++)
+    {
+        if (sscanf(&hex[2U * k], "%2x", &byte) != 1)
+        {
+            return false;
+        }
+        p_frame->data[k] = (uint8_t)byte;
+    }
+    return true;
+}
+
+static void SIM_REPLAY_ToBus(const SIM_REPLAY_Frame_T *p_replay, SIM_MCP_Frame_T *p_frame)
+{
+    memset(p_frame, 0, sizeof(*p_frame));
+    p_frame->id = p_replay->id;
+    p_frame->dlc = p_replay->ctrl & CAN_REPLAY_CTRL_DLC_MASK;
+    p_frame->ide = (p_replay->ctrl & CAN_REPLAY_CTRL_IDE) != 0U;
+    p_frame->rtr = (p_replay->ctrl & CAN_REPLAY_CTRL_RTR) != 0U;
+    p_frame->brs = (p_replay->ctrl & CAN_REPLAY_CTRL_BRS) != 0U;
+    p_frame->fdf = (p_replay->ctrl & CAN_REPLAY_CTRL_FDF) != 0U;
+    memcpy(p_frame->data, p_replay->data, sizeof(p_replay->data));
+}
+
+static uint64_t SIM_REPLAY_DueNs(uint32_t i)
+{
+    return s_replayStartNs + (uint64_t)((double)SIM_TIME_US(s_replayFrame[i].timeUs) / s_replaySpeed);
+}
+
+/* Frame i completes on the bus now. Schedules the next one, when it is due
+   but not before it could have been sent after this one. */
+static void SIM_REPLAY_BusFrame(void *p_arg)
+{
+    uint32_t i = (uint32_t)(uintptr_t)p_arg;
+    SIM_REPLAY_Frame_T *p_replay = &s_replayFrame[i];
+    SIM_MCP_Frame_T frame;
+    const SIM_MCP_Stats_T *p_mcp = SIM_MCP_StatsGet();
+    uint32_t overflows = p_mcp->rxOverflows;
+    uint64_t at;
+    uint64_t earliest;
+
+    SIM_REPLAY_ToBus(p_replay, &frame);
+    p_replay->busNs = SIM_TIME_Now();
+    if (SIM_MCP_BusReceive(&frame))
+    {
+        p_replay->status = 'S';
+    }
+    else
+    {
+        p_replay->status = (p_mcp->rxOverflows != overflows) ? 'O' : 'F';
+    }
+
+    if ((i + 1U) == s_replayFrameNum)
+    {
+        SIM_TIME_EndSet(SIM_TIME_Now() + s_replayDrainNs);
+        return;
+    }
+
+    SIM_REPLAY_ToBus(&s_replayFrame[i + 1U], &frame);
+    at = SIM_REPLAY_DueNs(i + 1U);
+    earliest = SIM_TIME_Now() + SIM_MCP_FrameTimeNs(&frame);
+    if (at < earliest)
+    {
+        at = earliest;
+        s_replayBusDelayed++;
+    }
+    (void)SIM_TIME_EventAdd(at, SIM_REPLAY_BusFrame, (void *)(uintptr_t)(i + 1U));
+}
+
+/* Matches one message object of a PDU. Stored frames passed over were lost. */
+static bool SIM_REPLAY_Match(const CAN_RX_MSGOBJ *p_obj, const uint8_t *p_data)
+{
+    uint32_t id = p_obj->bF.ctrl.IDE ? (((uint32_t)p_obj->bF.id.SID << 18) | p_obj->bF.id.EID) : p_obj->bF.id.SID;
+    uint8_t ide = p_obj->bF.ctrl.IDE ? CAN_REPLAY_CTRL_IDE : 0U;
+    uint8_t dlc = (uint8_t)p_obj->bF.ctrl.DLC;
+    SIM_REPLAY_Frame_T *p_replay;
+    uint32_t lost = 0;
+    uint32_t i;
+
+    for (i = s_replayNext; (i < s_replayFrameNum) && (s_replayFrame[i].status != 0); i++)
+    {
+        p_replay = &s_replayFrame[i];
+        if (p_replay->status != 'S')
+        {
+            continue;
+        }
+        if ((p_replay->id == id) && ((p_replay->ctrl & CAN_REPLAY_CTRL_IDE) == ide)
+            && ((p_replay->ctrl & CAN_REPLAY_CTRL_DLC_MASK) == dlc)
+            && ((p_replay->ctrl & CAN_REPLAY_CTRL_RTR) || (memcmp(p_replay->data, p_data, dlc) == 0)))
+        {
+            p_replay->bleNs = SIM_TIME_Now();
+            s_replayLost += lost;
+            s_replayNext = i + 1U;
+            return true;
+        }
+        lost++;
+    }
+    return false;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+bool SIM_REPLAY_Load(const char *p_path)
+{
+    char line[SIM_REPLAY_LINE_MAX];
+    SIM_REPLAY_Frame_T frame;
+    uint32_t max = 0;
+    uint32_t lineNum = 0;
+    FILE *p_file = fopen(p_path, "r");
+
+    if (p_file == NULL)
+    {
+        perror(p_path);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), p_file) != NULL)
+    {
+        lineNum++;
+        if ((line[0] == '#') || (line[strspn(line, " \t\r\n")] == '\0'))
+        {
+            continue;
+        }
+        if (!SIM_REPLAY_Parse(line, &frame)
+            || ((s_replayFrameNum > 0U) && (frame.timeUs < s_replayFrame[s_replayFrameNum - 1U].timeUs)))
+        {
+            fprintf(stderr, "%s:%lu: malformed or out of order frame\n", p_path, (unsigned long)lineNum);
+            fclose(p_file);
+            return false;
+        }
+        if (s_replayFrameNum == max)
+        {
+            max = (max == 0U) ? 1024U : (max * 2U);
+            s_replayFrame = realloc(s_replayFrame, max * sizeof(s_replayFrame[0]));
+            if (s_replayFrame == NULL)
+            {
+                fclose(p_file);
+                return false;
+            }
+        }
+        s_replayFrame[s_replayFrameNum++] = frame;
+    }
+    fclose(p_file);
+
+    if (s_replayFrameNum == 0U)
+    {
+        fprintf(stderr, "%s: no frames\n", p_path);
+        return false;
+    }
+    return true;
+}
+
+void SIM_REPLAY_Start(uint64_t startNs, double speed, uint64_t drainNs)
+{
+    s_replayStartNs = startNs;
+    s_replaySpeed = speed;
+    s_replayDrainNs = drainNs;
+    (void)SIM_TIME_EventAdd(SIM_REPLAY_DueNs(0), SIM_REPLAY_BusFrame, (void *)0);
+}
+
+void SIM_REPLAY_BleTx(const uint8_t *p_data, uint16_t len, bool vendor)
+{
+    CAN_RX_MSGOBJ obj;
+    uint16_t off = 0;
+    uint8_t frames = 0;
+
+    if (vendor)
+    {
+        return;
+    }
+
+    while ((off + SIM_REPLAY_OBJ_LEN) <= len)
+    {
+        memcpy(&obj, &p_data[off], SIM_REPLAY_OBJ_LEN);
+        off += SIM_REPLAY_OBJ_LEN;
+        if ((obj.bF.ctrl.DLC > 8U) || ((off + obj.bF.ctrl.DLC) > len))
+        {
+            break;
+        }
+        if (!SIM_REPLAY_Match(&obj, &p_data[off]))
+        {
+            s_replayErrors++;
+        }
+        off += obj.bF.ctrl.DLC;
+        frames++;
+    }
+    if (off != len)
+    {
+        s_replayErrors++;
+    }
+
+    if (s_replayPduNum == s_replayPduMax)
+    {
+        s_replayPduMax = (s_replayPduMax == 0U) ? 1024U : (s_replayPduMax * 2U);
+        s_replayPdu = realloc(s_replayPdu, s_replayPduMax * sizeof(s_replayPdu[0]));
+        if (s_replayPdu == NULL)
+        {
+            abort();
+        }
+    }
+    s_replayPdu[s_replayPduNum].ns = SIM_TIME_Now();
+    s_replayPdu[s_replayPduNum].len = len;
+    s_replayPdu[s_replayPduNum].frames = frames;
+    s_replayPduNum++;
+    s_replayPduFrames += frames;
+    s_replayPduBytes += len;
+}
+
+bool SIM_REPLAY_Report(const char *p_results)
+{
+    uint32_t count[3] = { 0, 0, 0 };  /* Stored, filtered, overflow */
+    uint32_t delivered = 0;
+    uint64_t latency;
+    uint64_t latencySum = 0;
+    uint64_t latencyMax = 0;
+    uint32_t i;
+    FILE *p_file;
+
+    /* Stored frames after the last one sent over BLE are lost as well. */
+    for (i = s_replayNext; i < s_replayFrameNum; i++)
+    {
+        if (s_replayFrame[i].status == 'S')
+        {
+            s_replayLost++;
+        }
+    }
+    for (i = 0; i < s_replayFrameNum; i++)
+    {
+        const SIM_REPLAY_Frame_T *p_replay = &s_replayFrame[i];
+
+        count[0] += (p_replay->status == 'S') ? 1U : 0U;
+        count[1] += (p_replay->status == 'F') ? 1U : 0U;
+        count[2] += (p_replay->status == 'O') ? 1U : 0U;
+        if (p_replay->bleNs != 0U)
+        {
+            latency = p_replay->bleNs - p_replay->busNs;
+            latencySum += latency;
+            latencyMax = (latency > latencyMax) ? latency : latencyMax;
+            delivered++;
+        }
+    }
+
+    printf("\n--- replay of %lu frames, speed %g, %.1f ms simulated ---\n", (unsigned long)s_replayFrameNum,
+           s_replaySpeed, SIM_TIME_Now() / 1e6);
+    printf("CAN: %lu stored, %lu filtered, %lu overflows, %lu not on the bus, %lu held back by the bus\n",
+           (unsigned long)count[0], (unsigned long)count[1], (unsigned long)count[2],
+           (unsigned long)(s_replayFrameNum - count[0] - count[1] - count[2]), (unsigned long)s_replayBusDelayed);
+    printf("Bridge: %lu sent over BLE, %lu lost, %lu errors", (unsigned long)delivered,
+           (unsigned long)s_replayLost, (unsigned long)s_replayErrors);
+    if (delivered > 0U)
+    {
+        printf(", latency avg/max %.1f/%.1f us", latencySum / 1000.0 / delivered, latencyMax / 1000.0);
+    }
+    printf("\n");
+    if (s_replayPduNum > 0U)
+    {
+        printf("BLE: %lu PDUs, %llu bytes, %.1f bytes per frame, %.2f frames per PDU, %.1f%% of %u byte PDUs\n",
+               (unsigned long)s_replayPduNum, (unsigned long long)s_replayPduBytes,
+               (s_replayPduFrames > 0U) ? ((double)s_replayPduBytes / s_replayPduFrames) : 0.0,
+               (double)s_replayPduFrames / s_replayPduNum,
+               100.0 * s_replayPduBytes / ((double)s_replayPduNum * SIM_BLE_PDU_MAX), SIM_BLE_PDU_MAX);
+    }
+
+    if (p_results == NULL)
+    {
+        return s_replayErrors == 0U;
+    }
+    p_file = fopen(p_results, "w");
+    if (p_file == NULL)
+    {
+        perror(p_results);
+        return false;
+    }
+    fprintf(p_file, "# speed %g pdu_max %u\n", s_replaySpeed, SIM_BLE_PDU_MAX);
+    for (i = 0; i < s_replayFrameNum; i++)
+    {
+        const SIM_REPLAY_Frame_T *p_replay = &s_replayFrame[i];
+
+        fprintf(p_file, "F %lu %" PRIu64 " %lX %02X %" PRIu64 " %c ", (unsigned long)i, p_replay->timeUs,
+                (unsigned long)p_replay->id, p_replay->ctrl, p_replay->busNs,
+                (p_replay->status != 0) ? p_replay->status : '-');
+        if (p_replay->bleNs != 0U)
+        {
+            fprintf(p_file, "%" PRIu64 "\n", p_replay->bleNs);
+        }
+        else
+        {
+            fprintf(p_file, "-1\n");
+        }
+    }
+    for (i = 0; i < s_replayPduNum; i++)
+    {
+        fprintf(p_file, "P %" PRIu64 " %u %u\n", s_replayPdu[i].ns, s_replayPdu[i].len, s_replayPdu[i].frames);
+    }
+    fclose(p_file);
+    return s_replayErrors == 0U;
+}
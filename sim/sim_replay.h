@@ -0,0 +1,122 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Host Simulation Trace Replay Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sim_replay.h
+
+  Summary:
+    Replays a recorded CAN trace into the MCP251863 model.
+
+  Description:
+    The trace is a text file written by "tools/can_replay.py convert", one
+    frame per line:
+
+      <time us> <identifier hex> <ctrl hex> <data hex>
+
+    with ctrl as in can_bridge/can_replay.h (DLC, IDE, RTR, BRS, FDF) and
+    the time relative to the first frame. Lines starting with # are skipped.
+
+    Each frame completes on the bus at its recorded time divided by the
+    speed, but not before the previous frame has left the bus. It is fed to
+    SIM_MCP_BusReceive, which tells whether the controller stored, filtered
+    or lost it. The data PDUs the application sends are split into their
+    message objects and matched in order against the stored frames; a stored
+    frame that is passed over was lost by the bridge.
+
+    The report lists the totals. The results file has one line per frame
+    and per PDU for the per identifier analysis of can_replay.py:
+
+      F <index> <time us> <identifier hex> <ctrl hex> <bus ns> <S|F|O> <BLE ns or -1>
+      P <ns> <length> <frames>
+*******************************************************************************/
+
+#ifndef SIM_REPLAY_H
+#define SIM_REPLAY_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    bool SIM_REPLAY_Load(const char *p_path)
+
+  Summary:
+    Reads the trace.
+
+  Returns:
+    true  - At least one frame was read.
+    false - The file could not be read or has a malformed line.
+*/
+bool SIM_REPLAY_Load(const char *p_path);
+
+/*******************************************************************************
+  Function:
+    void SIM_REPLAY_Start(uint64_t startNs, double speed, uint64_t drainNs)
+
+  Summary:
+    Schedules the first frame at startNs. Once the last frame is on the bus
+    the end of the simulation is set drainNs later.
+*/
+void SIM_REPLAY_Start(uint64_t startNs, double speed, uint64_t drainNs);
+
+/*******************************************************************************
+  Function:
+    void SIM_REPLAY_BleTx(const uint8_t *p_data, uint16_t len, bool vendor)
+
+  Summary:
+    BLE sink of the replay, see SIM_BLE_SinkFunc_T.
+*/
+void SIM_REPLAY_BleTx(const uint8_t *p_data, uint16_t len, bool vendor);
+
+/*******************************************************************************
+  Function:
+    bool SIM_REPLAY_Report(const char *p_results)
+
+  Summary:
+    Prints the totals and writes the results file unless p_results is NULL.
+
+  Returns:
+    true  - Every PDU carried frames of the trace, unchanged and in order.
+    false - Otherwise, or the results file could not be written.
+*/
+bool SIM_REPLAY_Report(const char *p_results);
+
+#endif /* SIM_REPLAY_H */
@@ -0,0 +1,533 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Host Simulation FreeRTOS Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sim_rtos.c
+
+  Summary:
+    FreeRTOS kernel stand-ins of the Linux host simulation.
+
+  Description:
+    The simulation runs APP_Tasks as the only task, so the kernel reduces to
+    queues, semaphores, the notification of the APP task, the tick count and
+    the heap. A blocking call waits in virtual time until an event, e.g. the
+    interrupt callback of the CAN controller or a BLE PDU, unblocks it or the
+    timeout expires.
+
+    The run time statistics report the APP task and the IDLE task. The time
+    spent blocked counts as idle time, everything else as APP time. Stack
+    high-water marks are not measured and read 0.
+
+    Queue sets are not supported, the application does not use them.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdlib.h>
+#include <string.h>
+#include "definitions.h"
+#include "sim_time.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_RTOS_TICK_NS        (1000000000ULL / configTICK_RATE_HZ)
+#define SIM_RTOS_CYCLES(ns)     ((uint32_t)(((ns) * (configCPU_CLOCK_HZ / 1000000UL)) / 1000ULL))
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+/* Queue, or semaphore when itemSize is 0 */
+struct QueueDefinition
+{
+    uint8_t        *p_storage;
+    UBaseType_t     length;
+    UBaseType_t     itemSize;
+    UBaseType_t     count;
+    UBaseType_t     head;       /* Next item received */
+    bool            ownStorage;
+};
+
+struct tskTaskControlBlock
+{
+    const char     *p_name;
+    UBaseType_t     number;
+    UBaseType_t     priority;
+    uint32_t        notifyValue;
+    bool            notifyPending;
+};
+
+/* Allocations carry their size in front for the heap statistics. */
+typedef union SIM_RTOS_Block_T
+{
+    size_t          size;
+    uint64_t        align;
+} SIM_RTOS_Block_T;
+
+static struct tskTaskControlBlock s_rtosAppTcb = { "APP", 1, 1, 0, false };
+static uint64_t s_rtosIdleNs;
+static size_t   s_rtosHeapUsed;
+static size_t   s_rtosHeapMaxUsed;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+TaskHandle_t xAPP_Tasks = &s_rtosAppTcb;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t SIM_RTOS_Deadline(TickType_t ticks)
+{
+    return (ticks == portMAX_DELAY) ? SIM_TIME_FOREVER : (SIM_TIME_Now() + (uint64_t)ticks * SIM_RTOS_TICK_NS);
+}
+
+/* Blocks until ready returns true or the timeout expires. */
+static bool SIM_RTOS_Block(TickType_t ticks, SIM_TIME_ReadyFunc_T ready, void *p_ctx)
+{
+    uint64_t start = SIM_TIME_Now();
+    bool result;
+
+    if (ready(p_ctx))
+    {
+        return true;
+    }
+    if (ticks == 0U)
+    {
+        return false;
+    }
+    result = SIM_TIME_Wait(SIM_RTOS_Deadline(ticks), ready, p_ctx);
+    s_rtosIdleNs += SIM_TIME_Now() - start;
+    return result;
+}
+
+static bool SIM_RTOS_QueueNotFull(void *p_ctx)
+{
+    QueueHandle_t xQueue = p_ctx;
+
+    return xQueue->count < xQueue->length;
+}
+
+static bool SIM_RTOS_QueueNotEmpty(void *p_ctx)
+{
+    QueueHandle_t xQueue = p_ctx;
+
+    return xQueue->count > 0U;
+}
+
+static bool SIM_RTOS_NotifyPending(void *p_ctx)
+{
+    TaskHandle_t xTask = p_ctx;
+
+    return xTask->notifyPending;
+}
+
+static QueueHandle_t SIM_RTOS_QueueNew(UBaseType_t length, UBaseType_t itemSize, uint8_t *p_storage)
+{
+    QueueHandle_t xQueue = calloc(1, sizeof(*xQueue));
+
+    if (xQueue == NULL)
+    {
+        return NULL;
+    }
+    xQueue->length = length;
+    xQueue->itemSize = itemSize;
+    xQueue->p_storage = p_storage;
+    if ((p_storage == NULL) && (itemSize > 0U))
+    {
+        xQueue->p_storage = malloc(length * itemSize);
+        xQueue->ownStorage = true;
+        if (xQueue->p_storage == NULL)
+        {
+            free(xQueue);
+            return NULL;
+        }
+    }
+    return xQueue;
+}
+
+static BaseType_t SIM_RTOS_QueuePut(QueueHandle_t xQueue, const void *pvItemToQueue, BaseType_t xCopyPosition)
+{
+    UBaseType_t pos;
+
+    if ((xQueue->count == xQueue->length) && (xCopyPosition != queueOVERWRITE))
+    {
+        return errQUEUE_FULL;
+    }
+    if (xQueue->itemSize > 0U)
+    {
+        if (xCopyPosition == queueOVERWRITE)
+        {
+            xQueue->count = 0;
+        }
+        if (xCopyPosition == queueSEND_TO_FRONT)
+        {
+            xQueue->head = (xQueue->head + xQueue->length - 1U) % xQueue->length;
+            pos = xQueue->head;
+        }
+        else
+        {
+            pos = (xQueue->head + xQueue->count) % xQueue->length;
+        }
+        memcpy(&xQueue->p_storage[pos * xQueue->itemSize], pvItemToQueue, xQueue->itemSize);
+    }
+    xQueue->count++;
+    return pdPASS;
+}
+
+static void SIM_RTOS_QueueGet(QueueHandle_t xQueue, void *pvBuffer)
+{
+    if (xQueue->itemSize > 0U)
+    {
+        memcpy(pvBuffer, &xQueue->p_storage[xQueue->head * xQueue->itemSize], xQueue->itemSize);
+        xQueue->head = (xQueue->head + 1U) % xQueue->length;
+    }
+    xQueue->count--;
+}
+
+static void SIM_RTOS_Notify(TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction)
+{
+    switch (eAction)
+    {
+        case eSetBits:
+            xTaskToNotify->notifyValue |= ulValue;
+            break;
+        case eIncrement:
+            xTaskToNotify->notifyValue++;
+            break;
+        case eSetValueWithOverwrite:
+        case eSetValueWithoutOverwrite:
+            xTaskToNotify->notifyValue = ulValue;
+            break;
+        default:
+            break;
+    }
+    xTaskToNotify->notifyPending = true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Queue Functions
+// *****************************************************************************
+// *****************************************************************************
+
+QueueHandle_t xQueueGenericCreate(const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, const uint8_t ucQueueType)
+{
+    (void)ucQueueType;
+    return SIM_RTOS_QueueNew(uxQueueLength, uxItemSize, NULL);
+}
+
+QueueHandle_t xQueueGenericCreateStatic(const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize,
+                                        uint8_t *pucQueueStorage, StaticQueue_t *pxStaticQueue, const uint8_t ucQueueType)
+{
+    (void)pxStaticQueue;
+    (void)ucQueueType;
+    return SIM_RTOS_QueueNew(uxQueueLength, uxItemSize, pucQueueStorage);
+}
+
+QueueHandle_t xQueueCreateMutex(const uint8_t ucQueueType)
+{
+    QueueHandle_t xQueue = SIM_RTOS_QueueNew(1, 0, NULL);
+
+    (void)ucQueueType;
+    if (xQueue != NULL)
+    {
+        xQueue->count = 1;
+    }
+    return xQueue;
+}
+
+QueueHandle_t xQueueCreateCountingSemaphore(const UBaseType_t uxMaxCount, const UBaseType_t uxInitialCount)
+{
+    QueueHandle_t xQueue = SIM_RTOS_QueueNew(uxMaxCount, 0, NULL);
+
+    if (xQueue != NULL)
+    {
+        xQueue->count = uxInitialCount;
+    }
+    return xQueue;
+}
+
+void vQueueDelete(QueueHandle_t xQueue)
+{
+    if (xQueue->ownStorage)
+    {
+        free(xQueue->p_storage);
+    }
+    free(xQueue);
+}
+
+BaseType_t xQueueGenericSend(QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait,
+                             const BaseType_t xCopyPosition)
+{
+    if ((xCopyPosition != queueOVERWRITE) && !SIM_RTOS_Block(xTicksToWait, SIM_RTOS_QueueNotFull, xQueue))
+    {
+        return errQUEUE_FULL;
+    }
+    return SIM_RTOS_QueuePut(xQueue, pvItemToQueue, xCopyPosition);
+}
+
+BaseType_t xQueueGenericSendFromISR(QueueHandle_t xQueue, const void * const pvItemToQueue,
+                                    BaseType_t * const pxHigherPriorityTaskWoken, const BaseType_t xCopyPosition)
+{
+    if (pxHigherPriorityTaskWoken != NULL)
+    {
+        *pxHigherPriorityTaskWoken = pdFALSE;
+    }
+    return SIM_RTOS_QueuePut(xQueue, pvItemToQueue, xCopyPosition);
+}
+
+BaseType_t xQueueGiveFromISR(QueueHandle_t xQueue, BaseType_t * const pxHigherPriorityTaskWoken)
+{
+    return xQueueGenericSendFromISR(xQueue, NULL, pxHigherPriorityTaskWoken, queueSEND_TO_BACK);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait)
+{
+    if (!SIM_RTOS_Block(xTicksToWait, SIM_RTOS_QueueNotEmpty, xQueue))
+    {
+        return pdFAIL;
+    }
+    SIM_RTOS_QueueGet(xQueue, pvBuffer);
+    return pdPASS;
+}
+
+BaseType_t xQueueSemaphoreTake(QueueHandle_t xQueue, TickType_t xTicksToWait)
+{
+    return xQueueReceive(xQueue, NULL, xTicksToWait);
+}
+
+UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t xQueue)
+{
+    return xQueue->count;
+}
+
+BaseType_t xQueueIsQueueFullFromISR(const QueueHandle_t xQueue)
+{
+    return (xQueue->count == xQueue->length) ? pdTRUE : pdFALSE;
+}
+
+QueueSetHandle_t xQueueCreateSet(const UBaseType_t uxEventQueueLength)
+{
+    (void)uxEventQueueLength;
+    return NULL;
+}
+
+BaseType_t xQueueAddToSet(QueueSetMemberHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet)
+{
+    (void)xQueueOrSemaphore;
+    (void)xQueueSet;
+    return pdFAIL;
+}
+
+QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t xQueueSet, const TickType_t xTicksToWait)
+{
+    (void)xQueueSet;
+    (void)xTicksToWait;
+    return NULL;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Task Functions
+// *****************************************************************************
+// *****************************************************************************
+
+BaseType_t xTaskGenericNotify(TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue,
+                              eNotifyAction eAction, uint32_t *pulPreviousNotificationValue)
+{
+    (void)uxIndexToNotify;
+    if (pulPreviousNotificationValue != NULL)
+    {
+        *pulPreviousNotificationValue = xTaskToNotify->notifyValue;
+    }
+    SIM_RTOS_Notify(xTaskToNotify, ulValue, eAction);
+    return pdPASS;
+}
+
+BaseType_t xTaskGenericNotifyFromISR(TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue,
+                                     eNotifyAction eAction, uint32_t *pulPreviousNotificationValue,
+                                     BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (pxHigherPriorityTaskWoken != NULL)
+    {
+        *pxHigherPriorityTaskWoken = pdFALSE;
+    }
+    return xTaskGenericNotify(xTaskToNotify, uxIndexToNotify, ulValue, eAction, pulPreviousNotificationValue);
+}
+
+BaseType_t xTaskGenericNotifyWait(UBaseType_t uxIndexToWaitOn, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit,
+                                  uint32_t *pulNotificationValue, TickType_t xTicksToWait)
+{
+    TaskHandle_t xTask = xAPP_Tasks;
+
+    (void)uxIndexToWaitOn;
+    if (!xTask->notifyPending)
+    {
+        xTask->notifyValue &= ~ulBitsToClearOnEntry;
+    }
+    if (!SIM_RTOS_Block(xTicksToWait, SIM_RTOS_NotifyPending, xTask))
+    {
+        if (pulNotificationValue != NULL)
+        {
+            *pulNotificationValue = xTask->notifyValue;
+        }
+        return pdFALSE;
+    }
+    if (pulNotificationValue != NULL)
+    {
+        *pulNotificationValue = xTask->notifyValue;
+    }
+    xTask->notifyValue &= ~ulBitsToClearOnExit;
+    xTask->notifyPending = false;
+    return pdTRUE;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(SIM_TIME_Now() / SIM_RTOS_TICK_NS);
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return xTaskGetTickCount();
+}
+
+/* There is no other task to preempt, the priority is only kept. */
+UBaseType_t uxTaskPriorityGet(const TaskHandle_t xTask)
+{
+    return ((xTask != NULL) ? xTask : xAPP_Tasks)->priority;
+}
+
+void vTaskPrioritySet(TaskHandle_t xTask, UBaseType_t uxNewPriority)
+{
+    ((xTask != NULL) ? xTask : xAPP_Tasks)->priority = uxNewPriority;
+}
+
+void vTaskSuspendAll(void)
+{
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    return pdFALSE;
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t * const pxTaskStatusArray, const UBaseType_t uxArraySize,
+                                 configRUN_TIME_COUNTER_TYPE * const pulTotalRunTime)
+{
+    uint64_t now = SIM_TIME_Now();
+
+    if (uxArraySize < 2U)
+    {
+        return 0;
+    }
+
+    memset(pxTaskStatusArray, 0, 2U * sizeof(TaskStatus_t));
+    pxTaskStatusArray[0].xHandle = xAPP_Tasks;
+    pxTaskStatusArray[0].pcTaskName = xAPP_Tasks->p_name;
+    pxTaskStatusArray[0].xTaskNumber = xAPP_Tasks->number;
+    pxTaskStatusArray[0].eCurrentState = eRunning;
+    pxTaskStatusArray[0].ulRunTimeCounter = SIM_RTOS_CYCLES(now - s_rtosIdleNs);
+    pxTaskStatusArray[1].pcTaskName = "IDLE";
+    pxTaskStatusArray[1].xTaskNumber = 2;
+    pxTaskStatusArray[1].eCurrentState = eReady;
+    pxTaskStatusArray[1].ulRunTimeCounter = SIM_RTOS_CYCLES(s_rtosIdleNs);
+    if (pulTotalRunTime != NULL)
+    {
+        *pulTotalRunTime = SIM_RTOS_CYCLES(now);
+    }
+    return 2;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Heap Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void *pvPortMalloc(size_t xWantedSize)
+{
+    SIM_RTOS_Block_T *p_block;
+
+    if ((xWantedSize == 0U) || ((s_rtosHeapUsed + xWantedSize + sizeof(*p_block)) > configTOTAL_HEAP_SIZE))
+    {
+        return NULL;
+    }
+    p_block = malloc(sizeof(*p_block) + xWantedSize);
+    if (p_block == NULL)
+    {
+        return NULL;
+    }
+    p_block->size = xWantedSize + sizeof(*p_block);
+    s_rtosHeapUsed += p_block->size;
+    if (s_rtosHeapUsed > s_rtosHeapMaxUsed)
+    {
+        s_rtosHeapMaxUsed = s_rtosHeapUsed;
+    }
+    return p_block + 1;
+}
+
+void vPortFree(void *pv)
+{
+    SIM_RTOS_Block_T *p_block = pv;
+
+    if (p_block != NULL)
+    {
+        p_block--;
+        s_rtosHeapUsed -= p_block->size;
+        free(p_block);
+    }
+}
+
+size_t xPortGetFreeHeapSize(void)
+{
+    return configTOTAL_HEAP_SIZE - s_rtosHeapUsed;
+}
+
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+    return configTOTAL_HEAP_SIZE - s_rtosHeapMaxUsed;
+}
@@ -0,0 +1,199 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Host Simulation Virtual Time Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sim_time.c
+
+  Summary:
+    Virtual clock and event list of the Linux host simulation.
+
+  Description:
+    See sim_time.h.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "definitions.h"
+#include "sim_time.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct SIM_TIME_Event_T
+{
+    uint64_t                atNs;
+    SIM_TIME_EventFunc_T    func;
+    void                   *p_arg;
+} SIM_TIME_Event_T;
+
+static uint64_t         s_simNow;
+static uint64_t         s_simEnd;
+static bool             s_simFinished;
+static bool             s_simInEvent;
+static SIM_TIME_Event_T s_simEvt[SIM_TIME_EVENT_NUM];   /* Sorted by time */
+static uint8_t          s_simEvtNum;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void SIM_TIME_Set(uint64_t ns)
+{
+    s_simNow = ns;
+    /* CYCCNT wraps like on the target, after 67 s at 64 MHz. */
+    DWT->CYCCNT = (uint32_t)((ns * (configCPU_CLOCK_HZ / 1000000UL)) / 1000ULL);
+}
+
+/* Runs the first event if it is due at limitNs. Returns false otherwise. */
+static bool SIM_TIME_RunNext(uint64_t limitNs)
+{
+    SIM_TIME_Event_T evt;
+
+    if ((s_simEvtNum == 0) || (s_simEvt[0].atNs > limitNs))
+    {
+        return false;
+    }
+
+    evt = s_simEvt[0];
+    s_simEvtNum--;
+    memmove(&s_simEvt[0], &s_simEvt[1], s_simEvtNum * sizeof(s_simEvt[0]));
+
+    if (evt.atNs > s_simNow)
+    {
+        SIM_TIME_Set(evt.atNs);
+    }
+    s_simInEvent = true;
+    evt.func(evt.p_arg);
+    s_simInEvent = false;
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SIM_TIME_Init(uint64_t endNs)
+{
+    s_simEnd = endNs;
+    s_simFinished = false;
+    s_simInEvent = false;
+    s_simEvtNum = 0;
+    SIM_TIME_Set(0);
+}
+
+void SIM_TIME_EndSet(uint64_t endNs)
+{
+    s_simEnd = endNs;
+}
+
+uint64_t SIM_TIME_Now(void)
+{
+    return s_simNow;
+}
+
+void SIM_TIME_Spend(uint64_t ns)
+{
+    uint64_t end = s_simNow + ns;
+
+    /* Time spent inside an event only moves the clock, the event list is
+       processed by the caller further up. */
+    if (!s_simInEvent)
+    {
+        while (SIM_TIME_RunNext(end))
+        {
+        }
+    }
+    if (end > s_simNow)
+    {
+        SIM_TIME_Set(end);
+    }
+}
+
+bool SIM_TIME_EventAdd(uint64_t atNs, SIM_TIME_EventFunc_T func, void *p_arg)
+{
+    uint8_t pos;
+
+    if (s_simEvtNum == SIM_TIME_EVENT_NUM)
+    {
+        return false;
+    }
+
+    pos = s_simEvtNum;
+    while ((pos > 0) && (s_simEvt[pos - 1].atNs > atNs))
+    {
+        s_simEvt[pos] = s_simEvt[pos - 1];
+        pos--;
+    }
+    s_simEvt[pos].atNs = atNs;
+    s_simEvt[pos].func = func;
+    s_simEvt[pos].p_arg = p_arg;
+    s_simEvtNum++;
+    return true;
+}
+
+bool SIM_TIME_Wait(uint64_t deadlineNs, SIM_TIME_ReadyFunc_T ready, void *p_ctx)
+{
+    uint64_t limit;
+
+    while (!ready(p_ctx))
+    {
+        /* An event may move the end. */
+        limit = (deadlineNs < s_simEnd) ? deadlineNs : s_simEnd;
+        if (!SIM_TIME_RunNext(limit))
+        {
+            if ((limit == SIM_TIME_FOREVER) || (limit == s_simEnd))
+            {
+                s_simFinished = true;
+            }
+            else if (limit > s_simNow)
+            {
+                SIM_TIME_Set(limit);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SIM_TIME_Finished(void)
+{
+    return s_simFinished;
+}
@@ -0,0 +1,177 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Host Simulation Virtual Time Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sim_time.h
+
+  Summary:
+    Virtual clock and event list of the Linux host simulation.
+
+  Description:
+    The simulation does not run in real time. Time only moves when the code
+    under test spends it (SPI transfers) or waits for an event (task
+    notifications, queue receives). Whatever happens outside of the
+    firmware, frames on the CAN bus, BLE packets, the model completing a
+    transmission, is an event at a point of that time line.
+
+    Events that fall due while the firmware spends time run right after the
+    spending call returns into the firmware, like an interrupt taken at the
+    end of an SPI transfer. Events never nest.
+
+    All times are in nanoseconds. The tick count and DWT->CYCCNT are derived
+    from the virtual time.
+*******************************************************************************/
+
+#ifndef SIM_TIME_H
+#define SIM_TIME_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_TIME_US(us)         ((uint64_t)(us) * 1000ULL)
+#define SIM_TIME_MS(ms)         ((uint64_t)(ms) * 1000000ULL)
+#define SIM_TIME_FOREVER        UINT64_MAX
+
+#define SIM_TIME_EVENT_NUM      64      /* Pending events */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef void (*SIM_TIME_EventFunc_T)(void *p_arg);
+
+/* Returns true when the condition a wait is for holds. */
+typedef bool (*SIM_TIME_ReadyFunc_T)(void *p_ctx);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void SIM_TIME_Init(uint64_t endNs)
+
+  Summary:
+    Sets the time to 0 and drops all events.
+
+  Parameters:
+    endNs - The simulation ends at this time. SIM_TIME_FOREVER: it ends when
+            nothing is left to wait for.
+*/
+void SIM_TIME_Init(uint64_t endNs);
+
+/*******************************************************************************
+  Function:
+    void SIM_TIME_EndSet(uint64_t endNs)
+
+  Summary:
+    Moves the end of the simulation, e.g. once the last input of a scenario
+    whose length is not known up front has been applied.
+*/
+void SIM_TIME_EndSet(uint64_t endNs);
+
+/*******************************************************************************
+  Function:
+    uint64_t SIM_TIME_Now(void)
+
+  Summary:
+    Returns the virtual time in ns.
+*/
+uint64_t SIM_TIME_Now(void);
+
+/*******************************************************************************
+  Function:
+    void SIM_TIME_Spend(uint64_t ns)
+
+  Summary:
+    Advances the time by the duration of an operation of the firmware and
+    runs the events that fell due meanwhile.
+*/
+void SIM_TIME_Spend(uint64_t ns);
+
+/*******************************************************************************
+  Function:
+    bool SIM_TIME_EventAdd(uint64_t atNs, SIM_TIME_EventFunc_T func, void *p_arg)
+
+  Summary:
+    Schedules func(p_arg) at atNs. Events due at the same time run in the
+    order they were added. A time in the past runs at the next opportunity.
+
+  Returns:
+    true  - Event scheduled.
+    false - SIM_TIME_EVENT_NUM events are already pending.
+*/
+bool SIM_TIME_EventAdd(uint64_t atNs, SIM_TIME_EventFunc_T func, void *p_arg);
+
+/*******************************************************************************
+  Function:
+    bool SIM_TIME_Wait(uint64_t deadlineNs, SIM_TIME_ReadyFunc_T ready, void *p_ctx)
+
+  Summary:
+    Runs events in time order until ready(p_ctx) returns true or the deadline
+    passes.
+
+  Description:
+    The time is left at the event that made the condition true, or at the
+    deadline. When no event is left before the deadline and the deadline is
+    SIM_TIME_FOREVER, or the end of the simulation is reached, the simulation
+    is finished. The caller must return to the main loop then.
+
+  Returns:
+    true  - The condition holds.
+    false - Timeout, or the simulation finished.
+*/
+bool SIM_TIME_Wait(uint64_t deadlineNs, SIM_TIME_ReadyFunc_T ready, void *p_ctx);
+
+/*******************************************************************************
+  Function:
+    bool SIM_TIME_Finished(void)
+
+  Summary:
+    Returns true once a wait found nothing left to do before the end.
+*/
+bool SIM_TIME_Finished(void);
+
+#endif /* SIM_TIME_H */
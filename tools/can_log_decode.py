@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Decoder for the binary log frames of the BLE CAN bridge firmware.
+
+With CAN_LOG_OUTPUT_BINARY defined in can_bridge/can_log.h the firmware
+writes every log record to the console UART as a frame:
+
+  0xA5, payload length, format ID (uint16), time stamp in ms (uint32),
+  arguments (uint32 each), all little endian.
+
+The format strings are read from the CAN_LOG_FORMATS list in can_log.h, so
+the header of the firmware that produced the capture must be used.
+
+Usage: can_log_decode.py <can_log.h> [capture file]
+The capture is a raw dump of the UART (e.g. a terminal log saved in binary
+mode). It is read from stdin when no file is given.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+FRAME_SYNC = 0xA5
+FRAME_HDR_LEN = 6
+FORMAT_RE = re.compile(r'X\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+
+
+def load_formats(header):
+    with open(header, errors="replace") as f:
+        text = f.read()
+
+    start = text.find("#define CAN_LOG_FORMATS(X)")
+    if start < 0:
+        raise SystemExit("%s: CAN_LOG_FORMATS not found" % header)
+
+    # The list ends at the first line that is not continued with a backslash.
+    body = []
+    for line in text[start:].splitlines():
+        body.append(line)
+        if not line.rstrip().endswith("\\"):
+            break
+
+    formats = []
+    for name, fmt in FORMAT_RE.findall("\n".join(body)):
+        fmt = fmt.encode().decode("unicode_escape")
+        formats.append((name, fmt))
+    return formats
+
+
+def decode(data, formats, out):
+    i = 0
+    skipped = 0
+    while i < len(data):
+        if data[i] != FRAME_SYNC or i + 2 > len(data):
+            i += 1
+            skipped += 1
+            continue
+
+        length = data[i + 1]
+        if length < FRAME_HDR_LEN or (length - FRAME_HDR_LEN) % 4 or i + 2 + length > len(data):
+            i += 1
+            skipped += 1
+            continue
+
+        payload = data[i + 2:i + 2 + length]
+        fmt_id, timestamp = struct.unpack_from("<HI", payload)
+        args = struct.unpack_from("<%dI" % ((length - FRAME_HDR_LEN) // 4), payload, FRAME_HDR_LEN)
+        if fmt_id >= len(formats):
+            i += 1
+            skipped += 1
+            continue
+
+        name, fmt = formats[fmt_id]
+        count = len(re.findall(r"%[-0-9.]*l?[diuxXc]", fmt))
+        args = tuple(args) + (0,) * max(0, count - len(args))
+        out.write("[%u] %s" % (timestamp, fmt % args[:count]))
+        i += 2 + length
+
+    if skipped:
+        out.write("(%d bytes outside of frames skipped)\n" % skipped)
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Expand binary CAN bridge log frames.")
+    parser.add_argument("header", help="can_bridge/can_log.h of the firmware")
+    parser.add_argument("capture", nargs="?", help="raw UART capture, stdin if omitted")
+    args = parser.parse_args(argv[1:])
+
+    formats = load_formats(args.header)
+    if args.capture:
+        with open(args.capture, "rb") as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    decode(data, formats, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,504 @@
+#!/usr/bin/env python3
+"""Replays recorded CAN traffic through the BLE CAN bridge.
+
+Reads a candump log, a Vector ASC or a BLF file and
+  convert  writes the frames in the replay format of sim/sim_replay.h,
+  sim      replays them in the host simulation (tools/sim_build.py) and
+           reports per identifier what became of the frames: filtered by the
+           controller, lost to a RX FIFO overflow or in the bridge, and the
+           latency from the end of the frame on the bus to the BLE send call,
+           plus the BLE bytes per frame and the PDU utilization,
+  header   writes can_bridge/can_replay_trace.h for the on-device replay
+           (CAN_REPLAY_ENABLE in can_bridge/can_replay.h).
+
+Supported inputs:
+  candump  "candump -l" log lines "(1436509052.249713) can0 123#1122" and
+           timestamped screen lines "(1436509052.249713) can0 123 [2] 11 22"
+  asc      classic frames ("x" for extended, "r" for remote frames) and CANFD
+           lines, hex or dec base, absolute or relative time stamps
+  blf      CAN_MESSAGE, CAN_MESSAGE2, CAN_FD_MESSAGE and CAN_FD_MESSAGE_64
+           objects, plain or in zlib compressed log containers. Other object
+           types are skipped.
+
+The RX and TX FIFOs of the bridge have an 8 byte payload, CAN FD frames with
+more data are skipped and counted. Error frames are skipped as well.
+
+Usage: can_replay.py convert trace.asc -o trace.rpl
+       can_replay.py sim trace.blf --project central --speed 10
+       can_replay.py header candump.log -o <project>/firmware/src/can_bridge/can_replay_trace.h
+"""
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+import zlib
+
+import sim_build
+
+CTRL_IDE = 0x10
+CTRL_RTR = 0x20
+CTRL_BRS = 0x40
+CTRL_FDF = 0x80
+
+FD_LEN = [0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64]
+
+
+class Frame:
+    __slots__ = ("time", "id", "ext", "rtr", "fdf", "brs", "dlc", "data", "channel")
+
+    def __init__(self, time, can_id, ext, data, dlc=None, rtr=False, fdf=False, brs=False, channel=None):
+        self.time = time            # seconds
+        self.id = can_id
+        self.ext = ext
+        self.rtr = rtr
+        self.fdf = fdf
+        self.brs = brs
+        self.data = bytes(data)
+        self.dlc = len(self.data) if dlc is None else dlc
+        self.channel = channel
+
+    def ctrl(self):
+        return (self.dlc | (CTRL_IDE if self.ext else 0) | (CTRL_RTR if self.rtr else 0)
+                | (CTRL_BRS if self.brs else 0) | (CTRL_FDF if self.fdf else 0))
+
+
+def fd_dlc(length):
+    for dlc, n in enumerate(FD_LEN):
+        if n >= length:
+            return dlc
+    raise ValueError("%d data bytes" % length)
+
+
+# *****************************************************************************
+# candump
+# *****************************************************************************
+
+def parse_candump(path):
+    with open(path, errors="replace") as f:
+        for num, line in enumerate(f, 1):
+            line = line.strip()
+            if not line.startswith("("):
+                continue
+            try:
+                stamp, rest = line[1:].split(")", 1)
+                fields = rest.split()
+                frame = candump_frame(float(stamp), fields)
+            except (ValueError, IndexError):
+                raise SystemExit("%s:%d: cannot parse %r" % (path, num, line))
+            if frame is not None:
+                yield frame
+
+
+def candump_frame(time, fields):
+    channel = fields[0]
+    if "#" in fields[1]:
+        # Log format: <id>#<data>, <id>#R[<dlc>], <id>##<flags><data>
+        ident, payload = fields[1].split("#", 1)
+        can_id = int(ident, 16)
+        if len(ident) == 8 and can_id & 0x20000000:
+            return None                                 # error frame
+        ext = len(ident) == 8
+        if payload.startswith("#"):
+            flags = int(payload[1], 16)
+            data = bytes.fromhex(payload[2:])
+            return Frame(time, can_id, ext, data, fd_dlc(len(data)), fdf=True, brs=bool(flags & 1), channel=channel)
+        if payload.startswith("R"):
+            dlc = int(payload[1:], 16) if len(payload) > 1 else 0
+            return Frame(time, can_id, ext, b"", dlc, rtr=True, channel=channel)
+        data = bytes.fromhex(payload.split("_")[0])
+        return Frame(time, can_id, ext, data, channel=channel)
+
+    # Screen format: <id> [<len>] <data bytes> or "remote request"
+    ident = fields[1]
+    can_id = int(ident, 16)
+    if "ERRORFRAME" in fields:
+        return None
+    length = int(fields[2].strip("[]"))
+    fdf = len(fields[2]) == 4                          # [08] for CAN FD
+    if "remote" in fields:
+        return Frame(time, can_id, len(ident) == 8, b"", length, rtr=True, channel=channel)
+    data = bytes(int(b, 16) for b in fields[3:3 + length])
+    return Frame(time, can_id, len(ident) == 8, data, fd_dlc(length) if fdf else length, fdf=fdf,
+                 channel=channel)
+
+
+# *****************************************************************************
+# Vector ASC
+# *****************************************************************************
+
+def parse_asc(path):
+    base = 16
+    relative = False
+    last = 0.0
+    with open(path, errors="replace") as f:
+        for num, line in enumerate(f, 1):
+            fields = line.split()
+            if not fields:
+                continue
+            if fields[0] == "base" and len(fields) >= 4:
+                base = 16 if fields[1] == "hex" else 10
+                relative = fields[3] == "relative"
+                continue
+            try:
+                time = float(fields[0])
+            except ValueError:
+                continue
+            if relative:
+                time += last
+            last = time
+            try:
+                frame = asc_frame(time, fields[1:], base)
+            except (ValueError, IndexError):
+                raise SystemExit("%s:%d: cannot parse %r" % (path, num, line.strip()))
+            if frame is not None:
+                yield frame
+
+
+def asc_id(text, base):
+    ext = text.endswith(("x", "X"))
+    return int(text.rstrip("xX"), base), ext
+
+
+def asc_frame(time, fields, base):
+    if fields[0] == "CANFD":
+        # CANFD <ch> <dir> <id> [<name>] <brs> <esi> <dlc> <len> <data> ...
+        channel = fields[1]
+        can_id, ext = asc_id(fields[3], base)
+        i = 4
+        if fields[i] not in ("0", "1"):
+            i += 1
+        brs = fields[i] == "1"
+        dlc = int(fields[i + 2], 16)
+        length = int(fields[i + 3])
+        data = bytes(int(b, base) for b in fields[i + 4:i + 4 + length])
+        return Frame(time, can_id, ext, data, dlc, fdf=True, brs=brs, channel=channel)
+
+    # <ch> <id> <dir> d <dlc> <data> ... or <ch> <id> <dir> r [<dlc>]
+    if not fields[0].isdigit() or len(fields) < 4 or fields[1] == "ErrorFrame":
+        return None
+    channel = fields[0]
+    can_id, ext = asc_id(fields[1], base)
+    if fields[3] == "r":
+        dlc = int(fields[4], 16) if len(fields) > 4 and fields[4].isalnum() else 0
+        return Frame(time, can_id, ext, b"", dlc, rtr=True, channel=channel)
+    if fields[3] != "d":
+        return None
+    dlc = int(fields[4], 16)
+    data = bytes(int(b, base) for b in fields[5:5 + min(dlc, 8)])
+    return Frame(time, can_id, ext, data, min(dlc, 8), channel=channel)
+
+
+# *****************************************************************************
+# BLF
+# *****************************************************************************
+
+BLF_OBJ_SIGNATURE = b"LOBJ"
+BLF_LOG_CONTAINER = 10
+BLF_CAN_MESSAGE = 1
+BLF_CAN_MESSAGE2 = 86
+BLF_CAN_FD_MESSAGE = 100
+BLF_CAN_FD_MESSAGE_64 = 101
+BLF_TIME_TEN_MICS = 1
+BLF_TIME_ONE_NANS = 2
+
+
+def parse_blf(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"LOGG":
+        raise SystemExit("%s: not a BLF file" % path)
+    header_size = struct.unpack_from("<I", data, 4)[0]
+    yield from blf_objects(path, data[header_size:], 0)
+
+
+def blf_objects(path, data, depth):
+    pos = 0
+    pending = b""
+    while pos + 16 <= len(data):
+        if data[pos:pos + 4] != BLF_OBJ_SIGNATURE:
+            pos += 1                                    # padding
+            continue
+        header_size, header_version, obj_size, obj_type = struct.unpack_from("<HHII", data, pos + 4)
+        if obj_size < 16 or pos + obj_size > len(data):
+            break
+        obj = data[pos:pos + obj_size]
+        pos += obj_size
+
+        if obj_type == BLF_LOG_CONTAINER and depth == 0:
+            method, _, size = struct.unpack_from("<H6sI", obj, 16)
+            body = obj[32:]
+            if method == 2:
+                body = zlib.decompress(body)
+            elif method != 0:
+                raise SystemExit("%s: compression method %d not supported" % (path, method))
+            # Objects may span containers.
+            pending += body[:size]
+            continue
+
+        frame = blf_frame(obj, header_size, header_version, obj_type)
+        if frame is not None:
+            yield frame
+
+    if pending:
+        yield from blf_objects(path, pending, depth + 1)
+
+
+def blf_frame(obj, header_size, header_version, obj_type):
+    if header_version == 1:
+        flags, _, _, stamp = struct.unpack_from("<IHHQ", obj, 16)
+    else:
+        flags, _, _, stamp = struct.unpack_from("<IBBHQ", obj, 16)
+    time = stamp * (1e-9 if flags == BLF_TIME_ONE_NANS else 1e-5)
+    body = obj[header_size:]
+
+    if obj_type in (BLF_CAN_MESSAGE, BLF_CAN_MESSAGE2):
+        channel, msg_flags, dlc, can_id = struct.unpack_from("<HBBI", body)
+        rtr = bool(msg_flags & 0x80)
+        data = b"" if rtr else body[8:8 + min(dlc, 8)]
+        return Frame(time, can_id & 0x1FFFFFFF, bool(can_id & 0x80000000), data, min(dlc, 8), rtr=rtr,
+                     channel=str(channel))
+    if obj_type == BLF_CAN_FD_MESSAGE:
+        channel, msg_flags, dlc, can_id, _, _, fd_flags, length = struct.unpack_from("<HBBIIBBB", body)
+        fdf = bool(fd_flags & 1)
+        rtr = bool(msg_flags & 0x80) and not fdf
+        data = b"" if rtr else body[20:20 + length]
+        return Frame(time, can_id & 0x1FFFFFFF, bool(can_id & 0x80000000), data, dlc, rtr=rtr, fdf=fdf,
+                     brs=bool(fd_flags & 2), channel=str(channel))
+    if obj_type == BLF_CAN_FD_MESSAGE_64:
+        channel, dlc, length, _, can_id, _, fd_flags = struct.unpack_from("<BBBBIII", body)
+        fdf = bool(fd_flags & 0x1000)
+        rtr = bool(fd_flags & 0x0010)
+        data = b"" if rtr else body[40:40 + length]
+        return Frame(time, can_id & 0x1FFFFFFF, bool(can_id & 0x80000000), data, dlc, rtr=rtr, fdf=fdf,
+                     brs=bool(fd_flags & 0x2000), channel=str(channel))
+    return None
+
+
+# *****************************************************************************
+# Common
+# *****************************************************************************
+
+PARSERS = {"candump": parse_candump, "asc": parse_asc, "blf": parse_blf}
+
+
+def detect(path):
+    with open(path, "rb") as f:
+        head = f.read(256)
+    if head.startswith(b"LOGG"):
+        return "blf"
+    if head.lstrip().startswith(b"("):
+        return "candump"
+    return "asc"
+
+
+def load(args):
+    fmt = args.format if args.format != "auto" else detect(args.input)
+    frames = []
+    skipped = 0
+    first = None
+    for frame in PARSERS[fmt](args.input):
+        if args.channel is not None and frame.channel != args.channel:
+            continue
+        if first is None:
+            first = frame.time
+        if frame.time - first < args.start:
+            continue
+        if args.duration is not None and frame.time - first >= args.start + args.duration:
+            break
+        if len(frame.data) > 8 or (frame.rtr and frame.dlc > 8):
+            skipped += 1
+            continue
+        frames.append(frame)
+        if args.limit and len(frames) >= args.limit:
+            break
+
+    if not frames:
+        raise SystemExit("%s: no frames" % args.input)
+    # Some loggers interleave channels slightly out of order.
+    frames.sort(key=lambda fr: fr.time)
+    t0 = frames[0].time
+    for frame in frames:
+        frame.time = int(round((frame.time - t0) * 1e6))
+    print("%s: %s, %d frames, %.3f s%s" % (args.input, fmt, len(frames), frames[-1].time / 1e6,
+                                          ", %d CAN FD frames above 8 bytes skipped" % skipped if skipped else ""),
+          file=sys.stderr)
+    return frames
+
+
+def write_replay(frames, out):
+    out.write("# time_us id ctrl data\n")
+    for fr in frames:
+        out.write("%d %X %02X %s\n" % (fr.time, fr.id, fr.ctrl(), fr.data.hex().upper() if fr.data else "-"))
+
+
+# *****************************************************************************
+# Commands
+# *****************************************************************************
+
+def cmd_convert(args):
+    frames = load(args)
+    if args.output:
+        with open(args.output, "w") as out:
+            write_replay(frames, out)
+    else:
+        write_replay(frames, sys.stdout)
+    return 0
+
+
+def percentile(values, p):
+    return values[min(len(values) - 1, (len(values) * p) // 100)]
+
+
+def report(path, out):
+    per_id = {}
+    pdus = []
+    pdu_max = 244
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if line.startswith("#"):
+                if "pdu_max" in fields:
+                    pdu_max = int(fields[fields.index("pdu_max") + 1])
+                continue
+            if fields[0] == "F":
+                ctrl = int(fields[4], 16)
+                key = (int(fields[3], 16), bool(ctrl & CTRL_IDE))
+                entry = per_id.setdefault(key, {"frames": 0, "F": 0, "O": 0, "lost": 0, "lat": [], "times": []})
+                entry["frames"] += 1
+                entry["times"].append(int(fields[2]))
+                status, ble = fields[6], int(fields[7])
+                if status in ("F", "O"):
+                    entry[status] += 1
+                elif ble < 0:
+                    entry["lost"] += 1
+                else:
+                    entry["lat"].append((ble - int(fields[5])) / 1000.0)
+            elif fields[0] == "P":
+                pdus.append((int(fields[2]), int(fields[3])))
+
+    out.write("\n%-10s %7s %8s %8s %7s %9s %8s %8s %8s\n" % ("ID", "frames", "filtered", "overflow", "lost",
+                                                           "period ms", "p50 us", "p99 us", "max us"))
+    for (can_id, ext), e in sorted(per_id.items()):
+        lat = sorted(e["lat"])
+        times = e["times"]
+        period = (times[-1] - times[0]) / 1000.0 / (len(times) - 1) if len(times) > 1 else 0.0
+        out.write("%-10s %7d %8d %8d %7d %9.2f" % (("%08X" if ext else "%03X") % can_id, e["frames"], e["F"], e["O"],
+                                                   e["lost"], period))
+        if lat:
+            out.write(" %8.1f %8.1f %8.1f\n" % (percentile(lat, 50), percentile(lat, 99), lat[-1]))
+        else:
+            out.write(" %8s %8s %8s\n" % ("-", "-", "-"))
+
+    sent = sum(len(e["lat"]) for e in per_id.values())
+    total = sum(e["frames"] for e in per_id.values())
+    out.write("\n%d of %d frames sent over BLE: %d filtered, %d overflows, %d lost in the bridge\n" % (
+        sent, total, sum(e["F"] for e in per_id.values()), sum(e["O"] for e in per_id.values()),
+        sum(e["lost"] for e in per_id.values())))
+    if pdus:
+        length = sum(p[0] for p in pdus)
+        records = sum(p[1] for p in pdus)
+        out.write("BLE: %d PDUs, %.1f bytes per frame, mean PDU %.1f bytes, %.1f%% of %d, %.2f frames per PDU\n" % (
+            len(pdus), length / max(records, 1), length / len(pdus), 100.0 * length / (len(pdus) * pdu_max),
+            pdu_max, records / len(pdus)))
+
+
+def cmd_sim(args):
+    frames = load(args)
+    exe = sim_build.build(args.project, args.cc, ["-D" + d for d in args.defines])
+    with tempfile.TemporaryDirectory() as tmp:
+        trace = os.path.join(tmp, "trace.rpl")
+        results = args.results or os.path.join(tmp, "results.txt")
+        with open(trace, "w") as out:
+            write_replay(frames, out)
+        status = subprocess.run([exe, "-q", "-r", trace, "-s", str(args.speed), "-o", results]).returncode
+        if os.path.exists(results):
+            report(results, sys.stdout)
+    return status
+
+
+HEADER_DESCRIPTION = """
+/*******************************************************************************
+  CAN Bridge Replay Trace
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    can_replay_trace.h
+
+  Summary:
+    Trace played by can_replay.c.
+
+  Description:
+    Generated by "tools/can_replay.py header" from %s,
+    %d frames over %.3f s. Included by can_replay.c only.
+*******************************************************************************/
+
+#ifndef _CAN_REPLAY_TRACE_H
+#define _CAN_REPLAY_TRACE_H
+
+#define CAN_REPLAY_TRACE_NUM        %dU
+
+static const CAN_REPLAY_Frame_T s_replayTrace[CAN_REPLAY_TRACE_NUM] =
+{
+"""
+
+
+def cmd_header(args):
+    frames = load(args)[:args.max]
+    if frames[-1].time > 0xFFFFFFFF:
+        raise SystemExit("trace longer than 71 minutes, use --duration")
+    with open(os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir,
+                           sim_build.PROJECTS["central"][0], "firmware", "src", "app.c")) as f:
+        license_text = f.read().split("// DOM-IGNORE-END", 1)[0] + "// DOM-IGNORE-END\n"
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    out.write(license_text)
+    out.write(HEADER_DESCRIPTION % (os.path.basename(args.input), len(frames), frames[-1].time / 1e6, len(frames)))
+    for fr in frames:
+        data = ", ".join("0x%02X" % b for b in fr.data) or "0"
+        out.write("    { %10d, 0x%08X, 0x%02X, { %s } },\n" % (fr.time, fr.id, fr.ctrl(), data))
+    out.write("};\n\n#endif /* _CAN_REPLAY_TRACE_H */\n\n/*******************************************************************************\n"
+              " End of File\n */\n")
+    if out is not sys.stdout:
+        out.close()
+    return 0
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Replay recorded CAN traffic through the bridge.")
+    sub = parser.add_subparsers(dest="command", required=True)
+    commands = {
+        "convert": (cmd_convert, "write the replay format of sim/sim_replay.h"),
+        "sim": (cmd_sim, "replay in the host simulation and report per identifier"),
+        "header": (cmd_header, "write can_replay_trace.h for the on-device replay"),
+    }
+    for name, (func, text) in commands.items():
+        p = sub.add_parser(name, help=text)
+        p.set_defaults(func=func)
+        p.add_argument("input", help="candump log, ASC or BLF file")
+        p.add_argument("--format", default="auto", choices=["auto"] + sorted(PARSERS))
+        p.add_argument("--channel", help="only this channel (candump interface or ASC/BLF channel number)")
+        p.add_argument("--start", type=float, default=0.0, help="skip the first seconds of the trace")
+        p.add_argument("--duration", type=float, help="seconds of the trace to use")
+        p.add_argument("--limit", type=int, default=0, help="at most this many frames")
+        if name in ("convert", "header"):
+            p.add_argument("-o", "--output", help="output file, stdout if omitted")
+        if name == "header":
+            p.add_argument("--max", type=int, default=500, help="at most this many frames (20 bytes of flash each)")
+        if name == "sim":
+            p.add_argument("--project", default="central", choices=sorted(sim_build.PROJECTS))
+            p.add_argument("--speed", type=float, default=1.0, help="replay speed, 1 for the recorded timing")
+            p.add_argument("--results", help="keep the per frame results of the simulation in this file")
+            p.add_argument("--cc", default=os.environ.get("CC", "gcc"), help="host C compiler")
+            p.add_argument("-D", dest="defines", action="append", default=[], help="extra define for the build")
+
+    args = parser.parse_args(argv[1:])
+    return args.func(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
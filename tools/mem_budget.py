@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""Memory budget report for the BLE CAN bridge firmware.
+
+Reads the GNU linker map file produced by XC32 (MPLAB X writes it to
+dist/<conf>/production/<project>.X.production.map when the linker option
+"Generate map file" is enabled) and prints:
+
+  * the size of every memory region and how much of it is used,
+  * the objects placed with APP_STATIC_SECTION(group), summed per group and
+    listed per object file (task stacks, queues, semaphores, frame pools),
+  * the FreeRTOS heap (ucHeap) when the map lists it as its own section.
+
+Usage: mem_budget.py <file.map> [--budget ram=<bytes>]
+The exit status is 1 when a --budget limit is exceeded, so the script can
+gate a build step.
+"""
+
+import argparse
+import re
+import sys
+from collections import OrderedDict, defaultdict
+
+STATIC_PREFIX = ".bss.app_static."
+HEX = r"0x[0-9a-fA-F]+"
+
+
+def parse_map(path):
+    regions = OrderedDict()
+    out_sections = []
+    static_objs = []
+    heap = None
+
+    with open(path, errors="replace") as f:
+        lines = f.read().splitlines()
+
+    i = 0
+    in_mem_cfg = False
+    while i < len(lines):
+        line = lines[i]
+
+        if line.startswith("Memory Configuration"):
+            in_mem_cfg = True
+            i += 1
+            continue
+        if in_mem_cfg:
+            if line.startswith("Linker script and memory map"):
+                in_mem_cfg = False
+            else:
+                m = re.match(r"^(\S+)\s+(%s)\s+(%s)" % (HEX, HEX), line)
+                if m and m.group(1) != "*default*":
+                    regions[m.group(1)] = (int(m.group(2), 16), int(m.group(3), 16))
+            i += 1
+            continue
+
+        # Section names that are too long are followed by address and size on
+        # the next line.
+        name_only = re.match(r"^(\s?)(\.\S+)\s*$", line)
+        if name_only and i + 1 < len(lines):
+            nxt = re.match(r"^\s+(%s)\s+(%s)\s*(.*)$" % (HEX, HEX), lines[i + 1])
+            if nxt:
+                line = "%s%s %s %s %s" % (name_only.group(1), name_only.group(2),
+                                          nxt.group(1), nxt.group(2), nxt.group(3))
+                i += 1
+
+        m = re.match(r"^(\s?)(\.\S+)\s+(%s)\s+(%s)\s*(.*)$" % (HEX, HEX), line)
+        if m:
+            indent, name, addr, size, obj = m.groups()
+            addr, size = int(addr, 16), int(size, 16)
+            if indent == "":
+                out_sections.append((name, addr, size))
+            elif name.startswith(STATIC_PREFIX) and size:
+                group = name[len(STATIC_PREFIX):]
+                static_objs.append((group, obj.strip(), size))
+            elif name.endswith("ucHeap") and size:
+                heap = size
+        i += 1
+
+    return regions, out_sections, static_objs, heap
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Memory budget report from an XC32 map file.")
+    parser.add_argument("map", help="linker map file")
+    parser.add_argument("--budget", action="append", default=[], metavar="REGION=BYTES",
+                        help="fail when REGION uses more than BYTES, e.g. ram=0x18000")
+    args = parser.parse_args(argv[1:])
+
+    budgets = {}
+    for item in args.budget:
+        region, _, limit = item.partition("=")
+        budgets[region] = int(limit, 0)
+
+    regions, out_sections, static_objs, heap = parse_map(args.map)
+    used = defaultdict(int)
+    for name, addr, size in out_sections:
+        for region, (origin, length) in regions.items():
+            if size and origin <= addr < origin + length:
+                used[region] += size
+                break
+
+    print("Memory regions")
+    for region, (origin, length) in regions.items():
+        pct = 100.0 * used[region] / length if length else 0.0
+        print("  %-12s %8d / %8d bytes  %5.1f%%" % (region, used[region], length, pct))
+
+    print("\nStatically allocated objects (APP_STATIC_SECTION)")
+    groups = OrderedDict()
+    for group, obj, size in static_objs:
+        groups.setdefault(group, []).append((obj, size))
+    total = 0
+    for group, objs in groups.items():
+        group_size = sum(s for _, s in objs)
+        total += group_size
+        print("  %-12s %8d bytes" % (group, group_size))
+        for obj, size in objs:
+            print("    %-40s %8d" % (obj.split("/")[-1], size))
+    print("  %-12s %8d bytes" % ("total", total))
+
+    if heap is not None:
+        print("\nFreeRTOS heap (ucHeap) %d bytes" % heap)
+
+    status = 0
+    for region, limit in budgets.items():
+        if used.get(region, 0) > limit:
+            print("\nBUDGET EXCEEDED: %s uses %d bytes, limit %d" % (region, used[region], limit))
+            status = 1
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
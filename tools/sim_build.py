@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Builds and runs the Linux host simulation of the BLE CAN bridge.
+
+The application sources of a project (app.c, the CAN FD SPI driver,
+can_bridge, the transparent profile handler and the OSAL) are compiled with
+the host gcc against the stand-ins in sim/: the MCP251863 model, the SPI
+driver, the FreeRTOS kernel, the BLE stack and the board. The target headers
+of the project are used unchanged, sim/include and sim/port are searched
+first.
+
+Usage: sim_build.py [central|peripheral|all] [--run] [-- sim arguments]
+The executables are written to sim/out/sim_<project>. With --run each one is
+started after the build, e.g. sim_build.py all --run -- -n 500 -q
+"""
+
+import argparse
+import glob
+import os
+import subprocess
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SIM = os.path.join(ROOT, "sim")
+OUT = os.path.join(SIM, "out")
+
+PROJECTS = {
+    "central": ("01_wbz451_mcp251863_CAN_BLE_Central", "app_trspc_handler.c", ["-DSIM_APP_CENTRAL"]),
+    "peripheral": ("02_wbz451_mcp251863_CAN_BLE_Peripheral", "app_trsps_handler.c", []),
+}
+
+APP_SOURCES = [
+    "app.c",
+    "app_telemetry.c",
+    "canfdspi/drv_canfdspi_api.c",
+    "can_bridge/*.c",
+    "app_ble/app_ble_evt_pool.c",
+    "config/default/osal/osal_freertos.c",
+    "config/default/osal/osal_freertos_extend.c",
+]
+
+INCLUDES = [
+    ".",
+    "app_ble",
+    "config/default",
+    "config/default/ble/lib/include",
+    "config/default/ble/middleware_ble",
+    "config/default/ble/profile_ble",
+    "config/default/ble/service_ble",
+    "config/default/driver/pds/include",
+    "packs/CMSIS",
+    "packs/CMSIS/CMSIS/Core/Include",
+    "packs/WBZ451_DFP",
+    "third_party/rtos/FreeRTOS/Source/include",
+    "third_party/wolfssl",
+    "third_party/wolfssl/wolfssl",
+]
+
+CFLAGS = [
+    "-std=gnu99", "-O1", "-g",
+    "-D__XC32", "-DHAVE_CONFIG_H", "-DWOLFSSL_IGNORE_FILE_WARN",
+    # The CMSIS NVIC vector helpers cast 32 bit addresses to pointers.
+    "-Wno-int-to-pointer-cast", "-Wno-pointer-to-int-cast",
+    "-ffunction-sections", "-fdata-sections",
+]
+
+
+def build(name, cc, extra):
+    project, handler, defines = PROJECTS[name]
+    src_dir = os.path.join(ROOT, project, "firmware", "src")
+
+    sources = []
+    for pattern in APP_SOURCES + ["app_ble/" + handler]:
+        sources += sorted(glob.glob(os.path.join(src_dir, pattern)))
+    sources += sorted(glob.glob(os.path.join(SIM, "*.c")))
+
+    includes = ["-I" + os.path.join(SIM, "include"), "-I" + os.path.join(SIM, "port")]
+    includes += ["-I" + os.path.join(src_dir, d) for d in INCLUDES]
+
+    os.makedirs(OUT, exist_ok=True)
+    exe = os.path.join(OUT, "sim_" + name)
+    cmd = [cc] + CFLAGS + defines + extra + includes + sources + ["-Wl,--gc-sections", "-o", exe]
+    print("building", os.path.relpath(exe, ROOT))
+    if subprocess.run(cmd, cwd=src_dir).returncode != 0:
+        raise SystemExit("%s: build failed" % name)
+    return exe
+
+
+def main(argv):
+    if "--" in argv:
+        sim_args = argv[argv.index("--") + 1:]
+        argv = argv[:argv.index("--")]
+    else:
+        sim_args = []
+
+    parser = argparse.ArgumentParser(description="Build the host simulation of the bridge.")
+    parser.add_argument("project", nargs="?", default="all", choices=sorted(PROJECTS) + ["all"])
+    parser.add_argument("--run", action="store_true", help="run each simulation after the build")
+    parser.add_argument("--cc", default=os.environ.get("CC", "gcc"), help="host C compiler")
+    parser.add_argument("-D", dest="defines", action="append", default=[],
+                        help="extra define, e.g. -D CAN_TRACE_ENABLE")
+    args = parser.parse_args(argv[1:])
+
+    names = sorted(PROJECTS) if args.project == "all" else [args.project]
+    extra = ["-D" + d for d in args.defines]
+    status = 0
+    for name in names:
+        exe = build(name, args.cc, extra)
+        if args.run:
+            print("running", name)
+            status |= subprocess.run([exe] + sim_args).returncode
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))